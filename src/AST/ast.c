@@ -5,12 +5,40 @@
 
 static ASTNode* ast_node_copy(ASTNode* node);
 
+/*
+ * When an arena is set (one per compilation unit, see tools/runner.c) nodes,
+ * their strings and child arrays are bump-allocated from it, constructors
+ * adopt their children instead of deep-copying them, and ast_free is a no-op
+ * for arena nodes: the whole tree goes away with arena_destroy.
+ */
+static Arena* ast_arena = NULL;
+
+void ast_set_arena(Arena* arena) {
+    ast_arena = arena;
+}
+
+Arena* ast_get_arena(void) {
+    return ast_arena;
+}
+
+static void* ast_alloc(size_t size) {
+    return ast_arena ? arena_alloc(ast_arena, size) : malloc(size);
+}
+
+static char* ast_strdup(const char* str) {
+    return ast_arena ? arena_strdup(ast_arena, str) : strdup(str);
+}
+
+static ASTNode* ast_adopt(ASTNode* child) {
+    return ast_arena ? child : ast_node_copy(child);
+}
+
 static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
     ASTNode* node = NULL;
     
     switch (node_type) {
         case NODE_BINARY_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(BinaryExpression));
+            node = (ASTNode*)ast_alloc(sizeof(BinaryExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -22,7 +50,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_FUNCTION_CALL_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(FunctionCallExpression));
+            node = (ASTNode*)ast_alloc(sizeof(FunctionCallExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -34,7 +62,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_UNARY_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(UnaryExpression));
+            node = (ASTNode*)ast_alloc(sizeof(UnaryExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -45,7 +73,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_LITERAL_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(LiteralExpression));
+            node = (ASTNode*)ast_alloc(sizeof(LiteralExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -56,7 +84,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
 
         case NODE_LITERAL_EXPRESSION_LONG_ARITHMETICS:
-            node = (ASTNode*)malloc(sizeof(LiteralExpressionLongArithmetics));
+            node = (ASTNode*)ast_alloc(sizeof(LiteralExpressionLongArithmetics));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -66,7 +94,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             }
             break;            
         case NODE_VARIABLE_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(VariableExpression));
+            node = (ASTNode*)ast_alloc(sizeof(VariableExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -76,7 +104,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_ARRAY_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(ArrayExpression));
+            node = (ASTNode*)ast_alloc(sizeof(ArrayExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -87,7 +115,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_SUBSCRIPT_EXPRESSION:
-            node = (ASTNode*)malloc(sizeof(SubscriptExpression));
+            node = (ASTNode*)ast_alloc(sizeof(SubscriptExpression));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -99,7 +127,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             
         case NODE_BREAK_STATEMENT:
         case NODE_CONTINUE_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(ASTNode));
+            node = (ASTNode*)ast_alloc(sizeof(ASTNode));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -107,7 +135,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_ARRAY_DECLARATION_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(ArrayDeclarationStatement));
+            node = (ASTNode*)ast_alloc(sizeof(ArrayDeclarationStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -115,12 +143,13 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
                 array_decl->element_type = TYPE_INT;
                 array_decl->name = NULL;
                 array_decl->size = NULL;
+                array_decl->columns = NULL;
                 array_decl->initializer = NULL;
             }
             break;
             
         case NODE_ASSIGNMENT_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(AssignmentStatement));
+            node = (ASTNode*)ast_alloc(sizeof(AssignmentStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -131,7 +160,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_VARIABLE_DECLARATION_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(VariableDeclarationStatement));
+            node = (ASTNode*)ast_alloc(sizeof(VariableDeclarationStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -143,7 +172,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_FUNCTION_DECLARATION_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(FunctionDeclarationStatement));
+            node = (ASTNode*)ast_alloc(sizeof(FunctionDeclarationStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -157,7 +186,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_RETURN_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(ReturnStatement));
+            node = (ASTNode*)ast_alloc(sizeof(ReturnStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -167,7 +196,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_EXPRESSION_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(ExpressionStatement));
+            node = (ASTNode*)ast_alloc(sizeof(ExpressionStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -177,18 +206,19 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_BLOCK_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(BlockStatement));
+            node = (ASTNode*)ast_alloc(sizeof(BlockStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
                 BlockStatement* block_stmt = (BlockStatement*) node;
                 block_stmt->statements = NULL;
                 block_stmt->statement_count = 0;
+                block_stmt->statement_capacity = 0;
             }
             break;
             
         case NODE_IF_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(IfStatement));
+            node = (ASTNode*)ast_alloc(sizeof(IfStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -203,7 +233,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_WHILE_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(WhileStatement));
+            node = (ASTNode*)ast_alloc(sizeof(WhileStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -214,7 +244,7 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
             
         case NODE_FOR_STATEMENT:
-            node = (ASTNode*)malloc(sizeof(ForStatement));
+            node = (ASTNode*)ast_alloc(sizeof(ForStatement));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -226,8 +256,45 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             }
             break;
             
+        case NODE_STRUCT_DECLARATION_STATEMENT:
+            node = (ASTNode*)ast_alloc(sizeof(StructDeclarationStatement));
+            if (node) {
+                node->node_type = node_type;
+                node->location = loc;
+                StructDeclarationStatement* struct_decl = (StructDeclarationStatement*) node;
+                struct_decl->name = NULL;
+                struct_decl->fields = NULL;
+                struct_decl->field_count = 0;
+            }
+            break;
+
+        case NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT:
+            node = (ASTNode*)ast_alloc(sizeof(StructVariableDeclarationStatement));
+            if (node) {
+                node->node_type = node_type;
+                node->location = loc;
+                StructVariableDeclarationStatement* var_decl = (StructVariableDeclarationStatement*) node;
+                var_decl->struct_name = NULL;
+                var_decl->name = NULL;
+                var_decl->is_array = false;
+                var_decl->size = NULL;
+                var_decl->initializer = NULL;
+            }
+            break;
+
+        case NODE_FIELD_EXPRESSION:
+            node = (ASTNode*)ast_alloc(sizeof(FieldExpression));
+            if (node) {
+                node->node_type = node_type;
+                node->location = loc;
+                FieldExpression* field_expr = (FieldExpression*) node;
+                field_expr->object = NULL;
+                field_expr->field = NULL;
+            }
+            break;
+            
         default:
-            node = malloc(sizeof(ASTNode));
+            node = ast_alloc(sizeof(ASTNode));
             if (node) {
                 node->node_type = node_type;
                 node->location = loc;
@@ -235,6 +302,9 @@ static ASTNode* ast_node_allocate(NodeType node_type, SourceLocation loc) {
             break;
     }
     
+    if (node) {
+        node->arena_owned = ast_arena != NULL;
+    }
     return node;
 }
 
@@ -460,6 +530,7 @@ static BlockStatement* copy_block_statement(ASTNode* original) {
     copy->base.node_type = orig->base.node_type;
     copy->base.location = orig->base.location;
     copy->statement_count = orig->statement_count;
+    copy->statement_capacity = orig->statement_count;
     
     if (orig->statement_count > 0 && orig->statements) {
         copy->statements = malloc(orig->statement_count * sizeof(ASTNode*));
@@ -532,6 +603,8 @@ static FunctionDeclarationStatement* copy_function_declaration_statement(ASTNode
             } else {
                 copy->parameters[i].name = NULL;
             }
+            copy->parameters[i].struct_name =
+                orig->parameters[i].struct_name ? strdup(orig->parameters[i].struct_name) : NULL;
         }
     } else {
         copy->parameters = NULL;
@@ -654,9 +727,22 @@ static ArrayDeclarationStatement* copy_array_declaration_statement(ASTNode* orig
         copy->size = NULL;
     }
 
+    if (orig_stmt->columns) {
+        copy->columns = ast_node_copy(orig_stmt->columns);
+        if (!copy->columns) {
+            ast_free(copy->size);
+            free(copy->name);
+            free(copy);
+            return NULL;
+        }
+    } else {
+        copy->columns = NULL;
+    }
+
     if (orig_stmt->initializer) {
         copy->initializer = ast_node_copy(orig_stmt->initializer);
         if (!copy->initializer) {
+            ast_free(copy->columns);
             ast_free(copy->size);
             free(copy->name);
             free(copy);
@@ -669,9 +755,80 @@ static ArrayDeclarationStatement* copy_array_declaration_statement(ASTNode* orig
     return copy;
 }
 
-static ASTNode* ast_node_copy(ASTNode* original) {
-    if (!original) return NULL;
-    
+static StructDeclarationStatement* copy_struct_declaration_statement(ASTNode* original) {
+    if (!original || original->node_type != NODE_STRUCT_DECLARATION_STATEMENT) {
+        return NULL;
+    }
+
+    StructDeclarationStatement* orig = (StructDeclarationStatement*)original;
+    StructDeclarationStatement* copy = malloc(sizeof(StructDeclarationStatement));
+    if (!copy) return NULL;
+
+    copy->base.node_type = NODE_STRUCT_DECLARATION_STATEMENT;
+    copy->base.location = orig->base.location;
+    copy->name = orig->name ? strdup(orig->name) : NULL;
+    copy->field_count = orig->field_count;
+    copy->fields = NULL;
+
+    if (orig->field_count > 0) {
+        copy->fields = malloc(orig->field_count * sizeof(Parameter));
+        if (!copy->fields) {
+            free(copy->name);
+            free(copy);
+            return NULL;
+        }
+        for (size_t i = 0; i < orig->field_count; i++) {
+            copy->fields[i] = orig->fields[i];
+            copy->fields[i].name = strdup(orig->fields[i].name);
+            copy->fields[i].struct_name = NULL;
+        }
+    }
+
+    return copy;
+}
+
+static StructVariableDeclarationStatement* copy_struct_variable_declaration_statement(ASTNode* original) {
+    if (!original || original->node_type != NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT) {
+        return NULL;
+    }
+
+    StructVariableDeclarationStatement* orig = (StructVariableDeclarationStatement*)original;
+    StructVariableDeclarationStatement* copy = malloc(sizeof(StructVariableDeclarationStatement));
+    if (!copy) return NULL;
+
+    copy->base.node_type = NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT;
+    copy->base.location = orig->base.location;
+    copy->struct_name = strdup(orig->struct_name);
+    copy->name = strdup(orig->name);
+    copy->is_array = orig->is_array;
+    copy->size = orig->size ? ast_node_copy(orig->size) : NULL;
+    copy->initializer = orig->initializer ? ast_node_copy(orig->initializer) : NULL;
+
+    return copy;
+}
+
+static FieldExpression* copy_field_expression(ASTNode* original) {
+    if (!original || original->node_type != NODE_FIELD_EXPRESSION) {
+        return NULL;
+    }
+
+    FieldExpression* orig = (FieldExpression*)original;
+    FieldExpression* copy = malloc(sizeof(FieldExpression));
+    if (!copy) return NULL;
+
+    copy->base.node_type = NODE_FIELD_EXPRESSION;
+    copy->base.location = orig->base.location;
+    copy->object = ast_node_copy(orig->object);
+    if (!copy->object) {
+        free(copy);
+        return NULL;
+    }
+    copy->field = strdup(orig->field);
+
+    return copy;
+}
+
+static ASTNode* ast_node_copy_by_type(ASTNode* original) {
     switch (original->node_type) {
         case NODE_BINARY_EXPRESSION:
             return (ASTNode*)copy_binary_expression(original);
@@ -719,17 +876,35 @@ static ASTNode* ast_node_copy(ASTNode* original) {
             return (ASTNode*)copy_array_declaration_statement(original);
         case NODE_SUBSCRIPT_EXPRESSION:
             return (ASTNode*)copy_subscript_expression(original);
+        case NODE_STRUCT_DECLARATION_STATEMENT:
+            return (ASTNode*)copy_struct_declaration_statement(original);
+        case NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT:
+            return (ASTNode*)copy_struct_variable_declaration_statement(original);
+        case NODE_FIELD_EXPRESSION:
+            return (ASTNode*)copy_field_expression(original);
         default:
             fprintf(stderr, "Unknown node type in copy function: %d\n", original->node_type);
             return NULL;
     }
 }
 
+static ASTNode* ast_node_copy(ASTNode* original) {
+    if (!original) return NULL;
+    
+    ASTNode* copy = ast_node_copy_by_type(original);
+    if (copy) {
+        copy->arena_owned = false;
+    }
+    return copy;
+}
+
 Parameter* ast_new_parameter(const char* name, TypeVar type) {
     Parameter* parameter = malloc(sizeof(Parameter));
     if (!parameter) return NULL;
     parameter->name = strdup(name);
     parameter->type = type;
+    parameter->is_array = false;
+    parameter->struct_name = NULL;
     return parameter;
 }
 
@@ -747,10 +922,10 @@ ASTNode* ast_new_function_declaration_statement(
     FunctionDeclarationStatement* casted_node =
         (FunctionDeclarationStatement*) node;
 
-    casted_node->name = name ? strdup(name) : NULL;
+    casted_node->name = name ? ast_strdup(name) : NULL;
     casted_node->return_type = return_type;
     casted_node->parameter_count = parameter_count;
-    casted_node->body = body ? ast_node_copy(body) : NULL;
+    casted_node->body = body ? ast_adopt(body) : NULL;
 
     if (parameter_count > 0) {
         if (!parameters) {
@@ -759,23 +934,20 @@ ASTNode* ast_new_function_declaration_statement(
         }
 
         casted_node->parameters =
-            malloc(sizeof(Parameter) * parameter_count);
-
-        if (parameter_count > 0) {
-            casted_node->parameters =
-                malloc(sizeof(Parameter) * parameter_count);
-        } else {
-            casted_node->parameters = NULL;
-        }
+            ast_alloc(sizeof(Parameter) * parameter_count);
 
         for (size_t i = 0; i < parameter_count; i++) {
             casted_node->parameters[i].name =
                 parameters[i].name
-                    ? strdup(parameters[i].name)
+                    ? ast_strdup(parameters[i].name)
                     : NULL;
             casted_node->parameters[i].type = parameters[i].type;
             casted_node->parameters[i].is_array =
                 parameters[i].is_array;
+            casted_node->parameters[i].struct_name =
+                parameters[i].struct_name
+                    ? ast_strdup(parameters[i].struct_name)
+                    : NULL;
         }
     } else {
         casted_node->parameters = NULL;
@@ -791,8 +963,8 @@ ASTNode* ast_new_variable_declaration_statement(SourceLocation loc, TypeVar var_
     if (!node) return NULL;
     VariableDeclarationStatement* casted_node = (VariableDeclarationStatement*) node;
     casted_node->var_type = var_type;
-    casted_node->name = strdup(name);
-    casted_node->initializer = ast_node_copy(initializer);
+    casted_node->name = ast_strdup(name);
+    casted_node->initializer = ast_adopt(initializer);
     return node;
 }
 
@@ -800,7 +972,7 @@ ASTNode* ast_new_expression_statement(SourceLocation loc, ASTNode* expression) {
     ASTNode* node = ast_node_allocate(NODE_EXPRESSION_STATEMENT, loc);
     if (!node) return NULL;
     ExpressionStatement* casted_node = (ExpressionStatement*) node;
-    casted_node->expression = ast_node_copy(expression);
+    casted_node->expression = ast_adopt(expression);
     return node;
 }
 
@@ -808,7 +980,7 @@ ASTNode* ast_new_return_statement(SourceLocation loc, ASTNode* expression) {
     ASTNode* node = ast_node_allocate(NODE_RETURN_STATEMENT, loc);
     if (!node) return NULL;
     ReturnStatement* casted_node = (ReturnStatement*) node;
-    casted_node->expression = ast_node_copy(expression);
+    casted_node->expression = ast_adopt(expression);
     return node;
 }
 
@@ -827,13 +999,13 @@ ASTNode* ast_new_array_expression(SourceLocation loc, ASTNode** elements, size_t
     ArrayExpression* casted_node = (ArrayExpression*) node;
     
     if (element_count > 0 && elements) {
-        casted_node->elements = malloc(element_count * sizeof(ASTNode*));
+        casted_node->elements = ast_alloc(element_count * sizeof(ASTNode*));
         if (!casted_node->elements) {
-            free(node);
+            ast_free(node);
             return NULL;
         }
         for (size_t i = 0; i < element_count; i++) {
-            casted_node->elements[i] = ast_node_copy(elements[i]);
+            casted_node->elements[i] = ast_adopt(elements[i]);
         }
         casted_node->element_count = element_count;
     } else {
@@ -849,46 +1021,99 @@ ASTNode* ast_new_subscript_expression(SourceLocation loc, ASTNode* array, ASTNod
     if (!node) return NULL;
     
     SubscriptExpression* casted_node = (SubscriptExpression*) node;
-    casted_node->array = ast_node_copy(array);
-    casted_node->index = ast_node_copy(index);
+    casted_node->array = ast_adopt(array);
+    casted_node->index = ast_adopt(index);
     
     return node;
 }
 
 ASTNode* ast_new_array_declaration_statement(SourceLocation loc, TypeVar element_type, 
                                              const char* name, ASTNode* size, 
-                                             ASTNode* initializer) {
+                                             ASTNode* columns, ASTNode* initializer) {
     ASTNode* node = ast_node_allocate(NODE_ARRAY_DECLARATION_STATEMENT, loc);
     if (!node) return NULL;
     
     ArrayDeclarationStatement* casted_node = (ArrayDeclarationStatement*) node;
     casted_node->element_type = element_type;
-    casted_node->name = strdup(name);
-    casted_node->size = ast_node_copy(size);
-    casted_node->initializer = ast_node_copy(initializer);
+    casted_node->name = ast_strdup(name);
+    casted_node->size = ast_adopt(size);
+    casted_node->columns = ast_adopt(columns);
+    casted_node->initializer = ast_adopt(initializer);
     
     return node;
 }
 
+ASTNode* ast_new_struct_declaration_statement(SourceLocation loc, const char* name,
+                                              Parameter* fields, size_t field_count) {
+    ASTNode* node = ast_node_allocate(NODE_STRUCT_DECLARATION_STATEMENT, loc);
+    if (!node) return NULL;
+
+    StructDeclarationStatement* casted_node = (StructDeclarationStatement*) node;
+    casted_node->name = ast_strdup(name);
+    if (field_count > 0 && fields) {
+        casted_node->fields = ast_alloc(field_count * sizeof(Parameter));
+        if (!casted_node->fields) {
+            ast_free(node);
+            return NULL;
+        }
+        for (size_t i = 0; i < field_count; i++) {
+            casted_node->fields[i].name = ast_strdup(fields[i].name);
+            casted_node->fields[i].type = fields[i].type;
+            casted_node->fields[i].is_array = false;
+            casted_node->fields[i].struct_name = NULL;
+        }
+        casted_node->field_count = field_count;
+    }
+
+    return node;
+}
+
+ASTNode* ast_new_struct_variable_declaration_statement(SourceLocation loc, const char* struct_name, const char* name,
+                                                       bool is_array, ASTNode* size, ASTNode* initializer) {
+    ASTNode* node = ast_node_allocate(NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT, loc);
+    if (!node) return NULL;
+
+    StructVariableDeclarationStatement* casted_node = (StructVariableDeclarationStatement*) node;
+    casted_node->struct_name = ast_strdup(struct_name);
+    casted_node->name = ast_strdup(name);
+    casted_node->is_array = is_array;
+    casted_node->size = size ? ast_adopt(size) : NULL;
+    casted_node->initializer = initializer ? ast_adopt(initializer) : NULL;
+
+    return node;
+}
+
+ASTNode* ast_new_field_expression(SourceLocation loc, ASTNode* object, const char* field) {
+    ASTNode* node = ast_node_allocate(NODE_FIELD_EXPRESSION, loc);
+    if (!node) return NULL;
+
+    FieldExpression* casted_node = (FieldExpression*) node;
+    casted_node->object = ast_adopt(object);
+    casted_node->field = ast_strdup(field);
+
+    return node;
+}
+
 ASTNode* ast_new_block_statement(SourceLocation loc, ASTNode** statements, size_t statement_count) {
     ASTNode* node = ast_node_allocate(NODE_BLOCK_STATEMENT, loc);
     if (!node) return NULL;
     BlockStatement* casted_node = (BlockStatement*) node;
     
     if (statement_count > 0 && statements) {
-        casted_node->statements = malloc(statement_count * sizeof(ASTNode*));
+        casted_node->statements = ast_alloc(statement_count * sizeof(ASTNode*));
         if (!casted_node->statements) {
-            free(node);
+            ast_free(node);
             return NULL;
         }
         for (size_t i = 0; i < statement_count; i++) {
-            casted_node->statements[i] = ast_node_copy(statements[i]);
+            casted_node->statements[i] = ast_adopt(statements[i]);
         }
     } else {
         casted_node->statements = NULL;
     }
     
     casted_node->statement_count = statement_count;
+    casted_node->statement_capacity = casted_node->statements ? statement_count : 0;
     return node;
 }
 
@@ -896,8 +1121,8 @@ ASTNode* ast_new_if_statement(SourceLocation loc, ASTNode* condition, ASTNode* t
     ASTNode* node = ast_node_allocate(NODE_IF_STATEMENT, loc);
     if (!node) return NULL;
     IfStatement* casted_node = (IfStatement*) node;
-    casted_node->condition = ast_node_copy(condition);
-    casted_node->then_branch = ast_node_copy(then_branch);
+    casted_node->condition = ast_adopt(condition);
+    casted_node->then_branch = ast_adopt(then_branch);
     casted_node->elif_conditions = NULL;
     casted_node->elif_branches = NULL;
     casted_node->elif_count = 0;
@@ -909,8 +1134,8 @@ ASTNode* ast_new_while_statement(SourceLocation loc, ASTNode* condition, ASTNode
     ASTNode* node = ast_node_allocate(NODE_WHILE_STATEMENT, loc);
     if (!node) return NULL;
     WhileStatement* casted_node = (WhileStatement*) node;
-    casted_node->condition = ast_node_copy(condition);
-    casted_node->body = ast_node_copy(body);
+    casted_node->condition = ast_adopt(condition);
+    casted_node->body = ast_adopt(body);
     return node;
 }
 
@@ -918,8 +1143,8 @@ ASTNode* ast_new_assignment_statement(SourceLocation loc, ASTNode* left, ASTNode
     ASTNode* node = ast_node_allocate(NODE_ASSIGNMENT_STATEMENT, loc);
     if (!node) return NULL;
     AssignmentStatement* casted_node = (AssignmentStatement*) node;
-    casted_node->left = ast_node_copy(left);
-    casted_node->right = ast_node_copy(right);
+    casted_node->left = ast_adopt(left);
+    casted_node->right = ast_adopt(right);
     return node;
 }
 
@@ -927,10 +1152,10 @@ ASTNode* ast_new_for_statement(SourceLocation loc, ASTNode* initializer, ASTNode
     ASTNode* node = ast_node_allocate(NODE_FOR_STATEMENT, loc);
     if (!node) return NULL;
     ForStatement* casted_node = (ForStatement*) node;
-    casted_node->initializer = ast_node_copy(initializer);
-    casted_node->condition = ast_node_copy(condition);
-    casted_node->increment = ast_node_copy(increment);
-    casted_node->body = ast_node_copy(body);
+    casted_node->initializer = ast_adopt(initializer);
+    casted_node->condition = ast_adopt(condition);
+    casted_node->increment = ast_adopt(increment);
+    casted_node->body = ast_adopt(body);
     return node;
 }
 
@@ -938,11 +1163,11 @@ ASTNode* ast_new_binary_expression(SourceLocation loc, ASTNode* left, Token op,
     ASTNode* node = ast_node_allocate(NODE_BINARY_EXPRESSION, loc);
     if (!node) return NULL;
     BinaryExpression* casted_node = (BinaryExpression*) node;
-    casted_node->left = ast_node_copy(left);
-    casted_node->right = ast_node_copy(right);
+    casted_node->left = ast_adopt(left);
+    casted_node->right = ast_adopt(right);
     casted_node->operator_ = op;
     if (op.value) {
-        casted_node->operator_.value = strdup(op.value);
+        casted_node->operator_.value = ast_strdup(op.value);
     }    
     return node;
 }
@@ -953,9 +1178,9 @@ ASTNode* ast_new_unary_expression(SourceLocation loc, Token op, ASTNode* operand
     UnaryExpression* casted_node = (UnaryExpression*) node;
     casted_node->operator_ = op;
     if (op.value) {
-        casted_node->operator_.value = strdup(op.value);
+        casted_node->operator_.value = ast_strdup(op.value);
     }
-    casted_node->operand = ast_node_copy(operand);
+    casted_node->operand = ast_adopt(operand);
     return node;
 }
 
@@ -974,9 +1199,9 @@ ASTNode* ast_new_literal_expression_long_arithmetics(SourceLocation loc, TypeVar
     LiteralExpressionLongArithmetics* casted_node = (LiteralExpressionLongArithmetics*) node;
     casted_node->type = type;
     if (value) {
-        casted_node->value = strdup(value);
+        casted_node->value = ast_strdup(value);
         if (!casted_node->value) {
-            free(node);
+            ast_free(node);
             return NULL;
         }
     } else {
@@ -989,7 +1214,7 @@ ASTNode* ast_new_variable_expression(SourceLocation loc, const char* name) {
     ASTNode* node = ast_node_allocate(NODE_VARIABLE_EXPRESSION, loc);
     if (!node) return NULL;
     VariableExpression* casted_node = (VariableExpression*) node;
-    casted_node->name = strdup(name);
+    casted_node->name = ast_strdup(name);
     return node;
 }
 
@@ -997,16 +1222,16 @@ ASTNode* ast_new_call_expression(SourceLocation loc, ASTNode* callee, ASTNode**
     ASTNode* node = ast_node_allocate(NODE_FUNCTION_CALL_EXPRESSION, loc);
     if (!node) return NULL;
     FunctionCallExpression* casted_node = (FunctionCallExpression*) node;
-    casted_node->callee = ast_node_copy(callee);
+    casted_node->callee = ast_adopt(callee);
     
     if (arg_count > 0 && args) {
-        casted_node->arguments = malloc(arg_count * sizeof(ASTNode*));
+        casted_node->arguments = ast_alloc(arg_count * sizeof(ASTNode*));
         if (!casted_node->arguments) {
-            free(node);
+            ast_free(node);
             return NULL;
         }
         for (int i = 0; i < arg_count; i++) {
-            casted_node->arguments[i] = ast_node_copy(args[i]);
+            casted_node->arguments[i] = ast_adopt(args[i]);
         }
         casted_node->argument_count = arg_count;
     } else {
@@ -1036,6 +1261,9 @@ void ast_free(ASTNode* node) {
         DPRINT("ast_free: NULL node\n");
         return;
     }
+    if (node->arena_owned) {
+        return;
+    }
     DPRINT("ast_free: node_type=%s\n", ast_node_type_to_string(node->node_type));
     
     switch (node->node_type) {
@@ -1044,6 +1272,7 @@ void ast_free(ASTNode* node) {
             free(casted_node->name);
             for (size_t i = 0; i < casted_node->parameter_count; i++) {
                 free(casted_node->parameters[i].name);
+                free(casted_node->parameters[i].struct_name);
             }
             free(casted_node->parameters);
             ast_free(casted_node->body);
@@ -1191,10 +1420,37 @@ void ast_free(ASTNode* node) {
             ArrayDeclarationStatement* casted_node = (ArrayDeclarationStatement*) node;
             free(casted_node->name);
             ast_free(casted_node->size);
+            ast_free(casted_node->columns);
             ast_free(casted_node->initializer);
             free(casted_node);
             break;
         }
+        case NODE_STRUCT_DECLARATION_STATEMENT: {
+            StructDeclarationStatement* casted_node = (StructDeclarationStatement*) node;
+            free(casted_node->name);
+            for (size_t i = 0; i < casted_node->field_count; i++) {
+                free(casted_node->fields[i].name);
+            }
+            free(casted_node->fields);
+            free(casted_node);
+            break;
+        }
+        case NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT: {
+            StructVariableDeclarationStatement* casted_node = (StructVariableDeclarationStatement*) node;
+            free(casted_node->struct_name);
+            free(casted_node->name);
+            ast_free(casted_node->size);
+            ast_free(casted_node->initializer);
+            free(casted_node);
+            break;
+        }
+        case NODE_FIELD_EXPRESSION: {
+            FieldExpression* casted_node = (FieldExpression*) node;
+            ast_free(casted_node->object);
+            free(casted_node->field);
+            free(casted_node);
+            break;
+        }
         default: {
             DPRINT("Freeing node type: %d at %p\n", ast_node_type_to_string(node->node_type), (void*)node);
             free(node);
@@ -1226,6 +1482,9 @@ const char* ast_node_type_to_string(int node_type) {
         case NODE_ARRAY_EXPRESSION: return "ArrayExpression";
         case NODE_SUBSCRIPT_EXPRESSION: return "SubscriptExpression";
         case NODE_ARRAY_DECLARATION_STATEMENT: return "ArrayDeclarationStatement";
+        case NODE_STRUCT_DECLARATION_STATEMENT: return "StructDeclarationStatement";
+        case NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT: return "StructVariableDeclarationStatement";
+        case NODE_FIELD_EXPRESSION: return "FieldExpression";
         default: return "Unknown";
     }
 }
@@ -1496,6 +1755,11 @@ void ast_print(ASTNode* node, int indent) {
                 DPRINT("Size:\n");
                 ast_print(casted_node->size, indent + 2);
             }
+            if (casted_node->columns) {
+                for (int i = 0; i < indent + 1; i++) DPRINT("  ");
+                DPRINT("Columns:\n");
+                ast_print(casted_node->columns, indent + 2);
+            }
             if (casted_node->initializer) {
                 for (int i = 0; i < indent + 1; i++) DPRINT("  ");
                 DPRINT("Initializer:\n");
@@ -1503,6 +1767,41 @@ void ast_print(ASTNode* node, int indent) {
             }
             break;
         }
+        case NODE_STRUCT_DECLARATION_STATEMENT: {
+            StructDeclarationStatement* casted_node = (StructDeclarationStatement*) node;
+            for (int i = 0; i < indent + 1; i++) DPRINT("  ");
+            DPRINT("Struct: %s (%zu fields)\n", casted_node->name, casted_node->field_count);
+            for (size_t i = 0; i < casted_node->field_count; i++) {
+                for (int j = 0; j < indent + 1; j++) DPRINT("  ");
+                DPRINT("Field: %s (type %s)\n", casted_node->fields[i].name,
+                       type_var_to_string(casted_node->fields[i].type));
+            }
+            break;
+        }
+        case NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT: {
+            StructVariableDeclarationStatement* casted_node = (StructVariableDeclarationStatement*) node;
+            for (int i = 0; i < indent + 1; i++) DPRINT("  ");
+            DPRINT("Struct Variable: %s (struct %s%s)\n", casted_node->name, casted_node->struct_name,
+                   casted_node->is_array ? " array" : "");
+            if (casted_node->size) {
+                for (int i = 0; i < indent + 1; i++) DPRINT("  ");
+                DPRINT("Size:\n");
+                ast_print(casted_node->size, indent + 2);
+            }
+            if (casted_node->initializer) {
+                for (int i = 0; i < indent + 1; i++) DPRINT("  ");
+                DPRINT("Initializer:\n");
+                ast_print(casted_node->initializer, indent + 2);
+            }
+            break;
+        }
+        case NODE_FIELD_EXPRESSION: {
+            FieldExpression* casted_node = (FieldExpression*) node;
+            for (int i = 0; i < indent + 1; i++) DPRINT("  ");
+            DPRINT("Field: %s of\n", casted_node->field);
+            ast_print(casted_node->object, indent + 2);
+            break;
+        }
         default: {
             for (int i = 0; i < indent + 1; i++) DPRINT("  ");
             DPRINT("Unknown node type: %d\n", node->node_type);
@@ -1511,23 +1810,53 @@ void ast_print(ASTNode* node, int indent) {
     }
 }
 
+static void* ast_grow_array(ASTNode* owner, void* items, size_t count, size_t new_capacity, size_t item_size) {
+    if (!owner->arena_owned) {
+        return realloc(items, new_capacity * item_size);
+    }
+    void* grown = arena_alloc(ast_arena, new_capacity * item_size);
+    if (grown && count > 0) {
+        memcpy(grown, items, count * item_size);
+    }
+    return grown;
+}
+
 bool add_statement_to_block(ASTNode* block_stmt, ASTNode* stmt) {
     BlockStatement* casted_node = (BlockStatement*) block_stmt;
-    size_t new_count = casted_node->statement_count + 1;
-    
-    ASTNode** new_statements = realloc(
-        casted_node->statements,
-        new_count * sizeof(ASTNode*)
-    );
     
-    if (!new_statements) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return false;
+    if (casted_node->statement_count >= casted_node->statement_capacity) {
+        size_t new_capacity = casted_node->statement_capacity == 0 ? 8 : casted_node->statement_capacity * 2;
+        ASTNode** new_statements = ast_grow_array(block_stmt, casted_node->statements,
+                                                  casted_node->statement_count, new_capacity,
+                                                  sizeof(ASTNode*));
+        if (!new_statements) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return false;
+        }
+        casted_node->statements = new_statements;
+        casted_node->statement_capacity = new_capacity;
     }
     
-    casted_node->statements = new_statements;
-    casted_node->statements[casted_node->statement_count] = ast_node_copy(stmt);
-    casted_node->statement_count = new_count;
+    casted_node->statements[casted_node->statement_count++] = ast_adopt(stmt);
+    return true;
+}
+
+bool add_elif_to_if_statement(ASTNode* if_node, ASTNode* condition, ASTNode* branch) {
+    IfStatement* if_stmt = (IfStatement*) if_node;
+    size_t new_count = if_stmt->elif_count + 1;
+    
+    ASTNode** new_conditions = ast_grow_array(if_node, if_stmt->elif_conditions,
+                                              if_stmt->elif_count, new_count, sizeof(ASTNode*));
+    if (!new_conditions) return false;
+    if_stmt->elif_conditions = new_conditions;
+    
+    ASTNode** new_branches = ast_grow_array(if_node, if_stmt->elif_branches,
+                                            if_stmt->elif_count, new_count, sizeof(ASTNode*));
+    if (!new_branches) return false;
+    if_stmt->elif_branches = new_branches;
     
+    if_stmt->elif_conditions[if_stmt->elif_count] = condition;
+    if_stmt->elif_branches[if_stmt->elif_count] = branch;
+    if_stmt->elif_count = new_count;
     return true;
 }
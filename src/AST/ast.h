@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "../lexer/token.h"
+#include "../arena.h"
 
 typedef struct {
     int line;
@@ -41,12 +42,17 @@ typedef enum NodeType {
 
     NODE_ARRAY_EXPRESSION,
     NODE_SUBSCRIPT_EXPRESSION,
-    NODE_ARRAY_DECLARATION_STATEMENT
+    NODE_ARRAY_DECLARATION_STATEMENT,
+
+    NODE_STRUCT_DECLARATION_STATEMENT,
+    NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT,
+    NODE_FIELD_EXPRESSION
 } NodeType;
 
 typedef struct ASTNode {
     NodeType node_type;
     SourceLocation location;
+    bool arena_owned;
 } ASTNode;
 
 typedef struct {
@@ -90,6 +96,7 @@ typedef struct {
     char* name;
     TypeVar type;
     bool is_array;
+    char* struct_name;      // struct S p / struct S[] p, NULL otherwise
 } Parameter;
 
 typedef struct {
@@ -128,6 +135,7 @@ typedef struct {
     ASTNode base;
     ASTNode** statements;
     size_t statement_count;
+    size_t statement_capacity;
 } BlockStatement;
 
 typedef struct {
@@ -167,6 +175,7 @@ typedef struct {
     TypeVar element_type;
     char* name;
     ASTNode* size;
+    ASTNode* columns;       // second dimension of T[n][m], NULL for T[n]
     ASTNode* initializer;
 } ArrayDeclarationStatement;
 
@@ -182,6 +191,33 @@ typedef struct {
     ASTNode* index;
 } SubscriptExpression;
 
+// struct Name { T field; ... }; the fields reuse Parameter for name and type.
+typedef struct {
+    ASTNode base;
+    char* name;
+    Parameter* fields;
+    size_t field_count;
+} StructDeclarationStatement;
+
+// struct Name s;, struct Name[size] s; or either form with "= expr", where
+// the size may be left out as in struct Name[] s = ps;
+typedef struct {
+    ASTNode base;
+    char* struct_name;
+    char* name;
+    bool is_array;
+    ASTNode* size;          // NULL for a single record or an unsized array
+    ASTNode* initializer;   // NULL to build zeroed records
+} StructVariableDeclarationStatement;
+
+typedef struct {
+    ASTNode base;
+    ASTNode* object;        // a struct variable or an element of a struct array
+    char* field;
+} FieldExpression;
+
+void ast_set_arena(Arena* arena);
+Arena* ast_get_arena(void);
 void ast_free(ASTNode* node);
 ASTNode* ast_new_binary_expression(SourceLocation loc, ASTNode* left, Token op, ASTNode* right);
 ASTNode* ast_new_unary_expression(SourceLocation loc, Token op, ASTNode* operand);
@@ -202,10 +238,15 @@ ASTNode* ast_new_break_statement(SourceLocation loc);
 ASTNode* ast_new_continue_statement(SourceLocation loc);
 ASTNode* ast_new_array_expression(SourceLocation loc, ASTNode** elements, size_t element_count);
 ASTNode* ast_new_subscript_expression(SourceLocation loc, ASTNode* array, ASTNode* index);
-ASTNode* ast_new_array_declaration_statement(SourceLocation loc, TypeVar element_type, const char* name, ASTNode* size, ASTNode* initializer);
+ASTNode* ast_new_array_declaration_statement(SourceLocation loc, TypeVar element_type, const char* name, ASTNode* size, ASTNode* columns, ASTNode* initializer);
+ASTNode* ast_new_struct_declaration_statement(SourceLocation loc, const char* name, Parameter* fields, size_t field_count);
+ASTNode* ast_new_struct_variable_declaration_statement(SourceLocation loc, const char* struct_name, const char* name,
+                                                       bool is_array, ASTNode* size, ASTNode* initializer);
+ASTNode* ast_new_field_expression(SourceLocation loc, ASTNode* object, const char* field);
 Parameter* ast_new_parameter(const char* name, TypeVar type);
 void parameter_free(Parameter* param);
 bool add_statement_to_block(ASTNode* block_stmt, ASTNode* stmt);
+bool add_elif_to_if_statement(ASTNode* if_stmt, ASTNode* condition, ASTNode* branch);
 const char* ast_node_type_to_string(int node_type);
 const char* type_var_to_string(int node_type);
 const char* token_type_to_string(int token_type);
@@ -0,0 +1,107 @@
+#include "arena.h"
+#include "system.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define ARENA_ALIGNMENT 16
+
+static size_t arena_align(size_t n) {
+    return (n + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static ArenaChunk* arena_chunk_new(size_t size) {
+    ArenaChunk* chunk = malloc(sizeof(ArenaChunk) + size);
+    if (!chunk) return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+Arena* arena_create(size_t chunk_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) return NULL;
+
+    arena->head = NULL;
+    arena->chunk_size = chunk_size ? arena_align(chunk_size) : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->bytes_used = 0;
+    arena->bytes_reserved = 0;
+    return arena;
+}
+
+void arena_reset(Arena* arena) {
+    if (!arena) return;
+
+    ArenaChunk* chunk = arena->head;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->bytes_used = 0;
+    arena->bytes_reserved = 0;
+}
+
+void arena_destroy(Arena* arena) {
+    if (!arena) return;
+
+    DPRINT("[ARENA] Releasing %zu bytes (%zu reserved)\n",
+           arena->bytes_used, arena->bytes_reserved);
+    arena_reset(arena);
+    free(arena);
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+
+    size = arena_align(size ? size : 1);
+    ArenaChunk* chunk = arena->head;
+
+    if (!chunk || chunk->size - chunk->used < size) {
+        /* oversized requests get a dedicated chunk so the bump chunk keeps its tail */
+        size_t chunk_size = size > arena->chunk_size / 4 ? size : arena->chunk_size;
+        ArenaChunk* fresh = arena_chunk_new(chunk_size);
+        if (!fresh) return NULL;
+        arena->bytes_reserved += chunk_size;
+
+        if (chunk && chunk_size != arena->chunk_size) {
+            fresh->next = chunk->next;
+            chunk->next = fresh;
+            fresh->used = size;
+            arena->bytes_used += size;
+            return fresh->data;
+        }
+
+        fresh->next = chunk;
+        arena->head = fresh;
+        chunk = fresh;
+    }
+
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->bytes_used += size;
+    return ptr;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* ptr = arena_alloc(arena, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+char* arena_strndup(Arena* arena, const char* str, size_t len) {
+    if (!str) return NULL;
+    char* copy = arena_alloc(arena, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char* arena_strdup(Arena* arena, const char* str) {
+    if (!str) return NULL;
+    return arena_strndup(arena, str, strlen(str));
+}
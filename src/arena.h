@@ -0,0 +1,39 @@
+#ifndef RENAME_ARENA_H
+#define RENAME_ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Region (bump) allocator. One arena is created per compilation unit and
+ * owns everything the front end produces that does not outlive codegen:
+ * token lexemes, AST nodes and their strings/child arrays, compiler scratch
+ * buffers. Individual allocations are never freed; arena_destroy releases
+ * the whole region in one step.
+ */
+
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;
+    size_t used;
+    unsigned char data[];
+} ArenaChunk;
+
+typedef struct Arena {
+    ArenaChunk* head;
+    size_t chunk_size;
+    size_t bytes_used;
+    size_t bytes_reserved;
+} Arena;
+
+Arena* arena_create(size_t chunk_size);
+void arena_destroy(Arena* arena);
+void arena_reset(Arena* arena);
+
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+char* arena_strdup(Arena* arena, const char* str);
+char* arena_strndup(Arena* arena, const char* str, size_t len);
+
+#endif
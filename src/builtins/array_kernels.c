@@ -0,0 +1,343 @@
+#include "array_kernels.h"
+#include "../system.h"
+#include <string.h>
+
+// Scalar versions do their arithmetic in uint64_t so overflow wraps the
+// same way the vector lanes do.
+
+static void scalar_fill(int64_t* dst, int64_t value, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = value;
+}
+
+static int64_t scalar_sum(const int64_t* src, size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint64_t)src[i];
+    return (int64_t)acc;
+}
+
+static int64_t scalar_dot(const int64_t* a, const int64_t* b, size_t n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint64_t)a[i] * (uint64_t)b[i];
+    return (int64_t)acc;
+}
+
+static void scalar_axpy(int64_t* y, int64_t a, const int64_t* x, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] = (int64_t)((uint64_t)y[i] + (uint64_t)a * (uint64_t)x[i]);
+    }
+}
+
+static void scalar_minmax(const int64_t* src, size_t n, int64_t* min, int64_t* max) {
+    int64_t lo = src[0], hi = src[0];
+    for (size_t i = 1; i < n; i++) {
+        if (src[i] < lo) lo = src[i];
+        if (src[i] > hi) hi = src[i];
+    }
+    *min = lo;
+    *max = hi;
+}
+
+static void scalar_add(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (int64_t)((uint64_t)a[i] + (uint64_t)b[i]);
+}
+
+static void scalar_sub(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (int64_t)((uint64_t)a[i] - (uint64_t)b[i]);
+}
+
+static void scalar_mul(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = (int64_t)((uint64_t)a[i] * (uint64_t)b[i]);
+}
+
+// No vector unit divides integers, so every table uses these two. A -1
+// divisor is special-cased: INT64_MIN / -1 traps on x86.
+static void scalar_div(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (b[i] == 0) dst[i] = 0;
+        else if (b[i] == -1) dst[i] = (int64_t)(0 - (uint64_t)a[i]);
+        else dst[i] = a[i] / b[i];
+    }
+}
+
+static void scalar_mod(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (b[i] == 0 || b[i] == -1) ? 0 : a[i] % b[i];
+    }
+}
+
+static void scalar_eq(uint8_t* dst, const int64_t* a, const int64_t* b, size_t n, uint8_t flip) {
+    for (size_t i = 0; i < n; i++) dst[i] = (uint8_t)(a[i] == b[i]) ^ flip;
+}
+
+static void scalar_lt(uint8_t* dst, const int64_t* a, const int64_t* b, size_t n, uint8_t flip) {
+    for (size_t i = 0; i < n; i++) dst[i] = (uint8_t)(a[i] < b[i]) ^ flip;
+}
+
+static const ArrayKernels scalar_kernels = {
+    "scalar", scalar_fill, scalar_sum, scalar_dot, scalar_axpy, scalar_minmax,
+    scalar_add, scalar_sub, scalar_mul, scalar_div, scalar_mod, scalar_eq, scalar_lt
+};
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define ARRAY_KERNELS_X86 1
+
+// Neither SSE2 nor AVX2 has a 64-bit lane multiply; build the low 64 bits
+// from three 32x32->64 products: lo*lo + ((hi*lo + lo*hi) << 32).
+
+static inline __m128i sse2_mullo_epi64(__m128i a, __m128i b) {
+    __m128i lo = _mm_mul_epu32(a, b);
+    __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                                  _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+    return _mm_add_epi64(lo, _mm_slli_epi64(cross, 32));
+}
+
+static void sse2_fill(int64_t* dst, int64_t value, size_t n) {
+    __m128i v = _mm_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_si128((__m128i*)(dst + i), v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+static int64_t sse2_sum(const int64_t* src, size_t n) {
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_epi64(acc0, _mm_loadu_si128((const __m128i*)(src + i)));
+        acc1 = _mm_add_epi64(acc1, _mm_loadu_si128((const __m128i*)(src + i + 2)));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, _mm_add_epi64(acc0, acc1));
+    return (int64_t)((uint64_t)lanes[0] + (uint64_t)lanes[1] +
+                     (uint64_t)scalar_sum(src + i, n - i));
+}
+
+static int64_t sse2_dot(const int64_t* a, const int64_t* b, size_t n) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        acc = _mm_add_epi64(acc, sse2_mullo_epi64(va, vb));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return (int64_t)((uint64_t)lanes[0] + (uint64_t)lanes[1] +
+                     (uint64_t)scalar_dot(a + i, b + i, n - i));
+}
+
+static void sse2_axpy(int64_t* y, int64_t a, const int64_t* x, size_t n) {
+    __m128i va = _mm_set1_epi64x(a);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i vy = _mm_loadu_si128((const __m128i*)(y + i));
+        __m128i vx = _mm_loadu_si128((const __m128i*)(x + i));
+        _mm_storeu_si128((__m128i*)(y + i), _mm_add_epi64(vy, sse2_mullo_epi64(va, vx)));
+    }
+    scalar_axpy(y + i, a, x + i, n - i);
+}
+
+static void sse2_add(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi64(va, vb));
+    }
+    scalar_add(dst + i, a + i, b + i, n - i);
+}
+
+static void sse2_sub(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_sub_epi64(va, vb));
+    }
+    scalar_sub(dst + i, a + i, b + i, n - i);
+}
+
+static void sse2_mul(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), sse2_mullo_epi64(va, vb));
+    }
+    scalar_mul(dst + i, a + i, b + i, n - i);
+}
+
+// SSE2 has no 64-bit compare (that is SSE4.2), so minmax and the compares
+// stay scalar here.
+static const ArrayKernels sse2_kernels = {
+    "sse2", sse2_fill, sse2_sum, sse2_dot, sse2_axpy, scalar_minmax,
+    sse2_add, sse2_sub, sse2_mul, scalar_div, scalar_mod, scalar_eq, scalar_lt
+};
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i avx2_mullo_epi64(__m256i a, __m256i b) {
+    __m256i lo = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+AVX2 static int64_t avx2_hsum(__m256i v) {
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return (int64_t)((uint64_t)lanes[0] + (uint64_t)lanes[1] +
+                     (uint64_t)lanes[2] + (uint64_t)lanes[3]);
+}
+
+AVX2 static void avx2_fill(int64_t* dst, int64_t value, size_t n) {
+    __m256i v = _mm256_set1_epi64x(value);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_si256((__m256i*)(dst + i), v);
+    for (; i < n; i++) dst[i] = value;
+}
+
+AVX2 static int64_t avx2_sum(const int64_t* src, size_t n) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256((const __m256i*)(src + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256((const __m256i*)(src + i + 4)));
+    }
+    return (int64_t)((uint64_t)avx2_hsum(_mm256_add_epi64(acc0, acc1)) +
+                     (uint64_t)scalar_sum(src + i, n - i));
+}
+
+AVX2 static int64_t avx2_dot(const int64_t* a, const int64_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        acc = _mm256_add_epi64(acc, avx2_mullo_epi64(va, vb));
+    }
+    return (int64_t)((uint64_t)avx2_hsum(acc) +
+                     (uint64_t)scalar_dot(a + i, b + i, n - i));
+}
+
+AVX2 static void avx2_axpy(int64_t* y, int64_t a, const int64_t* x, size_t n) {
+    __m256i va = _mm256_set1_epi64x(a);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i vy = _mm256_loadu_si256((const __m256i*)(y + i));
+        __m256i vx = _mm256_loadu_si256((const __m256i*)(x + i));
+        _mm256_storeu_si256((__m256i*)(y + i), _mm256_add_epi64(vy, avx2_mullo_epi64(va, vx)));
+    }
+    scalar_axpy(y + i, a, x + i, n - i);
+}
+
+AVX2 static void avx2_minmax(const int64_t* src, size_t n, int64_t* min, int64_t* max) {
+    if (n < 4) {
+        scalar_minmax(src, n, min, max);
+        return;
+    }
+    __m256i lo = _mm256_loadu_si256((const __m256i*)src);
+    __m256i hi = lo;
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        lo = _mm256_blendv_epi8(lo, v, _mm256_cmpgt_epi64(lo, v));
+        hi = _mm256_blendv_epi8(hi, v, _mm256_cmpgt_epi64(v, hi));
+    }
+    int64_t los[4], his[4];
+    _mm256_storeu_si256((__m256i*)los, lo);
+    _mm256_storeu_si256((__m256i*)his, hi);
+    int64_t rlo = los[0], rhi = his[0];
+    for (int k = 1; k < 4; k++) {
+        if (los[k] < rlo) rlo = los[k];
+        if (his[k] > rhi) rhi = his[k];
+    }
+    for (; i < n; i++) {
+        if (src[i] < rlo) rlo = src[i];
+        if (src[i] > rhi) rhi = src[i];
+    }
+    *min = rlo;
+    *max = rhi;
+}
+
+AVX2 static void avx2_add(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi64(va, vb));
+    }
+    scalar_add(dst + i, a + i, b + i, n - i);
+}
+
+AVX2 static void avx2_sub(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_sub_epi64(va, vb));
+    }
+    scalar_sub(dst + i, a + i, b + i, n - i);
+}
+
+AVX2 static void avx2_mul(int64_t* dst, const int64_t* a, const int64_t* b, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), avx2_mullo_epi64(va, vb));
+    }
+    scalar_mul(dst + i, a + i, b + i, n - i);
+}
+
+// Narrows a four-lane compare mask to four 0/1 bytes: movemask gives one
+// bit per lane, then multiplying by 0x204081 spreads bit k to bit 8k.
+AVX2 static inline void avx2_store_mask(uint8_t* dst, __m256i mask, uint8_t flip) {
+    uint32_t bits = (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(mask));
+    uint32_t bytes = ((bits * 0x204081u) & 0x01010101u) ^ (flip * 0x01010101u);
+    memcpy(dst, &bytes, sizeof(bytes));
+}
+
+AVX2 static void avx2_eq(uint8_t* dst, const int64_t* a, const int64_t* b, size_t n, uint8_t flip) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        avx2_store_mask(dst + i, _mm256_cmpeq_epi64(va, vb), flip);
+    }
+    scalar_eq(dst + i, a + i, b + i, n - i, flip);
+}
+
+AVX2 static void avx2_lt(uint8_t* dst, const int64_t* a, const int64_t* b, size_t n, uint8_t flip) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        avx2_store_mask(dst + i, _mm256_cmpgt_epi64(vb, va), flip);
+    }
+    scalar_lt(dst + i, a + i, b + i, n - i, flip);
+}
+
+static const ArrayKernels avx2_kernels = {
+    "avx2", avx2_fill, avx2_sum, avx2_dot, avx2_axpy, avx2_minmax,
+    avx2_add, avx2_sub, avx2_mul, scalar_div, scalar_mod, avx2_eq, avx2_lt
+};
+#endif
+
+const ArrayKernels* array_kernels_scalar(void) {
+    return &scalar_kernels;
+}
+
+const ArrayKernels* array_kernels(void) {
+    static const ArrayKernels* selected = NULL;
+    if (selected) return selected;
+
+    selected = &scalar_kernels;
+#ifdef ARRAY_KERNELS_X86
+    // SSE2 is part of x86-64 itself; AVX2 needs asking.
+    __builtin_cpu_init();
+    selected = __builtin_cpu_supports("avx2") ? &avx2_kernels : &sse2_kernels;
+#endif
+    DPRINT("[ARRAY_KERNELS] Using %s kernels\n", selected->name);
+    return selected;
+}
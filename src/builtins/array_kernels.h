@@ -0,0 +1,36 @@
+#ifndef ARRAY_KERNELS_H
+#define ARRAY_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Loops over contiguous int64 storage (int[n] arrays), used by the array
+// builtins and elementwise BINARY_OP. Each table entry is picked once at startup from what the CPU
+// supports; all variants give identical results, with wrapping arithmetic.
+typedef struct ArrayKernels {
+    const char* name;  // "avx2", "sse2" or "scalar"
+    void (*fill)(int64_t* dst, int64_t value, size_t n);
+    int64_t (*sum)(const int64_t* src, size_t n);
+    int64_t (*dot)(const int64_t* a, const int64_t* b, size_t n);
+    // y[i] += a * x[i]
+    void (*axpy)(int64_t* y, int64_t a, const int64_t* x, size_t n);
+    // n must be > 0
+    void (*minmax)(const int64_t* src, size_t n, int64_t* min, int64_t* max);
+    // dst[i] = a[i] op b[i]; dst may alias a or b. div and mod truncate
+    // like C and give 0 for a zero divisor, as BINARY_OP does on ints.
+    void (*add)(int64_t* dst, const int64_t* a, const int64_t* b, size_t n);
+    void (*sub)(int64_t* dst, const int64_t* a, const int64_t* b, size_t n);
+    void (*mul)(int64_t* dst, const int64_t* a, const int64_t* b, size_t n);
+    void (*div)(int64_t* dst, const int64_t* a, const int64_t* b, size_t n);
+    void (*mod)(int64_t* dst, const int64_t* a, const int64_t* b, size_t n);
+    // dst[i] = (a[i] == b[i]) ^ flip and (a[i] < b[i]) ^ flip, as 0 or 1;
+    // flip is 0 or 1, which with swapped operands covers all six compares
+    void (*eq)(uint8_t* dst, const int64_t* a, const int64_t* b, size_t n, uint8_t flip);
+    void (*lt)(uint8_t* dst, const int64_t* a, const int64_t* b, size_t n, uint8_t flip);
+} ArrayKernels;
+
+const ArrayKernels* array_kernels(void);
+// Always the portable C versions; lets tests compare against the fast path.
+const ArrayKernels* array_kernels_scalar(void);
+
+#endif
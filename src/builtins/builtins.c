@@ -1,4 +1,7 @@
 #include "builtins.h"
+#include "array_kernels.h"
+#include "sort.h"
+#include "matrix.h"
 #include "../runtime/vm/vm.h"
 #include "../system.h"
 #include <time.h>
@@ -197,3 +200,557 @@ Object* builtin_sqrt(VM* vm, int arg_count, Object** args) {
     return heap_alloc_float(heap, strdup(buf));
 }
 
+// gc_stats(): writes the same JSON document as --gc-stats=json to stdout.
+Object* builtin_gc_stats(VM* vm, int arg_count, Object** args) {
+    (void)arg_count;
+    (void)args;
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    vm_write_gc_stats(vm, stdout);
+    return heap_alloc_none(heap);
+}
+
+// Array builtins. int[n] arrays hand their contiguous storage to the
+// vectorized kernels; bool[n] and boxed arrays take element-wise paths.
+// Views work like any array: array_arg syncs them with their base first.
+
+static Object* array_arg(int arg_count, Object** args, int i) {
+    if (i >= arg_count || !args[i] || args[i]->type != OBJ_ARRAY) return NULL;
+    object_array_sync(args[i]);
+    return args[i];
+}
+
+static bool is_int_array(const Object* array) {
+    return array->elem_kind == ARRAY_INT && array->as.array.ints;
+}
+
+// Element i as an integer (bools count as 0/1); false for anything else.
+static bool array_int_at(const Object* array, size_t i, int64_t* out) {
+    switch (array->elem_kind) {
+        case ARRAY_INT:
+            *out = array->as.array.ints[i];
+            return true;
+        case ARRAY_BOOL:
+            *out = array->as.array.bools[i] != 0;
+            return true;
+        default: {
+            Object* item = array->as.array.items[i];
+            if (!item) return false;
+            if (item->type == OBJ_INT) {
+                *out = item->as.int_value;
+                return true;
+            }
+            if (item->type == OBJ_BOOL) {
+                *out = item->as.bool_value ? 1 : 0;
+                return true;
+            }
+            return false;
+        }
+    }
+}
+
+// fill(a, v): sets every element of a to v.
+Object* builtin_fill(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 2 || !args[1]) {
+        DPRINT("[BUILTIN_FILL] ERROR: Expected (array, value)\n");
+        return heap_alloc_none(heap);
+    }
+    Object* value = args[1];
+    size_t n = array->as.array.size;
+
+    if (is_int_array(array) && value->type == OBJ_INT) {
+        array_kernels()->fill(array->as.array.ints, value->as.int_value, n);
+    } else if (array->elem_kind == ARRAY_BOOL && value->type == OBJ_BOOL) {
+        memset(array->as.array.bools, value->as.bool_value ? 1 : 0, n);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            vm_array_store(vm, array, i, value);
+        }
+    }
+    DPRINT("[BUILTIN_FILL] Filled %zu elements of %p\n", n, (void*)array);
+    return heap_alloc_none(heap);
+}
+
+// copy(dst, src): copies the common prefix of src into dst; returns its length.
+Object* builtin_copy(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* dst = array_arg(arg_count, args, 0);
+    Object* src = array_arg(arg_count, args, 1);
+    if (!dst || !src || arg_count != 2) {
+        DPRINT("[BUILTIN_COPY] ERROR: Expected (array, array)\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t n = dst->as.array.size < src->as.array.size ? dst->as.array.size : src->as.array.size;
+    if (dst != src && n > 0) {
+        if (dst->elem_kind != ARRAY_BOXED && dst->elem_kind == src->elem_kind) {
+            memmove(dst->as.array.ints, src->as.array.ints,
+                    n * object_array_elem_size((ArrayKind)dst->elem_kind));
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                vm_array_store(vm, dst, i, heap_array_load(heap, src, i));
+            }
+        }
+    }
+    DPRINT("[BUILTIN_COPY] Copied %zu elements %p -> %p\n", n, (void*)src, (void*)dst);
+    return heap_alloc_int(heap, (int64_t)n);
+}
+
+// sum(a): integer sum of the elements, or None if one is not an int/bool.
+Object* builtin_sum(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 1) {
+        DPRINT("[BUILTIN_SUM] ERROR: Expected (array)\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t n = array->as.array.size;
+    if (is_int_array(array)) {
+        return heap_alloc_int(heap, array_kernels()->sum(array->as.array.ints, n));
+    }
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t v;
+        if (!array_int_at(array, i, &v)) {
+            DPRINT("[BUILTIN_SUM] ERROR: Element %zu is not an integer\n", i);
+            return heap_alloc_none(heap);
+        }
+        acc += (uint64_t)v;
+    }
+    return heap_alloc_int(heap, (int64_t)acc);
+}
+
+// dot(a, b): sum of a[i] * b[i] over two arrays of the same length.
+Object* builtin_dot(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* a = array_arg(arg_count, args, 0);
+    Object* b = array_arg(arg_count, args, 1);
+    if (!a || !b || arg_count != 2 || a->as.array.size != b->as.array.size) {
+        DPRINT("[BUILTIN_DOT] ERROR: Expected two arrays of equal length\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t n = a->as.array.size;
+    if (is_int_array(a) && is_int_array(b)) {
+        return heap_alloc_int(heap, array_kernels()->dot(a->as.array.ints, b->as.array.ints, n));
+    }
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t x, y;
+        if (!array_int_at(a, i, &x) || !array_int_at(b, i, &y)) {
+            DPRINT("[BUILTIN_DOT] ERROR: Element %zu is not an integer\n", i);
+            return heap_alloc_none(heap);
+        }
+        acc += (uint64_t)x * (uint64_t)y;
+    }
+    return heap_alloc_int(heap, (int64_t)acc);
+}
+
+// axpy(y, a, x): y[i] = y[i] + a * x[i] for arrays of the same length.
+Object* builtin_axpy(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* y = array_arg(arg_count, args, 0);
+    Object* x = array_arg(arg_count, args, 2);
+    if (!y || !x || arg_count != 3 || !args[1] || args[1]->type != OBJ_INT ||
+        y->as.array.size != x->as.array.size) {
+        DPRINT("[BUILTIN_AXPY] ERROR: Expected (array, int, array) of equal length\n");
+        return heap_alloc_none(heap);
+    }
+
+    int64_t a = args[1]->as.int_value;
+    size_t n = y->as.array.size;
+    if (is_int_array(y) && is_int_array(x)) {
+        array_kernels()->axpy(y->as.array.ints, a, x->as.array.ints, n);
+        return heap_alloc_none(heap);
+    }
+    for (size_t i = 0; i < n; i++) {
+        int64_t yi, xi;
+        if (!array_int_at(y, i, &yi) || !array_int_at(x, i, &xi)) {
+            DPRINT("[BUILTIN_AXPY] ERROR: Element %zu is not an integer\n", i);
+            break;
+        }
+        int64_t r = (int64_t)((uint64_t)yi + (uint64_t)a * (uint64_t)xi);
+        vm_array_store(vm, y, i, heap_alloc_int(heap, r));
+    }
+    return heap_alloc_none(heap);
+}
+
+// minmax(a): a new int[2] holding {min, max}, or None for an empty array.
+Object* builtin_minmax(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 1 || array->as.array.size == 0) {
+        DPRINT("[BUILTIN_MINMAX] ERROR: Expected a non-empty array\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t n = array->as.array.size;
+    int64_t lo, hi;
+    if (is_int_array(array)) {
+        array_kernels()->minmax(array->as.array.ints, n, &lo, &hi);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            int64_t v;
+            if (!array_int_at(array, i, &v)) {
+                DPRINT("[BUILTIN_MINMAX] ERROR: Element %zu is not an integer\n", i);
+                return heap_alloc_none(heap);
+            }
+            if (i == 0 || v < lo) lo = v;
+            if (i == 0 || v > hi) hi = v;
+        }
+    }
+
+    Object* result = heap_alloc_typed_array(heap, ARRAY_INT, 2);
+    if (!result || !result->as.array.ints) return heap_alloc_none(heap);
+    result->as.array.ints[0] = lo;
+    result->as.array.ints[1] = hi;
+    return result;
+}
+
+// sort(a) or sort(a, lo, hi): sorts a, or its elements [lo, hi), ascending.
+Object* builtin_sort(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || (arg_count != 1 && arg_count != 3)) {
+        DPRINT("[BUILTIN_SORT] ERROR: Expected (array) or (array, lo, hi)\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t lo = 0;
+    size_t hi = array->as.array.size;
+    if (arg_count == 3) {
+        if (!args[1] || args[1]->type != OBJ_INT || !args[2] || args[2]->type != OBJ_INT) {
+            DPRINT("[BUILTIN_SORT] ERROR: Bounds must be integers\n");
+            return heap_alloc_none(heap);
+        }
+        lo = args[1]->as.int_value > 0 ? (size_t)args[1]->as.int_value : 0;
+        hi = args[2]->as.int_value > 0 ? (size_t)args[2]->as.int_value : 0;
+    }
+
+    sort_array(array, lo, hi);
+    return heap_alloc_none(heap);
+}
+
+// Growable arrays. Any array can change length: storage keeps spare
+// capacity, doubled whenever an append runs out, so append and pop are
+// amortized O(1) and len is a field read.
+
+// Non-negative int argument i, or false.
+static bool size_arg(int arg_count, Object** args, int i, size_t* out) {
+    if (i >= arg_count || !args[i] || args[i]->type != OBJ_INT || args[i]->as.int_value < 0) {
+        return false;
+    }
+    *out = (size_t)args[i]->as.int_value;
+    return true;
+}
+
+// append(a, v): adds v after the last element of a.
+Object* builtin_append(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 2 || !args[1]) {
+        DPRINT("[BUILTIN_APPEND] ERROR: Expected (array, value)\n");
+        return heap_alloc_none(heap);
+    }
+    if (!vm_array_append(vm, array, args[1])) {
+        DPRINT("[BUILTIN_APPEND] ERROR: Could not grow array %p\n", (void*)array);
+    }
+    return heap_alloc_none(heap);
+}
+
+// pop(a): removes and returns the last element of a, or None if a is empty.
+Object* builtin_pop(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 1) {
+        DPRINT("[BUILTIN_POP] ERROR: Expected (array)\n");
+        return heap_alloc_none(heap);
+    }
+    Object* element = vm_array_pop(vm, array);
+    return element ? element : heap_alloc_none(heap);
+}
+
+// len(a): number of elements in a.
+Object* builtin_len(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 1) {
+        DPRINT("[BUILTIN_LEN] ERROR: Expected (array)\n");
+        return heap_alloc_none(heap);
+    }
+    return heap_alloc_int(heap, (int64_t)array->as.array.size);
+}
+
+// reserve(a, n): makes room for n elements without changing len(a).
+Object* builtin_reserve(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    size_t n;
+    if (!array || arg_count != 2 || !size_arg(arg_count, args, 1, &n)) {
+        DPRINT("[BUILTIN_RESERVE] ERROR: Expected (array, non-negative int)\n");
+        return heap_alloc_none(heap);
+    }
+    if (n > array->as.array.capacity) {
+        heap_array_reserve(heap, array, n);
+    }
+    return heap_alloc_none(heap);
+}
+
+// truncate(a, n): drops every element from index n on; keeps the storage.
+Object* builtin_truncate(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    size_t n;
+    if (!array || arg_count != 2 || !size_arg(arg_count, args, 1, &n)) {
+        DPRINT("[BUILTIN_TRUNCATE] ERROR: Expected (array, non-negative int)\n");
+        return heap_alloc_none(heap);
+    }
+    vm_array_truncate(vm, array, n);
+    return heap_alloc_none(heap);
+}
+
+// shrink(a): releases spare capacity so a holds exactly len(a) elements.
+Object* builtin_shrink(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    if (!array || arg_count != 1) {
+        DPRINT("[BUILTIN_SHRINK] ERROR: Expected (array)\n");
+        return heap_alloc_none(heap);
+    }
+    heap_array_reserve(heap, array, array->as.array.size);
+    return heap_alloc_none(heap);
+}
+
+// slice(a, lo, hi) or slice(a, lo): a view of a[lo] .. a[hi - 1] (to the end
+// without hi) that shares a's storage. Bounds are clamped to the array.
+Object* builtin_slice(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* array = array_arg(arg_count, args, 0);
+    size_t lo;
+    size_t hi = array ? array->as.array.size : 0;
+    if (!array || (arg_count != 2 && arg_count != 3) || !size_arg(arg_count, args, 1, &lo) ||
+        (arg_count == 3 && !size_arg(arg_count, args, 2, &hi))) {
+        DPRINT("[BUILTIN_SLICE] ERROR: Expected (array, lo) or (array, lo, hi) with non-negative bounds\n");
+        return heap_alloc_none(heap);
+    }
+
+    Object* view = vm_array_slice(vm, array, lo, hi);
+    return view ? view : heap_alloc_none(heap);
+}
+
+// Matrix builtins. Operands are 2-D arrays (T[n][m]); matvec's vector can
+// be any array. Integer operands run through the cache-blocked kernels in
+// matrix.c: int[n][m] storage directly, bool and boxed integers from a
+// scratch copy. Floats are BigFloats and are computed element by element.
+
+static Object* matrix_arg(int arg_count, Object** args, int i) {
+    Object* array = array_arg(arg_count, args, i);
+    return array && array->as.array.cols ? array : NULL;
+}
+
+// The first n elements as int64: int[] storage itself, or a malloc'd copy
+// (*owned set). NULL if an element is not an int or bool.
+static int64_t* array_ints(const Object* array, size_t n, bool* owned) {
+    *owned = false;
+    if (is_int_array(array)) return array->as.array.ints;
+
+    int64_t* ints = malloc((n > 0 ? n : 1) * sizeof(int64_t));
+    if (!ints) return NULL;
+    for (size_t i = 0; i < n; i++) {
+        if (!array_int_at(array, i, &ints[i])) {
+            free(ints);
+            return NULL;
+        }
+    }
+    *owned = true;
+    return ints;
+}
+
+// The first n elements as BigFloats, converting ints and bools. Free with
+// free_bigfloats. NULL if an element is not a number.
+static BigFloat** array_bigfloats(const Object* array, size_t n) {
+    BigFloat** values = calloc(n > 0 ? n : 1, sizeof(BigFloat*));
+    if (!values) return NULL;
+    for (size_t i = 0; i < n; i++) {
+        Object* item = array->elem_kind == ARRAY_BOXED ? array->as.array.items[i] : NULL;
+        int64_t v;
+        if (item && item->type == OBJ_FLOAT && item->as.float_value) {
+            char* s = bigfloat_to_string(item->as.float_value);
+            values[i] = s ? bigfloat_create(s) : NULL;
+            free(s);
+        } else if (array_int_at(array, i, &v)) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%lld", (long long)v);
+            values[i] = bigfloat_create(buf);
+        }
+        if (!values[i]) {
+            for (size_t j = 0; j < i; j++) bigfloat_destroy(values[j]);
+            free(values);
+            return NULL;
+        }
+    }
+    return values;
+}
+
+static void free_bigfloats(BigFloat** values, size_t n) {
+    if (!values) return;
+    for (size_t i = 0; i < n; i++) bigfloat_destroy(values[i]);
+    free(values);
+}
+
+// Sum of x[i * x_stride] * y[i * y_stride] for i < n, as a new BigFloat.
+static BigFloat* bigfloat_dot(BigFloat** x, size_t x_stride, BigFloat** y, size_t y_stride, size_t n) {
+    BigFloat* acc = bigfloat_zero();
+    for (size_t i = 0; acc && i < n; i++) {
+        BigFloat* prod = bigfloat_mul(x[i * x_stride], y[i * y_stride]);
+        BigFloat* sum = prod ? bigfloat_add(acc, prod) : NULL;
+        bigfloat_destroy(prod);
+        bigfloat_destroy(acc);
+        acc = sum;
+    }
+    return acc;
+}
+
+// matmul(a, b): the n x p product of an n x m and an m x p array.
+Object* builtin_matmul(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* a = matrix_arg(arg_count, args, 0);
+    Object* b = matrix_arg(arg_count, args, 1);
+    if (!a || !b || arg_count != 2 || a->as.array.cols != object_array_rows(b)) {
+        DPRINT("[BUILTIN_MATMUL] ERROR: Expected n x m and m x p arrays\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t n = object_array_rows(a), m = a->as.array.cols, p = b->as.array.cols;
+    bool a_owned, b_owned;
+    int64_t* ai = array_ints(a, n * m, &a_owned);
+    int64_t* bi = ai ? array_ints(b, m * p, &b_owned) : NULL;
+    if (ai && bi) {
+        Object* c = heap_alloc_matrix(heap, ARRAY_INT, n, p);
+        if (c && c->as.array.ints) matmul_i64(ai, bi, c->as.array.ints, n, m, p);
+        if (a_owned) free(ai);
+        if (b_owned) free(bi);
+        return c ? c : heap_alloc_none(heap);
+    }
+    if (ai && a_owned) free(ai);
+
+    BigFloat** af = array_bigfloats(a, n * m);
+    BigFloat** bf = af ? array_bigfloats(b, m * p) : NULL;
+    Object* c = bf ? heap_alloc_matrix(heap, ARRAY_BOXED, n, p) : NULL;
+    for (size_t i = 0; c && i < n; i++) {
+        for (size_t j = 0; j < p; j++) {
+            BigFloat* value = bigfloat_dot(af + i * m, 1, bf + j, p, m);
+            vm_array_store(vm, c, i * p + j, value ? heap_alloc_float_from_bf(heap, value) : heap_alloc_none(heap));
+        }
+    }
+    free_bigfloats(af, n * m);
+    free_bigfloats(bf, m * p);
+    if (!c) {
+        DPRINT("[BUILTIN_MATMUL] ERROR: Elements must be numbers\n");
+        return heap_alloc_none(heap);
+    }
+    return c;
+}
+
+// transpose(a): a new m x n array holding the transpose of an n x m one.
+Object* builtin_transpose(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* a = matrix_arg(arg_count, args, 0);
+    if (!a || arg_count != 1) {
+        DPRINT("[BUILTIN_TRANSPOSE] ERROR: Expected a 2-D array\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t rows = object_array_rows(a), cols = a->as.array.cols;
+    Object* t = heap_alloc_matrix(heap, (ArrayKind)a->elem_kind, cols, rows);
+    if (!t) return heap_alloc_none(heap);
+
+    if (is_int_array(a) && t->as.array.ints) {
+        transpose_i64(a->as.array.ints, t->as.array.ints, rows, cols);
+    } else {
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                vm_array_store(vm, t, j * rows + i, heap_array_load(heap, a, i * cols + j));
+            }
+        }
+    }
+    return t;
+}
+
+// matvec(a, x): the product of an n x m array and an m-element array, as
+// an n-element array.
+Object* builtin_matvec(VM* vm, int arg_count, Object** args) {
+    Heap* heap = vm_get_heap(vm);
+    if (!heap) return NULL;
+
+    Object* a = matrix_arg(arg_count, args, 0);
+    Object* x = array_arg(arg_count, args, 1);
+    if (!a || !x || arg_count != 2 || x->as.array.size != a->as.array.cols) {
+        DPRINT("[BUILTIN_MATVEC] ERROR: Expected an n x m array and an m-element array\n");
+        return heap_alloc_none(heap);
+    }
+
+    size_t rows = object_array_rows(a), cols = a->as.array.cols;
+    bool a_owned, x_owned;
+    int64_t* ai = array_ints(a, rows * cols, &a_owned);
+    int64_t* xi = ai ? array_ints(x, cols, &x_owned) : NULL;
+    if (ai && xi) {
+        Object* y = heap_alloc_typed_array(heap, ARRAY_INT, rows);
+        if (y && y->as.array.ints) matvec_i64(ai, xi, y->as.array.ints, rows, cols);
+        if (a_owned) free(ai);
+        if (x_owned) free(xi);
+        return y ? y : heap_alloc_none(heap);
+    }
+    if (ai && a_owned) free(ai);
+
+    BigFloat** af = array_bigfloats(a, rows * cols);
+    BigFloat** xf = af ? array_bigfloats(x, cols) : NULL;
+    Object* y = xf ? heap_alloc_array_with_size(heap, rows) : NULL;
+    for (size_t i = 0; y && i < rows; i++) {
+        BigFloat* value = bigfloat_dot(af + i * cols, 1, xf, 1, cols);
+        vm_array_store(vm, y, i, value ? heap_alloc_float_from_bf(heap, value) : heap_alloc_none(heap));
+    }
+    free_bigfloats(af, rows * cols);
+    free_bigfloats(xf, cols);
+    if (!y) {
+        DPRINT("[BUILTIN_MATVEC] ERROR: Elements must be numbers\n");
+        return heap_alloc_none(heap);
+    }
+    return y;
+}
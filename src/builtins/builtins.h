@@ -4,9 +4,41 @@
 typedef struct VM VM;
 typedef struct Object Object;
 
-Object* builtin_print(VM* vm, int arg_count, Object** args);
-Object* builtin_input(VM* vm, int arg_count, Object** args);
-Object* builtin_randint(VM* vm, int arg_count, Object** args);
-Object* builtin_sqrt(VM* vm, int arg_count, Object** args);
+// Builtins occupy the first global slots in this order: the compiler
+// reserves their names and vm_register_builtins binds builtin_<name>.
+#define BUILTIN_LIST(X) \
+    X(print)            \
+    X(input)            \
+    X(randint)          \
+    X(sqrt)             \
+    X(gc_stats)         \
+    X(fill)             \
+    X(copy)             \
+    X(sum)              \
+    X(dot)              \
+    X(axpy)             \
+    X(minmax)           \
+    X(sort)             \
+    X(append)           \
+    X(pop)              \
+    X(len)              \
+    X(reserve)          \
+    X(truncate)         \
+    X(shrink)           \
+    X(slice)            \
+    X(matmul)           \
+    X(transpose)        \
+    X(matvec)
+
+enum {
+#define BUILTIN_INDEX(name) BUILTIN_INDEX_##name,
+    BUILTIN_LIST(BUILTIN_INDEX)
+#undef BUILTIN_INDEX
+    BUILTIN_COUNT
+};
+
+#define BUILTIN_DECLARE(name) Object* builtin_##name(VM* vm, int arg_count, Object** args);
+BUILTIN_LIST(BUILTIN_DECLARE)
+#undef BUILTIN_DECLARE
 
 #endif
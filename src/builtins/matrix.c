@@ -0,0 +1,52 @@
+#include "matrix.h"
+#include "array_kernels.h"
+#include "../system.h"
+#include <string.h>
+
+// The inner loop is an axpy over a row slice: c[i][j..] += a[i][k] * b[k][j..],
+// so the SIMD work is the AVX2/SSE2 axpy kernel and the blocking only
+// decides which slices of b and c are hot in cache while it runs.
+void matmul_i64(const int64_t* a, const int64_t* b, int64_t* c, size_t n, size_t m, size_t p) {
+    const ArrayKernels* kernels = array_kernels();
+    memset(c, 0, n * p * sizeof(int64_t));
+
+    for (size_t jj = 0; jj < p; jj += MATMUL_BLOCK_J) {
+        size_t width = p - jj < MATMUL_BLOCK_J ? p - jj : MATMUL_BLOCK_J;
+        for (size_t kk = 0; kk < m; kk += MATMUL_BLOCK_K) {
+            size_t k_end = m - kk < MATMUL_BLOCK_K ? m : kk + MATMUL_BLOCK_K;
+            for (size_t i = 0; i < n; i++) {
+                const int64_t* a_row = a + i * m;
+                int64_t* c_row = c + i * p + jj;
+                for (size_t k = kk; k < k_end; k++) {
+                    if (a_row[k] != 0) {
+                        kernels->axpy(c_row, a_row[k], b + k * p + jj, width);
+                    }
+                }
+            }
+        }
+    }
+    DPRINT("[MATRIX] matmul %zu x %zu by %zu x %zu with %s kernels\n", n, m, m, p, kernels->name);
+}
+
+// Square tiles keep both the rows read and the columns written within a
+// few cache lines each, instead of striding the whole output per element.
+void transpose_i64(const int64_t* a, int64_t* t, size_t rows, size_t cols) {
+    for (size_t ii = 0; ii < rows; ii += TRANSPOSE_BLOCK) {
+        size_t i_end = rows - ii < TRANSPOSE_BLOCK ? rows : ii + TRANSPOSE_BLOCK;
+        for (size_t jj = 0; jj < cols; jj += TRANSPOSE_BLOCK) {
+            size_t j_end = cols - jj < TRANSPOSE_BLOCK ? cols : jj + TRANSPOSE_BLOCK;
+            for (size_t i = ii; i < i_end; i++) {
+                for (size_t j = jj; j < j_end; j++) {
+                    t[j * rows + i] = a[i * cols + j];
+                }
+            }
+        }
+    }
+}
+
+void matvec_i64(const int64_t* a, const int64_t* x, int64_t* y, size_t rows, size_t cols) {
+    const ArrayKernels* kernels = array_kernels();
+    for (size_t i = 0; i < rows; i++) {
+        y[i] = kernels->dot(a + i * cols, x, cols);
+    }
+}
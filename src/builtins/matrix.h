@@ -0,0 +1,24 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Dense row-major int64 matrix kernels behind matmul, transpose and matvec.
+// Arithmetic wraps like the array kernels they are built on.
+
+// Tile sizes in elements. A MATMUL_BLOCK_K x MATMUL_BLOCK_J panel of b
+// (128 KiB) stays in L2 while every row of a streams past it, and the
+// MATMUL_BLOCK_J slice of a row of c it accumulates into stays in L1.
+#define MATMUL_BLOCK_K 64
+#define MATMUL_BLOCK_J 256
+#define TRANSPOSE_BLOCK 32
+
+// c (n x p) = a (n x m) * b (m x p); c must not alias a or b.
+void matmul_i64(const int64_t* a, const int64_t* b, int64_t* c, size_t n, size_t m, size_t p);
+// t (cols x rows) = transpose of a (rows x cols).
+void transpose_i64(const int64_t* a, int64_t* t, size_t rows, size_t cols);
+// y (rows) = a (rows x cols) * x (cols).
+void matvec_i64(const int64_t* a, const int64_t* x, int64_t* y, size_t rows, size_t cols);
+
+#endif
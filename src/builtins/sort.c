@@ -0,0 +1,320 @@
+#include "sort.h"
+#include "../runtime/vm/object.h"
+#include "../runtime/vm/float_bigint.h"
+#include "../system.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define SORT_INSERTION_MAX 32
+
+// ---------------------------------------------------------------------------
+// int64
+
+static void insertion_sort_i64(int64_t* a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        int64_t v = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1] > v) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+
+// Flipping the sign bit makes unsigned byte order match signed order.
+static inline uint64_t radix_key(int64_t v) {
+    return (uint64_t)v ^ (UINT64_C(1) << 63);
+}
+
+// One histogram pass for all eight digits, then a scatter per digit that
+// is not shared by every key. tmp must hold n elements.
+static void radix_sort_i64(int64_t* a, int64_t* tmp, size_t n) {
+    size_t counts[8][256];
+    memset(counts, 0, sizeof(counts));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = radix_key(a[i]);
+        for (int d = 0; d < 8; d++) {
+            counts[d][(k >> (d * 8)) & 0xFF]++;
+        }
+    }
+
+    int64_t* src = a;
+    int64_t* dst = tmp;
+    for (int d = 0; d < 8; d++) {
+        size_t* count = counts[d];
+        int shift = d * 8;
+        if (count[(radix_key(src[0]) >> shift) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            int64_t v = src[i];
+            dst[count[(radix_key(v) >> shift) & 0xFF]++] = v;
+        }
+        int64_t* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != a) {
+        memcpy(a, src, n * sizeof(int64_t));
+    }
+}
+
+static void merge_i64(const int64_t* left, size_t nl, const int64_t* right, size_t nr, int64_t* out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < nl && j < nr) {
+        out[k++] = right[j] < left[i] ? right[j++] : left[i++];
+    }
+    while (i < nl) out[k++] = left[i++];
+    while (j < nr) out[k++] = right[j++];
+}
+
+typedef struct {
+    int64_t* a;
+    int64_t* tmp;
+    size_t lo, mid, hi;  // sort [lo, hi), or merge [lo, mid) with [mid, hi)
+} SortTask;
+
+static void* sort_chunk_worker(void* arg) {
+    SortTask* t = arg;
+    radix_sort_i64(t->a + t->lo, t->tmp + t->lo, t->hi - t->lo);
+    return NULL;
+}
+
+static void* merge_chunk_worker(void* arg) {
+    SortTask* t = arg;
+    merge_i64(t->a + t->lo, t->mid - t->lo, t->a + t->mid, t->hi - t->mid, t->tmp + t->lo);
+    return NULL;
+}
+
+static size_t sort_thread_count(size_t n) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = cpus > 0 ? (size_t)cpus : 1;
+    if (threads > SORT_MAX_THREADS) threads = SORT_MAX_THREADS;
+    while (threads > 1 && n / threads < SORT_PARALLEL_MIN / 4) threads--;
+    return threads;
+}
+
+// Radix-sorts one chunk per thread, then merges neighbouring runs in
+// parallel rounds, ping-ponging between a and tmp.
+static void parallel_sort_i64(int64_t* a, int64_t* tmp, size_t n, size_t threads) {
+    size_t bounds[SORT_MAX_THREADS + 1];
+    for (size_t t = 0; t <= threads; t++) bounds[t] = n * t / threads;
+
+    pthread_t tids[SORT_MAX_THREADS];
+    SortTask tasks[SORT_MAX_THREADS];
+    for (size_t t = 0; t < threads; t++) {
+        tasks[t] = (SortTask){a, tmp, bounds[t], bounds[t], bounds[t + 1]};
+        if (pthread_create(&tids[t], NULL, sort_chunk_worker, &tasks[t]) != 0) {
+            sort_chunk_worker(&tasks[t]);
+            tids[t] = 0;
+        }
+    }
+    for (size_t t = 0; t < threads; t++) {
+        if (tids[t]) pthread_join(tids[t], NULL);
+    }
+
+    int64_t* src = a;
+    int64_t* dst = tmp;
+    size_t runs = threads;
+    while (runs > 1) {
+        size_t merged = 0;
+        for (size_t r = 0; r < runs; r += 2) {
+            SortTask* task = &tasks[merged];
+            if (r + 1 < runs) {
+                *task = (SortTask){src, dst, bounds[r], bounds[r + 1], bounds[r + 2]};
+                if (pthread_create(&tids[merged], NULL, merge_chunk_worker, task) != 0) {
+                    merge_chunk_worker(task);
+                    tids[merged] = 0;
+                }
+            } else {
+                memcpy(dst + bounds[r], src + bounds[r], (bounds[r + 1] - bounds[r]) * sizeof(int64_t));
+                tids[merged] = 0;
+            }
+            merged++;
+        }
+        for (size_t m = 0; m < merged; m++) {
+            if (tids[m]) pthread_join(tids[m], NULL);
+        }
+        for (size_t m = 0; m < merged; m++) {
+            bounds[m + 1] = bounds[m * 2 + 2 < runs ? m * 2 + 2 : runs];
+        }
+        runs = merged;
+        int64_t* t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != a) {
+        memcpy(a, src, n * sizeof(int64_t));
+    }
+}
+
+void sort_i64(int64_t* a, size_t n) {
+    if (n <= SORT_INSERTION_MAX) {
+        insertion_sort_i64(a, n);
+        return;
+    }
+
+    int64_t* tmp = malloc(n * sizeof(int64_t));
+    if (!tmp) {
+        DPRINT("[SORT] ERROR: No scratch for %zu elements, using insertion sort\n", n);
+        insertion_sort_i64(a, n);
+        return;
+    }
+
+    size_t threads = n >= SORT_PARALLEL_MIN ? sort_thread_count(n) : 1;
+    DPRINT("[SORT] Sorting %zu ints on %zu thread(s)\n", n, threads);
+    if (threads > 1) {
+        parallel_sort_i64(a, tmp, n, threads);
+    } else {
+        radix_sort_i64(a, tmp, n);
+    }
+    free(tmp);
+}
+
+// ---------------------------------------------------------------------------
+// Boxed items
+
+// Numbers (int, bool, float) order by value; anything else sorts after
+// them and compares equal to its own kind.
+static int object_sort_cmp(const Object* a, const Object* b) {
+    bool a_num = a && (a->type == OBJ_INT || a->type == OBJ_BOOL || a->type == OBJ_FLOAT);
+    bool b_num = b && (b->type == OBJ_INT || b->type == OBJ_BOOL || b->type == OBJ_FLOAT);
+    if (!a_num || !b_num) return (int)b_num - (int)a_num;
+
+    if (a->type != OBJ_FLOAT && b->type != OBJ_FLOAT) {
+        int64_t x = a->type == OBJ_INT ? a->as.int_value : a->as.bool_value;
+        int64_t y = b->type == OBJ_INT ? b->as.int_value : b->as.bool_value;
+        return (x > y) - (x < y);
+    }
+
+    BigFloat* fa = a->as.float_value;
+    BigFloat* fb = b->as.float_value;
+    char buf[32];
+    if (a->type != OBJ_FLOAT) {
+        snprintf(buf, sizeof(buf), "%lld", (long long)(a->type == OBJ_INT ? a->as.int_value : a->as.bool_value));
+        fa = bigfloat_create(buf);
+    }
+    if (b->type != OBJ_FLOAT) {
+        snprintf(buf, sizeof(buf), "%lld", (long long)(b->type == OBJ_INT ? b->as.int_value : b->as.bool_value));
+        fb = bigfloat_create(buf);
+    }
+    int r = (fa && fb) ? bigfloat_cmp(fa, fb) : 0;
+    if (a->type != OBJ_FLOAT) bigfloat_destroy(fa);
+    if (b->type != OBJ_FLOAT) bigfloat_destroy(fb);
+    return r;
+}
+
+static void insertion_sort_objects(Object** a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        Object* v = a[i];
+        size_t j = i;
+        while (j > 0 && object_sort_cmp(a[j - 1], v) > 0) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+
+static void sift_down_objects(Object** a, size_t root, size_t n) {
+    for (;;) {
+        size_t child = root * 2 + 1;
+        if (child >= n) return;
+        if (child + 1 < n && object_sort_cmp(a[child], a[child + 1]) < 0) child++;
+        if (object_sort_cmp(a[root], a[child]) >= 0) return;
+        Object* t = a[root];
+        a[root] = a[child];
+        a[child] = t;
+        root = child;
+    }
+}
+
+static void heap_sort_objects(Object** a, size_t n) {
+    for (size_t i = n / 2; i-- > 0;) sift_down_objects(a, i, n);
+    for (size_t end = n; end-- > 1;) {
+        Object* t = a[0];
+        a[0] = a[end];
+        a[end] = t;
+        sift_down_objects(a, 0, end);
+    }
+}
+
+// Quicksort with a median-of-three pivot that falls back to heapsort once
+// the recursion gets deeper than 2*log2(n).
+static void introsort_objects(Object** a, size_t n, int depth) {
+    while (n > SORT_INSERTION_MAX) {
+        if (depth-- == 0) {
+            heap_sort_objects(a, n);
+            return;
+        }
+
+        size_t mid = n / 2;
+        if (object_sort_cmp(a[mid], a[0]) < 0) { Object* t = a[mid]; a[mid] = a[0]; a[0] = t; }
+        if (object_sort_cmp(a[n - 1], a[0]) < 0) { Object* t = a[n - 1]; a[n - 1] = a[0]; a[0] = t; }
+        if (object_sort_cmp(a[n - 1], a[mid]) < 0) { Object* t = a[n - 1]; a[n - 1] = a[mid]; a[mid] = t; }
+        Object* pivot = a[mid];
+
+        size_t i = 0, j = n - 1;
+        for (;;) {
+            while (object_sort_cmp(a[i], pivot) < 0) i++;
+            while (object_sort_cmp(pivot, a[j]) < 0) j--;
+            if (i >= j) break;
+            Object* t = a[i];
+            a[i] = a[j];
+            a[j] = t;
+            i++;
+            j--;
+        }
+
+        // recurse into the smaller half, loop on the larger
+        size_t left = j + 1;
+        if (left < n - left) {
+            introsort_objects(a, left, depth);
+            a += left;
+            n -= left;
+        } else {
+            introsort_objects(a + left, n - left, depth);
+            n = left;
+        }
+    }
+    insertion_sort_objects(a, n);
+}
+
+void sort_array(Object* array, size_t lo, size_t hi) {
+    if (!array || array->type != OBJ_ARRAY) return;
+    object_array_sync(array);
+    if (hi > array->as.array.size) hi = array->as.array.size;
+    if (lo >= hi) return;
+    size_t n = hi - lo;
+
+    switch (array->elem_kind) {
+        case ARRAY_INT:
+            sort_i64(array->as.array.ints + lo, n);
+            break;
+        case ARRAY_BOOL: {
+            uint8_t* bools = array->as.array.bools + lo;
+            size_t falses = 0;
+            for (size_t i = 0; i < n; i++) falses += bools[i] == 0;
+            memset(bools, 0, falses);
+            memset(bools + falses, 1, n - falses);
+            break;
+        }
+        default: {
+            if (!array->as.array.items) return;
+            int depth = 0;
+            for (size_t m = n; m > 1; m >>= 1) depth += 2;
+            introsort_objects(array->as.array.items + lo, n, depth);
+            break;
+        }
+    }
+    DPRINT("[SORT] Sorted [%zu, %zu) of array %p\n", lo, hi, (void*)array);
+}
@@ -0,0 +1,24 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct Object Object;
+
+// Below this many elements sort_i64 stays on one thread.
+#define SORT_PARALLEL_MIN (1u << 18)
+#define SORT_MAX_THREADS 8
+
+// Ascending int64 sort: insertion sort for short runs, LSD radix sort
+// otherwise, and a parallel merge of radix-sorted chunks above
+// SORT_PARALLEL_MIN.
+void sort_i64(int64_t* a, size_t n);
+
+// Sorts elements [lo, hi) of an array in place, ascending; hi is clamped
+// to the array size. int[n] uses sort_i64, bool[n] a counting pass, and
+// boxed arrays an introsort on numeric value (not stable). Only permutes
+// existing items, so reference counts and barriers are unaffected.
+void sort_array(Object* array, size_t lo, size_t hi);
+
+#endif
@@ -29,6 +29,17 @@ const char* bytecode_opcode_to_string(uint8_t op_code) {
         case TO_LONG: return "TO_LONG";
         case STORE_SUBSCR: return "STORE_SUBSCR";
         case LOAD_SUBSCR: return "LOAD_SUBSCR";
+        case STORE_SUBSCR2: return "STORE_SUBSCR2";
+        case LOAD_SUBSCR2: return "LOAD_SUBSCR2";
+        case LOAD_SUBSCR_UNCHECKED: return "LOAD_SUBSCR_UNCHECKED";
+        case STORE_SUBSCR_UNCHECKED: return "STORE_SUBSCR_UNCHECKED";
+        case GUARD_INDEX: return "GUARD_INDEX";
+        case GUARD_LENGTH: return "GUARD_LENGTH";
+        case REUSE_TYPED_ARRAY: return "REUSE_TYPED_ARRAY";
+        case BUILD_STRUCT: return "BUILD_STRUCT";
+        case BUILD_STRUCT_ARRAY: return "BUILD_STRUCT_ARRAY";
+        case LOAD_FIELD: return "LOAD_FIELD";
+        case STORE_FIELD: return "STORE_FIELD";
         case DEL_SUBSCR: return "DEL_SUBSCR";
         case RETURN_VALUE: return "RETURN_VALUE";
         case NOP: return "NOP";
@@ -49,6 +60,9 @@ const char* bytecode_opcode_to_string(uint8_t op_code) {
         case LOOP_START: return "LOOP_START";
         case LOOP_END: return "LOOP_END";
         case BUILD_ARRAY: return "BUILD_ARRAY";
+        case BUILD_TYPED_ARRAY: return "BUILD_TYPED_ARRAY";
+        case BUILD_ARRAY2: return "BUILD_ARRAY2";
+        case SORT_ARRAY: return "SORT_ARRAY";
         default: return "UNKNOWN";
     }
 }
@@ -161,8 +175,29 @@ void bytecode_print(bytecode* bc) {
         case BUILD_ARRAY:
             DPRINT("| element_count: %u ", arg);
             break;
+        case BUILD_TYPED_ARRAY:
+        case BUILD_ARRAY2:
+            DPRINT("| element_kind: %u ", arg);
+            break;
+        case REUSE_TYPED_ARRAY:
+            DPRINT("| local: %u, element_kind: %u ", arg >> 8, arg & 0xFF);
+            break;
+        case BUILD_STRUCT:
+        case BUILD_STRUCT_ARRAY:
+            DPRINT("| field_count: %u ", arg);
+            break;
+        case LOAD_FIELD:
+        case STORE_FIELD:
+            DPRINT("| offset: %u ", arg);
+            break;
         case LOAD_SUBSCR:
         case STORE_SUBSCR:
+        case LOAD_SUBSCR2:
+        case STORE_SUBSCR2:
+        case LOAD_SUBSCR_UNCHECKED:
+        case STORE_SUBSCR_UNCHECKED:
+        case GUARD_INDEX:
+        case GUARD_LENGTH:
         case DEL_SUBSCR:
             DPRINT("| no additional info", arg);
             break;
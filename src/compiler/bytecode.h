@@ -15,8 +15,27 @@
 #define TO_INT 0x0B
 #define TO_LONG 0x0C
 #define BUILD_ARRAY 0x17
+#define BUILD_TYPED_ARRAY 0x26
+#define BUILD_ARRAY2 0x29
 #define STORE_SUBSCR 0x0D
 #define LOAD_SUBSCR 0x18
+#define STORE_SUBSCR2 0x28
+#define LOAD_SUBSCR2 0x27
+// Emitted only by the JIT's bounds pass (src/runtime/jit/bounds.c), inside
+// loops whose guards have proven every index in range.
+#define LOAD_SUBSCR_UNCHECKED 0x2A
+#define STORE_SUBSCR_UNCHECKED 0x2B
+#define GUARD_INDEX 0x2C
+#define GUARD_LENGTH 0x2D
+// Emitted only by the JIT's escape pass (src/runtime/jit/escape.c) in place
+// of BUILD_TYPED_ARRAY for a scratch array; arg is local << 8 | kind.
+#define REUSE_TYPED_ARRAY 0x2E
+// struct records: arg of BUILD_STRUCT / BUILD_STRUCT_ARRAY is the field
+// count, arg of LOAD_FIELD / STORE_FIELD the field's offset in its layout.
+#define BUILD_STRUCT 0x2F
+#define BUILD_STRUCT_ARRAY 0x32
+#define LOAD_FIELD 0x30
+#define STORE_FIELD 0x31
 #define DEL_SUBSCR 0x0E
 #define CALL_FUNCTION 0x09
 #define RETURN_VALUE 0x0F
@@ -41,6 +60,14 @@
 #define CONTINUE_LOOP 0x44
 #define COMPARE_AND_SWAP 0xF0
 #define SWAP_ARRAY_ELEMENTS 0xF1
+#define SORT_ARRAY 0xF2
+
+// Element storage of an array; the argument of BUILD_TYPED_ARRAY and BUILD_ARRAY2.
+typedef enum {
+    ARRAY_BOXED,    // Object* per element
+    ARRAY_INT,      // int64_t per element
+    ARRAY_BOOL,     // uint8_t per element
+} ArrayKind;
 
 
 typedef struct __attribute__((packed, aligned(1))) {
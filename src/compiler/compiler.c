@@ -1,16 +1,19 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "../system.h"
 #include "../lexer/token.h"
 #include "compiler.h"
 #include "scope.h"
 #include "string_table.h"
+#include "../builtins/builtins.h"
 
 static bytecode_array compiler_compile_expression(compiler* comp, ASTNode* node);
 static bytecode_array compiler_compile_statement(compiler* comp, ASTNode* node);
 static bytecode_array compiler_compile_block_statement(compiler* comp, ASTNode* node);
+static bool compiler_resolve_field(compiler* comp, FieldExpression* field, uint32_t* offset);
 
 static bytecode_array concat_bytecode_arrays(bytecode_array a, bytecode_array b) {
     size_t total_count = a.count + b.count;
@@ -30,9 +33,27 @@ static bytecode_array concat_bytecode_arrays(bytecode_array a, bytecode_array b)
 static void emit_bytecode(compilation_result* result, bytecode_array array) {
     if (!array.bytecodes || array.count == 0) return;
     
-    bytecode_array new_array = concat_bytecode_arrays(result->code_array, array);
-    free_bytecode_array(result->code_array);
-    result->code_array = new_array;
+    bytecode_array* code = &result->code_array;
+    if (code->count + array.count > code->capacity) {
+        uint32_t new_capacity = code->capacity == 0 ? 64 : code->capacity * 2;
+        while (new_capacity < code->count + array.count) new_capacity *= 2;
+        
+        bytecode* grown = realloc(code->bytecodes, new_capacity * sizeof(bytecode));
+        if (!grown) return;
+        code->bytecodes = grown;
+        code->capacity = new_capacity;
+    }
+    
+    memcpy(code->bytecodes + code->count, array.bytecodes, array.count * sizeof(bytecode));
+    code->count += array.count;
+}
+
+static void* compiler_scratch_alloc(compiler* comp, size_t size) {
+    return comp->arena ? arena_alloc(comp->arena, size) : malloc(size);
+}
+
+static void compiler_scratch_free(compiler* comp, void* ptr) {
+    if (!comp->arena) free(ptr);
 }
 
 static void emit_single_bytecode(compilation_result* result, bytecode bc) {
@@ -45,10 +66,12 @@ static void emit_single_bytecode(compilation_result* result, bytecode bc) {
 static size_t compiler_add_constant(compilation_result* result, Value value) {
     if (!result) return SIZE_MAX;
     
-    for (size_t i = 0; i < result->constants_count; i++) {
-        if (values_equal(result->constants[i], value)) {
-            return i;
+    size_t existing = const_index_find(&result->constants_index, result->constants, value);
+    if (existing != SIZE_MAX) {
+        if (value.type == VAL_FLOAT) {
+            value_free(value);
         }
+        return existing;
     }
     
     if (result->constants_count >= result->constants_capacity) {
@@ -61,6 +84,7 @@ static size_t compiler_add_constant(compilation_result* result, Value value) {
     }
     
     result->constants[result->constants_count] = value;
+    const_index_insert(&result->constants_index, result->constants, result->constants_count);
     return result->constants_count++;
 }
 
@@ -68,10 +92,49 @@ static size_t compiler_add_constant_to_compiler(compiler* comp, Value value) {
     return compiler_add_constant(comp->result, value);
 }
 
+static int32_t compiler_add_pending_global(compiler* comp, const char* name, bool defines) {
+    for (size_t i = 0; i < comp->pending_count; i++) {
+        if (comp->pending[i].defines == defines && strcmp(comp->pending[i].name, name) == 0) {
+            return (int32_t)(comp->globals_snapshot + i);
+        }
+    }
+
+    if (comp->pending_count == comp->pending_capacity) {
+        size_t new_capacity = comp->pending_capacity == 0 ? 8 : comp->pending_capacity * 2;
+        pending_global* grown = realloc(comp->pending, new_capacity * sizeof(pending_global));
+        if (!grown) return -1;
+        comp->pending = grown;
+        comp->pending_capacity = new_capacity;
+    }
+
+    comp->pending[comp->pending_count].name = strdup(name);
+    comp->pending[comp->pending_count].defines = defines;
+    return (int32_t)(comp->globals_snapshot + comp->pending_count++);
+}
+
+/* index of an existing global, or -1; workers answer with a placeholder */
+static int32_t compiler_find_global(compiler* comp, const char* name) {
+    int32_t index = string_table_find(comp->global_names, name);
+    if (index >= 0 || !comp->is_worker) return index;
+
+    for (size_t i = 0; i < comp->pending_count; i++) {
+        if (comp->pending[i].defines && strcmp(comp->pending[i].name, name) == 0) {
+            return (int32_t)(comp->globals_snapshot + i);
+        }
+    }
+    return compiler_add_pending_global(comp, name, false);
+}
+
 static size_t compiler_add_global_name(compiler* comp, const char* name) {
     if (!comp->global_names) {
         comp->global_names = string_table_create();
     }
+    if (comp->is_worker) {
+        int32_t index = string_table_find(comp->global_names, name);
+        if (index >= 0) return (size_t)index;
+        index = compiler_add_pending_global(comp, name, true);
+        return index >= 0 ? (size_t)index : SIZE_MAX;
+    }
     return string_table_add(comp->global_names, name);
 }
 
@@ -93,17 +156,35 @@ static size_t compiler_resolve_variable(compiler* comp, const char* name) {
     return compiler_add_global_name(comp, name);
 }
 
-static bytecode_array compiler_compile_function_declaration(compiler* comp, ASTNode* node) {
-    FunctionDeclarationStatement* func_decl = (FunctionDeclarationStatement*)node;
-    if (node->node_type != NODE_FUNCTION_DECLARATION_STATEMENT) {
-        return create_bytecode_array(NULL, 0);
+static int32_t compiler_find_struct(compiler* comp, const char* name) {
+    for (size_t i = 0; i < comp->struct_count; i++) {
+        if (strcmp(comp->structs[i].name, name) == 0) return (int32_t)i;
+    }
+    return -1;
+}
+
+static void compiler_add_struct(compiler* comp, StructDeclarationStatement* decl) {
+    if (compiler_find_struct(comp, decl->name) >= 0) {
+        fprintf(stderr, "Error: struct '%s' is already defined\n", decl->name);
+        return;
+    }
+    if (comp->struct_count == comp->struct_capacity) {
+        size_t new_capacity = comp->struct_capacity == 0 ? 4 : comp->struct_capacity * 2;
+        struct_layout* grown = realloc(comp->structs, new_capacity * sizeof(struct_layout));
+        if (!grown) return;
+        comp->structs = grown;
+        comp->struct_capacity = new_capacity;
     }
+    comp->structs[comp->struct_count++] = (struct_layout){decl->name, decl->fields, decl->field_count};
+}
 
+static CodeObj* compiler_compile_function_body(compiler* comp, FunctionDeclarationStatement* func_decl) {
     compilation_result* body_result = malloc(sizeof(compilation_result));
     body_result->code_array = create_bytecode_array(NULL, 0);
     body_result->constants = NULL;
     body_result->constants_count = 0;
-        body_result->constants_capacity = 0;
+    body_result->constants_capacity = 0;
+    const_index_init(&body_result->constants_index);
     
     CompilerScope* previous_scope = comp->current_scope;
     compilation_result* previous_result = comp->result;
@@ -113,7 +194,15 @@ static bytecode_array compiler_compile_function_declaration(compiler* comp, ASTN
     
     for (size_t i = 0; i < func_decl->parameter_count; i++) {
         Parameter* param = &func_decl->parameters[i];
-        scope_add_local(comp->current_scope, param->name);
+        size_t local = scope_add_local(comp->current_scope, param->name);
+        if (param->struct_name) {
+            int32_t layout = compiler_find_struct(comp, param->struct_name);
+            if (layout < 0) {
+                fprintf(stderr, "Error: struct '%s' is not defined\n", param->struct_name);
+            } else {
+                scope_set_struct(comp->current_scope, local, layout << 1 | param->is_array);
+            }
+        }
     }
     
     if (func_decl->body != NULL) {
@@ -139,7 +228,7 @@ static bytecode_array compiler_compile_function_declaration(compiler* comp, ASTN
         }
     }
 
-    CodeObj* code_obj = malloc(sizeof(CodeObj));
+    CodeObj* code_obj = calloc(1, sizeof(CodeObj));
     code_obj->code = body_result->code_array;
     code_obj->name = strdup(func_decl->name);
     code_obj->arg_count = func_decl->parameter_count;
@@ -147,11 +236,19 @@ static bytecode_array compiler_compile_function_declaration(compiler* comp, ASTN
     code_obj->constants = body_result->constants;
     code_obj->constants_count = body_result->constants_count;
     
-    Value code_value = value_create_code(code_obj);
-    
+    const_index_free(&body_result->constants_index);
+    scope_destroy(comp->current_scope);
+    free(body_result);
+
     comp->result = previous_result;
-    uint32_t code_index = compiler_add_constant(comp->result, code_value);
     comp->current_scope = previous_scope;
+    return code_obj;
+}
+
+/* LOAD_CONST <code>; MAKE_FUNCTION; STORE_FAST/STORE_GLOBAL <name> */
+static bytecode_array compiler_bind_function(compiler* comp, FunctionDeclarationStatement* func_decl, CodeObj* code_obj) {
+    Value code_value = value_create_code(code_obj);
+    uint32_t code_index = compiler_add_constant(comp->result, code_value);
     
     bytecode_array result = create_bytecode_array(NULL, 0);
     
@@ -188,11 +285,19 @@ static bytecode_array compiler_compile_function_declaration(compiler* comp, ASTN
         free_bytecode_array(store_func_array);
     }
     
-    free(body_result);
-    
     return result;
 }
 
+static bytecode_array compiler_compile_function_declaration(compiler* comp, ASTNode* node) {
+    FunctionDeclarationStatement* func_decl = (FunctionDeclarationStatement*)node;
+    if (node->node_type != NODE_FUNCTION_DECLARATION_STATEMENT) {
+        return create_bytecode_array(NULL, 0);
+    }
+
+    CodeObj* code_obj = compiler_compile_function_body(comp, func_decl);
+    return compiler_bind_function(comp, func_decl, code_obj);
+}
+
 static bytecode_array create_single_bytecode_array(bytecode bc) {
     bytecode* bc_array = malloc(sizeof(bytecode));
     bc_array[0] = bc;
@@ -228,10 +333,7 @@ static bytecode_array compiler_compile_variable_declaration(compiler* comp, ASTN
     }
     
     if (comp->current_scope == NULL || comp->current_scope->parent == NULL) {
-        int32_t global_idx = string_table_find(comp->global_names, decl->name);
-        if (global_idx < 0) {
-            global_idx = string_table_add(comp->global_names, decl->name);
-        }
+        int32_t global_idx = (int32_t)compiler_add_global_name(comp, decl->name);
         DPRINT("[COMPILER] Variable %s is global at index %d\n", decl->name, global_idx);
         
         bytecode store_global = bytecode_create_with_number(STORE_GLOBAL, global_idx);
@@ -300,8 +402,8 @@ static bytecode_array compiler_compile_if_statement(compiler* comp, ASTNode* nod
     bytecode_array* elif_cond_bc = NULL;
     bytecode_array* elif_branch_bc = NULL;
     if (if_stmt->elif_count > 0) {
-        elif_cond_bc = malloc(if_stmt->elif_count * sizeof(bytecode_array));
-        elif_branch_bc = malloc(if_stmt->elif_count * sizeof(bytecode_array));
+        elif_cond_bc = compiler_scratch_alloc(comp, if_stmt->elif_count * sizeof(bytecode_array));
+        elif_branch_bc = compiler_scratch_alloc(comp, if_stmt->elif_count * sizeof(bytecode_array));
         
         for (size_t i = 0; i < if_stmt->elif_count; i++) {
             elif_cond_bc[i] = compiler_compile_expression(comp, if_stmt->elif_conditions[i]);
@@ -386,8 +488,8 @@ static bytecode_array compiler_compile_if_statement(compiler* comp, ASTNode* nod
     temp_code.bytecodes[jump_forward_pos] = bytecode_create_with_number(JUMP_FORWARD, jump_forward_offset);
     
     if (if_stmt->elif_count > 0) {
-        free(elif_cond_bc);
-        free(elif_branch_bc);
+        compiler_scratch_free(comp, elif_cond_bc);
+        compiler_scratch_free(comp, elif_branch_bc);
     }
     
     return temp_code;
@@ -569,6 +671,28 @@ static bytecode_array compiler_compile_for_statement(compiler* comp, ASTNode* no
     return result;
 }
 
+// Pushes the operands of a[i], or of a[i][j] as array, i, j. Returns true
+// for the two-index form, which loads and stores through the *_SUBSCR2 ops.
+static bool compiler_compile_subscript_operands(compiler* comp, SubscriptExpression* subscript, bytecode_array* result) {
+    bool two_indices = subscript->array->node_type == NODE_SUBSCRIPT_EXPRESSION;
+    SubscriptExpression* inner = (SubscriptExpression*)subscript->array;
+    
+    bytecode_array array_bc = compiler_compile_expression(comp, two_indices ? inner->array : subscript->array);
+    *result = concat_bytecode_arrays(*result, array_bc);
+    free_bytecode_array(array_bc);
+    
+    if (two_indices) {
+        bytecode_array row_bc = compiler_compile_expression(comp, inner->index);
+        *result = concat_bytecode_arrays(*result, row_bc);
+        free_bytecode_array(row_bc);
+    }
+    
+    bytecode_array index_bc = compiler_compile_expression(comp, subscript->index);
+    *result = concat_bytecode_arrays(*result, index_bc);
+    free_bytecode_array(index_bc);
+    return two_indices;
+}
+
 static bytecode_array compiler_compile_assignment_statement(compiler* comp, ASTNode* node) {
     if (node->node_type != NODE_ASSIGNMENT_STATEMENT) {
         return create_bytecode_array(NULL, 0);
@@ -588,22 +712,30 @@ static bytecode_array compiler_compile_assignment_statement(compiler* comp, ASTN
         DPRINT("[COMPILER] Assignment to array element\n");
         SubscriptExpression* subscript = (SubscriptExpression*)assign->left;
         
-        DPRINT("[COMPILER] Compiling array expression\n");
-        bytecode_array array_bc = compiler_compile_expression(comp, subscript->array);
-        result = concat_bytecode_arrays(result, array_bc);
-        free_bytecode_array(array_bc);
-        
-        DPRINT("[COMPILER] Compiling index expression\n");
-        bytecode_array index_bc = compiler_compile_expression(comp, subscript->index);
-        result = concat_bytecode_arrays(result, index_bc);
-        free_bytecode_array(index_bc);
+        bool two_indices = compiler_compile_subscript_operands(comp, subscript, &result);
         
-        DPRINT("[COMPILER] Adding STORE_SUBSCR instruction\n");
-        bytecode store_subscr_bc = bytecode_create(STORE_SUBSCR, 0, 0, 0);
+        DPRINT("[COMPILER] Adding %s instruction\n", two_indices ? "STORE_SUBSCR2" : "STORE_SUBSCR");
+        bytecode store_subscr_bc = bytecode_create(two_indices ? STORE_SUBSCR2 : STORE_SUBSCR, 0, 0, 0);
         bytecode_array store_subscr_array = create_single_bytecode_array(store_subscr_bc);
         result = concat_bytecode_arrays(result, store_subscr_array);
         free_bytecode_array(store_subscr_array);
         
+    } else if (assign->left->node_type == NODE_FIELD_EXPRESSION) {
+        DPRINT("[COMPILER] Assignment to struct field\n");
+        FieldExpression* field = (FieldExpression*)assign->left;
+        
+        uint32_t offset;
+        bytecode store_field_bc = bytecode_create(NOP, 0, 0, 0);
+        if (compiler_resolve_field(comp, field, &offset)) {
+            bytecode_array object_bc = compiler_compile_expression(comp, field->object);
+            result = concat_bytecode_arrays(result, object_bc);
+            free_bytecode_array(object_bc);
+            store_field_bc = bytecode_create_with_number(STORE_FIELD, offset);
+        }
+        bytecode_array store_field_array = create_single_bytecode_array(store_field_bc);
+        result = concat_bytecode_arrays(result, store_field_array);
+        free_bytecode_array(store_field_array);
+        
     } else if (assign->left->node_type == NODE_VARIABLE_EXPRESSION) {
         DPRINT("[COMPILER] Assignment to variable\n");
         VariableExpression* var_expr = (VariableExpression*)assign->left;
@@ -617,10 +749,7 @@ static bytecode_array compiler_compile_assignment_statement(compiler* comp, ASTN
             free_bytecode_array(store_array);
         } else {
             DPRINT("[COMPILER] Storing in global variable %s\n", var_expr->name);
-            int32_t global_idx = string_table_find(comp->global_names, var_expr->name);
-            if (global_idx < 0) {
-                global_idx = string_table_add(comp->global_names, var_expr->name);
-            }
+            int32_t global_idx = (int32_t)compiler_add_global_name(comp, var_expr->name);
             bytecode store_bc = bytecode_create_with_number(STORE_GLOBAL, (uint32_t)global_idx);
             bytecode_array store_array = create_single_bytecode_array(store_bc);
             result = concat_bytecode_arrays(result, store_array);
@@ -779,7 +908,7 @@ static bytecode_array compiler_compile_variable_expression(compiler* comp, ASTNo
         return create_bytecode_array(bc_array, 1);
     }
 
-    int32_t global_index = string_table_find(comp->global_names, var_expr->name);
+    int32_t global_index = compiler_find_global(comp, var_expr->name);
     if (global_index >= 0) {
         bytecode bc = bytecode_create_with_number(LOAD_GLOBAL, global_index << 1);
         bytecode* bc_array = malloc(sizeof(bytecode));
@@ -908,15 +1037,21 @@ static bytecode_array compiler_compile_array_declaration(compiler* comp, ASTNode
     
     bytecode_array result = create_bytecode_array(NULL, 0);
     
-    if (array_decl->size) {
-        bytecode_array size_bc = compiler_compile_expression(comp, array_decl->size);
-        result = concat_bytecode_arrays(result, size_bc);
-        free_bytecode_array(size_bc);
-    } else {
-        bytecode zero_bc = bytecode_create_with_number(LOAD_CONST, 0);
-        bytecode_array zero_array = create_single_bytecode_array(zero_bc);
-        result = concat_bytecode_arrays(result, zero_array);
-        free_bytecode_array(zero_array);
+    // the sizes only feed BUILD_*; an initializer brings its own array
+    bool two_dims = array_decl->columns != NULL;
+    ASTNode* dims[2] = {array_decl->size, array_decl->columns};
+    for (int d = 0; !array_decl->initializer && d < (two_dims ? 2 : 1); d++) {
+        if (dims[d]) {
+            bytecode_array size_bc = compiler_compile_expression(comp, dims[d]);
+            result = concat_bytecode_arrays(result, size_bc);
+            free_bytecode_array(size_bc);
+        } else {
+            uint32_t zero_index = compiler_add_constant_to_compiler(comp, value_create_int(0));
+            bytecode zero_bc = bytecode_create_with_number(LOAD_CONST, zero_index);
+            bytecode_array zero_array = create_single_bytecode_array(zero_bc);
+            result = concat_bytecode_arrays(result, zero_array);
+            free_bytecode_array(zero_array);
+        }
     }
     
     if (array_decl->initializer) {
@@ -924,7 +1059,21 @@ static bytecode_array compiler_compile_array_declaration(compiler* comp, ASTNode
         result = concat_bytecode_arrays(result, init_bc);
         free_bytecode_array(init_bc);
     } else {
-        bytecode create_bc = bytecode_create_with_number(BUILD_ARRAY, 0);
+        // int and bool elements are stored unboxed; floats stay BigFloat objects
+        ArrayKind kind = ARRAY_BOXED;
+        if (array_decl->element_type == TYPE_INT || array_decl->element_type == TYPE_LONG) {
+            kind = ARRAY_INT;
+        } else if (array_decl->element_type == TYPE_BOOL) {
+            kind = ARRAY_BOOL;
+        }
+        bytecode create_bc;
+        if (two_dims) {
+            create_bc = bytecode_create_with_number(BUILD_ARRAY2, kind);
+        } else if (kind != ARRAY_BOXED) {
+            create_bc = bytecode_create_with_number(BUILD_TYPED_ARRAY, kind);
+        } else {
+            create_bc = bytecode_create_with_number(BUILD_ARRAY, 0);
+        }
         bytecode_array create_array = create_single_bytecode_array(create_bc);
         result = concat_bytecode_arrays(result, create_array);
         free_bytecode_array(create_array);
@@ -981,15 +1130,9 @@ static bytecode_array compiler_compile_subscript_expression(compiler* comp, ASTN
     
     bytecode_array result = create_bytecode_array(NULL, 0);
     
-    bytecode_array array_bc = compiler_compile_expression(comp, subscript_expr->array);
-    result = concat_bytecode_arrays(result, array_bc);
-    free_bytecode_array(array_bc);
-    
-    bytecode_array index_bc = compiler_compile_expression(comp, subscript_expr->index);
-    result = concat_bytecode_arrays(result, index_bc);
-    free_bytecode_array(index_bc);
+    bool two_indices = compiler_compile_subscript_operands(comp, subscript_expr, &result);
     
-    bytecode load_subscr_bc = bytecode_create(LOAD_SUBSCR, 0, 0, 0);
+    bytecode load_subscr_bc = bytecode_create(two_indices ? LOAD_SUBSCR2 : LOAD_SUBSCR, 0, 0, 0);
     bytecode_array load_array = create_single_bytecode_array(load_subscr_bc);
     result = concat_bytecode_arrays(result, load_array);
     free_bytecode_array(load_array);
@@ -997,6 +1140,108 @@ static bytecode_array compiler_compile_subscript_expression(compiler* comp, ASTN
     return result;
 }
 
+static bytecode_array compiler_compile_struct_variable_declaration(compiler* comp, ASTNode* node) {
+    StructVariableDeclarationStatement* decl = (StructVariableDeclarationStatement*)node;
+    int32_t layout_index = compiler_find_struct(comp, decl->struct_name);
+    if (layout_index < 0) {
+        fprintf(stderr, "Error: struct '%s' is not defined\n", decl->struct_name);
+        return create_single_bytecode_array(bytecode_create(NOP, 0, 0, 0));
+    }
+    const struct_layout* layout = &comp->structs[layout_index];
+    DPRINT("[COMPILER] Struct %s variable '%s'\n", layout->name, decl->name);
+
+    bytecode_array result = create_bytecode_array(NULL, 0);
+    if (decl->initializer) {
+        // binds an existing record or struct array; nothing is allocated
+        bytecode_array init_bc = compiler_compile_expression(comp, decl->initializer);
+        result = concat_bytecode_arrays(result, init_bc);
+        free_bytecode_array(init_bc);
+    } else {
+        // every record starts out as the zero of each field's type
+        for (size_t i = 0; i < layout->field_count; i++) {
+            Value zero;
+            switch (layout->fields[i].type) {
+                case TYPE_BOOL:  zero = value_create_bool(false); break;
+                case TYPE_FLOAT: zero = value_create_float("0.0"); break;
+                default:         zero = value_create_int(0); break;
+            }
+            uint32_t zero_index = compiler_add_constant_to_compiler(comp, zero);
+            bytecode_array zero_array = create_single_bytecode_array(bytecode_create_with_number(LOAD_CONST, zero_index));
+            result = concat_bytecode_arrays(result, zero_array);
+            free_bytecode_array(zero_array);
+        }
+
+        if (decl->is_array) {
+            bytecode_array size_bc;
+            if (decl->size) {
+                size_bc = compiler_compile_expression(comp, decl->size);
+            } else {
+                uint32_t zero_index = compiler_add_constant_to_compiler(comp, value_create_int(0));
+                size_bc = create_single_bytecode_array(bytecode_create_with_number(LOAD_CONST, zero_index));
+            }
+            result = concat_bytecode_arrays(result, size_bc);
+            free_bytecode_array(size_bc);
+        }
+
+        bytecode build_bc = bytecode_create_with_number(decl->is_array ? BUILD_STRUCT_ARRAY : BUILD_STRUCT,
+                                                        (uint32_t)layout->field_count);
+        bytecode_array build_array = create_single_bytecode_array(build_bc);
+        result = concat_bytecode_arrays(result, build_array);
+        free_bytecode_array(build_array);
+    }
+
+    size_t var_index = scope_add_local(comp->current_scope, decl->name);
+    if (var_index == SIZE_MAX) {
+        free_bytecode_array(result);
+        return create_bytecode_array(NULL, 0);
+    }
+    scope_set_struct(comp->current_scope, var_index, layout_index << 1 | decl->is_array);
+
+    bytecode_array store_array = create_single_bytecode_array(bytecode_create_with_number(STORE_FAST, (uint32_t)var_index));
+    result = concat_bytecode_arrays(result, store_array);
+    free_bytecode_array(store_array);
+    return result;
+}
+
+// Offset of field->field in the record field->object evaluates to: a struct
+// variable s, or an element ps[i] of a struct array.
+static bool compiler_resolve_field(compiler* comp, FieldExpression* field, uint32_t* offset) {
+    ASTNode* object = field->object;
+    bool element = object->node_type == NODE_SUBSCRIPT_EXPRESSION;
+    if (element) object = ((SubscriptExpression*)object)->array;
+
+    int32_t tag = object->node_type == NODE_VARIABLE_EXPRESSION
+                      ? scope_find_struct(comp->current_scope, ((VariableExpression*)object)->name)
+                      : -1;
+    if (tag < 0 || (tag & 1) != element) {
+        fprintf(stderr, "Error: field '%s' accessed on something that is not a struct\n", field->field);
+        return false;
+    }
+
+    const struct_layout* layout = &comp->structs[tag >> 1];
+    for (size_t i = 0; i < layout->field_count; i++) {
+        if (strcmp(layout->fields[i].name, field->field) == 0) {
+            *offset = (uint32_t)i;
+            return true;
+        }
+    }
+    fprintf(stderr, "Error: struct '%s' has no field '%s'\n", layout->name, field->field);
+    return false;
+}
+
+static bytecode_array compiler_compile_field_expression(compiler* comp, ASTNode* node) {
+    FieldExpression* field = (FieldExpression*)node;
+    uint32_t offset;
+    if (!compiler_resolve_field(comp, field, &offset)) {
+        return create_single_bytecode_array(bytecode_create(NOP, 0, 0, 0));
+    }
+
+    bytecode_array result = compiler_compile_expression(comp, field->object);
+    bytecode_array load_array = create_single_bytecode_array(bytecode_create_with_number(LOAD_FIELD, offset));
+    result = concat_bytecode_arrays(result, load_array);
+    free_bytecode_array(load_array);
+    return result;
+}
 
 static bytecode_array compiler_compile_expression(compiler* comp, ASTNode* node) {
     if (!node) return create_bytecode_array(NULL, 0);
@@ -1017,6 +1262,8 @@ static bytecode_array compiler_compile_expression(compiler* comp, ASTNode* node)
             return compiler_compile_array_expression(comp, node);
         case NODE_SUBSCRIPT_EXPRESSION:
             return compiler_compile_subscript_expression(comp, node);
+        case NODE_FIELD_EXPRESSION:
+            return compiler_compile_field_expression(comp, node);
         default:
             fprintf(stderr, "[COMPILER] Unknown expression node type: %s\n", ast_node_type_to_string(node->node_type));
             return create_bytecode_array(NULL, 0);
@@ -1054,17 +1301,29 @@ static bytecode_array compiler_compile_block_statement(compiler* comp, ASTNode*
     }
 
     BlockStatement* block = (BlockStatement*)node;
-    bytecode_array result = create_bytecode_array(NULL, 0);
+    if (block->statement_count == 0) {
+        return create_bytecode_array(NULL, 0);
+    }
 
-    for (uint32_t i = 0; i < block->statement_count; i++) {
-        bytecode_array stmt_bc = compiler_compile_statement(comp, block->statements[i]);
-        bytecode_array new_result = concat_bytecode_arrays(result, stmt_bc);
-        free_bytecode_array(result);
-        free_bytecode_array(stmt_bc);
-        result = new_result;
+    bytecode_array* parts = compiler_scratch_alloc(comp, block->statement_count * sizeof(bytecode_array));
+    size_t total_count = 0;
+    for (size_t i = 0; i < block->statement_count; i++) {
+        parts[i] = compiler_compile_statement(comp, block->statements[i]);
+        total_count += parts[i].count;
     }
 
-    return result;
+    bytecode* joined = total_count > 0 ? malloc(total_count * sizeof(bytecode)) : NULL;
+    size_t offset = 0;
+    for (size_t i = 0; i < block->statement_count; i++) {
+        if (joined && parts[i].count > 0) {
+            memcpy(joined + offset, parts[i].bytecodes, parts[i].count * sizeof(bytecode));
+            offset += parts[i].count;
+        }
+        free_bytecode_array(parts[i]);
+    }
+    compiler_scratch_free(comp, parts);
+
+    return create_bytecode_array(joined, (uint32_t)offset);
 }
 
 static bytecode_array compiler_compile_break_statement(compiler* comp, ASTNode* node) {
@@ -1115,6 +1374,11 @@ static bytecode_array compiler_compile_statement(compiler* comp, ASTNode* statem
             return compiler_compile_break_statement(comp, statement);
         case NODE_CONTINUE_STATEMENT:
             return compiler_compile_continue_statement(comp, statement);
+        case NODE_STRUCT_DECLARATION_STATEMENT:
+            // the layout was recorded by compiler_collect_declarations
+            return create_bytecode_array(NULL, 0);
+        case NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT:
+            return compiler_compile_struct_variable_declaration(comp, statement);
         default:
             fprintf(stderr, "[COMPILER] Unknown statement node type: %s\n", ast_node_type_to_string(statement->node_type));
             return create_bytecode_array(NULL, 0);
@@ -1138,8 +1402,19 @@ compiler* compiler_create(ASTNode* ast_tree) {
     comp->result->constants = NULL;
     comp->result->constants_count = 0;
     comp->result->constants_capacity = 0;
+    const_index_init(&comp->result->constants_index);
     
     comp->global_names = NULL;
+    comp->structs = NULL;
+    comp->struct_count = 0;
+    comp->struct_capacity = 0;
+    comp->arena = NULL;
+    comp->threads = 1;
+    comp->is_worker = false;
+    comp->globals_snapshot = 0;
+    comp->pending = NULL;
+    comp->pending_count = 0;
+    comp->pending_capacity = 0;
     comp->current_scope = scope_create(NULL);
     if (!comp->current_scope) {
         free(comp->result);
@@ -1148,32 +1423,49 @@ compiler* compiler_create(ASTNode* ast_tree) {
     }
 
     comp->global_names = string_table_create();
-    size_t print_idx = string_table_add(comp->global_names, "print");
-    size_t input_idx = string_table_add(comp->global_names, "input");
-    size_t randint_idx = string_table_add(comp->global_names, "randint");
-    size_t sqrt_idx = string_table_add(comp->global_names, "sqrt");
-
-    if (print_idx != 0) {
-        DPRINT("Warning: print index is %zu, expected 0\n", print_idx);
-    }
-    if (input_idx != 1) {
-        DPRINT("Warning: input index is %zu, expected 1\n", input_idx);
-    }
-    if (randint_idx != 2) {
-        DPRINT("Warning: randint index is %zu, expected 2\n", randint_idx);
-    }
-    if (sqrt_idx != 3) {
-        DPRINT("Warning: sqrt index is %zu, expected 3\n", sqrt_idx);
+    static const char* builtin_names[BUILTIN_COUNT] = {
+#define BUILTIN_NAME(name) #name,
+        BUILTIN_LIST(BUILTIN_NAME)
+#undef BUILTIN_NAME
+    };
+    for (size_t i = 0; i < BUILTIN_COUNT; i++) {
+        size_t idx = string_table_add(comp->global_names, builtin_names[i]);
+        if (idx != i) {
+            DPRINT("Warning: %s index is %zu, expected %zu\n", builtin_names[i], idx, i);
+        }
     }
 
     return comp;
 }
 
+void compiler_set_arena(compiler* comp, Arena* arena) {
+    if (!comp) return;
+    comp->arena = arena;
+}
+
+void compiler_set_threads(compiler* comp, size_t threads) {
+    if (!comp) return;
+    comp->threads = threads == 0 ? 1 : threads;
+}
+
+void compiler_release_arena(compiler* comp) {
+    if (!comp || !comp->arena) return;
+    
+    /* the AST lives in the arena, so it goes with it */
+    if (comp->ast_tree && comp->ast_tree->arena_owned) {
+        comp->ast_tree = NULL;
+    }
+    arena_destroy(comp->arena);
+    comp->arena = NULL;
+}
+
 void compiler_destroy(compiler* comp) {
     if (!comp) return;
+    compiler_release_arena(comp);
     if (comp->result) {
         free_bytecode_array(comp->result->code_array);
         free(comp->result->constants);
+        const_index_free(&comp->result->constants_index);
         free(comp->result);
     }
     
@@ -1184,6 +1476,7 @@ void compiler_destroy(compiler* comp) {
     if (comp->current_scope) {
         scope_destroy(comp->current_scope);
     }
+    free(comp->structs);
     if (comp->ast_tree) {
         ast_free(comp->ast_tree);
     }
@@ -1198,6 +1491,9 @@ static void compiler_collect_declarations(compiler* comp, ASTNode* node) {
         FunctionDeclarationStatement* func_decl = (FunctionDeclarationStatement*)node;
         compiler_add_global_name(comp, func_decl->name);
     }
+    else if (node->node_type == NODE_STRUCT_DECLARATION_STATEMENT) {
+        compiler_add_struct(comp, (StructDeclarationStatement*)node);
+    }
     else if (node->node_type == NODE_BLOCK_STATEMENT) {
         BlockStatement* block = (BlockStatement*)node;
         for (size_t i = 0; i < block->statement_count; i++) {
@@ -1206,6 +1502,156 @@ static void compiler_collect_declarations(compiler* comp, ASTNode* node) {
     }
 }
 
+typedef struct function_job {
+    FunctionDeclarationStatement* func_decl;
+    CodeObj* code;
+    pending_global* pending;
+    size_t pending_count;
+} function_job;
+
+typedef struct function_job_queue {
+    compiler* parent;
+    function_job* jobs;
+    size_t job_count;
+    size_t next_job;
+    size_t globals_snapshot;
+} function_job_queue;
+
+static void* compiler_function_worker(void* arg) {
+    function_job_queue* queue = arg;
+
+    for (;;) {
+        size_t index = __atomic_fetch_add(&queue->next_job, 1, __ATOMIC_RELAXED);
+        if (index >= queue->job_count) break;
+        function_job* job = &queue->jobs[index];
+
+        /* private emitter and constant pool; global_names is only read */
+        compiler worker = {0};
+        worker.global_names = queue->parent->global_names;
+        worker.current_scope = queue->parent->current_scope;
+        worker.structs = queue->parent->structs;
+        worker.struct_count = queue->parent->struct_count;
+        worker.threads = 1;
+        worker.is_worker = true;
+        worker.globals_snapshot = queue->globals_snapshot;
+
+        job->code = compiler_compile_function_body(&worker, job->func_decl);
+        job->pending = worker.pending;
+        job->pending_count = worker.pending_count;
+    }
+    return NULL;
+}
+
+static void compiler_patch_globals(CodeObj* code, const int32_t* resolved, size_t snapshot) {
+    for (uint32_t i = 0; i < code->code.count; i++) {
+        bytecode* bc = &code->code.bytecodes[i];
+        if (bc->op_code == LOAD_GLOBAL) {
+            uint32_t arg = bytecode_get_arg(*bc);
+            if ((arg >> 1) < snapshot) continue;
+            int32_t index = resolved[(arg >> 1) - snapshot];
+            *bc = index >= 0 ? bytecode_create_with_number(LOAD_GLOBAL, ((uint32_t)index << 1) | (arg & 1))
+                             : bytecode_create(NOP, 0, 0, 0);
+        } else if (bc->op_code == STORE_GLOBAL) {
+            uint32_t arg = bytecode_get_arg(*bc);
+            if (arg < snapshot) continue;
+            *bc = bytecode_create_with_number(STORE_GLOBAL, (uint32_t)resolved[arg - snapshot]);
+        }
+    }
+
+    for (size_t i = 0; i < code->constants_count; i++) {
+        if (code->constants[i].type == VAL_CODE) {
+            compiler_patch_globals(code->constants[i].code_val, resolved, snapshot);
+        }
+    }
+}
+
+/*
+ * Resolve a body's placeholders against the module's global names. Called in
+ * statement order, so names are registered exactly as a serial compile would.
+ */
+static void compiler_merge_function_job(compiler* comp, function_job* job, size_t snapshot) {
+    if (job->pending_count > 0) {
+        int32_t* resolved = malloc(job->pending_count * sizeof(int32_t));
+        for (size_t i = 0; i < job->pending_count; i++) {
+            pending_global* pending = &job->pending[i];
+            if (pending->defines) {
+                resolved[i] = (int32_t)string_table_add(comp->global_names, pending->name);
+            } else {
+                resolved[i] = string_table_find(comp->global_names, pending->name);
+                if (resolved[i] < 0) {
+                    fprintf(stderr, "Error: variable '%s' is not defined\n", pending->name);
+                }
+            }
+        }
+        compiler_patch_globals(job->code, resolved, snapshot);
+        free(resolved);
+    }
+
+    for (size_t i = 0; i < job->pending_count; i++) {
+        free(job->pending[i].name);
+    }
+    free(job->pending);
+    job->pending = NULL;
+    job->pending_count = 0;
+}
+
+static bool compiler_compile_parallel(compiler* comp, BlockStatement* module) {
+    size_t job_count = 0;
+    for (size_t i = 0; i < module->statement_count; i++) {
+        if (module->statements[i]->node_type == NODE_FUNCTION_DECLARATION_STATEMENT) job_count++;
+    }
+    if (job_count < 2) return false;
+
+    function_job* jobs = calloc(job_count, sizeof(function_job));
+    if (!jobs) return false;
+
+    size_t next = 0;
+    for (size_t i = 0; i < module->statement_count; i++) {
+        if (module->statements[i]->node_type == NODE_FUNCTION_DECLARATION_STATEMENT) {
+            jobs[next++].func_decl = (FunctionDeclarationStatement*)module->statements[i];
+        }
+    }
+
+    function_job_queue queue = {
+        .parent = comp,
+        .jobs = jobs,
+        .job_count = job_count,
+        .next_job = 0,
+        .globals_snapshot = comp->global_names->count,
+    };
+
+    /* the calling thread is one of the workers */
+    size_t extra_threads = (comp->threads < job_count ? comp->threads : job_count) - 1;
+    pthread_t* threads = malloc(extra_threads * sizeof(pthread_t));
+    size_t started = 0;
+    for (; threads && started < extra_threads; started++) {
+        if (pthread_create(&threads[started], NULL, compiler_function_worker, &queue) != 0) break;
+    }
+    compiler_function_worker(&queue);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    next = 0;
+    for (size_t i = 0; i < module->statement_count; i++) {
+        ASTNode* statement = module->statements[i];
+        bytecode_array result;
+        if (statement->node_type == NODE_FUNCTION_DECLARATION_STATEMENT) {
+            function_job* job = &jobs[next++];
+            compiler_merge_function_job(comp, job, queue.globals_snapshot);
+            result = compiler_bind_function(comp, job->func_decl, job->code);
+        } else {
+            result = compiler_compile_statement(comp, statement);
+        }
+        emit_bytecode(comp->result, result);
+        free_bytecode_array(result);
+    }
+
+    free(jobs);
+    return true;
+}
+
 compilation_result* compiler_compile(compiler* compiler) {
     if (!compiler) return NULL;
     
@@ -1217,7 +1663,11 @@ compilation_result* compiler_compile(compiler* compiler) {
 
     BlockStatement* casted = (BlockStatement*) compiler->ast_tree;
     
-    for (uint32_t i = 0; i < casted->statement_count; i++) {
+    /* debug output from several threads would interleave, so -d stays serial */
+    bool parallel = compiler->threads > 1 && !debug_enabled &&
+                    compiler_compile_parallel(compiler, casted);
+    
+    for (uint32_t i = 0; !parallel && i < casted->statement_count; i++) {
         bytecode_array result = compiler_compile_statement(compiler, casted->statements[i]);
         emit_bytecode(compiler->result, result);
         free_bytecode_array(result);
@@ -2,10 +2,12 @@
 #define COMPILER_H
 
 #include "../AST/ast.h"
+#include "../arena.h"
 #include "bytecode.h"
 #include "string_table.h"
 #include "scope.h"
 #include "value.h"
+#include "const_pool.h"
 
 typedef struct compilation_result{
     bytecode_array code_array;
@@ -13,18 +15,59 @@ typedef struct compilation_result{
     Value* constants;
     size_t constants_count;
     size_t constants_capacity;
+    const_index constants_index;
 } compilation_result;
 
+/*
+ * A global name a function body referenced while it was compiled off the
+ * main thread. Such bodies see global_names read-only and emit a placeholder
+ * index (globals_snapshot + position) that is resolved at merge time.
+ */
+typedef struct pending_global {
+    char* name;
+    bool defines;
+} pending_global;
+
+/*
+ * A declared struct: field i lives at offset i of every record. Names and
+ * fields point into the AST, which outlives compilation.
+ */
+typedef struct struct_layout {
+    const char* name;
+    const Parameter* fields;
+    size_t field_count;
+} struct_layout;
+
 typedef struct compiler {
     ASTNode* ast_tree;
     compilation_result* result;
 
     string_table* global_names;
     CompilerScope* current_scope;
+
+    /* collected before any body compiles; workers share them read-only */
+    struct_layout* structs;
+    size_t struct_count;
+    size_t struct_capacity;
+
+    Arena* arena;
+
+    /* number of threads compiling top-level function bodies; <= 1 is serial */
+    size_t threads;
+
+    /* set only on per-body worker compilers */
+    bool is_worker;
+    size_t globals_snapshot;
+    pending_global* pending;
+    size_t pending_count;
+    size_t pending_capacity;
 } compiler;
 
 compiler* compiler_create(ASTNode* ast_tree);
 void compiler_destroy(compiler* compiler);
+void compiler_set_arena(compiler* compiler, Arena* arena);
+void compiler_release_arena(compiler* compiler);
+void compiler_set_threads(compiler* compiler, size_t threads);
 compilation_result* compiler_compile(compiler* compiler);
 
 #endif
@@ -0,0 +1,82 @@
+#include "const_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CONST_INDEX_MIN_CAPACITY 16
+
+void const_index_init(const_index* index) {
+    index->slots = NULL;
+    index->capacity = 0;
+    index->count = 0;
+}
+
+void const_index_free(const_index* index) {
+    if (!index) return;
+    free(index->slots);
+    const_index_init(index);
+}
+
+static void const_index_place(uint32_t* slots, size_t capacity, uint64_t hash, uint32_t entry) {
+    size_t mask = capacity - 1;
+    size_t pos = (size_t)hash & mask;
+    while (slots[pos] != 0) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos] = entry;
+}
+
+static bool const_index_grow(const_index* index, const Value* pool) {
+    size_t new_capacity = index->capacity == 0 ? CONST_INDEX_MIN_CAPACITY : index->capacity * 2;
+    uint32_t* new_slots = calloc(new_capacity, sizeof(uint32_t));
+    if (!new_slots) return false;
+
+    for (size_t i = 0; i < index->capacity; i++) {
+        uint32_t entry = index->slots[i];
+        if (entry != 0) {
+            const_index_place(new_slots, new_capacity, value_hash(pool[entry - 1]), entry);
+        }
+    }
+
+    free(index->slots);
+    index->slots = new_slots;
+    index->capacity = new_capacity;
+    return true;
+}
+
+bool const_index_build(const_index* index, const Value* pool, size_t pool_count) {
+    const_index_free(index);
+    for (size_t i = 0; i < pool_count; i++) {
+        if (const_index_find(index, pool, pool[i]) != SIZE_MAX) continue;
+        if (!const_index_insert(index, pool, i)) return false;
+    }
+    return true;
+}
+
+size_t const_index_find(const const_index* index, const Value* pool, Value value) {
+    if (!index || index->count == 0) return SIZE_MAX;
+
+    size_t mask = index->capacity - 1;
+    size_t pos = (size_t)value_hash(value) & mask;
+    while (index->slots[pos] != 0) {
+        size_t pool_index = index->slots[pos] - 1;
+        if (values_equal(pool[pool_index], value)) {
+            return pool_index;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return SIZE_MAX;
+}
+
+bool const_index_insert(const_index* index, const Value* pool, size_t pool_index) {
+    if (!index || pool_index >= UINT32_MAX) return false;
+
+    /* keep the load factor under 1/2 so probe chains stay short */
+    if ((index->count + 1) * 2 > index->capacity) {
+        if (!const_index_grow(index, pool)) return false;
+    }
+
+    const_index_place(index->slots, index->capacity, value_hash(pool[pool_index]),
+                      (uint32_t)(pool_index + 1));
+    index->count++;
+    return true;
+}
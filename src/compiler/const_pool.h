@@ -0,0 +1,26 @@
+#ifndef CONST_POOL_H
+#define CONST_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "value.h"
+
+/*
+ * Open-addressed hash index over a Value array (a constant pool).
+ * The index does not own the pool; slots store pool index + 1, 0 is empty.
+ */
+typedef struct const_index {
+    uint32_t* slots;
+    size_t capacity;
+    size_t count;
+} const_index;
+
+void const_index_init(const_index* index);
+void const_index_free(const_index* index);
+bool const_index_build(const_index* index, const Value* pool, size_t pool_count);
+
+size_t const_index_find(const const_index* index, const Value* pool, Value value);
+bool const_index_insert(const_index* index, const Value* pool, size_t pool_index);
+
+#endif
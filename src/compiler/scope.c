@@ -5,6 +5,8 @@ CompilerScope* scope_create(CompilerScope* parent) {
     CompilerScope* scope = malloc(sizeof(CompilerScope));
     scope->locals = string_table_create();
     scope->parent = parent;
+    scope->struct_tags = NULL;
+    scope->struct_tag_count = 0;
     return scope;
 }
 
@@ -14,6 +16,7 @@ void scope_destroy(CompilerScope* scope) {
     if (scope->locals) {
         string_table_destroy(scope->locals);
     }
+    free(scope->struct_tags);
     free(scope);
 }
 
@@ -30,3 +33,25 @@ int32_t scope_find_local(CompilerScope* scope, const char* name) {
 bool scope_contains_local(CompilerScope* scope, const char* name) {
     return scope_find_local(scope, name) >= 0;
 }
+
+void scope_set_struct(CompilerScope* scope, size_t local, int32_t tag) {
+    if (!scope || local == SIZE_MAX) return;
+    if (local >= scope->struct_tag_count) {
+        size_t new_count = scope->struct_tag_count == 0 ? 8 : scope->struct_tag_count;
+        while (new_count <= local) new_count *= 2;
+        int32_t* grown = realloc(scope->struct_tags, new_count * sizeof(int32_t));
+        if (!grown) return;
+        for (size_t i = scope->struct_tag_count; i < new_count; i++) {
+            grown[i] = -1;
+        }
+        scope->struct_tags = grown;
+        scope->struct_tag_count = new_count;
+    }
+    scope->struct_tags[local] = tag;
+}
+
+int32_t scope_find_struct(CompilerScope* scope, const char* name) {
+    int32_t local = scope_find_local(scope, name);
+    if (local < 0 || (size_t)local >= scope->struct_tag_count) return -1;
+    return scope->struct_tags[local];
+}
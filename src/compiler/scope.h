@@ -6,6 +6,10 @@
 typedef struct CompilerScope {
     string_table* locals;
     struct CompilerScope* parent;
+
+    /* per local: struct layout index << 1 | is_array, or -1 for plain values */
+    int32_t* struct_tags;
+    size_t struct_tag_count;
 } CompilerScope;
 
 CompilerScope* scope_create(CompilerScope* parent);
@@ -15,4 +19,7 @@ size_t scope_add_local(CompilerScope* scope, const char* name);
 int32_t scope_find_local(CompilerScope* scope, const char* name);
 bool scope_contains_local(CompilerScope* scope, const char* name);
 
+void scope_set_struct(CompilerScope* scope, size_t local, int32_t tag);
+int32_t scope_find_struct(CompilerScope* scope, const char* name);
+
 #endif
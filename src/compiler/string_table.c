@@ -3,14 +3,48 @@
 #include <string.h>
 #include <stdio.h>
 
+#define STRING_TABLE_LINEAR_LIMIT 16
+
 string_table* string_table_create() {
     string_table* table = malloc(sizeof(string_table));
     table->names = NULL;
     table->count = 0;
     table->capacity = 0;
+    table->slots = NULL;
+    table->slot_capacity = 0;
     return table;
 }
 
+static uint64_t string_table_hash(const char* name) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void string_table_index_insert(string_table* table, size_t index) {
+    size_t mask = table->slot_capacity - 1;
+    size_t slot = string_table_hash(table->names[index]) & mask;
+    while (table->slots[slot]) slot = (slot + 1) & mask;
+    table->slots[slot] = (uint32_t)(index + 1);
+}
+
+static bool string_table_index_grow(string_table* table) {
+    size_t capacity = table->slot_capacity ? table->slot_capacity * 2 : 64;
+    uint32_t* slots = calloc(capacity, sizeof(uint32_t));
+    if (!slots) return false;
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_capacity = capacity;
+    for (size_t i = 0; i < table->count; i++) {
+        string_table_index_insert(table, i);
+    }
+    return true;
+}
+
 void string_table_destroy(string_table* table) {
     if (!table) return;
     
@@ -18,6 +52,7 @@ void string_table_destroy(string_table* table) {
         free(table->names[i]);
     }
     free(table->names);
+    free(table->slots);
     free(table);
 }
 
@@ -42,7 +77,21 @@ size_t string_table_add(string_table* table, const char* name) {
     if (!name_copy) return SIZE_MAX;
     
     table->names[table->count] = name_copy;
-    return table->count++;
+    table->count++;
+
+    if (table->count > STRING_TABLE_LINEAR_LIMIT) {
+        if (table->count * 2 > table->slot_capacity) {
+            /* a failed grow drops the index; lookups fall back to scanning */
+            if (!string_table_index_grow(table)) {
+                free(table->slots);
+                table->slots = NULL;
+                table->slot_capacity = 0;
+            }
+        } else {
+            string_table_index_insert(table, table->count - 1);
+        }
+    }
+    return table->count - 1;
 }
 
 const char* string_table_get(const string_table* table, size_t index) {
@@ -52,6 +101,17 @@ const char* string_table_get(const string_table* table, size_t index) {
 
 int32_t string_table_find(const string_table* table, const char* name) {
     if (!table || !name) return -1;
+
+    if (table->slots) {
+        size_t mask = table->slot_capacity - 1;
+        size_t slot = string_table_hash(name) & mask;
+        while (table->slots[slot]) {
+            size_t index = table->slots[slot] - 1;
+            if (strcmp(table->names[index], name) == 0) return (int32_t)index;
+            slot = (slot + 1) & mask;
+        }
+        return -1;
+    }
     
     for (size_t i = 0; i < table->count; i++) {
         if (strcmp(table->names[i], name) == 0) {
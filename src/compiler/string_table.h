@@ -9,6 +9,10 @@ typedef struct string_table {
     char** names;
     size_t count;
     size_t capacity;
+
+    /* hashed index over names (slot holds index + 1), built once the table outgrows a linear scan */
+    uint32_t* slots;
+    size_t slot_capacity;
 } string_table;
 
 string_table* string_table_create();
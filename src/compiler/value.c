@@ -3,6 +3,16 @@
 #include "value.h"
 #include <stdlib.h>
 
+/* Length of a float literal with insignificant trailing zeros dropped,
+ * so "1.50" and "1.5" land in the same constant slot. */
+static size_t float_canonical_length(const char* s) {
+    size_t len = strlen(s);
+    if (!strchr(s, '.') || strpbrk(s, "eE")) return len;
+    while (len > 0 && s[len - 1] == '0') len--;
+    if (len > 0 && s[len - 1] == '.') len--;
+    return len;
+}
+
 bool values_equal(Value a, Value b) {
     if (a.type != b.type) {
         return false;
@@ -13,15 +23,51 @@ bool values_equal(Value a, Value b) {
             return a.int_val == b.int_val;
         case VAL_BOOL:
             return a.bool_val == b.bool_val;
-        case VAL_FLOAT:
-            return strcmp(a.float_val, b.float_val) == 0;
+        case VAL_FLOAT: {
+            size_t len_a = float_canonical_length(a.float_val);
+            return len_a == float_canonical_length(b.float_val) &&
+                   memcmp(a.float_val, b.float_val, len_a) == 0;
+        }
         case VAL_NONE:
             return true;
+        case VAL_CODE:
+            return a.code_val == b.code_val;
         default:
             return false;
     }
 }
 
+uint64_t value_hash(Value value) {
+    uint64_t h = 1469598103934665603ULL ^ (uint64_t)value.type;
+
+    switch (value.type) {
+        case VAL_INT:
+            h ^= (uint64_t)value.int_val;
+            break;
+        case VAL_BOOL:
+            h ^= (uint64_t)value.bool_val;
+            break;
+        case VAL_FLOAT: {
+            size_t len = float_canonical_length(value.float_val);
+            for (size_t i = 0; i < len; i++) {
+                h ^= (uint8_t)value.float_val[i];
+                h *= 1099511628211ULL;
+            }
+            break;
+        }
+        case VAL_CODE:
+            h ^= (uint64_t)(uintptr_t)value.code_val;
+            break;
+        default:
+            break;
+    }
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
 Value value_create_int(int64_t value) {
     Value val;
     val.type = VAL_INT;
@@ -37,9 +37,15 @@ typedef struct CodeObj {
 
     Value* constants;
     size_t constants_count;
+
+    // JIT hotness, shared by every function object made from this code:
+    // calls so far and, once hot, the optimized code to run instead.
+    size_t call_count;
+    struct CodeObj* jit_code;
 } CodeObj;
 
 bool values_equal(Value a, Value b);
+uint64_t value_hash(Value value);
 Value value_create_int(int64_t value);
 Value value_create_bool(bool value);
 Value value_create_float(const char* value);
@@ -1,14 +1,100 @@
 #include "lexer.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <ctype.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 static void lexer_advance(lexer *l);
 static void lexer_skip_whitespace(lexer *l);
-static Token* lexer_parse_identifier(lexer *l);
-static Token* lexer_next_token(lexer *l);
-static Token* lexer_parse_number(lexer *l);
+static Token lexer_parse_identifier(lexer *l);
+static Token lexer_next_token(lexer *l);
+static Token lexer_parse_number(lexer *l);
+static Token lexer_next_mapped_token(lexer *l);
+
+/*
+ * Keywords are resolved with a perfect hash over (length, first, last):
+ * every keyword lands in its own slot of a 64-entry table, so a lookup
+ * costs one hash and at most one memcmp.
+ */
+#define KEYWORD_HASH(len, first, last) \
+    ((((unsigned)(len) << 1) + (unsigned)(first) * 3u + (unsigned)(last)) & 63u)
+
+typedef struct keyword_entry {
+    const char* name;
+    unsigned char length;
+    TokenType type;
+} keyword_entry;
+
+static const keyword_entry keyword_table[64] = {
+    [3]  = {"or", 2, OP_OR},
+    [4]  = {"not", 3, OP_NOT},
+    [9]  = {"true", 4, KW_TRUE},
+    [13] = {"and", 3, OP_AND},
+    [14] = {"void", 4, KW_VOID},
+    [16] = {"return", 6, KW_RETURN},
+    [20] = {"while", 5, KW_WHILE},
+    [23] = {"None", 4, KW_NONE},
+    [25] = {"struct", 6, KW_STRUCT},
+    [26] = {"bool", 4, KW_BOOL},
+    [27] = {"break", 5, KW_BREAK},
+    [28] = {"else", 4, KW_ELSE},
+    [29] = {"elif", 4, KW_ELIF},
+    [30] = {"continue", 8, KW_CONTINUE},
+    [33] = {"false", 5, KW_FALSE},
+    [37] = {"if", 2, KW_IF},
+    [42] = {"for", 3, KW_FOR},
+    [48] = {"float", 5, KW_FLOAT},
+    [50] = {"is", 2, KW_IS},
+    [51] = {"long", 4, KW_LONG},
+    [53] = {"int", 3, KW_INT},
+};
+
+static TokenType lexer_keyword_lookup(const char* text, size_t length) {
+    if (length < 2 || length > 8) return IDENTIFIER;
+    const keyword_entry* entry = &keyword_table[KEYWORD_HASH(length,
+        (unsigned char)text[0], (unsigned char)text[length - 1])];
+    if (entry->name && entry->length == length && memcmp(entry->name, text, length) == 0) {
+        return entry->type;
+    }
+    return IDENTIFIER;
+}
+
+/* character classes for the mapped scanner */
+#define CC_SPACE       0x01
+#define CC_IDENT_START 0x02
+#define CC_DIGIT       0x04
+#define CC_IDENT       (CC_IDENT_START | CC_DIGIT)
+
+static unsigned char char_class[256];
+static int char_class_ready = 0;
+
+static void lexer_init_char_class(void) {
+    if (char_class_ready) return;
+    for (int c = 0; c < 256; c++) {
+        unsigned char cls = 0;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r') cls |= CC_SPACE;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') cls |= CC_IDENT_START;
+        if (c >= '0' && c <= '9') cls |= CC_DIGIT;
+        char_class[c] = cls;
+    }
+    char_class_ready = 1;
+}
+
+static Token lexer_make_token(lexer *l, TokenType type, const char* value, int line, int column) {
+    Token token;
+    token.type = type;
+    token.value = l->arena ? arena_strdup(l->arena, value) : strdup(value);
+    token.line = line;
+    token.column = column;
+    token.offset = (uint32_t)l->token_start;
+    token.length = (uint32_t)strlen(value);
+    return token;
+}
 
 static void lexer_advance(lexer *l) {
     if (l->current_char == '\n') {
@@ -18,6 +104,7 @@ static void lexer_advance(lexer *l) {
         l->column++;
     }
     l->current_char = fgetc(l->file);
+    l->pos++;
 }
 
 static void lexer_skip_whitespace(lexer *l) {
@@ -25,12 +112,13 @@ static void lexer_skip_whitespace(lexer *l) {
         if (l->current_char == '/') {
             int next_char = fgetc(l->file);
             
+            ungetc(next_char, l->file);
+            
             if (next_char == '/') {
                 while (l->current_char != EOF && l->current_char != '\n') {
                     lexer_advance(l);
                 }
             } else {
-                ungetc(next_char, l->file);
                 break;
             }
         } else {
@@ -39,7 +127,7 @@ static void lexer_skip_whitespace(lexer *l) {
     }
 }
 
-static Token* lexer_parse_identifier(lexer *l) {
+static Token lexer_parse_identifier(lexer *l) {
     char buffer[256] = {0};
     int i = 0;
     int start_line = l->line;
@@ -51,34 +139,10 @@ static Token* lexer_parse_identifier(lexer *l) {
     }
     buffer[i] = '\0';
     
-    if (strcmp(buffer, "int") == 0) return token_create(KW_INT, buffer, start_line, start_column);
-    if (strcmp(buffer, "float") == 0) return token_create(KW_FLOAT, buffer, start_line, start_column);
-    if (strcmp(buffer, "void") == 0) return token_create(KW_VOID, buffer, start_line, start_column);
-    if (strcmp(buffer, "bool") == 0) return token_create(KW_BOOL, buffer, start_line, start_column);
-    if (strcmp(buffer, "long") == 0) return token_create(KW_LONG, buffer, start_line, start_column);
-    if (strcmp(buffer, "None") == 0) return token_create(KW_NONE, buffer, start_line, start_column);
-    if (strcmp(buffer, "true") == 0) return token_create(KW_TRUE, buffer, start_line, start_column);
-    if (strcmp(buffer, "false") == 0) return token_create(KW_FALSE, buffer, start_line, start_column);
-    if (strcmp(buffer, "if") == 0) return token_create(KW_IF, buffer, start_line, start_column);
-    if (strcmp(buffer, "else") == 0) return token_create(KW_ELSE, buffer, start_line, start_column);
-    if (strcmp(buffer, "elif") == 0) return token_create(KW_ELIF, buffer, start_line, start_column);
-    if (strcmp(buffer, "while") == 0) return token_create(KW_WHILE, buffer, start_line, start_column);
-    if (strcmp(buffer, "for") == 0) return token_create(KW_FOR, buffer, start_line, start_column);
-    if (strcmp(buffer, "break") == 0) return token_create(KW_BREAK, buffer, start_line, start_column);
-    if (strcmp(buffer, "continue") == 0) return token_create(KW_CONTINUE, buffer, start_line, start_column);
-    if (strcmp(buffer, "return") == 0) return token_create(KW_RETURN, buffer, start_line, start_column);
-    if (strcmp(buffer, "struct") == 0) return token_create(KW_STRUCT, buffer, start_line, start_column);
-    if (strcmp(buffer, "is") == 0) return token_create(KW_IS, buffer, start_line, start_column);
-    if (strcmp(buffer, "not") == 0) return token_create(OP_NOT, buffer, start_line, start_column);
-    if (strcmp(buffer, "and") == 0) return token_create(OP_AND, buffer, start_line, start_column);
-    if (strcmp(buffer, "or") == 0) return token_create(OP_OR, buffer, start_line, start_column);
-
-
-    
-    return token_create(IDENTIFIER, buffer, start_line, start_column);
+    return lexer_make_token(l, lexer_keyword_lookup(buffer, (size_t)i), buffer, start_line, start_column);
 }
 
-static Token* lexer_parse_number(lexer *l) {
+static Token lexer_parse_number(lexer *l) {
     char buffer[256] = {0};
     int i = 0;
     int start_line = l->line;
@@ -120,26 +184,25 @@ static Token* lexer_parse_number(lexer *l) {
             }
         } else {
             buffer[i] = '\0';
-            return token_create(ERROR, buffer, start_line, start_column);
+            return lexer_make_token(l, ERROR, buffer, start_line, start_column);
         }
     }
     
     buffer[i] = '\0';
     
     if (is_float) {
-        return token_create(FLOAT_LITERAL, buffer, start_line, start_column);
+        return lexer_make_token(l, FLOAT_LITERAL, buffer, start_line, start_column);
     } else {
-        return token_create(INT_LITERAL, buffer, start_line, start_column);
+        return lexer_make_token(l, INT_LITERAL, buffer, start_line, start_column);
     }
 }
 
-static Token* lexer_next_token(lexer *l) {
-    if (!l || !l->file) return NULL;
-    
+static Token lexer_next_token(lexer *l) {
     lexer_skip_whitespace(l);
+    l->token_start = l->pos;
     
     if (l->current_char == EOF) {
-        return token_create(END_OF_FILE, "EOF", l->line, l->column);
+        return lexer_make_token(l, END_OF_FILE, "EOF", l->line, l->column);
     }
     
     int start_line = l->line;
@@ -155,24 +218,25 @@ static Token* lexer_next_token(lexer *l) {
     
     char double_char[3] = {l->current_char, 0, '\0'};
     char single_char[2] = {l->current_char, '\0'};
-    Token* token = NULL;
+    Token token;
     
     switch (l->current_char) {
-        case '+': token = token_create(OP_PLUS, single_char, start_line, start_column); break;
-        case '-': token = token_create(OP_MINUS, single_char, start_line, start_column); break;
-        case '*': token = token_create(OP_MULT, single_char, start_line, start_column); break;
-        case '/': token = token_create(OP_DIV, single_char, start_line, start_column); break;
-        case '%': token = token_create(OP_MOD, single_char, start_line, start_column); break;
+        case '+': token = lexer_make_token(l, OP_PLUS, single_char, start_line, start_column); break;
+        case '-': token = lexer_make_token(l, OP_MINUS, single_char, start_line, start_column); break;
+        case '*': token = lexer_make_token(l, OP_MULT, single_char, start_line, start_column); break;
+        case '/': token = lexer_make_token(l, OP_DIV, single_char, start_line, start_column); break;
+        case '%': token = lexer_make_token(l, OP_MOD, single_char, start_line, start_column); break;
         
         case '=':
             double_char[1] = fgetc(l->file);
             if (double_char[1] == '=') {
                 double_char[2] = '\0';
-                token = token_create(OP_EQ, double_char, start_line, start_column);
+                token = lexer_make_token(l, OP_EQ, double_char, start_line, start_column);
+                ungetc(double_char[1], l->file);
                 lexer_advance(l);
             } else {
                 ungetc(double_char[1], l->file);
-                token = token_create(OP_ASSIGN, single_char, start_line, start_column);
+                token = lexer_make_token(l, OP_ASSIGN, single_char, start_line, start_column);
             }
             break;
             
@@ -180,11 +244,12 @@ static Token* lexer_next_token(lexer *l) {
             double_char[1] = fgetc(l->file);
             if (double_char[1] == '=') {
                 double_char[2] = '\0';
-                token = token_create(OP_NE, double_char, start_line, start_column);
+                token = lexer_make_token(l, OP_NE, double_char, start_line, start_column);
+                ungetc(double_char[1], l->file);
                 lexer_advance(l);
             } else {
                 ungetc(double_char[1], l->file);
-                token = token_create(ERROR, single_char, start_line, start_column);
+                token = lexer_make_token(l, ERROR, single_char, start_line, start_column);
             }
             break;
             
@@ -192,11 +257,12 @@ static Token* lexer_next_token(lexer *l) {
             double_char[1] = fgetc(l->file);
             if (double_char[1] == '=') {
                 double_char[2] = '\0';
-                token = token_create(OP_LE, double_char, start_line, start_column);
+                token = lexer_make_token(l, OP_LE, double_char, start_line, start_column);
+                ungetc(double_char[1], l->file);
                 lexer_advance(l);
             } else {
                 ungetc(double_char[1], l->file);
-                token = token_create(OP_LT, single_char, start_line, start_column);
+                token = lexer_make_token(l, OP_LT, single_char, start_line, start_column);
             }
             break;
             
@@ -204,63 +270,292 @@ static Token* lexer_next_token(lexer *l) {
             double_char[1] = fgetc(l->file);
             if (double_char[1] == '=') {
                 double_char[2] = '\0';
-                token = token_create(OP_GE, double_char, start_line, start_column);
+                token = lexer_make_token(l, OP_GE, double_char, start_line, start_column);
+                ungetc(double_char[1], l->file);
                 lexer_advance(l);
             } else {
                 ungetc(double_char[1], l->file);
-                token = token_create(OP_GT, single_char, start_line, start_column);
+                token = lexer_make_token(l, OP_GT, single_char, start_line, start_column);
             }
             break;
             
-        case '(': token = token_create(LPAREN, single_char, start_line, start_column); break;
-        case ')': token = token_create(RPAREN, single_char, start_line, start_column); break;
-        case '{': token = token_create(LBRACE, single_char, start_line, start_column); break;
-        case '}': token = token_create(RBRACE, single_char, start_line, start_column); break;
-        case '[': token = token_create(LBRACKET, single_char, start_line, start_column); break;
-        case ']': token = token_create(RBRACKET, single_char, start_line, start_column); break;
-        case ';': token = token_create(SEMICOLON, single_char, start_line, start_column); break;
-        case ':': token = token_create(COLON, single_char, start_line, start_column); break;
-        case ',': token = token_create(COMMA, single_char, start_line, start_column); break;
-        case '.': token = token_create(KW_DOT, single_char, start_line, start_column); break;
+        case '(': token = lexer_make_token(l, LPAREN, single_char, start_line, start_column); break;
+        case ')': token = lexer_make_token(l, RPAREN, single_char, start_line, start_column); break;
+        case '{': token = lexer_make_token(l, LBRACE, single_char, start_line, start_column); break;
+        case '}': token = lexer_make_token(l, RBRACE, single_char, start_line, start_column); break;
+        case '[': token = lexer_make_token(l, LBRACKET, single_char, start_line, start_column); break;
+        case ']': token = lexer_make_token(l, RBRACKET, single_char, start_line, start_column); break;
+        case ';': token = lexer_make_token(l, SEMICOLON, single_char, start_line, start_column); break;
+        case ':': token = lexer_make_token(l, COLON, single_char, start_line, start_column); break;
+        case ',': token = lexer_make_token(l, COMMA, single_char, start_line, start_column); break;
+        case '.': token = lexer_make_token(l, KW_DOT, single_char, start_line, start_column); break;
         default: 
-            token = token_create(ERROR, single_char, start_line, start_column);
+            token = lexer_make_token(l, ERROR, single_char, start_line, start_column);
             break;
     }
     
-    if (token) {
-        lexer_advance(l);
+    lexer_advance(l);
+    
+    return token;
+}
+
+/*
+ * Mapped scanning: the whole source is mmap'd and walked with the
+ * char_class table. Tokens carry (offset, length) into the mapping; the
+ * value string is only materialized once per distinct spelling when an
+ * arena is attached (keywords and punctuators use static spellings,
+ * identifiers and literals are interned), otherwise it is strndup'd so
+ * callers that free token values keep working.
+ */
+
+static uint64_t lexer_hash_bytes(const char* text, size_t length) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int lexer_intern_grow(lexer *l) {
+    size_t capacity = l->intern_capacity ? l->intern_capacity * 2 : 256;
+    char** slots = calloc(capacity, sizeof(char*));
+    if (!slots) return 0;
+    
+    for (size_t i = 0; i < l->intern_capacity; i++) {
+        char* str = l->intern[i];
+        if (!str) continue;
+        size_t slot = lexer_hash_bytes(str, strlen(str)) & (capacity - 1);
+        while (slots[slot]) slot = (slot + 1) & (capacity - 1);
+        slots[slot] = str;
+    }
+    
+    free(l->intern);
+    l->intern = slots;
+    l->intern_capacity = capacity;
+    return 1;
+}
+
+static char* lexer_intern(lexer *l, const char* text, size_t length) {
+    if ((l->intern_count + 1) * 2 > l->intern_capacity && !lexer_intern_grow(l)) {
+        return arena_strndup(l->arena, text, length);
     }
     
+    size_t mask = l->intern_capacity - 1;
+    size_t slot = lexer_hash_bytes(text, length) & mask;
+    while (l->intern[slot]) {
+        char* str = l->intern[slot];
+        if (strncmp(str, text, length) == 0 && str[length] == '\0') return str;
+        slot = (slot + 1) & mask;
+    }
+    
+    char* copy = arena_strndup(l->arena, text, length);
+    if (!copy) return NULL;
+    l->intern[slot] = copy;
+    l->intern_count++;
+    return copy;
+}
+
+static Token lexer_make_slice_token(lexer *l, TokenType type, size_t start, size_t length,
+                                    const char* spelling, int line, int column) {
+    Token token;
+    token.type = type;
+    if (l->arena) {
+        token.value = spelling ? (char*)spelling : lexer_intern(l, l->source + start, length);
+    } else {
+        token.value = spelling ? strdup(spelling) : strndup(l->source + start, length);
+    }
+    token.line = line;
+    token.column = column;
+    token.offset = (uint32_t)start;
+    token.length = (uint32_t)length;
     return token;
 }
 
+static void lexer_skip_mapped_whitespace(lexer *l) {
+    const unsigned char* src = (const unsigned char*)l->source;
+    size_t size = l->source_size;
+    size_t pos = l->pos;
+    
+    for (;;) {
+        /* indentation runs are skipped a word at a time */
+        while (pos + sizeof(uint64_t) <= size) {
+            uint64_t word;
+            memcpy(&word, src + pos, sizeof(word));
+            if (word != 0x2020202020202020ULL) break;
+            pos += sizeof(uint64_t);
+        }
+        
+        while (pos < size && (char_class[src[pos]] & CC_SPACE)) {
+            if (src[pos] == '\n') {
+                l->line++;
+                l->line_start = pos + 1;
+            }
+            pos++;
+        }
+        
+        if (pos + 1 < size && src[pos] == '/' && src[pos + 1] == '/') {
+            const unsigned char* newline = memchr(src + pos, '\n', size - pos);
+            pos = newline ? (size_t)(newline - src) : size;
+            continue;
+        }
+        break;
+    }
+    
+    l->pos = pos;
+}
+
+static Token lexer_next_mapped_token(lexer *l) {
+    lexer_skip_mapped_whitespace(l);
+    
+    const unsigned char* src = (const unsigned char*)l->source;
+    size_t size = l->source_size;
+    size_t start = l->pos;
+    int line = l->line;
+    int column = (int)(start - l->line_start) + 1;
+    
+    if (start >= size) {
+        return lexer_make_slice_token(l, END_OF_FILE, start, 0, "EOF", line, column);
+    }
+    
+    unsigned char c = src[start];
+    size_t pos = start + 1;
+    
+    if (char_class[c] & CC_IDENT_START) {
+        while (pos < size && (char_class[src[pos]] & CC_IDENT)) pos++;
+        l->pos = pos;
+        size_t length = pos - start;
+        TokenType type = lexer_keyword_lookup(l->source + start, length);
+        const char* spelling = NULL;
+        if (type != IDENTIFIER) {
+            spelling = keyword_table[KEYWORD_HASH(length, c, src[pos - 1])].name;
+        }
+        return lexer_make_slice_token(l, type, start, length, spelling, line, column);
+    }
+    
+    if (char_class[c] & CC_DIGIT) {
+        TokenType type = INT_LITERAL;
+        while (pos < size && (char_class[src[pos]] & CC_DIGIT)) pos++;
+        
+        if (pos < size && src[pos] == '.') {
+            type = FLOAT_LITERAL;
+            pos++;
+            while (pos < size && (char_class[src[pos]] & CC_DIGIT)) pos++;
+        }
+        
+        if (pos < size && (src[pos] == 'e' || src[pos] == 'E')) {
+            type = FLOAT_LITERAL;
+            pos++;
+            if (pos < size && (src[pos] == '+' || src[pos] == '-')) pos++;
+            if (pos < size && (char_class[src[pos]] & CC_DIGIT)) {
+                while (pos < size && (char_class[src[pos]] & CC_DIGIT)) pos++;
+            } else {
+                type = ERROR;
+            }
+        }
+        
+        l->pos = pos;
+        return lexer_make_slice_token(l, type, start, pos - start, NULL, line, column);
+    }
+    
+    int has_eq = pos < size && src[pos] == '=';
+    TokenType type = ERROR;
+    const char* spelling = NULL;
+    
+    switch (c) {
+        case '+': type = OP_PLUS; spelling = "+"; break;
+        case '-': type = OP_MINUS; spelling = "-"; break;
+        case '*': type = OP_MULT; spelling = "*"; break;
+        case '/': type = OP_DIV; spelling = "/"; break;
+        case '%': type = OP_MOD; spelling = "%"; break;
+        case '=': type = has_eq ? OP_EQ : OP_ASSIGN; spelling = has_eq ? "==" : "="; break;
+        case '!': type = has_eq ? OP_NE : ERROR; spelling = has_eq ? "!=" : "!"; break;
+        case '<': type = has_eq ? OP_LE : OP_LT; spelling = has_eq ? "<=" : "<"; break;
+        case '>': type = has_eq ? OP_GE : OP_GT; spelling = has_eq ? ">=" : ">"; break;
+        case '(': type = LPAREN; spelling = "("; break;
+        case ')': type = RPAREN; spelling = ")"; break;
+        case '{': type = LBRACE; spelling = "{"; break;
+        case '}': type = RBRACE; spelling = "}"; break;
+        case '[': type = LBRACKET; spelling = "["; break;
+        case ']': type = RBRACKET; spelling = "]"; break;
+        case ';': type = SEMICOLON; spelling = ";"; break;
+        case ':': type = COLON; spelling = ":"; break;
+        case ',': type = COMMA; spelling = ","; break;
+        case '.': type = KW_DOT; spelling = "."; break;
+        default: break;
+    }
+    
+    if (has_eq && (c == '=' || c == '!' || c == '<' || c == '>')) pos++;
+    l->pos = pos;
+    return lexer_make_slice_token(l, type, start, pos - start, spelling, line, column);
+}
+
+static lexer* lexer_alloc(const char* filename) {
+    lexer *l = calloc(1, sizeof(lexer));
+    if (!l) return NULL;
+    
+    l->line = 1;
+    l->column = 1;
+    l->filename = strdup(filename);
+    l->arena = NULL;
+    return l;
+}
+
+/* regular non-empty files are mapped; anything else goes through stdio */
+static int lexer_map_file(lexer *l, const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (uint64_t)st.st_size > UINT32_MAX) {
+        close(fd);
+        return 0;
+    }
+    
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return 0;
+    
+    madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+    l->source = (const char*)mapping;
+    l->source_size = (size_t)st.st_size;
+    l->pos = 0;
+    l->line_start = 0;
+    lexer_init_char_class();
+    return 1;
+}
+
 lexer* lexer_create(const char* filename) {
-    lexer *l = malloc(sizeof(lexer));
+    lexer *l = lexer_alloc(filename);
     if (!l) return NULL;
     
+    int mapped = lexer_map_file(l, filename);
+    if (mapped < 0) {
+        free(l->filename);
+        free(l);
+        return NULL;
+    }
+    if (mapped) return l;
+    
     l->file = fopen(filename, "r");
     if (!l->file) {
+        free(l->filename);
         free(l);
         return NULL;
     }
     
     l->current_char = fgetc(l->file);
-    l->line = 1;
-    l->column = 1;
-    l->filename = strdup(filename);
     
     return l;
 }
 
 lexer* lexer_create_from_stream(FILE* file, const char* filename) {
-    lexer *l = malloc(sizeof(lexer));
+    lexer *l = lexer_alloc(filename);
     if (!l) return NULL;
     
     l->file = file;
     l->current_char = fgetc(l->file);
-    l->line = 1;
-    l->column = 1;
-    l->filename = strdup(filename);
     
     return l;
 }
@@ -268,49 +563,70 @@ lexer* lexer_create_from_stream(FILE* file, const char* filename) {
 void lexer_destroy(lexer *l) {
     if (l) {
         if (l->file) fclose(l->file);
+        if (l->source) munmap((void*)l->source, l->source_size);
         if (l->filename) free(l->filename);
+        free(l->intern);
         free(l);
     }
 }
 
+void lexer_set_arena(lexer *l, Arena* arena) {
+    if (l) l->arena = arena;
+}
+
+const char* lexer_source(const lexer *l) {
+    return l ? l->source : NULL;
+}
+
+Token lexer_next(lexer *l) {
+    Token token = l->source ? lexer_next_mapped_token(l) : lexer_next_token(l);
+    
+    if (token.type == ERROR) {
+        printf("Lexical error at %d:%d: unexpected character '%s'\n", 
+               token.line, token.column, token.value);
+    }
+    return token;
+}
+
 Token* lexer_parse_file(lexer* lexer, const char* filename) {
     if (!lexer) {
         lexer = lexer_create(filename);
         if (!lexer)         return NULL;
     }
+    if (!lexer->file && !lexer->source) return NULL;
     
-    int capacity = 100;
-    int count = 0;
-    Token** tokens = malloc(capacity * sizeof(Token*));
+    size_t capacity = 128;
+    size_t count = 0;
+    if (lexer->source) {
+        /* rough guess: one token per five bytes of source */
+        while (capacity < lexer->source_size / 5) capacity *= 2;
+    }
+    Token* tokens = malloc(capacity * sizeof(Token));
+    if (!tokens) return NULL;
     
-    Token* token;
-    while ((token = lexer_next_token(lexer)) != NULL && token->type != END_OF_FILE) {
-        if (count >= capacity) {
+    for (;;) {
+        /* keep one spare slot for the END_OF_FILE sentinel */
+        if (count + 2 > capacity) {
             capacity *= 2;
-            tokens = realloc(tokens, capacity * sizeof(Token*));
+            Token* grown = realloc(tokens, capacity * sizeof(Token));
+            if (!grown) {
+                free(tokens);
+                return NULL;
+            }
+            tokens = grown;
         }
-        tokens[count++] = token;
         
-        if (token->type == ERROR) {
-            printf("Lexical error at %d:%d: unexpected character '%s'\n", 
-                   token->line, token->column, token->value);
-        }
-    }
-    
-    if (count >= capacity) {
-        capacity += 1;
-        tokens = realloc(tokens, capacity * sizeof(Token*));
+        Token token = lexer_next(lexer);
+        tokens[count++] = token;
+        if (token.type == END_OF_FILE) break;
     }
-    tokens[count++] = token_create(END_OF_FILE, "EOF", lexer->line, lexer->column);
     
-    Token* result = malloc((count + 1) * sizeof(Token));
-    for (int i = 0; i < count; i++) {
-        result[i] = *tokens[i];
-        free(tokens[i]);
-    }
-    result[count].type = END_OF_FILE;
-    result[count].value = NULL;
+    tokens[count].type = END_OF_FILE;
+    tokens[count].value = NULL;
+    tokens[count].line = tokens[count - 1].line;
+    tokens[count].column = tokens[count - 1].column;
+    tokens[count].offset = tokens[count - 1].offset;
+    tokens[count].length = 0;
     
-    free(tokens);
-    return result;
+    return tokens;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "token.h"
+#include "../arena.h"
 #include <stdio.h>
 
 typedef struct lexer {
@@ -9,9 +10,23 @@ typedef struct lexer {
     int line;
     int column;
     char *filename;
+    Arena *arena;
+    size_t token_start;
+    /* mmap'd source; NULL when lexing from a stream */
+    const char *source;
+    size_t source_size;
+    size_t pos;
+    size_t line_start;
+    /* arena-backed spellings of identifiers and literals */
+    char **intern;
+    size_t intern_capacity;
+    size_t intern_count;
 } lexer;
 
 lexer* lexer_create(const char* filename);
 lexer* lexer_create_from_stream(FILE* file, const char* filename);
 void lexer_destroy(lexer *l);
+void lexer_set_arena(lexer *l, Arena* arena);
+const char* lexer_source(const lexer *l);
+Token lexer_next(lexer *l);
 Token* lexer_parse_file(lexer* lexer_obj, const char* filename);
@@ -8,6 +8,8 @@ Token* token_create(TokenType type, const char* value, int line, int column) {
     token->value = strdup(value);
     token->line = line;
     token->column = column;
+    token->offset = 0;
+    token->length = (uint32_t)strlen(value);
     return token;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 typedef enum TokenType {
 
     KW_INT, KW_FLOAT, KW_BOOL, KW_LONG, KW_VOID,
@@ -40,6 +42,9 @@ typedef struct {
     char* value;
     int line;
     int column;
+    /* slice of the source text; see lexer_source() for mapped lexers */
+    uint32_t offset;
+    uint32_t length;
 } Token;
 
 Token* token_create(TokenType type, const char* value, int line, int column);
@@ -68,10 +68,14 @@ static ASTNode* parser_parse_variable_expression(Parser* parser);
 
 static ASTNode* parse_array_expression(Parser* parser);
 static ASTNode* parse_subscript_expression(Parser* parser, ASTNode* array);
+static ASTNode* parse_field_expression(Parser* parser, ASTNode* object);
+static ASTNode* parser_parse_struct_declaration_statement(Parser* parser);
+static ASTNode* parser_parse_struct_variable_declaration_statement(Parser* parser);
 
 
 Parser* parser_create(Token* tokens, size_t token_count) {
-    Parser* parser = malloc(sizeof(Parser));
+    Parser* parser = calloc(1, sizeof(Parser));
+    if (!parser) return NULL;
     parser->tokens = tokens;
     parser->token_count = token_count;
     parser->current = 0;
@@ -82,19 +86,99 @@ Parser* parser_create(Token* tokens, size_t token_count) {
     return parser;
 }
 
+Parser* parser_create_from_lexer(lexer* source) {
+    if (!source) return NULL;
+
+    Parser* parser = parser_create(NULL, 0);
+    if (!parser) return NULL;
+
+    parser->tokens = malloc(PARSER_TOKEN_WINDOW * sizeof(Token));
+    if (!parser->tokens) {
+        free(parser);
+        return NULL;
+    }
+    parser->source = source;
+    return parser;
+}
+
+static void parser_retire_value(Parser* parser, size_t index, char* value) {
+    // arena-backed lexers hand out shared spellings; nothing to free
+    if (!value || parser->source->arena) return;
+
+    if (parser->retired_count == parser->retired_capacity) {
+        size_t capacity = parser->retired_capacity ? parser->retired_capacity * 2 : 64;
+        RetiredValue* grown = realloc(parser->retired, capacity * sizeof(RetiredValue));
+        if (!grown) {
+            free(value);
+            return;
+        }
+        parser->retired = grown;
+        parser->retired_capacity = capacity;
+    }
+    parser->retired[parser->retired_count++] = (RetiredValue){index, value};
+}
+
+// Frees retired spellings of tokens at or after `from`. Only safe once every
+// parse frame that copied one of those Tokens has returned, i.e. between the
+// statements of a block that started at `from`: enclosing frames only hold
+// copies of tokens consumed before the block.
+static void parser_release_retired(Parser* parser, size_t from) {
+    while (parser->retired_count > 0 && parser->retired[parser->retired_count - 1].index >= from) {
+        free(parser->retired[--parser->retired_count].value);
+    }
+}
+
+static Token* parser_token_at(Parser* parser, size_t index) {
+    if (!parser->source) {
+        return index < parser->token_count ? &parser->tokens[index] : NULL;
+    }
+
+    if (index < parser->window_start) {
+        DPRINT("[PARSER] token %zu is behind the %d token window\n", index, PARSER_TOKEN_WINDOW);
+        return NULL;
+    }
+
+    while (index >= parser->window_end && !parser->source_done) {
+        if (parser->window_end - parser->window_start == PARSER_TOKEN_WINDOW) {
+            parser_retire_value(parser, parser->window_start,
+                                parser->tokens[parser->window_start % PARSER_TOKEN_WINDOW].value);
+            parser->window_start++;
+        }
+
+        Token token = lexer_next(parser->source);
+        DPRINT("[PARSER] token[%zu] type=%s value='%s'\n", parser->window_end,
+               token_type_to_string(token.type), token.value ? token.value : "NULL");
+        parser->tokens[parser->window_end % PARSER_TOKEN_WINDOW] = token;
+        parser->window_end++;
+        if (token.type == END_OF_FILE) parser->source_done = true;
+    }
+
+    if (index >= parser->window_end) return NULL;
+    return &parser->tokens[index % PARSER_TOKEN_WINDOW];
+}
+
 void parser_destroy(Parser* parser) {
+    if (!parser) return;
+    if (parser->source) {
+        for (size_t i = parser->window_start; i < parser->window_end; i++) {
+            parser_retire_value(parser, i, parser->tokens[i % PARSER_TOKEN_WINDOW].value);
+        }
+        parser_release_retired(parser, 0);
+        free(parser->retired);
+        free(parser->tokens);
+    }
     free(parser);
 }
 
 static bool parser_is_at_end(Parser* parser) {
-    return parser->current >= parser->token_count;
+    return parser_token_at(parser, parser->current) == NULL;
 }
 
 void report_error(Parser* parser, const char* error_message) {
     if (error_message == NULL); return;
     DPRINT("%s\n", error_message);
     DPRINT("%s", "current token is ");
-    DPRINT(" %s\n", parser->tokens[parser->current].value);
+    DPRINT(" %s\n", parser_peek(parser) ? parser_peek(parser)->value : "NULL");
 }
 
 static Token* parser_consume(Parser* parser, TokenType expected, const char* error_message) {
@@ -107,26 +191,24 @@ static Token* parser_consume(Parser* parser, TokenType expected, const char* err
 }
 
 static Token* parser_peek(Parser* parser) {
-    if (parser_is_at_end(parser)) {
-        return NULL;
-    }
-    return &(parser->tokens[parser->current]);
+    return parser_token_at(parser, parser->current);
 }
 
 static Token* parser_previous(Parser* parser) {
     if (parser->current == 0) {
         return NULL;
     }
-    return &(parser->tokens[parser->current - 1]);
+    return parser_token_at(parser, parser->current - 1);
 }
 
 static Token* parser_retreat(Parser* parser) {
     if (parser->current == 0) {
         return NULL;
     }
-    parser->current--;
 
-    Token* current = parser_peek(parser);
+    Token* current = parser_token_at(parser, parser->current - 1);
+    if (!current) return NULL;
+    parser->current--;
 
     parser->current_location.line = current->line;
     parser->current_location.column = current->column;
@@ -215,6 +297,36 @@ static ASTNode* parse_array_expression(Parser* parser) {
     return array_node;
 }
 
+// a[lo:hi], a[lo:] and a[:hi] are sugar for slice(a, lo, hi) / slice(a, lo).
+static ASTNode* parse_slice_expression(Parser* parser, SourceLocation loc, ASTNode* array, ASTNode* lo) {
+    parser_consume(parser, COLON, "Expected ':' in slice expression");
+
+    ASTNode* hi = NULL;
+    Token* next = parser_peek(parser);
+    if (next && next->type != RBRACKET) {
+        hi = parser_parse_expression(parser);
+        if (!hi) {
+            ast_free(lo);
+            return NULL;
+        }
+    }
+    parser_consume(parser, RBRACKET, "Expected ']' after slice bounds");
+
+    size_t arg_count = hi ? 3 : 2;
+    ASTNode** args = malloc(arg_count * sizeof(ASTNode*));
+    if (!args) {
+        ast_free(lo);
+        ast_free(hi);
+        return NULL;
+    }
+    args[0] = array;
+    args[1] = lo;
+    if (hi) args[2] = hi;
+
+    DPRINT("[PARSER] Slice expression with %zu arguments\n", arg_count);
+    return ast_new_call_expression(loc, ast_new_variable_expression(loc, "slice"), args, (int)arg_count);
+}
+
 static ASTNode* parse_subscript_expression(Parser* parser, ASTNode* array) {
     Token* current = parser_peek(parser);
     if (!current) return NULL;
@@ -222,14 +334,49 @@ static ASTNode* parse_subscript_expression(Parser* parser, ASTNode* array) {
     SourceLocation loc = {current->line, current->column};
     parser_consume(parser, LBRACKET, "Expected '[' after array in subscript expression");
     
-    ASTNode* index = parser_parse_expression(parser);
+    Token* next = parser_peek(parser);
+    ASTNode* index = next && next->type == COLON
+        ? ast_new_literal_expression(loc, TYPE_INT, 0)
+        : parser_parse_expression(parser);
     if (!index) {
         return NULL;
     }
+
+    next = parser_peek(parser);
+    if (next && next->type == COLON) {
+        return parse_slice_expression(parser, loc, array, index);
+    }
     
     parser_consume(parser, RBRACKET, "Expected ']' after index in subscript expression");
     
-    return ast_new_subscript_expression(loc, array, index);
+    ASTNode* subscript = ast_new_subscript_expression(loc, array, index);
+    next = parser_peek(parser);
+    if (subscript && next && next->type == LBRACKET) {
+        // a[i][j]: the compiler turns the nested pair into one LOAD_SUBSCR2
+        ASTNode* outer = parse_subscript_expression(parser, subscript);
+        ast_free(subscript);
+        return outer;
+    }
+    return subscript;
+}
+
+// s.f after a struct variable or an element of a struct array. Fields are
+// scalars, so one '.' ends the chain.
+static ASTNode* parse_field_expression(Parser* parser, ASTNode* object) {
+    Token* dot = parser_consume(parser, KW_DOT, "Expected '.' before field name");
+    if (!dot) return object;
+
+    SourceLocation loc = {dot->line, dot->column};
+    Token* field = parser_consume(parser, IDENTIFIER, "Expected field name after '.'");
+    if (!field) {
+        ast_free(object);
+        return NULL;
+    }
+
+    DPRINT("[PARSER] Field expression .%s\n", field->value);
+    ASTNode* node = ast_new_field_expression(loc, object, field->value);
+    ast_free(object);
+    return node;
 }
 
 static ASTNode* parser_parse_function_call_expression(Parser* parser) {
@@ -410,27 +557,12 @@ static ASTNode* parser_parse_if_statement(Parser* parser) {
             return NULL;
         }
         
-        size_t new_elif_count = if_stmt->elif_count + 1;
-        ASTNode** new_elif_conditions = realloc(if_stmt->elif_conditions, 
-                                               new_elif_count * sizeof(ASTNode*));
-        ASTNode** new_elif_branches = realloc(if_stmt->elif_branches,
-                                             new_elif_count * sizeof(ASTNode*));
-        
-        if (!new_elif_conditions || !new_elif_branches) {
-            free(new_elif_conditions);
-            free(new_elif_branches);
+        if (!add_elif_to_if_statement(if_node, elif_condition, elif_branch)) {
             ast_free(elif_condition);
             ast_free(elif_branch);
             ast_free(if_node);
             return NULL;
         }
-        
-        if_stmt->elif_conditions = new_elif_conditions;
-        if_stmt->elif_branches = new_elif_branches;
-        
-        if_stmt->elif_conditions[if_stmt->elif_count] = elif_condition;
-        if_stmt->elif_branches[if_stmt->elif_count] = elif_branch;
-        if_stmt->elif_count = new_elif_count;
     }
     
     if (parser_peek(parser) && parser_peek(parser)->type == KW_ELSE) {
@@ -649,25 +781,167 @@ static ASTNode* parser_parse_array_declaration_statement(Parser* parser) {
     DPRINT("[PARSER] Parsing array declaration statement\n");
     DPRINT("[PARSER] Array element type is %s\n", 
            parser_peek(parser) ? token_type_to_string(parser_peek(parser)->type) : "NULL");
-    Token* array_token = parser_advance(parser);
-    SourceLocation loc = (SourceLocation){array_token->line, array_token->column};
+    // copied out: the streaming token window may move past them while parsing the size
+    Token array_token = *parser_advance(parser);
+    SourceLocation loc = (SourceLocation){array_token.line, array_token.column};
    
     parser_consume(parser, LBRACKET, "Expected '[' after array name");
-    ASTNode* size = parser_parse_expression(parser);
-    if (!size) return NULL;
+    // T[] name = expr; takes its length from the initializer
+    ASTNode* size = NULL;
+    if (!parser_peek(parser) || parser_peek(parser)->type != RBRACKET) {
+        size = parser_parse_expression(parser);
+        if (!size) return NULL;
+    }
     parser_consume(parser, RBRACKET, "Expected ']' after array size");
 
-    Token* identifier = parser_consume(parser, IDENTIFIER, "Expected array name");
-    if (!identifier) return NULL;
+    // T[n][m] name; is a 2-D array of n rows of m elements
+    ASTNode* columns = NULL;
+    if (parser_peek(parser) && parser_peek(parser)->type == LBRACKET) {
+        parser_advance(parser);
+        if (!parser_peek(parser) || parser_peek(parser)->type != RBRACKET) {
+            columns = parser_parse_expression(parser);
+            if (!columns) return NULL;
+        }
+        parser_consume(parser, RBRACKET, "Expected ']' after array column count");
+    }
+
+    Token* identifier_token = parser_consume(parser, IDENTIFIER, "Expected array name");
+    if (!identifier_token) return NULL;
+    Token identifier = *identifier_token;
 
     ASTNode* initializer = NULL;
     if (parser_peek(parser) && parser_peek(parser)->type == OP_ASSIGN) {
         parser_advance(parser);
         initializer = parser_parse_expression(parser);
     }
-    DPRINT("[PARSER] Finished parsing array declaration for '%s'\n", identifier->value);
-    return ast_new_array_declaration_statement(loc, token_type_to_type_var(array_token->type), 
-                                               identifier->value, size, initializer);
+    DPRINT("[PARSER] Finished parsing array declaration for '%s'\n", identifier.value);
+    return ast_new_array_declaration_statement(loc, token_type_to_type_var(array_token.type), 
+                                               identifier.value, size, columns, initializer);
+}
+
+static void free_parameters(Parameter* parameters, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(parameters[i].name);
+        free(parameters[i].struct_name);
+    }
+    free(parameters);
+}
+
+// struct Name { T field; ... }; with int, long, bool or float fields. The
+// compiler gives each field a fixed offset in declaration order.
+static ASTNode* parser_parse_struct_declaration_statement(Parser* parser) {
+    Token struct_token = *parser_advance(parser);
+    SourceLocation loc = (SourceLocation){struct_token.line, struct_token.column};
+
+    Token* name_token = parser_consume(parser, IDENTIFIER, "Expected struct name");
+    if (!name_token) return NULL;
+    Token name = *name_token;
+    if (!parser_consume(parser, LBRACE, "Expected '{' after struct name")) return NULL;
+
+    Parameter* fields = NULL;
+    size_t field_count = 0;
+    size_t field_capacity = 0;
+    while (parser_peek(parser) && parser_peek(parser)->type != RBRACE) {
+        TokenType type = parser_advance(parser)->type;
+        if (type != KW_INT && type != KW_LONG && type != KW_BOOL && type != KW_FLOAT) {
+            report_error(parser, "Struct fields must be int, long, bool or float");
+            free_parameters(fields, field_count);
+            return NULL;
+        }
+
+        Token* field_token = parser_consume(parser, IDENTIFIER, "Expected field name");
+        if (!field_token) {
+            free_parameters(fields, field_count);
+            return NULL;
+        }
+        for (size_t i = 0; i < field_count; i++) {
+            if (strcmp(fields[i].name, field_token->value) == 0) {
+                fprintf(stderr, "Error: struct %s declares field '%s' twice\n", name.value, field_token->value);
+                free_parameters(fields, field_count);
+                return NULL;
+            }
+        }
+
+        if (field_count == field_capacity) {
+            field_capacity = field_capacity == 0 ? 4 : field_capacity * 2;
+            Parameter* grown = realloc(fields, field_capacity * sizeof(Parameter));
+            if (!grown) {
+                free_parameters(fields, field_count);
+                return NULL;
+            }
+            fields = grown;
+        }
+        fields[field_count].name = strdup(field_token->value);
+        fields[field_count].type = token_type_to_type_var(type);
+        fields[field_count].is_array = false;
+        fields[field_count].struct_name = NULL;
+        field_count++;
+
+        if (!parser_consume(parser, SEMICOLON, "Expected ';' after struct field")) {
+            free_parameters(fields, field_count);
+            return NULL;
+        }
+    }
+
+    if (!parser_consume(parser, RBRACE, "Expected '}' after struct fields")) {
+        free_parameters(fields, field_count);
+        return NULL;
+    }
+
+    DPRINT("[PARSER] Struct %s with %zu fields\n", name.value, field_count);
+    ASTNode* node = ast_new_struct_declaration_statement(loc, name.value, fields, field_count);
+    free_parameters(fields, field_count);
+    return node;
+}
+
+// struct Name s; is one record, struct Name[n] s; an array of n records.
+// Either may bind an existing value instead: struct Name s = ps[i];
+static ASTNode* parser_parse_struct_variable_declaration_statement(Parser* parser) {
+    Token struct_token = *parser_advance(parser);
+    SourceLocation loc = (SourceLocation){struct_token.line, struct_token.column};
+
+    Token* type_token = parser_consume(parser, IDENTIFIER, "Expected struct name");
+    if (!type_token) return NULL;
+    Token type_name = *type_token;
+
+    bool is_array = false;
+    ASTNode* size = NULL;
+    if (parser_check(parser, LBRACKET)) {
+        parser_advance(parser);
+        is_array = true;
+        if (!parser_check(parser, RBRACKET)) {
+            size = parser_parse_expression(parser);
+            if (!size) return NULL;
+        }
+        if (!parser_consume(parser, RBRACKET, "Expected ']' after struct array size")) {
+            ast_free(size);
+            return NULL;
+        }
+    }
+
+    Token* identifier_token = parser_consume(parser, IDENTIFIER, "Expected struct variable name");
+    if (!identifier_token) {
+        ast_free(size);
+        return NULL;
+    }
+    Token identifier = *identifier_token;
+
+    ASTNode* initializer = NULL;
+    if (parser_check(parser, OP_ASSIGN)) {
+        parser_advance(parser);
+        initializer = parser_parse_expression(parser);
+        if (!initializer) {
+            ast_free(size);
+            return NULL;
+        }
+    }
+
+    DPRINT("[PARSER] Struct %s variable '%s'\n", type_name.value, identifier.value);
+    ASTNode* node = ast_new_struct_variable_declaration_statement(loc, type_name.value, identifier.value,
+                                                                  is_array, size, initializer);
+    if (size) ast_free(size);
+    if (initializer) ast_free(initializer);
+    return node;
 }
 
 static ASTNode* parser_parse_continue_statement(Parser* parser) {
@@ -689,34 +963,36 @@ static ASTNode* parser_parse_continue_statement(Parser* parser) {
 }
 
 static ASTNode* parser_parse_variable_declaration_statement(Parser* parser){
-    Token* token = parser_advance(parser);
-    SourceLocation loc = (SourceLocation){token->line, token->column};
+    Token token = *parser_advance(parser);
+    SourceLocation loc = (SourceLocation){token.line, token.column};
     ASTNode* initializer = NULL;
-    DPRINT("[PARSER] parse_variable_declaration start: type=%d value=%s\n", token->type, token->value);
+    DPRINT("[PARSER] parse_variable_declaration start: type=%d value=%s\n", token.type, token.value);
 
-    Token* identifier = parser_consume(parser, IDENTIFIER, "declaration should have a naming");
-    if (!identifier) return NULL;
+    Token* identifier_token = parser_consume(parser, IDENTIFIER, "declaration should have a naming");
+    if (!identifier_token) return NULL;
+    Token identifier = *identifier_token;
     if (parser_consume(parser, OP_ASSIGN, NULL)){
         initializer = parser_parse_expression(parser);
     }
 
-    ASTNode* node = ast_new_variable_declaration_statement(loc, token_type_to_type_var(token->type), identifier->value, initializer);
+    ASTNode* node = ast_new_variable_declaration_statement(loc, token_type_to_type_var(token.type), identifier.value, initializer);
     
-    DPRINT("[PARSER] parse_variable_declaration finished for name=%s\n", identifier->value);
+    DPRINT("[PARSER] parse_variable_declaration finished for name=%s\n", identifier.value);
     return node;
 }
 
 
 static ASTNode* parser_parse_function_declaration_statement(Parser* parser) {
     DPRINT("[PARSER] Starting to parse function declaration\n");
-    Token* return_type_token = parser_advance(parser);
-    SourceLocation loc = (SourceLocation){return_type_token->line, return_type_token->column};
-    if (return_type_token->type == KW_VOID) {
-        return_type_token->type = KW_NONE;
+    Token return_type_token = *parser_advance(parser);
+    SourceLocation loc = (SourceLocation){return_type_token.line, return_type_token.column};
+    if (return_type_token.type == KW_VOID) {
+        return_type_token.type = KW_NONE;
     }
 
-    Token* identifier = parser_consume(parser, IDENTIFIER, "Function declaration should have a name");
-    if (!identifier) return NULL;
+    Token* identifier_token = parser_consume(parser, IDENTIFIER, "Function declaration should have a name");
+    if (!identifier_token) return NULL;
+    Token identifier = *identifier_token;
 
     if (!parser_consume(parser, LPAREN, "Expected '(' after function name")) {
         return NULL;
@@ -734,10 +1010,7 @@ static ASTNode* parser_parse_function_declaration_statement(Parser* parser) {
             param_capacity *= 2;
             Parameter* new_params = realloc(parameters, sizeof(Parameter) * param_capacity);
             if (!new_params) {
-                for (size_t i = 0; i < param_count; i++) {
-                    free(parameters[i].name);
-                }
-                free(parameters);
+                free_parameters(parameters, param_count);
                 return NULL;
             }
             parameters = new_params;
@@ -745,20 +1018,26 @@ static ASTNode* parser_parse_function_declaration_statement(Parser* parser) {
 
         Token* param_type_token = parser_advance(parser);
         if (!param_type_token) {
-            for (size_t i = 0; i < param_count; i++) {
-                free(parameters[i].name);
-            }
-            free(parameters);
+            free_parameters(parameters, param_count);
             return NULL;
         }
         
+        // struct Name p passes one record, struct Name[] p an array of them
+        char* struct_name = NULL;
+        if (param_type_token->type == KW_STRUCT) {
+            Token* struct_token = parser_consume(parser, IDENTIFIER, "Expected struct name");
+            if (!struct_token) {
+                free_parameters(parameters, param_count);
+                return NULL;
+            }
+            struct_name = strdup(struct_token->value);
+        }
+
         TypeVar param_type = token_type_to_type_var(param_type_token->type);
         if (param_type == TYPE_NONE) {
             report_error(parser, "Invalid parameter type");
-            for (size_t i = 0; i < param_count; i++) {
-                free(parameters[i].name);
-            }
-            free(parameters);
+            free(struct_name);
+            free_parameters(parameters, param_count);
             return NULL;
         }
         
@@ -769,27 +1048,28 @@ static ASTNode* parser_parse_function_declaration_statement(Parser* parser) {
             parser_advance(parser);
             
             parser_consume(parser, RBRACKET, "Expected ']' after array type");
+            if (parser_peek(parser) && parser_peek(parser)->type == LBRACKET) {
+                parser_advance(parser);
+                parser_consume(parser, RBRACKET, "Expected ']' after array type");
+            }
         }
         
         Token* param_name = parser_consume(parser, IDENTIFIER, "Expected parameter name after type");
         if (!param_name) {
-            for (size_t i = 0; i < param_count; i++) {
-                free(parameters[i].name);
-            }
-            free(parameters);
+            free(struct_name);
+            free_parameters(parameters, param_count);
             return NULL;
         }
         
         parameters[param_count].name = strdup(param_name->value);
         if (!parameters[param_count].name) {
-            for (size_t i = 0; i < param_count; i++) {
-                free(parameters[i].name);
-            }
-            free(parameters);
+            free(struct_name);
+            free_parameters(parameters, param_count);
             return NULL;
         }
         parameters[param_count].type = param_type;
         parameters[param_count].is_array = is_array;
+        parameters[param_count].struct_name = struct_name;
         param_count++;
 
         if (parser_peek(parser)->type == COMMA) {
@@ -800,24 +1080,18 @@ static ASTNode* parser_parse_function_declaration_statement(Parser* parser) {
     }
 
     if (!parser_consume(parser, RPAREN, "Expected ')' after parameters")) {
-        for (size_t i = 0; i < param_count; i++) {
-            free(parameters[i].name);
-        }
-        free(parameters);
+        free_parameters(parameters, param_count);
         return NULL;
     }
 
     ASTNode* function_body = parser_parse_block(parser);
     if (!function_body) {
-        for (size_t i = 0; i < param_count; i++) {
-            free(parameters[i].name);
-        }
-        free(parameters);
+        free_parameters(parameters, param_count);
         return NULL;
     }
 
-    TypeVar return_type = token_type_to_type_var(return_type_token->type);
-    ASTNode* func_node = ast_new_function_declaration_statement(loc, identifier->value, return_type, parameters, param_count, function_body);
+    TypeVar return_type = token_type_to_type_var(return_type_token.type);
+    ASTNode* func_node = ast_new_function_declaration_statement(loc, identifier.value, return_type, parameters, param_count, function_body);
     
     return func_node;
 }
@@ -887,6 +1161,11 @@ static ASTNode* parser_parse_assignment_statement(Parser* parser) {
         lhs = ast_new_variable_expression(loc, identifier_token->value);
     }
     
+    if (lhs && parser_check(parser, KW_DOT)) {
+        DPRINT("[PARSER] Parsing field in LHS of assignment\n");
+        lhs = parse_field_expression(parser, lhs);
+    }
+    
     if (!lhs) {
         return NULL;
     }
@@ -931,7 +1210,15 @@ static ASTNode* parser_parse_primary_expression(Parser* parser) {
                 }
                 case LBRACKET: {
                     ASTNode* array = ast_new_variable_expression(loc, current->value);
-                    return parse_subscript_expression(parser, array);
+                    ASTNode* subscript = parse_subscript_expression(parser, array);
+                    if (subscript && parser_check(parser, KW_DOT)) {
+                        return parse_field_expression(parser, subscript);
+                    }
+                    return subscript;
+                }
+                case KW_DOT: {
+                    ASTNode* object = ast_new_variable_expression(loc, current->value);
+                    return parse_field_expression(parser, object);
                 }
                 default: {
                     DPRINT("[PARSER] Creating VariableExpression for '%s'\n", current->value);
@@ -1132,8 +1419,10 @@ static ASTNode* parser_parse_statement(Parser* parser) {
     DPRINT("[PARSER] parse_statement at index %zu token=%s value='%s'\n", parser->current, token_type_to_string(current->type), current->value ? current->value : "NULL");
     ASTNode* res = NULL;
     bool flag_fun_declaration = false;
+    // the statement may run past the streaming token window, keep only the type
+    TokenType statement_type = current->type;
     
-    switch (current->type) {
+    switch (statement_type) {
         case KW_IF:
             res = parser_parse_if_statement(parser);
             break;
@@ -1187,7 +1476,8 @@ static ASTNode* parser_parse_statement(Parser* parser) {
         case IDENTIFIER:
             {
                 Token* current_identifier = parser_advance(parser);
-                if (parser_check(parser, OP_ASSIGN) || parser_check(parser, LBRACKET)) {
+                if (parser_check(parser, OP_ASSIGN) || parser_check(parser, LBRACKET) ||
+                    parser_check(parser, KW_DOT)) {
                     parser_retreat(parser);
                     res = parser_parse_assignment_statement(parser);
                 } else {
@@ -1197,6 +1487,18 @@ static ASTNode* parser_parse_statement(Parser* parser) {
             }
             break;
 
+        case KW_STRUCT: {
+            // struct Name { ... }; declares a layout, struct Name[...] x; a variable
+            parser_advance(parser);
+            parser_advance(parser);
+            bool is_layout = parser_check(parser, LBRACE);
+            parser_retreat(parser);
+            parser_retreat(parser);
+            res = is_layout ? parser_parse_struct_declaration_statement(parser)
+                            : parser_parse_struct_variable_declaration_statement(parser);
+            break;
+        }
+
         case LBRACE:
             res = parser_parse_block(parser);
             break;
@@ -1229,10 +1531,10 @@ static ASTNode* parser_parse_statement(Parser* parser) {
     }
 
     if (res != NULL && 
-        current->type != KW_IF && 
-        current->type != KW_WHILE && 
-        current->type != KW_FOR && 
-        current->type != LBRACE &&
+        statement_type != KW_IF && 
+        statement_type != KW_WHILE && 
+        statement_type != KW_FOR && 
+        statement_type != LBRACE &&
         !flag_fun_declaration) {
 
         
@@ -1262,6 +1564,7 @@ static ASTNode* parser_parse_block(Parser* parser) {
         return NULL;
     }
 
+    size_t body_start = parser->current;
     while (!parser_is_at_end(parser) && parser_peek(parser) != NULL && parser_peek(parser)->type != RBRACE) {
         Token* current = parser_peek(parser);
         DPRINT("[PARSER] Parsing statement in block: type=%s, value='%s'\n", 
@@ -1281,6 +1584,8 @@ static ASTNode* parser_parse_block(Parser* parser) {
         else
             DPRINT("[PARSER] Failed to add statement to block\n");
 
+        if (parser->source) parser_release_retired(parser, body_start);
+
     }
 
     if (!parser_consume(parser, RBRACE, "Expected '}' after block")) {
@@ -1326,6 +1631,7 @@ ASTNode* parser_parse(Parser* parser) {
         add_statement_to_block(block_statements, stmt);
         
         ast_free(stmt);
+        if (parser->source) parser_release_retired(parser, 0);
     }
     
     DPRINT("[PARSER] Finished parsing, returning block with statements\n");
@@ -2,16 +2,36 @@
 
 #include "../AST/ast.h"
 #include "../lexer/token.h"
+#include "../lexer/lexer.h"
 #include <stdbool.h>
 
+// tokens kept behind the cursor when streaming from a lexer; bounds parser_retreat
+#define PARSER_TOKEN_WINDOW 64
+
+// spelling of a token evicted from the window; copied Tokens may still point at it
+typedef struct RetiredValue {
+    size_t index;           // absolute index of the token that owned `value`
+    char* value;
+} RetiredValue;
+
 typedef struct Parser {
     Token* tokens;
     size_t token_count;
     size_t current;
     size_t errors;
     SourceLocation current_location;
+
+    // streaming mode: tokens are pulled on demand from `source` into a ring
+    lexer* source;
+    size_t window_start;    // absolute index of the oldest buffered token
+    size_t window_end;      // absolute index one past the newest buffered token
+    bool source_done;
+    RetiredValue* retired;  // evicted heap-owned token values, oldest first
+    size_t retired_count;
+    size_t retired_capacity;
 } Parser;
 
 Parser* parser_create(Token* tokens, size_t token_count);
+Parser* parser_create_from_lexer(lexer* source);
 void parser_destroy(Parser* parser);
 ASTNode* parser_parse(Parser* parser);
@@ -4,109 +4,150 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
 
-#define GC_MARK_TABLE_SIZE 1024
-#define GC_MARK_TABLE_LOAD_FACTOR 0.75
+#define GC_MARK_STACK_INITIAL 256
+// objects processed between clock checks in incremental slices
+#define GC_SLICE_CHECK_INTERVAL 256
+// most grey objects a parallel marker takes from a victim at once
+#define GC_STEAL_BATCH 256
 
-typedef struct {
-    Object** marked_objects;
-    size_t capacity;
-    size_t size;
-    size_t threshold;
-} MarkTable;
+typedef enum {
+    GC_PHASE_IDLE,
+    GC_PHASE_MARK,
+    GC_PHASE_SWEEP,
+} GCPhase;
 
 struct GC {
     size_t allocated_count;
     size_t marked_count;
     size_t collected_count;
 
-    MarkTable mark_table;
+    // root scan cost of the last collection, plus the running total
+    size_t root_count;
+    uint64_t root_scan_ns;
+    uint64_t total_root_scan_ns;
+
+    // minor collections only trace and sweep young objects
+    bool minor;
+    size_t minor_collections;
+    size_t major_collections;
+    size_t promoted_count;
+
+    // helper threads for atomic major collections; 1 keeps them serial
+    size_t threads;
+    // roots are shaded without draining so workers can share the grey set
+    bool defer_drain;
+
+    // allocation-driven trigger policy, all sizes in bytes
+    double growth_factor;
+    size_t min_heap_bytes;
+    size_t young_budget;
+    size_t heap_target;
+    // old generation estimate: what survived the last major plus promotions
+    size_t old_bytes;
+    // old objects found live by the last sweep
+    size_t live_bytes;
+    double survival_rate;
+
+    // a major collection marked, the heap sweeps lazily as it allocates
+    bool lazy_sweep;
+
+    // incremental major cycle state
+    GCPhase phase;
+    bool sweep_restart;
+    size_t cycle_collected;
+
+    // every stop-the-world pause, bucketed by log2 microseconds
+    size_t pause_histogram[GC_PAUSE_BUCKETS];
+    size_t pause_count;
+    uint64_t total_pause_ns;
+    uint64_t max_pause_ns;
+
+    // telemetry: running totals, the totals when the current pause began,
+    // and a ring of the last GC_STATS_HISTORY pauses
+    GCWork work;
+    GCWork pause_work;
+    GCPauseRecord history[GC_STATS_HISTORY];
+    size_t history_next;
+
+    // old objects that may hold references to young ones
+    Object** remembered;
+    size_t remembered_count;
+    size_t remembered_capacity;
+
+    // old objects whose heap references all went away; see gc_decref_deferred
+    Object** zct;
+    size_t zct_count;
+    size_t zct_capacity;
+
+    // grey objects waiting to have their children scanned
+    Object** mark_stack;
+    size_t mark_stack_size;
+    size_t mark_stack_capacity;
 
     Object** roots;
     size_t roots_capacity;
     size_t roots_count;
 };
 
-static size_t hash_pointer(Object* obj) {
-    return ((size_t)obj) % GC_MARK_TABLE_SIZE;
+static uint64_t gc_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
 }
 
-static void mark_table_init(MarkTable* table) {
-    table->capacity = GC_MARK_TABLE_SIZE;
-    table->size = 0;
-    table->threshold = (size_t)(GC_MARK_TABLE_SIZE * GC_MARK_TABLE_LOAD_FACTOR);
-    table->marked_objects = calloc(table->capacity, sizeof(Object*));
+// Starts timing a pause; its work is measured against the totals here.
+static uint64_t gc_pause_begin(GC* gc) {
+    gc->pause_work = gc->work;
+    return gc_now_ns();
 }
 
-static void mark_table_clear(MarkTable* table) {
-    if (table->marked_objects) {
-        memset(table->marked_objects, 0, table->capacity * sizeof(Object*));
-    }
-    table->size = 0;
-}
+static void gc_record_pause(GC* gc, GCKind kind, uint64_t start_ns) {
+    uint64_t pause = gc_now_ns() - start_ns;
+    uint64_t us = pause / 1000;
 
-static bool mark_table_add(MarkTable* table, Object* obj) {
-    if (!obj || !table->marked_objects) return false;
-
-    if (table->size >= table->threshold) {
-        size_t new_capacity = table->capacity * 2;
-        Object** new_table = calloc(new_capacity, sizeof(Object*));
-        if (!new_table) return false;
-
-        for (size_t i = 0; i < table->capacity; i++) {
-            if (table->marked_objects[i]) {
-                size_t hash = ((size_t)table->marked_objects[i]) % new_capacity;
-                while (new_table[hash] != NULL) {
-                    hash = (hash + 1) % new_capacity;
-                }
-                new_table[hash] = table->marked_objects[i];
-            }
-        }
-        
-        free(table->marked_objects);
-        table->marked_objects = new_table;
-        table->capacity = new_capacity;
-        table->threshold = (size_t)(new_capacity * GC_MARK_TABLE_LOAD_FACTOR);
+    size_t bucket = 0;
+    while (bucket < GC_PAUSE_BUCKETS - 1 && us >= (1ull << bucket)) {
+        bucket++;
     }
-
-    size_t hash = hash_pointer(obj) % table->capacity;
-    while (table->marked_objects[hash] != NULL && table->marked_objects[hash] != obj) {
-        hash = (hash + 1) % table->capacity;
+    gc->pause_histogram[bucket]++;
+    gc->pause_count++;
+    gc->total_pause_ns += pause;
+    if (pause > gc->max_pause_ns) {
+        gc->max_pause_ns = pause;
     }
-    
-    if (table->marked_objects[hash] == NULL) {
-        table->marked_objects[hash] = obj;
-        table->size++;
-        return true;
-    }
-    
-    return false;
+
+    GCPauseRecord* record = &gc->history[gc->history_next];
+    gc->history_next = (gc->history_next + 1) % GC_STATS_HISTORY;
+    record->kind = kind;
+    record->pause_ns = pause;
+    record->work.marked_objects = gc->work.marked_objects - gc->pause_work.marked_objects;
+    record->work.marked_bytes = gc->work.marked_bytes - gc->pause_work.marked_bytes;
+    record->work.swept_objects = gc->work.swept_objects - gc->pause_work.swept_objects;
+    record->work.swept_bytes = gc->work.swept_bytes - gc->pause_work.swept_bytes;
+    record->work.promoted_objects = gc->work.promoted_objects - gc->pause_work.promoted_objects;
+    record->work.promoted_bytes = gc->work.promoted_bytes - gc->pause_work.promoted_bytes;
 }
 
-static bool mark_table_contains(MarkTable* table, Object* obj) {
-    if (!obj || !table->marked_objects) return false;
-    
-    size_t hash = hash_pointer(obj) % table->capacity;
-    size_t start_hash = hash;
-    
-    while (table->marked_objects[hash] != NULL) {
-        if (table->marked_objects[hash] == obj) {
-            return true;
-        }
-        hash = (hash + 1) % table->capacity;
-        if (hash == start_hash) break;
-    }
-    
-    return false;
+// Mark bits belong to an unfinished major until its sweep is done.
+static bool gc_busy(GC* gc) {
+    return gc->phase != GC_PHASE_IDLE || gc->lazy_sweep;
 }
 
-static void mark_table_destroy(MarkTable* table) {
-    if (table->marked_objects) {
-        free(table->marked_objects);
-        table->marked_objects = NULL;
+static bool mark_stack_push(GC* gc, Object* obj) {
+    if (gc->mark_stack_size >= gc->mark_stack_capacity) {
+        size_t new_capacity = gc->mark_stack_capacity == 0
+            ? GC_MARK_STACK_INITIAL : gc->mark_stack_capacity * 2;
+        Object** new_stack = realloc(gc->mark_stack, new_capacity * sizeof(Object*));
+        if (!new_stack) return false;
+        gc->mark_stack = new_stack;
+        gc->mark_stack_capacity = new_capacity;
     }
-    table->capacity = 0;
-    table->size = 0;
+    gc->mark_stack[gc->mark_stack_size++] = obj;
+    return true;
 }
 
 GC* gc_create(void) {
@@ -116,8 +157,54 @@ GC* gc_create(void) {
     g->allocated_count = 0;
     g->marked_count = 0;
     g->collected_count = 0;
-    
-    mark_table_init(&g->mark_table);
+
+    g->root_count = 0;
+    g->root_scan_ns = 0;
+    g->total_root_scan_ns = 0;
+
+    g->minor = false;
+    g->minor_collections = 0;
+    g->major_collections = 0;
+    g->promoted_count = 0;
+
+    g->threads = 1;
+    g->defer_drain = false;
+
+    g->growth_factor = GC_DEFAULT_GROWTH_FACTOR;
+    g->min_heap_bytes = GC_DEFAULT_MIN_HEAP;
+    g->young_budget = GC_YOUNG_BUDGET_INITIAL;
+    g->heap_target = GC_DEFAULT_MIN_HEAP;
+    g->old_bytes = 0;
+    g->live_bytes = 0;
+    g->survival_rate = 0.0;
+
+    g->lazy_sweep = false;
+
+    g->phase = GC_PHASE_IDLE;
+    g->sweep_restart = false;
+    g->cycle_collected = 0;
+
+    memset(g->pause_histogram, 0, sizeof(g->pause_histogram));
+    g->pause_count = 0;
+    g->total_pause_ns = 0;
+    g->max_pause_ns = 0;
+
+    memset(&g->work, 0, sizeof(g->work));
+    memset(&g->pause_work, 0, sizeof(g->pause_work));
+    memset(g->history, 0, sizeof(g->history));
+    g->history_next = 0;
+
+    g->remembered = NULL;
+    g->remembered_count = 0;
+    g->remembered_capacity = 0;
+
+    g->zct = NULL;
+    g->zct_count = 0;
+    g->zct_capacity = 0;
+
+    g->mark_stack = NULL;
+    g->mark_stack_size = 0;
+    g->mark_stack_capacity = 0;
     
     g->roots = NULL;
     g->roots_capacity = 0;
@@ -129,8 +216,10 @@ GC* gc_create(void) {
 void gc_destroy(GC* gc) {
     if (!gc) return;
     
-    mark_table_destroy(&gc->mark_table);
-    
+    free(gc->mark_stack);
+    free(gc->remembered);
+    free(gc->zct);
+
     if (gc->roots) {
         free(gc->roots);
     }
@@ -152,92 +241,239 @@ void gc_decref(GC* gc, Object* o) {
     object_decref(o);
 }
 
+static bool object_is_immortal(Object* obj) {
+    return obj->ref_count == 0x7FFFFFFF;
+}
+
+static void gc_zct_add(GC* gc, Object* obj) {
+    if (obj->gc_flags & (OBJ_GC_ZCT | OBJ_GC_YOUNG)) return;
+
+    if (gc->zct_count >= gc->zct_capacity) {
+        size_t new_capacity = gc->zct_capacity == 0 ? 64 : gc->zct_capacity * 2;
+        Object** new_zct = realloc(gc->zct, new_capacity * sizeof(Object*));
+        // unlogged, it waits for the next major collection instead
+        if (!new_zct) return;
+        gc->zct = new_zct;
+        gc->zct_capacity = new_capacity;
+    }
+    obj->gc_flags |= OBJ_GC_ZCT;
+    gc->zct[gc->zct_count++] = obj;
+}
+
+void gc_decref_deferred(GC* gc, Object* o) {
+    if (!gc || !o || object_is_immortal(o) || o->ref_count <= GC_RC_BIAS) return;
+
+    if (--o->ref_count == GC_RC_BIAS) {
+        gc_zct_add(gc, o);
+    }
+}
+
+size_t gc_get_zct_count(GC* gc) {
+    return gc ? gc->zct_count : 0;
+}
+
+// Objects with outgoing references to scan: boxed arrays with items and
+// views, whose one reference is their base.
+static inline bool gc_has_children(const Object* obj) {
+    return (object_array_has_refs(obj) && obj->as.array.size > 0) || object_array_base(obj);
+}
+
+static void gc_scan_object(GC* gc, Object* obj);
+
+// Sets the header mark bit and queues the object for scanning. Marking
+// never recurses, so deeply nested arrays cannot exhaust the C stack.
 static void gc_mark_object(GC* gc, Object* obj) {
     if (!obj || !gc) return;
 
-    if (mark_table_contains(&gc->mark_table, obj)) {
+    if (object_is_immortal(obj) || (obj->gc_flags & OBJ_GC_MARKED)) {
         return;
     }
-
-    if (obj->ref_count == 0x7FFFFFFF) {
+    // old objects are assumed live during a minor collection; logged
+    // zero-count ones are flagged so reconciliation keeps them
+    if (gc->minor && !(obj->gc_flags & OBJ_GC_YOUNG)) {
+        if (obj->gc_flags & OBJ_GC_ZCT) {
+            obj->gc_flags |= OBJ_GC_MARKED;
+        }
         return;
     }
 
-    if (mark_table_add(&gc->mark_table, obj)) {
-        gc->marked_count++;
+    obj->gc_flags |= OBJ_GC_MARKED;
+    gc->marked_count++;
+    gc->work.marked_objects++;
+    gc->work.marked_bytes += object_footprint(obj);
+
+    if (gc_has_children(obj) && !mark_stack_push(gc, obj)) {
+        // the mark bit is already set, so the object would never be queued
+        // again; scan it now rather than let the sweep free its children
+        DPRINT("[GC] Mark phase: failed to grow mark stack, scanning in place\n");
+        gc_scan_object(gc, obj);
     }
+}
+
+// Marks everything a grey object references.
+static void gc_scan_object(GC* gc, Object* obj) {
+    // freed by refcounting while grey; its items are gone
+    if (obj->ref_count == 0) return;
 
     switch (obj->type) {
         case OBJ_ARRAY:
-            if (obj->as.array.items) {
-                for (size_t i = 0; i < obj->as.array.size; i++) {
-                    if (obj->as.array.items[i]) {
-                        gc_mark_object(gc, obj->as.array.items[i]);
-                    }
+            gc_mark_object(gc, obj->as.array.base);
+            for (size_t i = 0; object_array_has_refs(obj) && i < obj->as.array.size; i++) {
+                if (obj->as.array.items[i]) {
+                    gc_mark_object(gc, obj->as.array.items[i]);
                 }
             }
             break;
-            
-        case OBJ_FUNCTION:
-            break;
-            
-        case OBJ_CODE:
-            break;
-            
-        case OBJ_NATIVE_FUNCTION:
-            break;
-            
-        case OBJ_INT:
-        case OBJ_BOOL:
-        case OBJ_NONE:
-        case OBJ_FLOAT:
-            break;
-            
+
         default:
             break;
     }
 }
 
-static void gc_mark_phase(GC* gc, Object** roots, size_t roots_count) {
+static void gc_drain_mark_stack(GC* gc) {
+    while (gc->mark_stack_size > 0) {
+        gc_scan_object(gc, gc->mark_stack[--gc->mark_stack_size]);
+    }
+}
+
+// Drains until the stack is empty or the deadline passes; returns true
+// when no grey objects are left.
+static bool gc_drain_mark_stack_until(GC* gc, uint64_t deadline_ns) {
+    while (gc->mark_stack_size > 0) {
+        size_t batch = gc->mark_stack_size < GC_SLICE_CHECK_INTERVAL
+            ? gc->mark_stack_size : GC_SLICE_CHECK_INTERVAL;
+        for (size_t n = 0; n < batch && gc->mark_stack_size > 0; n++) {
+            gc_scan_object(gc, gc->mark_stack[--gc->mark_stack_size]);
+        }
+        if (gc_now_ns() >= deadline_ns) break;
+    }
+    return gc->mark_stack_size == 0;
+}
+
+void gc_visit_root(GC* gc, Object* root) {
+    if (!gc || !root) return;
+    gc->root_count++;
+    gc_mark_object(gc, root);
+    // an incremental cycle leaves roots grey and drains them in slices
+    if (gc->phase != GC_PHASE_MARK && !gc->defer_drain) {
+        gc_drain_mark_stack(gc);
+    }
+}
+
+void gc_visit_roots(GC* gc, Object** slots, size_t count) {
+    if (!gc || !slots) return;
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i]) {
+            gc_visit_root(gc, slots[i]);
+        }
+    }
+}
+
+static void gc_mark_phase(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data) {
     if (!gc) return;
 
-    mark_table_clear(&gc->mark_table);
     gc->marked_count = 0;
-    
-    DPRINT("[GC] Mark phase: starting with %zu roots\n", roots_count);
+    gc->mark_stack_size = 0;
+    gc->root_count = 0;
 
-    for (size_t i = 0; i < roots_count; i++) {
-        if (roots[i]) {
-            gc_mark_object(gc, roots[i]);
-        }
+    DPRINT("[GC] Mark phase: starting\n");
+
+    uint64_t start = gc_now_ns();
+    if (enumerate_roots) {
+        enumerate_roots(gc, roots_data);
     }
-    
-    DPRINT("[GC] Mark phase: marked %zu objects\n", gc->marked_count);
+    gc->root_scan_ns = gc_now_ns() - start;
+    gc->total_root_scan_ns += gc->root_scan_ns;
+
+    DPRINT("[GC] Mark phase: marked %zu objects from %zu roots in %llu ns\n",
+           gc->marked_count, gc->root_count, (unsigned long long)gc->root_scan_ns);
 }
 
 typedef struct {
-    GC* gc;
-    Object** unmarked;
+    Object** roots;
     size_t count;
-    size_t capacity;
+} RootArray;
+
+static void enumerate_root_array(GC* gc, void* roots_data) {
+    RootArray* array = (RootArray*)roots_data;
+    gc_visit_roots(gc, array->roots, array->count);
+}
+
+static void gc_free_object_payload(Object* obj) {
+    switch (obj->type) {
+        case OBJ_ARRAY:
+            // a view's items and base reference belong to the base
+            if (obj->as.array.base) {
+                obj->as.array.base = NULL;
+                obj->as.array.items = NULL;
+                obj->as.array.size = 0;
+                obj->as.array.offset = 0;
+            } else if (obj->as.array.items) {
+                free(obj->as.array.items);
+                obj->as.array.items = NULL;
+                obj->as.array.size = 0;
+                obj->as.array.capacity = 0;
+            }
+            break;
+
+        case OBJ_NATIVE_FUNCTION:
+            if (obj->as.native_function.name) {
+                free((void*)obj->as.native_function.name);
+                obj->as.native_function.name = NULL;
+            }
+            break;
+
+        case OBJ_FLOAT:
+            if (obj->as.float_value) {
+                extern void bigfloat_destroy(BigFloat*);
+                bigfloat_destroy(obj->as.float_value);
+                obj->as.float_value = NULL;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+typedef struct {
+    GC* gc;
+    size_t collected;
+    size_t live_bytes;
+    size_t collected_bytes;
 } SweepContext;
 
-static void sweep_collect_callback(void* user_data, Object* obj) {
+static void gc_note_sweep(GC* gc, const SweepContext* ctx) {
+    gc->collected_count += ctx->collected;
+    gc->work.swept_objects += ctx->collected;
+    gc->work.swept_bytes += ctx->collected_bytes;
+}
+
+// Survivors get their mark bit cleared for the next cycle; everything
+// else that is still live from the heap's point of view is reclaimed.
+static void sweep_object_callback(void* user_data, Object* obj) {
     SweepContext* ctx = (SweepContext*)user_data;
     if (!ctx || !obj) return;
 
-    if (obj->ref_count == 0x7FFFFFFF) {
+    if (obj->gc_flags & OBJ_GC_MARKED) {
+        obj->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+        // young survivors are counted when they are promoted
+        if (!(obj->gc_flags & OBJ_GC_YOUNG)) {
+            ctx->live_bytes += object_footprint(obj);
+        }
         return;
     }
 
-    if (!mark_table_contains(&ctx->gc->mark_table, obj)) {
-        if (ctx->count >= ctx->capacity) {
-            ctx->capacity = ctx->capacity == 0 ? 64 : ctx->capacity * 2;
-            ctx->unmarked = realloc(ctx->unmarked, ctx->capacity * sizeof(Object*));
-            if (!ctx->unmarked) return;
-        }
-        ctx->unmarked[ctx->count++] = obj;
+    if (obj->ref_count == 0 || object_is_immortal(obj)) {
+        return;
     }
+
+    DPRINT("[GC] Sweep: collecting object type=%d at %p\n", obj->type, (void*)obj);
+
+    ctx->collected_bytes += object_footprint(obj);
+    gc_free_object_payload(obj);
+    obj->ref_count = 0;
+    ctx->collected++;
 }
 
 static void gc_sweep_phase(GC* gc, GC_ObjectIterator iterate_all_objects, void* iterator_data) {
@@ -254,78 +490,803 @@ static void gc_sweep_phase(GC* gc, GC_ObjectIterator iterate_all_objects, void*
 
     SweepContext ctx = {0};
     ctx.gc = gc;
-    ctx.capacity = 64;
-    ctx.unmarked = malloc(ctx.capacity * sizeof(Object*));
-    
-    if (!ctx.unmarked) {
-        DPRINT("[GC] Sweep phase: failed to allocate memory\n");
-        return;
-    }
 
-    iterate_all_objects(iterator_data, sweep_collect_callback, &ctx);
-
-    for (size_t i = 0; i < ctx.count; i++) {
-        Object* obj = ctx.unmarked[i];
-        if (obj) {
-            DPRINT("[GC] Sweep: collecting object type=%d at %p\n", obj->type, (void*)obj);
-
-            switch (obj->type) {
-                case OBJ_ARRAY:
-                    if (obj->as.array.items) {
-                        free(obj->as.array.items);
-                        obj->as.array.items = NULL;
-                        obj->as.array.size = 0;
-                    }
-                    break;
-                    
-                case OBJ_NATIVE_FUNCTION:
-                    if (obj->as.native_function.name) {
-                        free((void*)obj->as.native_function.name);
-                        obj->as.native_function.name = NULL;
-                    }
-                    break;
-                    
-                case OBJ_FLOAT:
-                    if (obj->as.float_value) {
-                        extern void bigfloat_destroy(BigFloat*);
-                        bigfloat_destroy(obj->as.float_value);
-                        obj->as.float_value = NULL;
-                    }
-                    break;
-                    
-                default:
-                    break;
-            }
-            obj->ref_count = 0;
-            collected++;
-        }
-    }
-    
-    free(ctx.unmarked);
-    
-    gc->collected_count += collected;
+    iterate_all_objects(iterator_data, sweep_object_callback, &ctx);
+    collected = ctx.collected;
+
+    gc_note_sweep(gc, &ctx);
+    gc->live_bytes = ctx.live_bytes;
     DPRINT("[GC] Sweep phase: collected %zu objects\n", collected);
 }
 
-void gc_collect(GC* gc, Object** roots, size_t roots_count,
-                GC_ObjectIterator iterate_all_objects, void* iterator_data) {
-    if (!gc) return;
-    
+static void gc_collect_atomic(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                              GC_ObjectIterator iterate_all_objects, void* iterator_data) {
     DPRINT("[GC] Starting garbage collection...\n");
 
-    gc_mark_phase(gc, roots, roots_count);
+    gc_mark_phase(gc, enumerate_roots, roots_data);
 
     if (iterate_all_objects) {
         gc_sweep_phase(gc, iterate_all_objects, iterator_data);
     }
-    
+
     DPRINT("[GC] Garbage collection completed. Marked: %zu, Collected: %zu\n",
            gc->marked_count, gc->collected_count);
 }
 
+void gc_collect_with_roots(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                           GC_ObjectIterator iterate_all_objects, void* iterator_data) {
+    if (!gc || gc_busy(gc)) return;
+
+    uint64_t start = gc_pause_begin(gc);
+    gc_collect_atomic(gc, enumerate_roots, roots_data, iterate_all_objects, iterator_data);
+    gc_record_pause(gc, GC_KIND_MAJOR, start);
+}
+
+void gc_collect(GC* gc, Object** roots, size_t roots_count,
+                GC_ObjectIterator iterate_all_objects, void* iterator_data) {
+    RootArray array = { roots, roots_count };
+    gc_collect_with_roots(gc, enumerate_root_array, &array, iterate_all_objects, iterator_data);
+}
+
+void gc_remember(GC* gc, Object* holder) {
+    if (!gc || !holder || (holder->gc_flags & OBJ_GC_REMEMBERED)) return;
+
+    if (gc->remembered_count >= gc->remembered_capacity) {
+        size_t new_capacity = gc->remembered_capacity == 0 ? 64 : gc->remembered_capacity * 2;
+        Object** new_set = realloc(gc->remembered, new_capacity * sizeof(Object*));
+        if (!new_set) return;
+        gc->remembered = new_set;
+        gc->remembered_capacity = new_capacity;
+    }
+    holder->gc_flags |= OBJ_GC_REMEMBERED;
+    gc->remembered[gc->remembered_count++] = holder;
+}
+
+// A remembered entry can be freed by refcounting and even reused as a
+// young object before the next collection; both are skipped here.
+static bool remembered_entry_valid(Object* obj) {
+    return obj->ref_count != 0 && !object_is_immortal(obj) &&
+           !(obj->gc_flags & OBJ_GC_YOUNG);
+}
+
+static bool object_has_young_child(Object* obj) {
+    Object* base = object_array_base(obj);
+    if (base && (base->gc_flags & OBJ_GC_YOUNG)) return true;
+    if (!object_array_has_refs(obj)) return false;
+    for (size_t i = 0; i < obj->as.array.size; i++) {
+        Object* item = obj->as.array.items[i];
+        if (item && (item->gc_flags & OBJ_GC_YOUNG)) return true;
+    }
+    return false;
+}
+
+static void gc_trace_remembered(GC* gc) {
+    for (size_t i = 0; i < gc->remembered_count; i++) {
+        Object* holder = gc->remembered[i];
+        if (!remembered_entry_valid(holder) || !gc_has_children(holder)) {
+            continue;
+        }
+        gc_mark_object(gc, object_array_base(holder));
+        for (size_t j = 0; object_array_has_refs(holder) && j < holder->as.array.size; j++) {
+            if (holder->as.array.items[j]) {
+                gc_mark_object(gc, holder->as.array.items[j]);
+            }
+        }
+        gc_drain_mark_stack(gc);
+    }
+}
+
+// Keeps only live old objects that still point into the nursery, once each.
+static void gc_rebuild_remembered(GC* gc) {
+    for (size_t i = 0; i < gc->remembered_count; i++) {
+        gc->remembered[i]->gc_flags &= (uint8_t)~OBJ_GC_REMEMBERED;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < gc->remembered_count; i++) {
+        Object* holder = gc->remembered[i];
+        if (!remembered_entry_valid(holder) || (holder->gc_flags & OBJ_GC_REMEMBERED)) {
+            continue;
+        }
+        if (object_has_young_child(holder)) {
+            holder->gc_flags |= OBJ_GC_REMEMBERED;
+            gc->remembered[kept++] = holder;
+        }
+    }
+    gc->remembered_count = kept;
+}
+
+// Runs after a minor collection marked from the roots. A logged object
+// still at the bias that no root reached is garbage: every heap reference
+// to it would have been counted. Its items lose their counts, and the ones
+// falling to the bias are logged for the next minor, since the roots were
+// not checked for them. Entries whose slot was reused are dropped.
+static size_t gc_reconcile_zct(GC* gc) {
+    size_t count = gc->zct_count;
+    size_t kept = 0;
+    size_t freed = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        Object* obj = gc->zct[i];
+        if (!(obj->gc_flags & OBJ_GC_ZCT)) continue;
+
+        if (obj->ref_count != GC_RC_BIAS) {
+            obj->gc_flags &= (uint8_t)~(OBJ_GC_ZCT | OBJ_GC_MARKED);
+            continue;
+        }
+        if (obj->gc_flags & OBJ_GC_MARKED) {
+            gc->zct[kept++] = obj;
+            continue;
+        }
+
+        DPRINT("[GC] Reconcile: collecting object type=%d at %p\n", obj->type, (void*)obj);
+        size_t bytes = object_footprint(obj);
+        gc->old_bytes -= bytes < gc->old_bytes ? bytes : gc->old_bytes;
+        gc->work.swept_objects++;
+        gc->work.swept_bytes += bytes;
+        if (object_array_has_refs(obj)) {
+            for (size_t j = 0; j < obj->as.array.size; j++) {
+                gc_decref_deferred(gc, obj->as.array.items[j]);
+            }
+        }
+        gc_decref_deferred(gc, object_array_base(obj));
+        gc_free_object_payload(obj);
+        obj->ref_count = 0;
+        obj->gc_flags &= (uint8_t)~OBJ_GC_ZCT;
+        freed++;
+    }
+
+    // rooted entries stay logged, once each, with their flag cleared
+    size_t unique = 0;
+    for (size_t i = 0; i < kept; i++) {
+        Object* obj = gc->zct[i];
+        if (!(obj->gc_flags & OBJ_GC_MARKED)) continue;
+        obj->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+        gc->zct[unique++] = obj;
+    }
+    // entries logged while reconciling; gc->zct stays NULL until the first one
+    size_t logged = gc->zct_count - count;
+    if (logged > 0) {
+        memmove(gc->zct + unique, gc->zct + count, logged * sizeof(Object*));
+    }
+    gc->zct_count = unique + logged;
+    return freed;
+}
+
+// Walks the nursery log after marking. Dead entries are dropped (and
+// reclaimed when sweep_unmarked is set), survivors age and are promoted
+// in place once they reach GC_PROMOTION_AGE.
+static size_t gc_age_nursery(GC* gc, Object** young, size_t* young_count, bool sweep_unmarked) {
+    size_t kept = 0;
+    size_t collected = 0;
+    size_t young_bytes = 0;
+    size_t survived_bytes = 0;
+
+    for (size_t i = 0; i < *young_count; i++) {
+        Object* obj = young[i];
+
+        if (obj->ref_count == 0 || object_is_immortal(obj)) {
+            obj->gc_flags &= (uint8_t)~(OBJ_GC_YOUNG | OBJ_GC_MARKED);
+            continue;
+        }
+
+        size_t bytes = object_footprint(obj);
+        young_bytes += bytes;
+
+        if (sweep_unmarked && !(obj->gc_flags & OBJ_GC_MARKED)) {
+            DPRINT("[GC] Minor sweep: collecting object type=%d at %p\n", obj->type, (void*)obj);
+            gc_free_object_payload(obj);
+            obj->ref_count = 0;
+            obj->gc_flags &= (uint8_t)~OBJ_GC_YOUNG;
+            collected++;
+            gc->work.swept_objects++;
+            gc->work.swept_bytes += bytes;
+            continue;
+        }
+
+        survived_bytes += bytes;
+        if (++obj->gc_age >= GC_PROMOTION_AGE) {
+            // a pending lazy sweep must still find promoted objects marked
+            if (!gc->lazy_sweep) {
+                obj->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+            }
+            obj->gc_flags &= (uint8_t)~OBJ_GC_YOUNG;
+            gc->promoted_count++;
+            gc->old_bytes += bytes;
+            gc->work.promoted_objects++;
+            gc->work.promoted_bytes += bytes;
+            // only stack and local slots hold it; reconcile it from now on
+            if (obj->ref_count == GC_RC_BIAS) {
+                gc_zct_add(gc, obj);
+            }
+            // its children may stay young; gc_rebuild_remembered prunes this
+            if (obj->type == OBJ_ARRAY) {
+                gc_remember(gc, obj);
+            }
+            continue;
+        }
+        obj->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+        young[kept++] = obj;
+    }
+
+    *young_count = kept;
+    if (young_bytes > 0) {
+        gc->survival_rate = (double)survived_bytes / (double)young_bytes;
+    }
+    return collected;
+}
+
+// Collecting a nursery that mostly survives is wasted work, so its budget
+// doubles and gives objects longer to die; a nursery that mostly dies can
+// be collected sooner to keep the footprint cache-sized.
+static void gc_resize_young_budget(GC* gc) {
+    if (gc->survival_rate > GC_SURVIVAL_HIGH && gc->young_budget < GC_YOUNG_BUDGET_MAX) {
+        gc->young_budget *= 2;
+    } else if (gc->survival_rate < GC_SURVIVAL_LOW && gc->young_budget > GC_YOUNG_BUDGET_MIN) {
+        gc->young_budget /= 2;
+    }
+}
+
+// The next major collection is due once the old generation grows to
+// growth_factor times what the last one left live.
+static void gc_update_heap_target(GC* gc) {
+    double target = (double)gc->live_bytes * gc->growth_factor;
+    gc->heap_target = target > (double)gc->min_heap_bytes ? (size_t)target : gc->min_heap_bytes;
+
+    DPRINT("[GC] Heap target: %zu live bytes, next major at %zu bytes\n",
+           gc->live_bytes, gc->heap_target);
+}
+
+void gc_collect_minor(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                      Object** young, size_t* young_count) {
+    if (!gc || !young_count) return;
+    // a major cycle in progress owns the mark bits until it finishes
+    if (gc_busy(gc)) return;
+
+    uint64_t start = gc_pause_begin(gc);
+    DPRINT("[GC] Minor collection: %zu young objects, %zu remembered\n",
+           *young_count, gc->remembered_count);
+
+    gc->minor = true;
+    gc_mark_phase(gc, enumerate_roots, roots_data);
+    gc_trace_remembered(gc);
+
+    size_t reconciled = gc_reconcile_zct(gc);
+    size_t collected = gc_age_nursery(gc, young, young_count, true);
+    gc_rebuild_remembered(gc);
+    gc_resize_young_budget(gc);
+    gc->minor = false;
+
+    gc->collected_count += collected + reconciled;
+    gc->minor_collections++;
+    gc_record_pause(gc, GC_KIND_MINOR, start);
+
+    DPRINT("[GC] Minor collection completed. Marked: %zu, Collected: %zu, Young: %zu\n",
+           gc->marked_count, collected, *young_count);
+    DPRINT("[GC] Reconciled zero-count table: %zu freed, %zu still logged\n",
+           reconciled, gc->zct_count);
+}
+
+void gc_set_threads(GC* gc, size_t threads) {
+    if (gc) gc->threads = threads > 0 ? threads : 1;
+}
+
+size_t gc_get_threads(GC* gc) {
+    return gc ? gc->threads : 1;
+}
+
+// Per-worker grey set. The owner pushes and pops at the tail, thieves
+// take the older half from the head.
+typedef struct {
+    Object** items;
+    size_t head;
+    size_t tail;
+    size_t capacity;
+    pthread_mutex_t lock;
+} MarkDeque;
+
+typedef struct ParallelMark ParallelMark;
+
+typedef struct {
+    ParallelMark* shared;
+    MarkDeque deque;
+    size_t index;
+    size_t marked;
+    size_t marked_bytes;
+} MarkWorker;
+
+struct ParallelMark {
+    MarkWorker* workers;
+    size_t worker_count;
+    size_t participants;
+    size_t idle;
+};
+
+static bool mark_deque_push(MarkDeque* deque, Object* obj) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail >= deque->capacity) {
+        size_t live = deque->tail - deque->head;
+        if (deque->head > 0 && live < deque->capacity / 2) {
+            memmove(deque->items, deque->items + deque->head, live * sizeof(Object*));
+        } else {
+            size_t new_capacity = deque->capacity == 0 ? GC_MARK_STACK_INITIAL : deque->capacity * 2;
+            Object** new_items = malloc(new_capacity * sizeof(Object*));
+            if (!new_items) {
+                pthread_mutex_unlock(&deque->lock);
+                return false;
+            }
+            if (live > 0) {
+                memcpy(new_items, deque->items + deque->head, live * sizeof(Object*));
+            }
+            free(deque->items);
+            deque->items = new_items;
+            deque->capacity = new_capacity;
+        }
+        deque->head = 0;
+        deque->tail = live;
+    }
+    deque->items[deque->tail++] = obj;
+    pthread_mutex_unlock(&deque->lock);
+    return true;
+}
+
+static Object* mark_deque_pop(MarkDeque* deque) {
+    Object* obj = NULL;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail > deque->head) {
+        obj = deque->items[--deque->tail];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return obj;
+}
+
+static bool mark_deque_empty(MarkDeque* deque) {
+    pthread_mutex_lock(&deque->lock);
+    bool empty = deque->tail == deque->head;
+    pthread_mutex_unlock(&deque->lock);
+    return empty;
+}
+
+static void mark_worker_scan(MarkWorker* worker, Object* obj);
+
+// Queues a marked object on the worker's deque. The mark bit is already
+// set, so if the deque cannot grow the object is scanned right away.
+static void mark_worker_push(MarkWorker* worker, Object* obj) {
+    if (!mark_deque_push(&worker->deque, obj)) {
+        mark_worker_scan(worker, obj);
+    }
+}
+
+// Moves half of victim's oldest entries into thief; returns how many.
+static size_t mark_deque_steal(MarkDeque* victim, MarkWorker* thief) {
+    Object* batch[GC_STEAL_BATCH];
+    size_t taken = 0;
+
+    pthread_mutex_lock(&victim->lock);
+    size_t available = victim->tail - victim->head;
+    if (available > 0) {
+        taken = (available + 1) / 2;
+        if (taken > GC_STEAL_BATCH) taken = GC_STEAL_BATCH;
+        memcpy(batch, victim->items + victim->head, taken * sizeof(Object*));
+        victim->head += taken;
+    }
+    pthread_mutex_unlock(&victim->lock);
+
+    for (size_t i = 0; i < taken; i++) {
+        mark_worker_push(thief, batch[i]);
+    }
+    return taken;
+}
+
+// Only the thread that flips the bit scans the object.
+static bool gc_try_mark_atomic(Object* obj) {
+    if (object_is_immortal(obj)) return false;
+    uint8_t old = __atomic_fetch_or(&obj->gc_flags, (uint8_t)OBJ_GC_MARKED, __ATOMIC_ACQ_REL);
+    return !(old & OBJ_GC_MARKED);
+}
+
+static void mark_worker_visit(MarkWorker* worker, Object* item) {
+    if (!item || !gc_try_mark_atomic(item)) return;
+    worker->marked++;
+    worker->marked_bytes += object_footprint(item);
+    if (gc_has_children(item)) {
+        mark_worker_push(worker, item);
+    }
+}
+
+static void mark_worker_scan(MarkWorker* worker, Object* obj) {
+    if (obj->ref_count == 0) return;
+
+    mark_worker_visit(worker, object_array_base(obj));
+    for (size_t i = 0; object_array_has_refs(obj) && i < obj->as.array.size; i++) {
+        mark_worker_visit(worker, obj->as.array.items[i]);
+    }
+}
+
+static bool mark_worker_steal(MarkWorker* worker) {
+    ParallelMark* shared = worker->shared;
+    for (size_t n = 1; n < shared->worker_count; n++) {
+        MarkWorker* victim = &shared->workers[(worker->index + n) % shared->worker_count];
+        if (mark_deque_steal(&victim->deque, worker) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool mark_all_deques_empty(ParallelMark* shared) {
+    for (size_t i = 0; i < shared->worker_count; i++) {
+        if (!mark_deque_empty(&shared->workers[i].deque)) return false;
+    }
+    return true;
+}
+
+static void* mark_worker_run(void* arg) {
+    MarkWorker* worker = (MarkWorker*)arg;
+    ParallelMark* shared = worker->shared;
+
+    for (;;) {
+        Object* obj;
+        while ((obj = mark_deque_pop(&worker->deque)) != NULL) {
+            mark_worker_scan(worker, obj);
+        }
+        if (mark_worker_steal(worker)) continue;
+
+        // A worker only goes idle with an empty deque and nobody pushes
+        // into another worker's deque, so all idle means marking is done.
+        __atomic_fetch_add(&shared->idle, 1, __ATOMIC_ACQ_REL);
+        for (;;) {
+            if (!mark_all_deques_empty(shared)) {
+                __atomic_fetch_sub(&shared->idle, 1, __ATOMIC_ACQ_REL);
+                break;
+            }
+            if (__atomic_load_n(&shared->idle, __ATOMIC_ACQUIRE) ==
+                __atomic_load_n(&shared->participants, __ATOMIC_ACQUIRE)) {
+                return NULL;
+            }
+            sched_yield();
+        }
+    }
+}
+
+static void gc_mark_parallel(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data) {
+    gc->marked_count = 0;
+    gc->mark_stack_size = 0;
+    gc->root_count = 0;
+
+    uint64_t start = gc_now_ns();
+    gc->defer_drain = true;
+    if (enumerate_roots) {
+        enumerate_roots(gc, roots_data);
+    }
+    gc->defer_drain = false;
+    gc->root_scan_ns = gc_now_ns() - start;
+    gc->total_root_scan_ns += gc->root_scan_ns;
+
+    size_t count = gc->threads;
+    ParallelMark shared = { NULL, count, count, 0 };
+    MarkWorker* workers = calloc(count, sizeof(MarkWorker));
+    if (!workers) {
+        gc_drain_mark_stack(gc);
+        return;
+    }
+    shared.workers = workers;
+
+    for (size_t i = 0; i < count; i++) {
+        workers[i].shared = &shared;
+        workers[i].index = i;
+        pthread_mutex_init(&workers[i].deque.lock, NULL);
+    }
+    // roots were marked serially; deal the grey ones out round-robin
+    for (size_t i = 0; i < gc->mark_stack_size; i++) {
+        mark_worker_push(&workers[i % count], gc->mark_stack[i]);
+    }
+    gc->mark_stack_size = 0;
+
+    pthread_t* threads = malloc((count - 1) * sizeof(pthread_t));
+    size_t started = 0;
+    for (size_t i = 1; threads && i < count; i++) {
+        if (pthread_create(&threads[started], NULL, mark_worker_run, &workers[i]) != 0) {
+            // its deque stays stealable; just stop waiting for it to go idle
+            __atomic_fetch_sub(&shared.participants, 1, __ATOMIC_ACQ_REL);
+            continue;
+        }
+        started++;
+    }
+    if (!threads) {
+        shared.participants = 1;
+    }
+    mark_worker_run(&workers[0]);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    for (size_t i = 0; i < count; i++) {
+        gc->marked_count += workers[i].marked;
+        gc->work.marked_objects += workers[i].marked;
+        gc->work.marked_bytes += workers[i].marked_bytes;
+        free(workers[i].deque.items);
+        pthread_mutex_destroy(&workers[i].deque.lock);
+    }
+    free(workers);
+
+    DPRINT("[GC] Parallel mark: %zu threads marked %zu objects from %zu roots\n",
+           count, gc->marked_count, gc->root_count);
+}
+
+typedef struct {
+    SweepContext ctx;
+    GC_PartitionIterator iterate_partition;
+    void* iterator_data;
+    size_t part;
+    size_t parts;
+} SweepWorker;
+
+static void* sweep_worker_run(void* arg) {
+    SweepWorker* worker = (SweepWorker*)arg;
+    worker->iterate_partition(worker->iterator_data, worker->part, worker->parts,
+                              sweep_object_callback, &worker->ctx);
+    return NULL;
+}
+
+static void gc_sweep_parallel(GC* gc, GC_PartitionIterator iterate_partition, void* iterator_data) {
+    size_t count = gc->threads;
+    SweepWorker* workers = calloc(count, sizeof(SweepWorker));
+    pthread_t* threads = malloc(count * sizeof(pthread_t));
+    if (!workers || !threads) {
+        free(workers);
+        free(threads);
+        SweepContext ctx = { gc, 0, 0, 0 };
+        iterate_partition(iterator_data, 0, 1, sweep_object_callback, &ctx);
+        gc_note_sweep(gc, &ctx);
+        gc->live_bytes = ctx.live_bytes;
+        return;
+    }
+
+    bool* joined = calloc(count, sizeof(bool));
+    for (size_t i = 0; i < count; i++) {
+        workers[i].ctx.gc = gc;
+        workers[i].iterate_partition = iterate_partition;
+        workers[i].iterator_data = iterator_data;
+        workers[i].part = i;
+        workers[i].parts = count;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if (joined && pthread_create(&threads[i], NULL, sweep_worker_run, &workers[i]) == 0) {
+            joined[i] = true;
+        } else {
+            sweep_worker_run(&workers[i]);
+        }
+    }
+    sweep_worker_run(&workers[0]);
+
+    SweepContext total = { gc, 0, 0, 0 };
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && joined && joined[i]) {
+            pthread_join(threads[i], NULL);
+        }
+        total.collected += workers[i].ctx.collected;
+        total.live_bytes += workers[i].ctx.live_bytes;
+        total.collected_bytes += workers[i].ctx.collected_bytes;
+    }
+    gc_note_sweep(gc, &total);
+    gc->live_bytes = total.live_bytes;
+
+    DPRINT("[GC] Parallel sweep: %zu threads collected %zu objects\n", count, total.collected);
+
+    free(joined);
+    free(threads);
+    free(workers);
+}
+
+typedef struct {
+    GC_PartitionIterator iterate_partition;
+    void* iterator_data;
+} WholeHeap;
+
+static void iterate_whole_heap(void* iterator_data, GC_ObjectCallback callback, void* callback_data) {
+    WholeHeap* heap = (WholeHeap*)iterator_data;
+    heap->iterate_partition(heap->iterator_data, 0, 1, callback, callback_data);
+}
+
+void gc_collect_major(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                      GC_PartitionIterator iterate_partition, void* iterator_data,
+                      Object** young, size_t* young_count) {
+    if (!gc || gc_busy(gc)) return;
+
+    uint64_t start = gc_pause_begin(gc);
+    if (gc->threads > 1 && iterate_partition) {
+        gc_mark_parallel(gc, enumerate_roots, roots_data);
+        gc_sweep_parallel(gc, iterate_partition, iterator_data);
+    } else {
+        WholeHeap heap = { iterate_partition, iterator_data };
+        gc_collect_atomic(gc, enumerate_roots, roots_data,
+                          iterate_partition ? iterate_whole_heap : NULL, &heap);
+    }
+
+    gc->old_bytes = gc->live_bytes;
+    gc_update_heap_target(gc);
+    // the full sweep already reclaimed dead young objects and cleared marks
+    if (young && young_count) {
+        gc_age_nursery(gc, young, young_count, false);
+    }
+    gc_rebuild_remembered(gc);
+    gc->major_collections++;
+    gc_record_pause(gc, GC_KIND_MAJOR, start);
+}
+
+void gc_collect_major_lazy(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                           Object** young, size_t* young_count) {
+    if (!gc || gc_busy(gc)) return;
+
+    uint64_t start = gc_pause_begin(gc);
+    gc_mark_phase(gc, enumerate_roots, roots_data);
+    gc->lazy_sweep = true;
+    gc->live_bytes = 0;
+
+    // young objects are swept here; the heap's lazy sweep skips them
+    if (young && young_count) {
+        gc->collected_count += gc_age_nursery(gc, young, young_count, true);
+    }
+    gc_rebuild_remembered(gc);
+    gc->major_collections++;
+    gc_record_pause(gc, GC_KIND_MAJOR, start);
+
+    DPRINT("[GC] Major collection marked %zu objects, sweeping lazily\n", gc->marked_count);
+}
+
+bool gc_incremental_active(GC* gc) {
+    return gc && gc->phase != GC_PHASE_IDLE;
+}
+
+void gc_shade(GC* gc, Object* obj) {
+    if (!gc || gc->phase != GC_PHASE_MARK) return;
+    gc_mark_object(gc, obj);
+}
+
+void gc_incremental_start(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data) {
+    if (!gc || gc_busy(gc)) return;
+
+    uint64_t start = gc_pause_begin(gc);
+    gc->phase = GC_PHASE_MARK;
+    gc->cycle_collected = 0;
+    gc->live_bytes = 0;
+    // roots are only shaded grey here; slices blacken them
+    gc_mark_phase(gc, enumerate_roots, roots_data);
+    gc_record_pause(gc, GC_KIND_INCREMENTAL, start);
+
+    DPRINT("[GC] Incremental cycle started: %zu roots, %zu grey\n",
+           gc->root_count, gc->mark_stack_size);
+}
+
+// Young objects were allocated white and wired up without barriers, so
+// the final remark treats them like roots; the sweep leaves them to the
+// next minor collection.
+static void incremental_sweep_callback(void* user_data, Object* obj) {
+    if (obj->gc_flags & OBJ_GC_YOUNG) {
+        obj->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+        return;
+    }
+    sweep_object_callback(user_data, obj);
+}
+
+void gc_sweep_object(void* user_data, Object* obj) {
+    GC* gc = (GC*)user_data;
+    if (!gc || !obj) return;
+
+    SweepContext ctx = { gc, 0, 0, 0 };
+    incremental_sweep_callback(&ctx, obj);
+    gc_note_sweep(gc, &ctx);
+    gc->live_bytes += ctx.live_bytes;
+}
+
+bool gc_lazy_sweep_pending(GC* gc) {
+    return gc && gc->lazy_sweep;
+}
+
+void gc_finish_lazy_sweep(GC* gc) {
+    if (!gc || !gc->lazy_sweep) return;
+
+    gc->lazy_sweep = false;
+    gc->old_bytes = gc->live_bytes;
+    gc_update_heap_target(gc);
+}
+
+bool gc_incremental_step(GC* gc, uint64_t budget_ns,
+                         GC_RootEnumerator enumerate_roots, void* roots_data,
+                         GC_ObjectStepIterator step_objects, void* iterator_data,
+                         Object** young, size_t young_count) {
+    if (!gc || gc->phase == GC_PHASE_IDLE) return true;
+
+    uint64_t start = gc_pause_begin(gc);
+    uint64_t deadline = budget_ns > UINT64_MAX - start ? UINT64_MAX : start + budget_ns;
+
+    if (gc->phase == GC_PHASE_MARK) {
+        if (!gc_drain_mark_stack_until(gc, deadline)) {
+            gc_record_pause(gc, GC_KIND_INCREMENTAL, start);
+            return false;
+        }
+
+        // remark: locals, stacks and globals change without barriers
+        gc->root_count = 0;
+        if (enumerate_roots) {
+            enumerate_roots(gc, roots_data);
+        }
+        for (size_t i = 0; i < young_count; i++) {
+            if (young[i]->ref_count != 0) {
+                gc_mark_object(gc, young[i]);
+            }
+        }
+        gc->phase = GC_PHASE_SWEEP;
+        gc_drain_mark_stack(gc);
+        gc->sweep_restart = true;
+
+        DPRINT("[GC] Incremental remark: %zu roots, %zu marked\n",
+               gc->root_count, gc->marked_count);
+    }
+
+    SweepContext ctx = {0};
+    ctx.gc = gc;
+    bool done = !step_objects;
+    while (!done) {
+        done = step_objects(iterator_data, gc->sweep_restart, GC_SLICE_CHECK_INTERVAL,
+                            incremental_sweep_callback, &ctx);
+        gc->sweep_restart = false;
+        if (gc_now_ns() >= deadline) break;
+    }
+    gc->cycle_collected += ctx.collected;
+    gc_note_sweep(gc, &ctx);
+    gc->live_bytes += ctx.live_bytes;
+
+    if (done) {
+        gc->phase = GC_PHASE_IDLE;
+        gc->old_bytes = gc->live_bytes;
+        gc_update_heap_target(gc);
+        gc_rebuild_remembered(gc);
+        gc->major_collections++;
+        DPRINT("[GC] Incremental cycle completed. Marked: %zu, Collected: %zu\n",
+               gc->marked_count, gc->cycle_collected);
+    }
+
+    gc_record_pause(gc, GC_KIND_INCREMENTAL, start);
+    return done;
+}
+
+// Without a heap iterator there is no sweep to reset the mark bits, so
+// walk the marked graph again and clear them here.
+static void gc_clear_marks(GC* gc, Object** roots, size_t roots_count) {
+    gc->mark_stack_size = 0;
+    for (size_t i = 0; i < roots_count; i++) {
+        Object* root = roots[i];
+        if (!root || !(root->gc_flags & OBJ_GC_MARKED)) continue;
+        root->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+        if (!mark_stack_push(gc, root)) continue;
+
+        while (gc->mark_stack_size > 0) {
+            Object* obj = gc->mark_stack[--gc->mark_stack_size];
+            Object* base = object_array_base(obj);
+            if (base && (base->gc_flags & OBJ_GC_MARKED)) {
+                base->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+                mark_stack_push(gc, base);
+            }
+            if (!object_array_has_refs(obj)) continue;
+            for (size_t j = 0; j < obj->as.array.size; j++) {
+                Object* item = obj->as.array.items[j];
+                if (item && (item->gc_flags & OBJ_GC_MARKED)) {
+                    item->gc_flags &= (uint8_t)~OBJ_GC_MARKED;
+                    mark_stack_push(gc, item);
+                }
+            }
+        }
+    }
+}
+
 void gc_collect_simple(GC* gc, Object** roots, size_t roots_count) {
-    if (!gc) return;
-    gc_mark_phase(gc, roots, roots_count);
+    if (!gc || gc_busy(gc)) return;
+    RootArray array = { roots, roots_count };
+    gc_mark_phase(gc, enumerate_root_array, &array);
+    gc_clear_marks(gc, roots, roots_count);
 }
 
 void gc_add_root(GC* gc, Object* root) {
@@ -361,6 +1322,38 @@ void gc_clear_roots(GC* gc) {
     gc->roots_count = 0;
 }
 
+void gc_set_growth_factor(GC* gc, double factor) {
+    if (!gc || factor <= 1.0) return;
+    gc->growth_factor = factor;
+    gc_update_heap_target(gc);
+}
+
+void gc_set_min_heap(GC* gc, size_t bytes) {
+    if (!gc) return;
+    gc->min_heap_bytes = bytes;
+    gc_update_heap_target(gc);
+}
+
+bool gc_major_due(GC* gc) {
+    return gc && gc->old_bytes >= gc->heap_target;
+}
+
+size_t gc_get_young_budget(GC* gc) {
+    return gc ? gc->young_budget : 0;
+}
+
+size_t gc_get_heap_target(GC* gc) {
+    return gc ? gc->heap_target : 0;
+}
+
+size_t gc_get_old_bytes(GC* gc) {
+    return gc ? gc->old_bytes : 0;
+}
+
+double gc_get_survival_rate(GC* gc) {
+    return gc ? gc->survival_rate : 0.0;
+}
+
 size_t gc_get_allocated_count(GC* gc) {
     return gc ? gc->allocated_count : 0;
 }
@@ -372,3 +1365,100 @@ size_t gc_get_marked_count(GC* gc) {
 size_t gc_get_collected_count(GC* gc) {
     return gc ? gc->collected_count : 0;
 }
+
+size_t gc_get_root_count(GC* gc) {
+    return gc ? gc->root_count : 0;
+}
+
+uint64_t gc_get_root_scan_ns(GC* gc) {
+    return gc ? gc->root_scan_ns : 0;
+}
+
+uint64_t gc_get_total_root_scan_ns(GC* gc) {
+    return gc ? gc->total_root_scan_ns : 0;
+}
+
+size_t gc_get_minor_count(GC* gc) {
+    return gc ? gc->minor_collections : 0;
+}
+
+size_t gc_get_major_count(GC* gc) {
+    return gc ? gc->major_collections : 0;
+}
+
+size_t gc_get_promoted_count(GC* gc) {
+    return gc ? gc->promoted_count : 0;
+}
+
+size_t gc_get_remembered_count(GC* gc) {
+    return gc ? gc->remembered_count : 0;
+}
+
+const size_t* gc_get_pause_histogram(GC* gc) {
+    return gc ? gc->pause_histogram : NULL;
+}
+
+size_t gc_get_pause_count(GC* gc) {
+    return gc ? gc->pause_count : 0;
+}
+
+uint64_t gc_get_max_pause_ns(GC* gc) {
+    return gc ? gc->max_pause_ns : 0;
+}
+
+uint64_t gc_get_total_pause_ns(GC* gc) {
+    return gc ? gc->total_pause_ns : 0;
+}
+
+void gc_print_pause_histogram(GC* gc) {
+    if (!gc || !debug_enabled) return;
+
+    DPRINT("\n=== GC Pauses ===\n");
+    DPRINT("Pauses: %zu, total %.3f ms, max %.3f ms\n", gc->pause_count,
+           gc->total_pause_ns / 1e6, gc->max_pause_ns / 1e6);
+    for (size_t i = 0; i < GC_PAUSE_BUCKETS; i++) {
+        if (gc->pause_histogram[i] == 0) continue;
+        if (i == GC_PAUSE_BUCKETS - 1) {
+            DPRINT("  >= %8llu us | %zu\n", 1ull << (i - 1), gc->pause_histogram[i]);
+        } else {
+            DPRINT("  <  %8llu us | %zu\n", 1ull << i, gc->pause_histogram[i]);
+        }
+    }
+    DPRINT("=================\n");
+}
+
+const char* gc_kind_name(GCKind kind) {
+    switch (kind) {
+        case GC_KIND_MINOR: return "minor";
+        case GC_KIND_MAJOR: return "major";
+        case GC_KIND_INCREMENTAL: return "incremental";
+        default: return "unknown";
+    }
+}
+
+void gc_get_stats(GC* gc, GCStats* stats) {
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!gc) return;
+
+    stats->minor_collections = gc->minor_collections;
+    stats->major_collections = gc->major_collections;
+    stats->pause_count = gc->pause_count;
+    stats->total_pause_ns = gc->total_pause_ns;
+    stats->max_pause_ns = gc->max_pause_ns;
+    stats->total = gc->work;
+
+    stats->young_budget = gc->young_budget;
+    stats->heap_target = gc->heap_target;
+    stats->old_bytes = gc->old_bytes;
+    stats->survival_rate = gc->survival_rate;
+    stats->remembered_count = gc->remembered_count;
+    stats->zct_count = gc->zct_count;
+
+    size_t count = gc->pause_count < GC_STATS_HISTORY ? gc->pause_count : GC_STATS_HISTORY;
+    size_t first = (gc->history_next + GC_STATS_HISTORY - count) % GC_STATS_HISTORY;
+    for (size_t i = 0; i < count; i++) {
+        stats->history[i] = gc->history[(first + i) % GC_STATS_HISTORY];
+    }
+    stats->history_count = count;
+}
@@ -3,6 +3,7 @@
 #include "../vm/object.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 typedef struct GC GC;
 
@@ -10,15 +11,121 @@ typedef void (*GC_ObjectCallback)(void* user_data, Object* obj);
 
 typedef void (*GC_ObjectIterator)(void* iterator_data, GC_ObjectCallback callback, void* callback_data);
 
+// Resumable object walk for incremental sweeping: restart rewinds to the
+// first object; returns true once every object has been visited.
+typedef bool (*GC_ObjectStepIterator)(void* iterator_data, bool restart, size_t max_objects,
+                                      GC_ObjectCallback callback, void* callback_data);
+
+// Visits the part-th of parts disjoint slices of the heap, so slices can
+// be swept on different threads; parts == 1 covers every object.
+typedef void (*GC_PartitionIterator)(void* iterator_data, size_t part, size_t parts,
+                                     GC_ObjectCallback callback, void* callback_data);
+
+// Called once per collection; reports every root in place through
+// gc_visit_root / gc_visit_roots instead of copying them into a buffer.
+typedef void (*GC_RootEnumerator)(GC* gc, void* roots_data);
+
 GC* gc_create(void);
 void gc_destroy(GC* gc);
 
 void gc_incref(GC* gc, Object* o);
 void gc_decref(GC* gc, Object* o);
 
+// Deferred reference counting. The VM only counts heap-to-heap references
+// (array items and globals); stack and local slots are roots instead. A
+// live object holds GC_RC_BIAS plus one count per heap reference, so a
+// dropped reference never frees anything: an old object falling back to
+// the bias is logged in the zero-count table, and each minor collection
+// frees the logged objects that no root reaches. Young ones are left to
+// the minor collection itself.
+#define GC_RC_BIAS 1
+
+void gc_decref_deferred(GC* gc, Object* o);
+size_t gc_get_zct_count(GC* gc);
+
 void gc_collect(GC* gc, Object** roots, size_t roots_count, 
                 GC_ObjectIterator iterate_all_objects, void* iterator_data);
 
+void gc_collect_with_roots(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                           GC_ObjectIterator iterate_all_objects, void* iterator_data);
+
+// Generational collection. Young objects are listed in a nursery log owned
+// by the caller; minor collections trace from the roots plus the
+// remembered set and only sweep that log, major ones cover the whole heap.
+#define GC_PROMOTION_AGE 2
+
+void gc_collect_minor(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                      Object** young, size_t* young_count);
+void gc_collect_major(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                      GC_PartitionIterator iterate_partition, void* iterator_data,
+                      Object** young, size_t* young_count);
+
+// Major collection that only marks. Young objects are swept at once; the
+// heap then sweeps the rest block by block, passing each object to
+// gc_sweep_object (with the GC as user data) as it allocates. Finish the
+// sweep and call gc_finish_lazy_sweep before the next collection.
+void gc_collect_major_lazy(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data,
+                           Object** young, size_t* young_count);
+void gc_sweep_object(void* gc, Object* obj);
+bool gc_lazy_sweep_pending(GC* gc);
+void gc_finish_lazy_sweep(GC* gc);
+
+// Atomic major collections mark with work-stealing helper threads and
+// sweep heap partitions in parallel when threads > 1.
+void gc_set_threads(GC* gc, size_t threads);
+size_t gc_get_threads(GC* gc);
+
+// Allocation-driven triggering. The caller collects once it has allocated
+// gc_get_young_budget() bytes since the last collection, and makes that
+// collection major when gc_major_due(). The young budget follows the
+// survival rate of minor collections; the major target is growth_factor
+// times the old bytes left live by the last major, never below min_heap.
+#define GC_DEFAULT_GROWTH_FACTOR 2.0
+#define GC_DEFAULT_MIN_HEAP      (8u << 20)
+#define GC_YOUNG_BUDGET_INITIAL  (256u << 10)
+#define GC_YOUNG_BUDGET_MIN      (64u << 10)
+#define GC_YOUNG_BUDGET_MAX      (32u << 20)
+#define GC_SURVIVAL_HIGH         0.5
+#define GC_SURVIVAL_LOW          0.05
+
+void gc_set_growth_factor(GC* gc, double factor);
+void gc_set_min_heap(GC* gc, size_t bytes);
+bool gc_major_due(GC* gc);
+size_t gc_get_young_budget(GC* gc);
+size_t gc_get_heap_target(GC* gc);
+size_t gc_get_old_bytes(GC* gc);
+double gc_get_survival_rate(GC* gc);
+
+// Incremental tri-color major cycle. Start shades the roots; each step
+// blackens grey objects, then remarks roots and the young objects and
+// sweeps, within budget_ns. A step returns true once the cycle is done.
+bool gc_incremental_active(GC* gc);
+void gc_incremental_start(GC* gc, GC_RootEnumerator enumerate_roots, void* roots_data);
+bool gc_incremental_step(GC* gc, uint64_t budget_ns,
+                         GC_RootEnumerator enumerate_roots, void* roots_data,
+                         GC_ObjectStepIterator step_objects, void* iterator_data,
+                         Object** young, size_t young_count);
+
+void gc_remember(GC* gc, Object* holder);
+void gc_shade(GC* gc, Object* obj);
+
+// Must run after storing value into holder's payload. Records old->young
+// edges, and keeps marked (black) holders from pointing at white objects
+// while an incremental cycle is marking.
+static inline void gc_write_barrier(GC* gc, Object* holder, Object* value) {
+    if (!value) return;
+    if ((value->gc_flags & OBJ_GC_YOUNG) &&
+        !(holder->gc_flags & (OBJ_GC_YOUNG | OBJ_GC_REMEMBERED))) {
+        gc_remember(gc, holder);
+    }
+    if ((holder->gc_flags & OBJ_GC_MARKED) && !(value->gc_flags & OBJ_GC_MARKED)) {
+        gc_shade(gc, value);
+    }
+}
+
+void gc_visit_root(GC* gc, Object* root);
+void gc_visit_roots(GC* gc, Object** slots, size_t count);
+
 void gc_collect_simple(GC* gc, Object** roots, size_t roots_count);
 
 void gc_add_root(GC* gc, Object* root);
@@ -28,4 +135,69 @@ void gc_clear_roots(GC* gc);
 size_t gc_get_allocated_count(GC* gc);
 size_t gc_get_marked_count(GC* gc);
 size_t gc_get_collected_count(GC* gc);
+size_t gc_get_root_count(GC* gc);
+uint64_t gc_get_root_scan_ns(GC* gc);
+uint64_t gc_get_total_root_scan_ns(GC* gc);
+size_t gc_get_minor_count(GC* gc);
+size_t gc_get_major_count(GC* gc);
+size_t gc_get_promoted_count(GC* gc);
+size_t gc_get_remembered_count(GC* gc);
+
+// bucket i counts pauses shorter than 2^i us; the last bucket is open-ended
+#define GC_PAUSE_BUCKETS 20
+const size_t* gc_get_pause_histogram(GC* gc);
+size_t gc_get_pause_count(GC* gc);
+uint64_t gc_get_max_pause_ns(GC* gc);
+uint64_t gc_get_total_pause_ns(GC* gc);
+void gc_print_pause_histogram(GC* gc);
+
+// Telemetry. The collector keeps running totals of the work it does, and
+// records what each pause did: a whole stop-the-world collection, or one
+// slice of an incremental cycle. Work done outside pauses (lazy sweeping
+// from the allocator) only shows in the totals.
+#define GC_STATS_HISTORY 32
+
+typedef enum {
+    GC_KIND_MINOR,
+    GC_KIND_MAJOR,
+    GC_KIND_INCREMENTAL,
+} GCKind;
+
+typedef struct {
+    size_t marked_objects;
+    size_t marked_bytes;
+    size_t swept_objects;
+    size_t swept_bytes;
+    size_t promoted_objects;
+    size_t promoted_bytes;
+} GCWork;
+
+typedef struct {
+    GCKind kind;
+    uint64_t pause_ns;
+    GCWork work;
+} GCPauseRecord;
+
+typedef struct {
+    size_t minor_collections;
+    size_t major_collections;
+    size_t pause_count;
+    uint64_t total_pause_ns;
+    uint64_t max_pause_ns;
+    GCWork total;
+
+    size_t young_budget;
+    size_t heap_target;
+    size_t old_bytes;
+    double survival_rate;
+    size_t remembered_count;
+    size_t zct_count;
+
+    // the last history_count pauses, oldest first
+    size_t history_count;
+    GCPauseRecord history[GC_STATS_HISTORY];
+} GCStats;
+
+void gc_get_stats(GC* gc, GCStats* stats);
+const char* gc_kind_name(GCKind kind);
 
@@ -0,0 +1,349 @@
+#include "bounds.h"
+#include "const_folding.h"
+#include "../../system.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ---------------------------------------------------------------------------
+// Counted loops
+//
+//     for (i = <init>; i < n; i = i + step) body
+//
+// where n is a local or an int constant and step a positive int constant
+// or a local. If the body never stores i, n, step or an array it indexes
+// with a[i], makes no calls and deletes nothing, no array can shrink while
+// the loop runs, so 0 <= i and n <= len(a) checked once on entry cover
+// every a[i] in it. Such a loop is versioned:
+//
+//     GUARD_INDEX i / GUARD_INDEX step / GUARD_LENGTH a, n   -> slow
+//     fast: the loop with a[i] as LOAD/STORE_SUBSCR_UNCHECKED
+//           JUMP_FORWARD done
+//     slow: the loop as it was, LOOP_START marked so it is not versioned again
+//     done:
+//
+// Both copies keep their own relative jumps and BREAK_LOOP/CONTINUE_LOOP
+// find their loop by nesting, so only jumps that cross the loop move.
+
+#define BOUNDS_MAX_ARRAYS 8
+#define BOUNDS_MAX_LOOPS 16
+#define BOUNDS_MAX_GROWTH 8         // never more than 8x the original code
+#define BOUNDS_INDEX_LIMIT (INT64_C(1) << 62)   // what GUARD_INDEX accepts
+#define LOOP_START_CHECKED 1        // LOOP_START arg of a slow copy
+
+typedef struct {
+    size_t start, end;      // [start, end) is the loop, end its exit
+    size_t body;            // first instruction after the condition
+    uint32_t i_idx;
+    bytecode step;          // LOAD_CONST or LOAD_FAST
+    bytecode bound;         // LOAD_CONST or LOAD_FAST
+    uint32_t arrays[BOUNDS_MAX_ARRAYS];
+    size_t array_count;
+    size_t subscripts;
+} CountedLoop;
+
+static int is_op(bytecode bc, uint8_t op, uint32_t arg) {
+    return bc.op_code == op && bytecode_get_arg(bc) == arg;
+}
+
+static int const_int(CodeObj* code, uint32_t idx, int64_t* value) {
+    if (idx >= code->constants_count || code->constants[idx].type != VAL_INT) return 0;
+    *value = code->constants[idx].int_val;
+    return 1;
+}
+
+static int is_backward(uint8_t op) {
+    return op == JUMP_BACKWARD || op == JUMP_BACKWARD_NO_INTERRUPT;
+}
+
+static int jump_target(bytecode bc, size_t at, size_t* target) {
+    uint32_t arg = bytecode_get_arg(bc);
+    switch (bc.op_code) {
+        case JUMP_BACKWARD:
+        case JUMP_BACKWARD_NO_INTERRUPT:
+            if (arg > at + 1) return 0;
+            *target = at + 1 - arg;
+            return 1;
+        case JUMP_FORWARD:
+        case POP_JUMP_IF_TRUE:
+        case POP_JUMP_IF_FALSE:
+        case POP_JUMP_IF_NONE:
+        case POP_JUMP_IF_NOT_NONE:
+            *target = at + 1 + arg;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static bytecode jump_to(uint8_t op, size_t at, size_t target) {
+    uint32_t arg = is_backward(op) ? (uint32_t)(at + 1 - target) : (uint32_t)(target - at - 1);
+    return bytecode_create_with_number(op, arg);
+}
+
+// One flag per instruction (plus the end): some jump lands there.
+static uint8_t* find_jump_targets(CodeObj* code) {
+    uint8_t* targets = calloc(code->code.count + 1, 1);
+    if (!targets) return NULL;
+    for (size_t k = 0; k < code->code.count; k++) {
+        size_t t;
+        if (jump_target(code->code.bytecodes[k], k, &t) && t <= code->code.count) {
+            targets[t] = 1;
+        }
+    }
+    return targets;
+}
+
+// a[i] in the body: LOAD_FAST a; LOAD_FAST i; LOAD_SUBSCR or STORE_SUBSCR at
+// k, with nothing jumping in between the operands and the subscript.
+static int is_loop_subscript(CodeObj* code, const CountedLoop* m, const uint8_t* targets, size_t k) {
+    bytecode* ins = code->code.bytecodes;
+    if (k < m->body + 2 || k + 2 >= m->end) return 0;
+    if (ins[k].op_code != LOAD_SUBSCR && ins[k].op_code != STORE_SUBSCR) return 0;
+    if (!is_op(ins[k - 1], LOAD_FAST, m->i_idx) || ins[k - 2].op_code != LOAD_FAST) return 0;
+    if (bytecode_get_arg(ins[k - 2]) == m->i_idx) return 0;
+    return !targets[k - 1] && !targets[k];
+}
+
+static int is_loop_local(const CountedLoop* m, uint32_t idx) {
+    if (idx == m->i_idx) return 1;
+    if (m->step.op_code == LOAD_FAST && bytecode_get_arg(m->step) == idx) return 1;
+    if (m->bound.op_code == LOAD_FAST && bytecode_get_arg(m->bound) == idx) return 1;
+    for (size_t a = 0; a < m->array_count; a++) {
+        if (m->arrays[a] == idx) return 1;
+    }
+    return 0;
+}
+
+// Collects the arrays indexed by i, then rejects bodies that could move i,
+// the bound or the step, rebind or shrink an array, or jump out of the loop
+// other than through its exit.
+static int scan_body(CodeObj* code, CountedLoop* m, const uint8_t* targets) {
+    bytecode* ins = code->code.bytecodes;
+    size_t back_edge = m->end - 2;
+
+    m->array_count = 0;
+    m->subscripts = 0;
+    for (size_t k = m->body; k < back_edge; k++) {
+        if (!is_loop_subscript(code, m, targets, k)) continue;
+        uint32_t a = bytecode_get_arg(ins[k - 2]);
+        size_t n = 0;
+        while (n < m->array_count && m->arrays[n] != a) n++;
+        if (n == m->array_count) {
+            if (m->array_count == BOUNDS_MAX_ARRAYS) return 0;
+            m->arrays[m->array_count++] = a;
+        }
+        m->subscripts++;
+    }
+    if (m->subscripts == 0) return 0;
+
+    for (size_t k = m->body; k < back_edge; k++) {
+        size_t t;
+        switch (ins[k].op_code) {
+            case CALL_FUNCTION:
+            case DEL_SUBSCR:
+                return 0;
+            case STORE_FAST:
+                if (is_loop_local(m, bytecode_get_arg(ins[k]))) return 0;
+                break;
+            default:
+                if (jump_target(ins[k], k, &t) && (t <= m->start || t > m->end)) return 0;
+                break;
+        }
+    }
+    return 1;
+}
+
+// The canonical for loop the compiler emits, starting at the JUMP_FORWARD
+// into its condition:
+//
+//     p    JUMP_FORWARD -> p+6          p+6  LOAD_FAST i
+//     p+1  LOOP_START                   p+7  LOAD_FAST n | LOAD_CONST
+//     p+2  LOAD_FAST i                  p+8  BINARY_OP <
+//     p+3  LOAD_CONST | LOAD_FAST s     p+9  POP_JUMP_IF_FALSE -> exit
+//     p+4  BINARY_OP +                       body
+//     p+5  STORE_FAST i                      JUMP_BACKWARD -> p+1
+//                                            LOOP_END
+static int match_counted_loop(CodeObj* code, const uint8_t* targets, size_t p, CountedLoop* m) {
+    bytecode* ins = code->code.bytecodes;
+    size_t count = code->code.count;
+    size_t t;
+    int64_t c;
+
+    if (p + 12 > count) return 0;
+    if (ins[p].op_code != JUMP_FORWARD || !jump_target(ins[p], p, &t) || t != p + 6) return 0;
+    if (!is_op(ins[p + 1], LOOP_START, 0)) return 0;
+
+    if (ins[p + 2].op_code != LOAD_FAST) return 0;
+    m->i_idx = bytecode_get_arg(ins[p + 2]);
+    m->step = ins[p + 3];
+    if (m->step.op_code == LOAD_CONST) {
+        if (!const_int(code, bytecode_get_arg(m->step), &c) || c <= 0 || c >= BOUNDS_INDEX_LIMIT) return 0;
+    } else if (m->step.op_code != LOAD_FAST || bytecode_get_arg(m->step) == m->i_idx) {
+        return 0;
+    }
+    if (!is_op(ins[p + 4], BINARY_OP, 0x00) || !is_op(ins[p + 5], STORE_FAST, m->i_idx)) return 0;
+
+    if (!is_op(ins[p + 6], LOAD_FAST, m->i_idx)) return 0;
+    m->bound = ins[p + 7];
+    if (m->bound.op_code == LOAD_CONST) {
+        if (!const_int(code, bytecode_get_arg(m->bound), &c)) return 0;
+    } else if (m->bound.op_code != LOAD_FAST || bytecode_get_arg(m->bound) == m->i_idx) {
+        return 0;
+    }
+    if (!is_op(ins[p + 8], BINARY_OP, 0x52) || ins[p + 9].op_code != POP_JUMP_IF_FALSE) return 0;
+    m->body = p + 10;
+
+    int depth = 1;
+    size_t q = p + 2;
+    for (; q < count; q++) {
+        if (ins[q].op_code == LOOP_START) depth++;
+        else if (ins[q].op_code == LOOP_END && --depth == 0) break;
+    }
+    if (q >= count || q < m->body + 1) return 0;
+    m->start = p;
+    m->end = q + 1;
+    if (ins[q - 1].op_code != JUMP_BACKWARD || !jump_target(ins[q - 1], q - 1, &t) || t != p + 1) return 0;
+    if (!jump_target(ins[p + 9], p + 9, &t) || t != m->end) return 0;
+
+    return scan_body(code, m, targets);
+}
+
+static size_t guard_size(const CountedLoop* m) {
+    return 3 + (m->step.op_code == LOAD_FAST ? 3 : 0) + 4 * m->array_count;
+}
+
+// <operands> <guard> POP_JUMP_IF_FALSE slow
+static void emit_guard(bytecode* out, size_t* p, const bytecode* operands, size_t n, uint8_t guard, size_t slow) {
+    for (size_t k = 0; k < n; k++) out[(*p)++] = operands[k];
+    out[(*p)++] = bytecode_create_with_number(guard, 0);
+    out[*p] = jump_to(POP_JUMP_IF_FALSE, *p, slow);
+    (*p)++;
+}
+
+static int version_loop(CodeObj* code, const CountedLoop* m, const uint8_t* targets) {
+    bytecode* ins = code->code.bytecodes;
+    size_t count = code->code.count;
+    size_t len = m->end - m->start;
+    size_t guards = guard_size(m);
+    size_t delta = guards + len + 1;
+
+    bytecode* out = malloc((count + delta) * sizeof(bytecode));
+    if (!out) return 0;
+
+    // everything around the loop; jumps into it now land on the slow copy,
+    // jumps to its start on the guards
+    for (size_t k = 0; k < count; k++) {
+        if (k >= m->start && k < m->end) continue;
+        size_t at = k < m->start ? k : k + delta;
+        bytecode bc = ins[k];
+        size_t t;
+        if (jump_target(bc, k, &t)) {
+            bc = jump_to(bc.op_code, at, t <= m->start ? t : t + delta);
+        }
+        out[at] = bc;
+    }
+
+    size_t slow = m->start + guards + len + 1;
+    size_t p = m->start;
+    bytecode i = bytecode_create_with_number(LOAD_FAST, m->i_idx);
+    emit_guard(out, &p, &i, 1, GUARD_INDEX, slow);
+    if (m->step.op_code == LOAD_FAST) emit_guard(out, &p, &m->step, 1, GUARD_INDEX, slow);
+    for (size_t a = 0; a < m->array_count; a++) {
+        bytecode operands[2] = { bytecode_create_with_number(LOAD_FAST, m->arrays[a]), m->bound };
+        emit_guard(out, &p, operands, 2, GUARD_LENGTH, slow);
+    }
+
+    for (size_t k = m->start; k < m->end; k++) {
+        bytecode bc = ins[k];
+        if (is_loop_subscript(code, m, targets, k)) {
+            bc.op_code = bc.op_code == LOAD_SUBSCR ? LOAD_SUBSCR_UNCHECKED : STORE_SUBSCR_UNCHECKED;
+        }
+        out[p++] = bc;
+    }
+    out[p] = jump_to(JUMP_FORWARD, p, slow + len);
+    p++;
+
+    memcpy(out + slow, ins + m->start, len * sizeof(bytecode));
+    out[slow + 1] = bytecode_create_with_number(LOOP_START, LOOP_START_CHECKED);
+
+    free(code->code.bytecodes);
+    code->code.bytecodes = out;
+    code->code.count = count + delta;
+    code->code.capacity = count + delta;
+    return 1;
+}
+
+static int find_loop(CodeObj* code, const uint8_t* targets, CountedLoop* m) {
+    for (size_t p = 0; p < code->code.count; p++) {
+        if (match_counted_loop(code, targets, p, m)) return 1;
+    }
+    return 0;
+}
+
+int has_bounds_loop(CodeObj* code) {
+    if (!code || !code->code.bytecodes || !code->constants) return 0;
+
+    uint8_t* targets = find_jump_targets(code);
+    if (!targets) return 0;
+    CountedLoop m;
+    int found = find_loop(code, targets, &m);
+    free(targets);
+    return found;
+}
+
+// The fast copy of a versioned loop has no checked a[i] left and the slow
+// copy is marked, so every round either versions a new loop or stops.
+static int find_and_version_loops(CodeObj* code, BoundsStats* stats) {
+    size_t limit = code->code.count * BOUNDS_MAX_GROWTH;
+
+    while (stats->versioned_loops < BOUNDS_MAX_LOOPS) {
+        uint8_t* targets = find_jump_targets(code);
+        if (!targets) break;
+
+        CountedLoop m;
+        int versioned = 0;
+        if (find_loop(code, targets, &m) &&
+            code->code.count + guard_size(&m) + (m.end - m.start) + 1 <= limit) {
+            DPRINT("[JIT-BOUNDS] Unchecked loop at [%zu, %zu): i=%u, %zu array(s), %zu subscript(s)\n",
+                   m.start, m.end, m.i_idx, m.array_count, m.subscripts);
+            versioned = version_loop(code, &m, targets);
+        }
+        free(targets);
+        if (!versioned) break;
+
+        stats->versioned_loops++;
+        stats->unchecked_subscripts += m.subscripts;
+    }
+    return stats->versioned_loops > 0;
+}
+
+CodeObj* jit_optimize_bounds(CodeObj* original, BoundsStats* stats) {
+    memset(stats, 0, sizeof(BoundsStats));
+
+    if (!original || !original->code.bytecodes || !original->constants) {
+        DPRINT("[JIT-BOUNDS] Invalid input\n");
+        return NULL;
+    }
+
+    if (!has_bounds_loop(original)) {
+        DPRINT("[JIT-BOUNDS] No counted loops to version in '%s'\n",
+               original->name ? original->name : "anonymous");
+        return NULL;
+    }
+
+    CodeObj* optimized = deep_copy_codeobj(original);
+    if (!optimized) {
+        DPRINT("[JIT-BOUNDS] Failed to copy CodeObj\n");
+        return NULL;
+    }
+
+    if (find_and_version_loops(optimized, stats)) {
+        DPRINT("[JIT-BOUNDS] Versioned %zu loop(s), %zu unchecked subscript(s), size %u -> %u\n",
+               stats->versioned_loops, stats->unchecked_subscripts,
+               original->code.count, optimized->code.count);
+        return optimized;
+    }
+
+    free_code_obj(optimized);
+    return NULL;
+}
@@ -0,0 +1,17 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include "../../compiler/bytecode.h"
+#include "../../compiler/value.h"
+
+typedef struct {
+    size_t versioned_loops;
+    size_t unchecked_subscripts;
+} BoundsStats;
+
+// A counted loop whose subscripts a[i] can run without bounds checks once
+// a few guards have passed on entry.
+int has_bounds_loop(CodeObj* code);
+CodeObj* jit_optimize_bounds(CodeObj* original, BoundsStats* stats);
+
+#endif
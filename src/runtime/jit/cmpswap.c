@@ -36,7 +36,7 @@ static int is_store_local_with_idx(bytecode bc, size_t idx) {
 static CodeObj* deep_copy_codeobj(CodeObj* original) {
     if (!original) return NULL;
     
-    CodeObj* copy = malloc(sizeof(CodeObj));
+    CodeObj* copy = calloc(1, sizeof(CodeObj));
     if (!copy) return NULL;
     
     copy->name = original->name ? strdup(original->name) : NULL;
@@ -295,12 +295,376 @@ static void replace_with_swap(bytecode_array* bc, size_t start, PatternMatch* ma
     bc->bytecodes[start + 3] = bytecode_create_with_number(SWAP_ARRAY_ELEMENTS, 0x00);
 }
 
+// ---------------------------------------------------------------------------
+// Whole bubble-sort loop nests:
+//
+//     for (int i = 0; i < Y; i = i + 1)
+//         for (int j = 0; j < X [- i]; j = j + 1)
+//             if (a[j] > a[j + 1]) { swap a[j], a[j + 1] through t }
+//
+// with Y = X or X + 1 sort a[0 .. X] ascending, so one SORT_ARRAY over
+// [0, X + 1) goes in front of the nest. It only sorts when the range lies
+// inside the array and holds numbers, where the order of equal values cannot
+// be observed; otherwise it pushes false and the unchanged nest runs.
+
+#define BINARY_OP_LT 0x52
+#define BINARY_OP_GT 0x54
+#define BINARY_OP_SUB 0x0A
+
+typedef struct {
+    uint8_t op;        // LOAD_FAST or LOAD_CONST
+    uint32_t arg;
+    int64_t offset;    // 0, or -1 for "operand - 1"
+} LoopBound;
+
+typedef struct {
+    size_t start, end;  // [start, end) is replaced
+    size_t array_idx, i_idx, j_idx, temp_idx;
+    size_t zero_const, one_const;
+    LoopBound inner;    // X
+} SortLoopMatch;
+
+static int const_is_int(CodeObj* code, uint32_t idx, int64_t value) {
+    return idx < code->constants_count && code->constants[idx].type == VAL_INT &&
+           code->constants[idx].int_val == value;
+}
+
+static int is_op(bytecode bc, uint8_t op, uint32_t arg) {
+    return bc.op_code == op && bytecode_get_arg(bc) == arg;
+}
+
+static int jump_target(bytecode bc, size_t at, size_t* target) {
+    uint32_t arg = bytecode_get_arg(bc);
+    if (bc.op_code == JUMP_BACKWARD) {
+        if (arg > at + 1) return 0;
+        *target = at + 1 - arg;
+        return 1;
+    }
+    if (bc.op_code == JUMP_FORWARD || bc.op_code == POP_JUMP_IF_FALSE) {
+        *target = at + arg + 1;
+        return 1;
+    }
+    return 0;
+}
+
+// operand ["one" SUB]; the operand may not be one of the loop's own locals
+static int match_bound(CodeObj* code, size_t* pos, SortLoopMatch* m, LoopBound* bound) {
+    bytecode* ins = code->code.bytecodes;
+    size_t p = *pos;
+    if (p + 2 >= code->code.count) return 0;
+
+    bytecode op = ins[p];
+    if (op.op_code == LOAD_CONST) {
+        uint32_t c = bytecode_get_arg(op);
+        if (c >= code->constants_count || code->constants[c].type != VAL_INT) return 0;
+    } else if (op.op_code == LOAD_FAST) {
+        uint32_t idx = bytecode_get_arg(op);
+        if (idx == m->array_idx || idx == m->i_idx || idx == m->j_idx) return 0;
+    } else {
+        return 0;
+    }
+    bound->op = op.op_code;
+    bound->arg = bytecode_get_arg(op);
+    bound->offset = 0;
+    p++;
+
+    if (ins[p].op_code == LOAD_CONST && const_is_int(code, bytecode_get_arg(ins[p]), 1) &&
+        is_op(ins[p + 1], BINARY_OP, BINARY_OP_SUB)) {
+        bound->offset = -1;
+        p += 2;
+    }
+    *pos = p;
+    return 1;
+}
+
+// Y - X, if both are known relative to the same operand.
+static int bound_distance(CodeObj* code, LoopBound y, LoopBound x, int64_t* dist) {
+    if (y.op != x.op) return 0;
+    if (y.op == LOAD_FAST) {
+        if (y.arg != x.arg) return 0;
+        *dist = y.offset - x.offset;
+        return 1;
+    }
+    *dist = (code->constants[y.arg].int_val + y.offset) - (code->constants[x.arg].int_val + x.offset);
+    return 1;
+}
+
+// LOAD_CONST 0; STORE_FAST v; JUMP_FORWARD cond; LOOP_START; v = v + 1
+static int match_loop_head(CodeObj* code, size_t* pos, size_t* var, size_t* zero, size_t* one,
+                           size_t* loop_start) {
+    bytecode* ins = code->code.bytecodes;
+    size_t p = *pos;
+    if (p + 8 >= code->code.count) return 0;
+
+    if (ins[p].op_code != LOAD_CONST || !const_is_int(code, bytecode_get_arg(ins[p]), 0)) return 0;
+    *zero = bytecode_get_arg(ins[p]);
+    if (!is_store_local(ins[p + 1], var)) return 0;
+
+    size_t target;
+    if (ins[p + 2].op_code != JUMP_FORWARD || !jump_target(ins[p + 2], p + 2, &target)) return 0;
+    if (target != p + 8) return 0;
+    if (ins[p + 3].op_code != LOOP_START) return 0;
+    *loop_start = p + 3;
+
+    if (!is_load_local_with_idx(ins[p + 4], *var)) return 0;
+    if (ins[p + 5].op_code != LOAD_CONST || !const_is_int(code, bytecode_get_arg(ins[p + 5]), 1)) return 0;
+    *one = bytecode_get_arg(ins[p + 5]);
+    if (!is_binary_add(ins[p + 6])) return 0;
+    if (!is_store_local_with_idx(ins[p + 7], *var)) return 0;
+
+    *pos = p + 8;
+    return 1;
+}
+
+// a[j] or a[j + 1], left on the stack
+static int match_element(CodeObj* code, size_t* pos, SortLoopMatch* m, int plus_one) {
+    bytecode* ins = code->code.bytecodes;
+    size_t p = *pos;
+    size_t need = plus_one ? 5 : 3;
+    if (p + need >= code->code.count) return 0;
+
+    if (!is_load_local_with_idx(ins[p], m->array_idx)) return 0;
+    if (!is_load_local_with_idx(ins[p + 1], m->j_idx)) return 0;
+    p += 2;
+    if (plus_one) {
+        if (ins[p].op_code != LOAD_CONST || !const_is_int(code, bytecode_get_arg(ins[p]), 1)) return 0;
+        if (!is_binary_add(ins[p + 1])) return 0;
+        p += 2;
+    }
+    if (ins[p].op_code != LOAD_SUBSCR) return 0;
+    *pos = p + 1;
+    return 1;
+}
+
+// "a; j [+ 1]; STORE_SUBSCR" with the value already pushed
+static int match_element_store(CodeObj* code, size_t* pos, SortLoopMatch* m, int plus_one) {
+    bytecode* ins = code->code.bytecodes;
+    size_t p = *pos;
+    size_t need = plus_one ? 5 : 3;
+    if (p + need >= code->code.count) return 0;
+
+    if (!is_load_local_with_idx(ins[p], m->array_idx)) return 0;
+    if (!is_load_local_with_idx(ins[p + 1], m->j_idx)) return 0;
+    p += 2;
+    if (plus_one) {
+        if (ins[p].op_code != LOAD_CONST || !const_is_int(code, bytecode_get_arg(ins[p]), 1)) return 0;
+        if (!is_binary_add(ins[p + 1])) return 0;
+        p += 2;
+    }
+    if (ins[p].op_code != STORE_SUBSCR) return 0;
+    *pos = p + 1;
+    return 1;
+}
+
+// t = a[k]; a[k] = a[other]; a[other] = t, with k either j or j + 1
+static int match_swap_body(CodeObj* code, size_t* pos, SortLoopMatch* m) {
+    bytecode* ins = code->code.bytecodes;
+    for (int first = 0; first <= 1; first++) {
+        size_t p = *pos;
+        if (!match_element(code, &p, m, first)) continue;
+        if (p >= code->code.count || !is_store_local(ins[p], &m->temp_idx)) continue;
+        if (m->temp_idx == m->array_idx || m->temp_idx == m->i_idx || m->temp_idx == m->j_idx) continue;
+        p++;
+        if (!match_element(code, &p, m, !first)) continue;
+        if (!match_element_store(code, &p, m, first)) continue;
+        if (p >= code->code.count || !is_load_local_with_idx(ins[p], m->temp_idx)) continue;
+        p++;
+        if (!match_element_store(code, &p, m, !first)) continue;
+        *pos = p;
+        return 1;
+    }
+    return 0;
+}
+
+static int local_read_outside(CodeObj* code, size_t idx, size_t start, size_t end) {
+    for (size_t k = 0; k < code->code.count; k++) {
+        if (k >= start && k < end) continue;
+        if (is_load_local_with_idx(code->code.bytecodes[k], idx)) return 1;
+    }
+    return 0;
+}
+
+static int match_sort_loop(CodeObj* code, size_t start, SortLoopMatch* m) {
+    bytecode* ins = code->code.bytecodes;
+    size_t count = code->code.count;
+    size_t p = start;
+    size_t outer_start, inner_start, zero2, one2, target;
+    LoopBound outer;
+
+    memset(m, 0, sizeof(*m));
+    m->array_idx = (size_t)-1;
+    m->j_idx = (size_t)-1;
+    m->start = start;
+
+    if (!match_loop_head(code, &p, &m->i_idx, &m->zero_const, &m->one_const, &outer_start)) return 0;
+    if (!is_load_local_with_idx(ins[p], m->i_idx)) return 0;
+    p++;
+    if (!match_bound(code, &p, m, &outer)) return 0;
+    if (p + 1 >= count || !is_op(ins[p], BINARY_OP, BINARY_OP_LT)) return 0;
+    size_t outer_exit = p + 1;
+    if (ins[outer_exit].op_code != POP_JUMP_IF_FALSE) return 0;
+    p += 2;
+
+    if (!match_loop_head(code, &p, &m->j_idx, &zero2, &one2, &inner_start)) return 0;
+    if (m->j_idx == m->i_idx) return 0;
+    if (p >= count || !is_load_local_with_idx(ins[p], m->j_idx)) return 0;
+    p++;
+    if (!match_bound(code, &p, m, &m->inner)) return 0;
+    if (p + 2 < count && is_load_local_with_idx(ins[p], m->i_idx) &&
+        is_op(ins[p + 1], BINARY_OP, BINARY_OP_SUB)) {
+        p += 2;
+        // "n - i - 1" folds the same - 1 in after the i
+        if (m->inner.offset == 0 && p + 2 < count && ins[p].op_code == LOAD_CONST &&
+            const_is_int(code, bytecode_get_arg(ins[p]), 1) &&
+            is_op(ins[p + 1], BINARY_OP, BINARY_OP_SUB)) {
+            m->inner.offset = -1;
+            p += 2;
+        }
+    }
+    if (p + 1 >= count || !is_op(ins[p], BINARY_OP, BINARY_OP_LT)) return 0;
+    size_t inner_exit = p + 1;
+    if (ins[inner_exit].op_code != POP_JUMP_IF_FALSE) return 0;
+    p += 2;
+
+    // if (a[j] > a[j + 1])
+    if (p >= count || ins[p].op_code != LOAD_FAST) return 0;
+    m->array_idx = bytecode_get_arg(ins[p]);
+    if (m->array_idx == m->i_idx || m->array_idx == m->j_idx) return 0;
+    if (m->inner.op == LOAD_FAST && m->inner.arg == m->array_idx) return 0;
+    if (outer.op == LOAD_FAST && outer.arg == m->array_idx) return 0;
+    if (!match_element(code, &p, m, 0)) return 0;
+    if (!match_element(code, &p, m, 1)) return 0;
+    if (p + 1 >= count || !is_op(ins[p], BINARY_OP, BINARY_OP_GT)) return 0;
+    size_t cmp_exit = p + 1;
+    if (ins[cmp_exit].op_code != POP_JUMP_IF_FALSE) return 0;
+    p += 2;
+
+    if (!match_swap_body(code, &p, m)) return 0;
+    if (p < count && is_op(ins[p], JUMP_FORWARD, 0)) p++;
+
+    // back edges and exits
+    if (p + 3 >= count) return 0;
+    if (!jump_target(ins[cmp_exit], cmp_exit, &target) || target != p) return 0;
+    if (ins[p].op_code != JUMP_BACKWARD || !jump_target(ins[p], p, &target) || target != inner_start) return 0;
+    if (ins[p + 1].op_code != LOOP_END) return 0;
+    if (!jump_target(ins[inner_exit], inner_exit, &target) || target != p + 2) return 0;
+    if (ins[p + 2].op_code != JUMP_BACKWARD || !jump_target(ins[p + 2], p + 2, &target) || target != outer_start) return 0;
+    if (ins[p + 3].op_code != LOOP_END) return 0;
+    m->end = p + 4;
+    if (!jump_target(ins[outer_exit], outer_exit, &target) || target != m->end) return 0;
+
+    // enough passes: Y is X or X + 1
+    int64_t dist;
+    if (!bound_distance(code, outer, m->inner, &dist) || dist < 0 || dist > 1) return 0;
+
+    if ((m->inner.op == LOAD_FAST && m->inner.arg == m->temp_idx) ||
+        (outer.op == LOAD_FAST && outer.arg == m->temp_idx)) return 0;
+
+    // the loop variables must be dead once the nest is gone
+    if (local_read_outside(code, m->i_idx, m->start, m->end) ||
+        local_read_outside(code, m->j_idx, m->start, m->end) ||
+        local_read_outside(code, m->temp_idx, m->start, m->end)) return 0;
+
+    return 1;
+}
+
+static int retarget(bytecode bc, size_t at, size_t* target) {
+    uint32_t arg = bytecode_get_arg(bc);
+    switch (bc.op_code) {
+        case JUMP_BACKWARD:
+        case JUMP_BACKWARD_NO_INTERRUPT:
+            if (arg > at + 1) return 0;
+            *target = at + 1 - arg;
+            return 1;
+        case JUMP_FORWARD:
+        case POP_JUMP_IF_TRUE:
+        case POP_JUMP_IF_FALSE:
+        case POP_JUMP_IF_NONE:
+        case POP_JUMP_IF_NOT_NONE:
+            *target = at + 1 + arg;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Inserts "if (SORT_ARRAY(a, 0, X + 1)) skip the nest" at m->start and moves
+// every jump over it; the nest itself stays as it was. Returns the number of
+// instructions inserted, 0 if out of memory.
+static size_t insert_sort_guard(bytecode_array* bc, SortLoopMatch* m) {
+    bytecode guard[10];
+    size_t g = 0;
+    guard[g++] = bytecode_create_with_number(LOAD_FAST, m->array_idx);
+    guard[g++] = bytecode_create_with_number(LOAD_CONST, m->zero_const);
+    guard[g++] = bytecode_create_with_number(m->inner.op, m->inner.arg);
+    if (m->inner.offset < 0) {
+        guard[g++] = bytecode_create_with_number(LOAD_CONST, m->one_const);
+        guard[g++] = bytecode_create_with_number(BINARY_OP, BINARY_OP_SUB);
+    }
+    guard[g++] = bytecode_create_with_number(LOAD_CONST, m->one_const);
+    guard[g++] = bytecode_create_with_number(BINARY_OP, 0x00);
+    guard[g++] = bytecode_create_with_number(SORT_ARRAY, 0x00);
+    guard[g++] = bytecode_create_with_number(POP_JUMP_IF_TRUE, (uint32_t)(m->end - m->start));
+
+    bytecode* code = malloc((bc->count + g) * sizeof(bytecode));
+    if (!code) return 0;
+
+    // a jump from outside the nest to its first instruction enters the guard
+    for (size_t k = 0; k < bc->count; k++) {
+        bytecode ins = bc->bytecodes[k];
+        size_t at = k < m->start ? k : k + g;
+        size_t t;
+        if (retarget(ins, k, &t) && t <= bc->count) {
+            int inside = k >= m->start && k < m->end;
+            size_t nt = t < m->start || (t == m->start && !inside) ? t : t + g;
+            uint32_t arg = (ins.op_code == JUMP_BACKWARD || ins.op_code == JUMP_BACKWARD_NO_INTERRUPT)
+                               ? (uint32_t)(at + 1 - nt) : (uint32_t)(nt - at - 1);
+            ins = bytecode_create_with_number(ins.op_code, arg);
+        }
+        code[at] = ins;
+    }
+    memcpy(code + m->start, guard, g * sizeof(bytecode));
+
+    free(bc->bytecodes);
+    bc->bytecodes = code;
+    bc->count += g;
+    bc->capacity = bc->count;
+    return g;
+}
+
+int has_sort_loop(CodeObj* code) {
+    if (!code || !code->code.bytecodes || !code->constants) return 0;
+
+    SortLoopMatch match;
+    for (size_t i = 0; i < code->code.count; i++) {
+        if (match_sort_loop(code, i, &match)) return 1;
+    }
+    return 0;
+}
+
 static int find_and_replace_patterns(CodeObj* code, CmpswapStats* stats) {
     bytecode_array* bc = &code->code;
     int changed = 0;
     
     for (size_t i = 0; i < bc->count; i++) {
         PatternMatch match;
+        SortLoopMatch loop;
+
+        if (match_sort_loop(code, i, &loop)) {
+            DPRINT("[JIT-CMPSWAP] Found bubble sort loop at [%zu, %zu): array=%zu\n",
+                   loop.start, loop.end, loop.array_idx);
+
+            size_t inserted = insert_sort_guard(bc, &loop);
+            if (inserted) {
+                stats->sort_loops++;
+                stats->optimized_patterns++;
+                changed = 1;
+            }
+
+            // the nest is the fallback; leave it exactly as compiled
+            i = loop.end + inserted - 1;
+            continue;
+        }
 
         if (match_swap_pattern(bc, i, &match)) {
             DPRINT("[JIT-CMPSWAP] Found unconditional swap pattern at position %zu\n", i);
@@ -366,7 +730,7 @@ CodeObj* jit_optimize_cmpswap(CodeObj* original, CmpswapStats* stats) {
     
     memset(stats, 0, sizeof(CmpswapStats));
     
-    if (!has_sorting_pattern(original)) {
+    if (!has_sorting_pattern(original) && !has_sort_loop(original)) {
         DPRINT("[JIT-CMPSWAP] No sorting patterns found\n");
         return NULL;
     }
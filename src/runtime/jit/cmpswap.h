@@ -8,6 +8,7 @@ typedef struct {
     size_t optimized_patterns;
     size_t swap_patterns;
     size_t cmpswap_patterns;
+    size_t sort_loops;
 } CmpswapStats;
 
 typedef struct {
@@ -20,6 +21,8 @@ typedef struct {
 } PatternMatch;
 
 int has_sorting_pattern(CodeObj* code);
+// A whole bubble-sort loop nest that can become one SORT_ARRAY.
+int has_sort_loop(CodeObj* code);
 CodeObj* jit_optimize_cmpswap(CodeObj* original, CmpswapStats* stats);
 
 #endif
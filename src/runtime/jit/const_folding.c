@@ -5,7 +5,7 @@
 
 int is_truthy(Value v);
 int is_falsy(Value v);
-size_t find_or_add_constant(CodeObj* code, Value v, FoldStats* stats);
+size_t find_or_add_constant(CodeObj* code, const_index* index, Value v, FoldStats* stats);
 CodeObj* deep_copy_codeobj(CodeObj* original);
 int is_constant_foldable(Value a, Value b, uint8_t op);
 int is_unary_foldable(Value a, uint8_t op);
@@ -38,11 +38,10 @@ int is_falsy(Value v) {
     return !is_truthy(v);
 }
 
-size_t find_or_add_constant(CodeObj* code, Value v, FoldStats* stats) {
-    for (size_t i = 0; i < code->constants_count; i++) {
-        if (values_equal(code->constants[i], v)) {
-            return i;
-        }
+size_t find_or_add_constant(CodeObj* code, const_index* index, Value v, FoldStats* stats) {
+    size_t existing = const_index_find(index, code->constants, v);
+    if (existing != SIZE_MAX) {
+        return existing;
     }
     
     size_t new_count = code->constants_count + 1;
@@ -52,6 +51,7 @@ size_t find_or_add_constant(CodeObj* code, Value v, FoldStats* stats) {
     code->constants = new_consts;
     code->constants[code->constants_count] = v;
     code->constants_count = new_count;
+    const_index_insert(index, code->constants, code->constants_count - 1);
     
     return code->constants_count - 1;
 }
@@ -59,7 +59,7 @@ size_t find_or_add_constant(CodeObj* code, Value v, FoldStats* stats) {
 CodeObj* deep_copy_codeobj(CodeObj* original) {
     if (!original) return NULL;
     
-    CodeObj* copy = malloc(sizeof(CodeObj));
+    CodeObj* copy = calloc(1, sizeof(CodeObj));
     if (!copy) return NULL;
     
     copy->name = original->name ? strdup(original->name) : NULL;
@@ -188,93 +188,67 @@ void mark_as_nops(bytecode_array* bc, size_t start, size_t end) {
     }
 }
 
-int fold_operation_chain(CodeObj* code, bytecode_array* bc, size_t start, FoldStats* stats) {
-    size_t pos = start;
-    int changed = 0;
-    
-    size_t chain_start = pos;
-    size_t chain_end = pos;
-    
-    while (pos < bc->count) {
-        bytecode ins = bc->bytecodes[pos];
-        uint8_t op = ins.op_code;
-        
-        if (op == LOAD_CONST) {
-            chain_end = pos;
-            pos = skip_nops(bc, pos + 1);
-        } 
-        else if (op == BINARY_OP) {
-            uint8_t binop = bytecode_get_arg(ins) & 0xFF;
-            if (binop < 0x00 || binop > 0x0B) {
-                break;
-            }
-            chain_end = pos;
-            pos = skip_nops(bc, pos + 1);
-        }
-        else {
-            break;
-        }
+// Folds c0 (c1 op1) (c2 op2) ... into one constant: in stack order each
+// BINARY_OP applies to the running value and the constant just before it.
+// A BINARY_OP right after the first constant takes an operand computed
+// earlier, e.g. the 1 in (x - 1) / 2, so such a chain is left alone.
+int fold_operation_chain(CodeObj* code, const_index* index, bytecode_array* bc, size_t start, FoldStats* stats) {
+    bytecode first = bc->bytecodes[start];
+    if (first.op_code != LOAD_CONST || bytecode_get_arg(first) >= code->constants_count) {
+        return 0;
     }
-    
-    if (chain_end - chain_start < 2) {
+
+    Value current_value = code->constants[bytecode_get_arg(first)];
+    size_t chain_end = start;
+    int folded = 0;
+
+    for (;;) {
+        size_t const_pos = skip_nops(bc, chain_end + 1);
+        size_t op_pos = skip_nops(bc, const_pos + 1);
+        if (op_pos >= bc->count) break;
+
+        bytecode const_ins = bc->bytecodes[const_pos];
+        bytecode op_ins = bc->bytecodes[op_pos];
+        if (const_ins.op_code != LOAD_CONST || op_ins.op_code != BINARY_OP) break;
+
+        uint32_t const_idx = bytecode_get_arg(const_ins);
+        uint8_t binop = bytecode_get_arg(op_ins) & 0xFF;
+        if (const_idx >= code->constants_count || binop > 0x0B) break;
+
+        Value v = code->constants[const_idx];
+        if (!is_constant_foldable(current_value, v, binop)) break;
+
+        current_value = fold_binary_constant(current_value, v, binop);
+        chain_end = op_pos;
+        folded++;
+    }
+
+    if (folded < 2) {
+        // a single pair is aggressive_constant_folding's job
         return 0;
     }
-    
-    Value current_value = value_create_none();
-    uint8_t last_op = 0xFF;
-    int has_value = 0;
-    
-    for (size_t i = chain_start; i <= chain_end; i = skip_nops(bc, i + 1)) {
-        bytecode ins = bc->bytecodes[i];
-        uint8_t op = ins.op_code;
-        
-        if (op == LOAD_CONST) {
-            uint32_t const_idx = bytecode_get_arg(ins);
-            if (const_idx >= code->constants_count) break;
-            
-            Value v = code->constants[const_idx];
-            
-            if (!has_value) {
-                current_value = v;
-                has_value = 1;
-            } else if (last_op != 0xFF) {
-                if (is_constant_foldable(current_value, v, last_op)) {
-                    current_value = fold_binary_constant(current_value, v, last_op);
-                    changed = 1;
-                } else {
-                    break;
-                }
-            }
-        }
-        else if (op == BINARY_OP) {
-            last_op = bytecode_get_arg(ins) & 0xFF;
-        }
+
+    size_t new_const_idx = find_or_add_constant(code, index, current_value, stats);
+    if (new_const_idx == (size_t)-1) {
+        return 0;
     }
-    
-    if (changed && has_value) {
-        size_t new_const_idx = find_or_add_constant(code, current_value, stats);
-        if (new_const_idx != (size_t)-1) {
-            bc->bytecodes[chain_start] = bytecode_create_with_number(LOAD_CONST, new_const_idx);
-            
-            for (size_t i = chain_start + 1; i <= chain_end; i++) {
-                mark_as_nop(bc, i);
-                stats->removed_instructions++;
-            }
-            
-            stats->folded_constants++;
-            return 1;
+    bc->bytecodes[start] = bytecode_create_with_number(LOAD_CONST, new_const_idx);
+    for (size_t i = start + 1; i <= chain_end; i++) {
+        if (bc->bytecodes[i].op_code != NOP) {
+            mark_as_nop(bc, i);
+            stats->removed_instructions++;
         }
     }
-    
-    return 0;
+    stats->folded_constants++;
+    return 1;
 }
 
-int find_and_fold_chains(CodeObj* code, bytecode_array* bc, FoldStats* stats) {
+int find_and_fold_chains(CodeObj* code, const_index* index, bytecode_array* bc, FoldStats* stats) {
     int changed = 0;
     
     for (size_t i = 0; i < bc->count; i = skip_nops(bc, i + 1)) {
         if (bc->bytecodes[i].op_code == LOAD_CONST) {
-            if (fold_operation_chain(code, bc, i, stats)) {
+            if (fold_operation_chain(code, index, bc, i, stats)) {
                 changed = 1;
                 break;
             }
@@ -399,7 +373,7 @@ Value fold_unary_constant(Value a, uint8_t op) {
     return value_create_none();
 }
 
-int aggressive_constant_folding(CodeObj* code, bytecode_array* bc, FoldStats* stats) {
+int aggressive_constant_folding(CodeObj* code, const_index* index, bytecode_array* bc, FoldStats* stats) {
     int changed = 0;
     
     int local_changed;
@@ -428,7 +402,7 @@ int aggressive_constant_folding(CodeObj* code, bytecode_array* bc, FoldStats* st
                         
                         if (is_constant_foldable(a, b, binop)) {
                             Value result = fold_binary_constant(a, b, binop);
-                            size_t new_idx = find_or_add_constant(code, result, stats);
+                            size_t new_idx = find_or_add_constant(code, index, result, stats);
                             
                             if (new_idx != (size_t)-1) {
                                 bc->bytecodes[i] = bytecode_create_with_number(LOAD_CONST, new_idx);
@@ -468,6 +442,10 @@ CodeObj* jit_optimize_constant_folding(CodeObj* original, FoldStats* stats) {
         return NULL;
     }
     
+    const_index index;
+    const_index_init(&index);
+    const_index_build(&index, optimized->constants, optimized->constants_count);
+    
     bytecode_array* bc = &optimized->code;
     int changed;
     int iteration = 0;
@@ -478,11 +456,11 @@ CodeObj* jit_optimize_constant_folding(CodeObj* original, FoldStats* stats) {
         
         DPRINT("[JIT-CF] Iteration %d\n", iteration);
         
-        if (aggressive_constant_folding(optimized, bc, stats)) {
+        if (aggressive_constant_folding(optimized, &index, bc, stats)) {
             changed = 1;
         }
         
-        if (find_and_fold_chains(optimized, bc, stats)) {
+        if (find_and_fold_chains(optimized, &index, bc, stats)) {
             changed = 1;
             recalculate_jumps(bc);
         }
@@ -502,6 +480,7 @@ CodeObj* jit_optimize_constant_folding(CodeObj* original, FoldStats* stats) {
     } while (changed && bc->count > 0);
     
     recalculate_jumps(bc);
+    const_index_free(&index);
     
     DPRINT("[JIT-CF] Optimization complete:\n");
     DPRINT("  Folded constants: %zu\n", stats->folded_constants);
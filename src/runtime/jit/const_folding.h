@@ -3,6 +3,7 @@
 
 #include "../../compiler/bytecode.h"
 #include "../../compiler/value.h"
+#include "../../compiler/const_pool.h"
 #include "../../runtime/vm/vm.h"
 
 typedef struct {
@@ -26,7 +27,7 @@ void mark_as_nop(bytecode_array* bc, size_t index);
 void mark_as_nops(bytecode_array* bc, size_t start, size_t end);
 int is_truthy(Value v);
 int is_falsy(Value v);
-size_t find_or_add_constant(CodeObj* code, Value v, FoldStats* stats);
+size_t find_or_add_constant(CodeObj* code, const_index* index, Value v, FoldStats* stats);
 int is_constant_foldable(Value a, Value b, uint8_t op);
 Value fold_binary_constant(Value a, Value b, uint8_t op);
 int is_unary_foldable(Value a, uint8_t op);
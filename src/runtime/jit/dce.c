@@ -20,8 +20,14 @@ static bool has_side_effects(bytecode bc) {
         case STORE_SUBSCR:
         case DEL_SUBSCR:
         case LOAD_SUBSCR:
+        case STORE_SUBSCR2:
+        case LOAD_SUBSCR2:
+        case LOAD_SUBSCR_UNCHECKED:
+        case STORE_SUBSCR_UNCHECKED:
+        case STORE_FIELD:
         case CALL_FUNCTION:
         case COMPARE_AND_SWAP:
+        case SORT_ARRAY:
             return true;
         default:
             return false;
@@ -55,8 +61,8 @@ static bool loop_has_live_effect(bytecode_array* bc, size_t start, size_t end) {
 
         if (opcode == CALL_FUNCTION || opcode == RETURN_VALUE ||
             opcode == STORE_GLOBAL || opcode == STORE_NAME ||
-            opcode == STORE_SUBSCR || opcode == DEL_SUBSCR ||
-            opcode == COMPARE_AND_SWAP) return true;
+            opcode == STORE_SUBSCR || opcode == DEL_SUBSCR || opcode == STORE_SUBSCR2 ||
+            opcode == STORE_FIELD || opcode == COMPARE_AND_SWAP || opcode == SORT_ARRAY) return true;
 
         if (opcode == STORE_FAST) {
             uint8_t idx = bytecode_get_arg(ins);
@@ -79,7 +85,7 @@ static void remove_empty_loop(bytecode_array* bc, size_t loop_start_idx, size_t
 
 static CodeObj* create_optimized_codeobj(CodeObj* original) {
     if (!original) return NULL;
-    CodeObj* optimized = malloc(sizeof(CodeObj));
+    CodeObj* optimized = calloc(1, sizeof(CodeObj));
     if (!optimized) return NULL;
 
     optimized->name = original->name ? strdup(original->name) : NULL;
@@ -252,8 +258,11 @@ static void remove_empty_loops_aggressive(bytecode_array* bc) {
                 case STORE_NAME:
                 case STORE_SUBSCR:
                 case DEL_SUBSCR:
+                case STORE_SUBSCR2:
+                case STORE_FIELD:
                 case RETURN_VALUE:
                 case COMPARE_AND_SWAP:
+                case SORT_ARRAY:
                     safe = false; break;
                 case STORE_FAST:
                     writes_local[bytecode_get_arg(ins)] = true; break;
@@ -338,6 +347,14 @@ static bool validate_bytecode_stack(bytecode_array* bc) {
                 }
                 stack -= 1; break;
 
+            case STORE_FIELD:
+                if (stack < 2) {
+                    DPRINT("[DCE-VERIFY] STORE_FIELD at %zu has insufficient stack (%d)\n", i, stack);
+                    return false;
+                }
+                stack -= 2;
+                break;
+
             case COMPARE_AND_SWAP:
                 if (stack < 2) {
                     DPRINT("[DCE-VERIFY] COMPARE_AND_SWAP at %zu has insufficient stack (%d)\n", i, stack);
@@ -346,6 +363,30 @@ static bool validate_bytecode_stack(bytecode_array* bc) {
                 stack = stack - 2 + 1;
                 break;
 
+            case SORT_ARRAY:
+                if (stack < 3) {
+                    DPRINT("[DCE-VERIFY] SORT_ARRAY at %zu has insufficient stack (%d)\n", i, stack);
+                    return false;
+                }
+                stack = stack - 3 + 1;
+                break;
+
+            case LOAD_SUBSCR2:
+                if (stack < 3) {
+                    DPRINT("[DCE-VERIFY] LOAD_SUBSCR2 at %zu has insufficient stack (%d)\n", i, stack);
+                    return false;
+                }
+                stack -= 2;
+                break;
+
+            case STORE_SUBSCR2:
+                if (stack < 4) {
+                    DPRINT("[DCE-VERIFY] STORE_SUBSCR2 at %zu has insufficient stack (%d)\n", i, stack);
+                    return false;
+                }
+                stack -= 4;
+                break;
+
             default:
                 break;
         }
@@ -0,0 +1,277 @@
+#include "escape.h"
+#include "const_folding.h"
+#include "../../system.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ---------------------------------------------------------------------------
+// Scratch arrays
+//
+// A local t is a scratch array when every store to it is a fresh
+// BUILD_TYPED_ARRAY or BUILD_ARRAY2 and every load of it is consumed as the
+// container of a LOAD_SUBSCR or STORE_SUBSCR. No other reference to the
+// array can then exist: it is never passed, returned, stored elsewhere,
+// copied on the stack or viewed (a single index only makes a view of a
+// 2-D array, and those are left alone). So
+//
+//   - if nothing loads t at all, its allocations are removed;
+//   - otherwise each 1-D int/bool allocation becomes REUSE_TYPED_ARRAY,
+//     which clears and reuses the array t still holds from the previous
+//     iteration instead of allocating another one.
+//
+// Parameters are never scratch: they start out holding the caller's array.
+
+#define ESCAPE_SCAN_LIMIT 64    // instructions between a load and its use
+#define REUSE_MAX_LOCAL 0xFFFF  // REUSE_TYPED_ARRAY arg: local << 8 | kind
+
+static int jump_target(bytecode bc, size_t at, size_t* target) {
+    uint32_t arg = bytecode_get_arg(bc);
+    switch (bc.op_code) {
+        case JUMP_BACKWARD:
+        case JUMP_BACKWARD_NO_INTERRUPT:
+            if (arg > at + 1) return 0;
+            *target = at + 1 - arg;
+            return 1;
+        case JUMP_FORWARD:
+        case POP_JUMP_IF_TRUE:
+        case POP_JUMP_IF_FALSE:
+        case POP_JUMP_IF_NONE:
+        case POP_JUMP_IF_NOT_NONE:
+            *target = at + 1 + arg;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int is_alloc(bytecode bc) {
+    return bc.op_code == BUILD_TYPED_ARRAY || bc.op_code == BUILD_ARRAY2;
+}
+
+// Stack effect of the straight-line instructions an index expression is
+// made of; anything else ends the scan.
+static int stack_effect(bytecode bc, int* pops, int* pushes) {
+    switch (bc.op_code) {
+        case NOP:
+            *pops = 0; *pushes = 0; return 1;
+        case LOAD_FAST:
+        case LOAD_CONST:
+        case LOAD_GLOBAL:
+        case PUSH_NULL:
+            *pops = 0; *pushes = 1; return 1;
+        case UNARY_OP:
+        case TO_BOOL:
+        case TO_INT:
+        case TO_LONG:
+            *pops = 1; *pushes = 1; return 1;
+        case BINARY_OP:
+        case LOAD_SUBSCR:
+        case LOAD_SUBSCR_UNCHECKED:
+            *pops = 2; *pushes = 1; return 1;
+        case LOAD_SUBSCR2:
+            *pops = 3; *pushes = 1; return 1;
+        case STORE_SUBSCR:
+        case STORE_SUBSCR_UNCHECKED:
+            *pops = 3; *pushes = 0; return 1;
+        default:
+            return 0;
+    }
+}
+
+// Follows the array pushed by the LOAD_FAST at k until an instruction pops
+// it; that must be a subscript with the array as its container.
+static int load_is_subscripted(CodeObj* code, size_t k) {
+    bytecode* ins = code->code.bytecodes;
+    size_t end = k + 1 + ESCAPE_SCAN_LIMIT;
+    if (end > code->code.count) end = code->code.count;
+
+    int above = 0;  // values pushed on top of the array
+    for (size_t j = k + 1; j < end; j++) {
+        int pops, pushes;
+        if (!stack_effect(ins[j], &pops, &pushes)) return 0;
+        if (pops > above) {
+            uint8_t op = ins[j].op_code;
+            return above == 1 && (op == LOAD_SUBSCR || op == STORE_SUBSCR ||
+                                  op == LOAD_SUBSCR_UNCHECKED || op == STORE_SUBSCR_UNCHECKED);
+        }
+        above += pushes - pops;
+    }
+    return 0;
+}
+
+static uint8_t* find_jump_targets(CodeObj* code) {
+    uint8_t* targets = calloc(code->code.count + 1, 1);
+    if (!targets) return NULL;
+    for (size_t k = 0; k < code->code.count; k++) {
+        size_t t;
+        if (jump_target(code->code.bytecodes[k], k, &t) && t <= code->code.count) {
+            targets[t] = 1;
+        }
+    }
+    return targets;
+}
+
+typedef struct {
+    int scratch;    // every store an allocation, every load a subscript
+    int loaded;
+} LocalUse;
+
+static LocalUse local_use(CodeObj* code, const uint8_t* targets, uint32_t idx) {
+    bytecode* ins = code->code.bytecodes;
+    LocalUse use = { idx >= (uint32_t)code->arg_count, 0 };
+    for (size_t k = 0; k < code->code.count && use.scratch; k++) {
+        if (bytecode_get_arg(ins[k]) != idx) continue;
+        if (ins[k].op_code == STORE_FAST) {
+            if (k == 0 || !is_alloc(ins[k - 1]) || targets[k]) use.scratch = 0;
+        } else if (ins[k].op_code == LOAD_FAST) {
+            use.loaded = 1;
+            if (!load_is_subscripted(code, k)) use.scratch = 0;
+        }
+    }
+    return use;
+}
+
+// Operands of the allocation ending at k that can be dropped with it:
+// one or two plain loads, nothing jumping in between.
+static int alloc_operands(CodeObj* code, const uint8_t* targets, size_t k, size_t* first) {
+    bytecode* ins = code->code.bytecodes;
+    size_t n = ins[k].op_code == BUILD_ARRAY2 ? 2 : 1;
+    if (k < n) return 0;
+    for (size_t j = k - n; j < k; j++) {
+        if (ins[j].op_code != LOAD_FAST && ins[j].op_code != LOAD_CONST) return 0;
+        if (j > k - n && targets[j]) return 0;
+    }
+    if (targets[k] || targets[k + 1]) return 0;
+    *first = k - n;
+    return 1;
+}
+
+static int is_reusable(bytecode alloc, uint32_t idx) {
+    uint32_t kind = bytecode_get_arg(alloc);
+    return alloc.op_code == BUILD_TYPED_ARRAY && (kind == ARRAY_INT || kind == ARRAY_BOOL) &&
+           idx <= REUSE_MAX_LOCAL;
+}
+
+// Drops the NOPs and retargets every jump; a jump to a dropped instruction
+// lands on the next one kept.
+static void remove_nops(bytecode_array* bc) {
+    size_t* new_pos = malloc((bc->count + 1) * sizeof(size_t));
+    if (!new_pos) return;
+    size_t kept = 0;
+    for (size_t k = 0; k < bc->count; k++) {
+        new_pos[k] = kept;
+        if (bc->bytecodes[k].op_code != NOP) kept++;
+    }
+    new_pos[bc->count] = kept;
+
+    size_t w = 0;
+    for (size_t k = 0; k < bc->count; k++) {
+        bytecode ins = bc->bytecodes[k];
+        if (ins.op_code == NOP) continue;
+        size_t t;
+        if (jump_target(ins, k, &t) && t <= bc->count) {
+            size_t nt = new_pos[t];
+            uint32_t arg = (ins.op_code == JUMP_BACKWARD || ins.op_code == JUMP_BACKWARD_NO_INTERRUPT)
+                               ? (uint32_t)(w + 1 - nt) : (uint32_t)(nt - w - 1);
+            ins = bytecode_create_with_number(ins.op_code, arg);
+        }
+        bc->bytecodes[w++] = ins;
+    }
+    bc->count = w;
+    free(new_pos);
+}
+
+// Loop nesting at each instruction, counted by LOOP_START / LOOP_END.
+static void loop_depths(CodeObj* code, size_t* depths) {
+    size_t depth = 0;
+    for (size_t k = 0; k < code->code.count; k++) {
+        uint8_t op = code->code.bytecodes[k].op_code;
+        if (op == LOOP_START) depth++;
+        depths[k] = depth;
+        if (op == LOOP_END && depth) depth--;
+    }
+}
+
+// ins[k] allocates an array that ins[k + 1] stores into a local.
+static int is_alloc_store(CodeObj* code, size_t k) {
+    return k + 1 < code->code.count && is_alloc(code->code.bytecodes[k]) &&
+           code->code.bytecodes[k + 1].op_code == STORE_FAST;
+}
+
+int has_scratch_array(CodeObj* code) {
+    if (!code || !code->code.bytecodes) return 0;
+
+    uint8_t* targets = find_jump_targets(code);
+    size_t* depths = malloc((code->code.count + 1) * sizeof(size_t));
+    int found = 0;
+    if (targets && depths) {
+        loop_depths(code, depths);
+        for (size_t k = 0; k < code->code.count && !found; k++) {
+            if (!depths[k] || !is_alloc_store(code, k)) continue;
+            uint32_t idx = bytecode_get_arg(code->code.bytecodes[k + 1]);
+            LocalUse use = local_use(code, targets, idx);
+            found = use.scratch && (!use.loaded || is_reusable(code->code.bytecodes[k], idx));
+        }
+    }
+    free(targets);
+    free(depths);
+    return found;
+}
+
+static int sink_allocations(CodeObj* code, EscapeStats* stats) {
+    uint8_t* targets = find_jump_targets(code);
+    if (!targets) return 0;
+
+    bytecode* ins = code->code.bytecodes;
+    int removed = 0;
+    for (size_t k = 0; k < code->code.count; k++) {
+        if (!is_alloc_store(code, k)) continue;
+        uint32_t idx = bytecode_get_arg(ins[k + 1]);
+        LocalUse use = local_use(code, targets, idx);
+        if (!use.scratch) continue;
+
+        size_t first;
+        if (!use.loaded && alloc_operands(code, targets, k, &first)) {
+            DPRINT("[JIT-ESCAPE] Removing unused array stored to local %u at %zu\n", idx, k);
+            for (size_t j = first; j <= k + 1; j++) {
+                ins[j] = bytecode_create_with_number(NOP, 0);
+            }
+            stats->removed_arrays++;
+            removed = 1;
+        } else if (use.loaded && is_reusable(ins[k], idx)) {
+            DPRINT("[JIT-ESCAPE] Reusing scratch array in local %u at %zu\n", idx, k);
+            uint32_t kind = bytecode_get_arg(ins[k]);
+            ins[k] = bytecode_create_with_number(REUSE_TYPED_ARRAY, idx << 8 | kind);
+            stats->reused_arrays++;
+        }
+    }
+    free(targets);
+
+    if (removed) remove_nops(&code->code);
+    return stats->reused_arrays + stats->removed_arrays > 0;
+}
+
+CodeObj* jit_optimize_escape(CodeObj* original, EscapeStats* stats) {
+    memset(stats, 0, sizeof(EscapeStats));
+
+    if (!original || !original->code.bytecodes) {
+        DPRINT("[JIT-ESCAPE] Invalid input\n");
+        return NULL;
+    }
+
+    CodeObj* optimized = deep_copy_codeobj(original);
+    if (!optimized) {
+        DPRINT("[JIT-ESCAPE] Failed to copy CodeObj\n");
+        return NULL;
+    }
+
+    if (sink_allocations(optimized, stats)) {
+        DPRINT("[JIT-ESCAPE] Reused %zu array(s), removed %zu, size %u -> %u\n",
+               stats->reused_arrays, stats->removed_arrays,
+               original->code.count, optimized->code.count);
+        return optimized;
+    }
+
+    free_code_obj(optimized);
+    return NULL;
+}
@@ -0,0 +1,16 @@
+#ifndef ESCAPE_H
+#define ESCAPE_H
+
+#include "../../compiler/bytecode.h"
+#include "../../compiler/value.h"
+
+typedef struct {
+    size_t reused_arrays;       // BUILD_TYPED_ARRAY -> REUSE_TYPED_ARRAY
+    size_t removed_arrays;      // allocations into locals nothing reads
+} EscapeStats;
+
+// An array allocated inside a loop into a local it never escapes from.
+int has_scratch_array(CodeObj* code);
+CodeObj* jit_optimize_escape(CodeObj* original, EscapeStats* stats);
+
+#endif
@@ -2,6 +2,8 @@
 #include "cmpswap.h"
 #include "const_folding.h"
 #include "dce.h"
+#include "bounds.h"
+#include "escape.h"
 #include "jit.h"
 #include "jit_types.h"
 #include <stdio.h>
@@ -15,6 +17,11 @@ typedef struct {
 } JITStats;
 
 
+int jit_wants_eager_compile(void* code) {
+    return code && (has_sort_loop((CodeObj*)code) || has_bounds_loop((CodeObj*)code) ||
+                    has_scratch_array((CodeObj*)code));
+}
+
 JIT* jit_create(void) {
     JIT* jit = malloc(sizeof(JIT));
     if (!jit) return NULL;
@@ -141,6 +148,36 @@ void* jit_compile_function(JIT* jit, void* code_ptr) {
     } else if (dce_result == optimized) {
         DPRINT("[JIT-DCE] No DCE changes applied\n");
     }
+
+    EscapeStats escape_stats;
+    CodeObj* escape_result = jit_optimize_escape(optimized, &escape_stats);
+
+    if (escape_result) {
+        DPRINT("[JIT] Escape analysis: reused %zu scratch arrays, removed %zu\n",
+               escape_stats.reused_arrays, escape_stats.removed_arrays);
+
+        if (was_optimized && optimized != original) {
+            free_code_obj(optimized);
+        }
+
+        optimized = escape_result;
+        was_optimized = true;
+    }
+
+    BoundsStats bounds_stats;
+    CodeObj* bounds_result = jit_optimize_bounds(optimized, &bounds_stats);
+
+    if (bounds_result) {
+        DPRINT("[JIT] Bounds checks: versioned %zu loops, %zu unchecked subscripts\n",
+               bounds_stats.versioned_loops, bounds_stats.unchecked_subscripts);
+
+        if (was_optimized && optimized != original) {
+            free_code_obj(optimized);
+        }
+
+        optimized = bounds_result;
+        was_optimized = true;
+    }
     
     if (was_optimized && optimized) {
         jit_add_to_cache(jit, optimized);
@@ -6,5 +6,8 @@ typedef struct JIT JIT;
 JIT* jit_create(void);
 void jit_destroy(JIT* jit);
 void* jit_compile_function(JIT* jit, void* code);
+// True if code is worth compiling on its first call instead of once hot:
+// it holds a loop nest the JIT replaces outright.
+int jit_wants_eager_compile(void* code);
 
 #endif
@@ -652,7 +652,8 @@ int bigfloat_cmp(const BigFloat* a, const BigFloat* b) {
     bigfloat_free(diff);
     bigfloat_free(epsilon);
     
-    return a->neg ? -result : result;
+    // diff carries the sign already, negative operands included
+    return result;
 }
 
 static int bigfloat_cmp_abs(const BigFloat* a, const BigFloat* b) {
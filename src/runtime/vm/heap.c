@@ -3,32 +3,34 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
-
-static Object* find_free_object_in_pool(ObjectPool* pool) {
-    if (!pool || !pool->first) return NULL;
-    
-    MemoryBlock* block = pool->first;
-    while (block) {
-        for (size_t i = 0; i < block->used; i++) {
-            Object* obj = &block->memory[i];
-            if (obj && obj->ref_count == 0) {
-                return obj;
-            }
-        }
-        block = block->next;
+static ObjectPool* heap_pool_at(Heap* heap, int index) {
+    switch (index) {
+        case 0: return &heap->int_pool;
+        case 1: return &heap->array_pool;
+        case 2: return &heap->function_pool;
+        case 3: return &heap->code_pool;
+        case 4: return &heap->native_func_pool;
+        case 5: return &heap->float_pool;
+        case 6: return &heap->bool_pool;
+        case 7: return &heap->none_pool;
+        case 8: return &heap->record_pool;
+        default: return NULL;
     }
-    return NULL;
 }
 
 
-static void recycle_object(Object* obj) {
+static void recycle_object(Object* obj, size_t slot_size) {
     if (!obj) return;
     
     switch (obj->type) {
         case OBJ_ARRAY:
-            if (obj->as.array.items) {
-                for (size_t i = 0; i < obj->as.array.size; i++) {
+            if (obj->as.array.base) {
+                object_array_free(obj);
+            } else if (obj->as.array.items) {
+                for (size_t i = 0; object_array_has_refs(obj) && i < obj->as.array.size; i++) {
                     if (obj->as.array.items[i]) {
                         object_decref(obj->as.array.items[i]);
                     }
@@ -36,6 +38,7 @@ static void recycle_object(Object* obj) {
                 free(obj->as.array.items);
                 obj->as.array.items = NULL;
                 obj->as.array.size = 0;
+                obj->as.array.capacity = 0;
             }
             break;
             
@@ -60,7 +63,41 @@ static void recycle_object(Object* obj) {
         default:
             break;
     }
-    memset(obj, 0, sizeof(Object));
+    // a reused slot may still be listed in the nursery; keep it listed once
+    uint8_t young = obj->gc_flags & OBJ_GC_YOUNG;
+    memset(obj, 0, slot_size);
+    obj->gc_flags = young;
+}
+
+static void heap_note_young(Heap* heap, Object* obj) {
+    if (!heap->track_young || !obj) return;
+
+    obj->gc_age = 0;
+    if (obj->gc_flags & OBJ_GC_YOUNG) return;
+
+    if (heap->nursery_count >= heap->nursery_capacity) {
+        size_t new_capacity = heap->nursery_capacity == 0 ? 4096 : heap->nursery_capacity * 2;
+        Object** new_nursery = realloc(heap->nursery, new_capacity * sizeof(Object*));
+        if (!new_nursery) {
+            DPRINT("ERROR: Failed to grow nursery, allocating %p old\n", (void*)obj);
+            return;
+        }
+        heap->nursery = new_nursery;
+        heap->nursery_capacity = new_capacity;
+    }
+    obj->gc_flags |= OBJ_GC_YOUNG;
+    heap->nursery[heap->nursery_count++] = obj;
+}
+
+// Counts a fresh allocation towards the next collection trigger.
+static void heap_note_alloc(Heap* heap, Object* obj) {
+    if (!obj) return;
+
+    size_t bytes = object_footprint(obj);
+    heap->bytes_since_gc += bytes;
+    heap->total_bytes += bytes;
+    heap->objects_since_gc++;
+    heap_note_young(heap, obj);
 }
 
 
@@ -68,16 +105,17 @@ static void init_int_cache(Heap* heap) {
     DPRINT("[heap] Initializing int cache for values %d..%d\n", 
            INT_CACHE_MIN, INT_CACHE_MAX);
     
+    size_t slot = object_slot_size(OBJ_INT);
+    heap->int_cache_slab = calloc(INT_CACHE_SIZE, slot);
+    if (!heap->int_cache_slab) {
+        DPRINT("ERROR: Failed to allocate int cache\n");
+        exit(1);
+    }
+
     for (int i = INT_CACHE_MIN; i <= INT_CACHE_MAX; i++) {
         int idx = i - INT_CACHE_MIN;
         
-        heap->int_cache[idx] = malloc(sizeof(Object));
-        if (!heap->int_cache[idx]) {
-            DPRINT("ERROR: Failed to allocate int cache for value %d\n", i);
-            exit(1);
-        }
-        
-        memset(heap->int_cache[idx], 0, sizeof(Object));
+        heap->int_cache[idx] = (Object*)(heap->int_cache_slab + (size_t)idx * slot);
         heap->int_cache[idx]->type = OBJ_INT;
         heap->int_cache[idx]->ref_count = 0x7FFFFFFF;
         heap->int_cache[idx]->as.int_value = i;
@@ -85,14 +123,9 @@ static void init_int_cache(Heap* heap) {
 }
 
 static void free_int_cache(Heap* heap) {
-    for (int i = INT_CACHE_MIN; i <= INT_CACHE_MAX; i++) {
-        int idx = i - INT_CACHE_MIN;
-        if (heap->int_cache[idx]) {
-            heap->int_cache[idx]->ref_count = 0;
-            free(heap->int_cache[idx]);
-            heap->int_cache[idx] = NULL;
-        }
-    }
+    free(heap->int_cache_slab);
+    heap->int_cache_slab = NULL;
+    memset(heap->int_cache, 0, sizeof(heap->int_cache));
 }
 
 static Object* get_int_from_cache(Heap* heap, int64_t v) {
@@ -102,22 +135,31 @@ static Object* get_int_from_cache(Heap* heap, int64_t v) {
     return NULL;
 }
 
-static MemoryBlock* block_create(size_t capacity) {
+// Blocks are mapped directly, rounded up to whole pages, so that empty
+// ones can be handed back to the OS. A fresh mapping is already zeroed,
+// which is exactly a block of free slots.
+static MemoryBlock* block_create(size_t capacity, size_t slot_size) {
     MemoryBlock* block = malloc(sizeof(MemoryBlock));
     if (!block) return NULL;
     
-    block->memory = malloc(capacity * sizeof(Object));
-    if (!block->memory) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t bytes = (capacity * slot_size + page - 1) / page * page;
+    void* memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
         free(block);
         return NULL;
     }
     
-    block->capacity = capacity;
+    block->memory = memory;
+    block->slot_size = slot_size;
+    block->capacity = bytes / slot_size;
     block->used = 0;
+    block->unswept = false;
+    block->released = false;
+    block->live = 0;
     block->next = NULL;
     
-    memset(block->memory, 0, capacity * sizeof(Object));
-    
     return block;
 }
 
@@ -125,7 +167,7 @@ static void block_destroy(MemoryBlock* block) {
     while (block) {
         MemoryBlock* next = block->next;
         if (block->memory) {
-            free(block->memory);
+            munmap(block->memory, block->capacity * block->slot_size);
         }
         free(block);
         block = next;
@@ -137,23 +179,28 @@ static Object* block_alloc_bump(MemoryBlock* block) {
         return NULL;
     }
     
-    Object* obj = &block->memory[block->used];
+    Object* obj = heap_block_slot(block, block->used);
     block->used++;
     
-    memset(obj, 0, sizeof(Object));
+    memset(obj, 0, block->slot_size);
     return obj;
 }
 
 
-static void pool_init(ObjectPool* pool, size_t block_size) {
+static void pool_init(ObjectPool* pool, size_t block_size, ObjectType type) {
     pool->first = NULL;
     pool->current = NULL;
     pool->block_size = block_size;
+    pool->slot_size = object_slot_size(type);
     pool->total_allocations = 0;
+    pool->scan_block = NULL;
+    pool->scan_index = 0;
+    pool->scan_exhausted = false;
+    pool->bumped_since_scan = 0;
 }
 
 static bool pool_add_block(ObjectPool* pool) {
-    MemoryBlock* new_block = block_create(pool->block_size);
+    MemoryBlock* new_block = block_create(pool->block_size, pool->slot_size);
     if (!new_block) {
         return false;
     }
@@ -213,6 +260,101 @@ static void pool_destroy(ObjectPool* pool) {
     pool->current = NULL;
 }
 
+static void pool_rewind_scan(ObjectPool* pool) {
+    pool->scan_block = NULL;
+    pool->scan_index = 0;
+    pool->scan_exhausted = false;
+}
+
+static void heap_sweep_block(Heap* heap, MemoryBlock* block) {
+    for (size_t i = 0; i < block->used; i++) {
+        heap->sweep_callback(heap->sweep_data, heap_block_slot(block, i));
+    }
+    block->unswept = false;
+
+    if (--heap->unswept_blocks == 0) {
+        heap->sweep_completed = true;
+        DPRINT("[HEAP] Lazy sweep completed\n");
+    }
+}
+
+// Sweeps the next block still flagged by heap_begin_lazy_sweep.
+static void heap_sweep_next_block(Heap* heap) {
+    while (heap->unswept_blocks > 0 && heap->sweep_pool < HEAP_POOL_COUNT) {
+        MemoryBlock* block = heap->sweep_block;
+        if (!block) {
+            if (++heap->sweep_pool < HEAP_POOL_COUNT) {
+                heap->sweep_block = heap_pool_at(heap, heap->sweep_pool)->first;
+            }
+            continue;
+        }
+        heap->sweep_block = block->next;
+        if (block->unswept) {
+            heap_sweep_block(heap, block);
+            return;
+        }
+    }
+}
+
+// Next-fit search for a slot whose ref_count dropped to 0, resumed where
+// the previous search stopped instead of rescanning from the first block.
+static Object* pool_find_free(Heap* heap, ObjectPool* pool) {
+    if (pool->scan_exhausted) {
+        // slots freed by refcounting meanwhile are picked up on the next pass
+        if (pool->bumped_since_scan * HEAP_RESCAN_DIVISOR < pool->total_allocations) {
+            return NULL;
+        }
+        pool_rewind_scan(pool);
+    }
+    if (!pool->scan_block) {
+        pool->scan_block = pool->first;
+        pool->scan_index = 0;
+    }
+
+    while (pool->scan_block) {
+        MemoryBlock* block = pool->scan_block;
+        if (block->unswept) {
+            heap_sweep_block(heap, block);
+        }
+        while (pool->scan_index < block->used) {
+            Object* obj = heap_block_slot(block, pool->scan_index++);
+            if (obj->ref_count == 0) {
+                return obj;
+            }
+        }
+        pool->scan_block = block->next;
+        pool->scan_index = 0;
+    }
+
+    pool->scan_exhausted = true;
+    pool->bumped_since_scan = 0;
+    return NULL;
+}
+
+// Every allocation comes through here: advance a pending lazy sweep by
+// one block, then reuse a free slot, else bump allocate. New objects only
+// ever land in swept blocks.
+static Object* heap_take_slot(Heap* heap, ObjectPool* pool) {
+    if (heap->unswept_blocks > 0) {
+        heap_sweep_next_block(heap);
+    }
+
+    Object* obj = pool_find_free(heap, pool);
+    if (obj) {
+        recycle_object(obj, pool->slot_size);
+        return obj;
+    }
+
+    if (pool->current && pool->current->unswept) {
+        heap_sweep_block(heap, pool->current);
+    }
+    obj = pool_alloc(pool);
+    if (obj) {
+        pool->bumped_since_scan++;
+    }
+    return obj;
+}
+
 
 Heap* heap_create(void) {
     Heap* heap = malloc(sizeof(Heap));
@@ -220,21 +362,39 @@ Heap* heap_create(void) {
 
     init_int_cache(heap);
     
-    pool_init(&heap->int_pool, 2000000);
-    pool_init(&heap->array_pool, 100);
-    pool_init(&heap->function_pool, 100);
-    pool_init(&heap->code_pool, 100);
-    pool_init(&heap->native_func_pool, 100);
-    pool_init(&heap->float_pool, 10000);
+    // blocks are the unit of lazy sweeping and of returning memory
+    pool_init(&heap->int_pool, 65536, OBJ_INT);
+    pool_init(&heap->array_pool, 4096, OBJ_ARRAY);
+    pool_init(&heap->function_pool, 100, OBJ_FUNCTION);
+    pool_init(&heap->code_pool, 100, OBJ_CODE);
+    pool_init(&heap->native_func_pool, 100, OBJ_NATIVE_FUNCTION);
+    pool_init(&heap->float_pool, 16384, OBJ_FLOAT);
 
-    pool_init(&heap->bool_pool, 2);
-    pool_init(&heap->none_pool, 1);
+    pool_init(&heap->bool_pool, 2, OBJ_BOOL);
+    pool_init(&heap->none_pool, 1, OBJ_NONE);
+    pool_init(&heap->record_pool, 4096, OBJ_ARRAY);
 
     heap->none_singleton = NULL;
     heap->true_singleton = NULL;
     heap->false_singleton = NULL;
+
+    heap->track_young = false;
+    heap->nursery = NULL;
+    heap->nursery_count = 0;
+    heap->nursery_capacity = 0;
     
     heap->total_allocations = 0;
+    heap->total_bytes = 0;
+    heap->bytes_since_gc = 0;
+    heap->objects_since_gc = 0;
+
+    heap->sweep_callback = NULL;
+    heap->sweep_data = NULL;
+    heap->unswept_blocks = 0;
+    heap->sweep_pool = HEAP_POOL_COUNT;
+    heap->sweep_block = NULL;
+    heap->sweep_completed = false;
+    heap->released_bytes = 0;
     
     return heap;
 }
@@ -252,6 +412,9 @@ void heap_destroy(Heap* heap) {
     pool_destroy(&heap->code_pool);
     pool_destroy(&heap->native_func_pool);
     pool_destroy(&heap->float_pool);
+    pool_destroy(&heap->record_pool);
+
+    free(heap->nursery);
     
     free(heap);
 }
@@ -263,23 +426,7 @@ Object* heap_alloc_int(Heap* heap, int64_t v) {
     
     heap->total_allocations++;
 
-    MemoryBlock* block = heap->int_pool.first;
-    while (block) {
-        for (size_t i = 0; i < block->used; i++) {
-            Object* obj = &block->memory[i];
-            if (obj && obj->ref_count == 0) {
-                obj->type = OBJ_INT;
-                obj->ref_count = 1;
-                obj->as.int_value = v;
-                DPRINT("[HEAP] Reused int %lld at %p\n", 
-                        (long long)v, (void*)obj);
-                return obj;
-            }
-        }
-        block = block->next;
-    }
-
-    Object* o = pool_alloc(&heap->int_pool);
+    Object* o = heap_take_slot(heap, &heap->int_pool);
     if (!o) {
         DPRINT("ERROR: Failed to allocate int object\n");
         return NULL;
@@ -288,6 +435,7 @@ Object* heap_alloc_int(Heap* heap, int64_t v) {
     o->type = OBJ_INT;
     o->ref_count = 1;
     o->as.int_value = v;
+    heap_note_alloc(heap, o);
     
     DPRINT("[HEAP] New int %lld at %p\n", 
             (long long)v, (void*)o);
@@ -297,82 +445,225 @@ Object* heap_alloc_int(Heap* heap, int64_t v) {
 Object* heap_alloc_float_from_bf(Heap* heap, BigFloat* bf) {
     heap->total_allocations++;
     
-    Object* o = pool_alloc(&heap->float_pool);
+    Object* o = heap_take_slot(heap, &heap->float_pool);
     if (!o) {
         DPRINT("ERROR: Failed to allocate float object from BigFloat\n");
         bigfloat_destroy(bf);
+        return NULL;
     }
 
     o->type = OBJ_FLOAT;
     o->ref_count = 1;
     o->as.float_value = bf;
+    heap_note_alloc(heap, o);
     
     return o;
 }
 
-Object* heap_alloc_array(Heap* heap) {
+static Object* heap_alloc_array_from(Heap* heap, ObjectPool* pool) {
     heap->total_allocations++;
     
-    Object* o = find_free_object_in_pool(&heap->array_pool);
-    if (o) {
-        DPRINT("[HEAP] Reusing array object at %p\n", (void*)o);
-        recycle_object(o);
-    } else {
-        o = pool_alloc(&heap->array_pool);
-        if (!o) {
-            DPRINT("ERROR: Failed to allocate array object\n");
-            return NULL;
-        }
+    Object* o = heap_take_slot(heap, pool);
+    if (!o) {
+        DPRINT("ERROR: Failed to allocate array object\n");
+        return NULL;
     }
     
     o->type = OBJ_ARRAY;
     o->ref_count = 1;
     o->as.array.items = NULL;
     o->as.array.size = 0;
+    o->as.array.capacity = 0;
+    o->as.array.base = NULL;
+    o->as.array.cols = 0;
+    heap_note_alloc(heap, o);
     
     return o;
 }
 
+// Gives a fresh array size elements of kind: None for boxed items, zero
+// for typed ones.
+static void heap_array_init_storage(Heap* heap, Object* array, ArrayKind kind, size_t size) {
+    if (kind == ARRAY_BOXED) {
+        array->as.array.items = malloc(size * sizeof(Object*));
+        if (!array->as.array.items) {
+            DPRINT("ERROR: Failed to allocate array items\n");
+            return;
+        }
+        Object* none = heap_alloc_none(heap);
+        for (size_t i = 0; i < size; i++) {
+            array->as.array.items[i] = none;
+        }
+    } else {
+        void* storage = calloc(size > 0 ? size : 1, object_array_elem_size(kind));
+        if (!storage) {
+            DPRINT("ERROR: Failed to allocate typed array storage\n");
+            return;
+        }
+        array->elem_kind = (uint8_t)kind;
+        if (kind == ARRAY_INT) {
+            array->as.array.ints = storage;
+        } else {
+            array->as.array.bools = storage;
+        }
+    }
+
+    size_t bytes = size * object_array_elem_size(kind);
+    array->as.array.size = size;
+    array->as.array.capacity = size;
+    heap->bytes_since_gc += bytes;
+    heap->total_bytes += bytes;
+}
+
+Object* heap_alloc_array(Heap* heap) {
+    return heap_alloc_array_from(heap, &heap->array_pool);
+}
+
 Object* heap_alloc_array_with_size(Heap* heap, size_t size) {
+    return heap_alloc_typed_array(heap, ARRAY_BOXED, size);
+}
+
+Object* heap_alloc_typed_array(Heap* heap, ArrayKind kind, size_t size) {
     Object* array = heap_alloc_array(heap);
-    if (!array) {
+    if (array) {
+        heap_array_init_storage(heap, array, kind, size);
+    }
+    return array;
+}
+
+Object* heap_alloc_record(Heap* heap, ArrayKind kind, size_t fields) {
+    Object* record = heap_alloc_array_from(heap, &heap->record_pool);
+    if (record) {
+        heap_array_init_storage(heap, record, kind, fields);
+    }
+    return record;
+}
+
+Object* heap_alloc_matrix(Heap* heap, ArrayKind kind, size_t rows, size_t cols) {
+    if (cols > 0 && rows > SIZE_MAX / cols / sizeof(int64_t)) {
+        DPRINT("ERROR: Matrix of %zu x %zu elements is too large\n", rows, cols);
         return NULL;
     }
-    
-    array->as.array.items = malloc(size * sizeof(Object*));
-    if (!array->as.array.items) {
-        DPRINT("ERROR: Failed to allocate array items\n");
-        return array;
+
+    Object* matrix = heap_alloc_typed_array(heap, kind, rows * cols);
+    if (!matrix) {
+        return NULL;
+    }
+    matrix->as.array.cols = cols;
+    return matrix;
+}
+
+Object* heap_array_load(Heap* heap, Object* array, size_t index) {
+    switch (array->elem_kind) {
+        case ARRAY_INT:
+            return heap_alloc_int(heap, array->as.array.ints[index]);
+        case ARRAY_BOOL:
+            return heap_alloc_bool(heap, array->as.array.bools[index] != 0);
+        default: {
+            Object* item = array->as.array.items[index];
+            return item ? item : heap_alloc_none(heap);
+        }
+    }
+}
+
+bool heap_array_store_unboxed(Object* array, size_t index, Object* value) {
+    switch (array->elem_kind) {
+        case ARRAY_INT:
+            if (value->type != OBJ_INT) return false;
+            array->as.array.ints[index] = value->as.int_value;
+            return true;
+        case ARRAY_BOOL:
+            if (value->type != OBJ_BOOL) return false;
+            array->as.array.bools[index] = value->as.bool_value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool heap_array_box(Heap* heap, Object* array) {
+    if (array->elem_kind == ARRAY_BOXED) return true;
+
+    size_t size = array->as.array.size;
+    size_t capacity = array->as.array.capacity;
+    Object** items = malloc((capacity > 0 ? capacity : 1) * sizeof(Object*));
+    if (!items) {
+        DPRINT("ERROR: Failed to box typed array\n");
+        return false;
     }
-    
-    array->as.array.size = size;
-    
-    Object* none = heap_alloc_none(heap);
     for (size_t i = 0; i < size; i++) {
-        array->as.array.items[i] = none;
+        items[i] = heap_array_load(heap, array, i);
     }
-    
-    return array;
+    DPRINT("[heap] Boxed typed array %p of %zu elements\n", (void*)array, size);
+
+    size_t raw = capacity * object_array_elem_size((ArrayKind)array->elem_kind);
+    free(array->as.array.ints);
+    array->as.array.items = items;
+    array->elem_kind = ARRAY_BOXED;
+    if (capacity * sizeof(Object*) > raw) {
+        heap->bytes_since_gc += capacity * sizeof(Object*) - raw;
+        heap->total_bytes += capacity * sizeof(Object*) - raw;
+    }
+    return true;
+}
+
+Object* heap_alloc_array_view(Heap* heap, Object* array, size_t lo, size_t hi) {
+    Object* base = object_array_owner(array);
+    object_array_sync(array);
+    if (hi > array->as.array.size) hi = array->as.array.size;
+    if (lo > hi) lo = hi;
+    size_t offset = (array == base ? 0 : array->as.array.offset) + lo;
+
+    Object* view = heap_alloc_array(heap);
+    if (!view) {
+        return NULL;
+    }
+    view->as.array.base = base;
+    view->as.array.offset = offset;
+    view->as.array.size = hi - lo;
+    object_array_view_sync(view);
+    DPRINT("[heap] View %p of array %p: [%zu, %zu)\n", (void*)view, (void*)base, offset, offset + hi - lo);
+    return view;
+}
+
+bool heap_array_reserve(Heap* heap, Object* array, size_t capacity) {
+    size_t elem_size = object_array_elem_size((ArrayKind)array->elem_kind);
+    size_t before = array->as.array.capacity;
+    if (!object_array_reserve(array, capacity)) return false;
+
+    size_t after = array->as.array.capacity;
+    if (after > before) {
+        heap->bytes_since_gc += (after - before) * elem_size;
+        heap->total_bytes += (after - before) * elem_size;
+    }
+    if (after != before) {
+        DPRINT("[heap] Array %p capacity %zu -> %zu\n", (void*)array, before, after);
+    }
+    return true;
+}
+
+bool heap_array_grow(Heap* heap, Object* array, size_t needed) {
+    size_t capacity = array->as.array.capacity;
+    if (needed <= capacity) return true;
+
+    capacity = capacity < OBJECT_ARRAY_MIN_CAPACITY ? OBJECT_ARRAY_MIN_CAPACITY : capacity;
+    while (capacity < needed) capacity *= 2;
+    return heap_array_reserve(heap, array, capacity);
 }
 
 Object* heap_alloc_float(Heap* heap, const char* v) {
     heap->total_allocations++;
     
-    Object* o = find_free_object_in_pool(&heap->float_pool);
-    if (o) {
-        DPRINT("[HEAP] Reusing float object at %p\n", (void*)o);
-        recycle_object(o);
-    } else {
-        o = pool_alloc(&heap->float_pool);
-        if (!o) {
-            DPRINT("ERROR: Failed to allocate float object\n");
-            return NULL;
-        }
+    Object* o = heap_take_slot(heap, &heap->float_pool);
+    if (!o) {
+        DPRINT("ERROR: Failed to allocate float object\n");
+        return NULL;
     }
     
     o->type = OBJ_FLOAT;
     o->ref_count = 1;
     o->as.float_value = bigfloat_create(v);
+    heap_note_alloc(heap, o);
     
     return o;
 }
@@ -380,23 +671,16 @@ Object* heap_alloc_float(Heap* heap, const char* v) {
 Object* heap_alloc_function(Heap* heap, CodeObj* code) {
     heap->total_allocations++;
     
-    Object* o = find_free_object_in_pool(&heap->function_pool);
-    if (o) {
-        DPRINT("[HEAP] Reusing function object at %p\n", (void*)o);
-        recycle_object(o);
-    } else {
-        o = pool_alloc(&heap->function_pool);
-        if (!o) {
-            DPRINT("ERROR: Failed to allocate function object\n");
-            return NULL;
-        }
+    Object* o = heap_take_slot(heap, &heap->function_pool);
+    if (!o) {
+        DPRINT("ERROR: Failed to allocate function object\n");
+        return NULL;
     }
     
     o->type = OBJ_FUNCTION;
     o->ref_count = 1;
     o->as.function.codeptr = code;
-    o->as.function.call_count = 0;
-    o->as.function.jit_compiled = false;
+    heap_note_alloc(heap, o);
     
     return o;
 }
@@ -404,21 +688,16 @@ Object* heap_alloc_function(Heap* heap, CodeObj* code) {
 Object* heap_alloc_code(Heap* heap, CodeObj* code) {
     heap->total_allocations++;
     
-    Object* o = find_free_object_in_pool(&heap->code_pool);
-    if (o) {
-        DPRINT("[HEAP] Reusing code object at %p\n", (void*)o);
-        recycle_object(o);
-    } else {
-        o = pool_alloc(&heap->code_pool);
-        if (!o) {
-            DPRINT("ERROR: Failed to allocate code object\n");
-            return NULL;
-        }
+    Object* o = heap_take_slot(heap, &heap->code_pool);
+    if (!o) {
+        DPRINT("ERROR: Failed to allocate code object\n");
+        return NULL;
     }
     
     o->type = OBJ_CODE;
     o->ref_count = 1;
     o->as.codeptr = code;
+    heap_note_alloc(heap, o);
     
     return o;
 }
@@ -426,22 +705,17 @@ Object* heap_alloc_code(Heap* heap, CodeObj* code) {
 Object* heap_alloc_native_function(Heap* heap, NativeCFunc c_func, const char* name) {
     heap->total_allocations++;
     
-    Object* o = find_free_object_in_pool(&heap->native_func_pool);
-    if (o) {
-        DPRINT("[HEAP] Reusing native function object at %p\n", (void*)o);
-        recycle_object(o);
-    } else {
-        o = pool_alloc(&heap->native_func_pool);
-        if (!o) {
-            DPRINT("ERROR: Failed to allocate native function object\n");
-            return NULL;
-        }
+    Object* o = heap_take_slot(heap, &heap->native_func_pool);
+    if (!o) {
+        DPRINT("ERROR: Failed to allocate native function object\n");
+        return NULL;
     }
     
     o->type = OBJ_NATIVE_FUNCTION;
     o->ref_count = 1;
     o->as.native_function.c_func = c_func;
     o->as.native_function.name = strdup(name);
+    heap_note_alloc(heap, o);
     
     return o;
 }
@@ -507,120 +781,88 @@ size_t heap_live_objects(Heap* heap) {
            pool_used_objects(&heap->array_pool) +
            pool_used_objects(&heap->function_pool) +
            pool_used_objects(&heap->code_pool) +
-           pool_used_objects(&heap->native_func_pool);
+           pool_used_objects(&heap->native_func_pool) +
+           pool_used_objects(&heap->record_pool);
 }
 
-static size_t pool_block_count(ObjectPool* pool) {
-    size_t count = 0;
-    MemoryBlock* block = pool->first;
-    
-    while (block) {
-        count++;
-        block = block->next;
-    }
-    
-    return count;
-}
+static const char* const heap_pool_names[HEAP_POOL_COUNT] = {
+    "int", "array", "function", "code", "native_function", "float", "bool", "none", "record"
+};
 
+void heap_get_pool_stats(Heap* heap, HeapPoolStats stats[HEAP_POOL_COUNT]) {
+    memset(stats, 0, HEAP_POOL_COUNT * sizeof(HeapPoolStats));
+    for (int p = 0; p < HEAP_POOL_COUNT; p++) {
+        HeapPoolStats* s = &stats[p];
+        s->name = heap_pool_names[p];
+        if (!heap) continue;
+        s->slot_size = heap_pool_at(heap, p)->slot_size;
 
-void heap_print_stats(Heap* heap) {
-    if (!heap || !debug_enabled) return;
-    
-    DPRINT("\n=== Heap Statistics ===\n");
-    DPRINT("Total allocations: %zu\n", heap->total_allocations);
-    
-    typedef struct {
-        const char* name;
-        size_t live;
-        size_t free;
-        size_t immortal;
-        size_t blocks;
-    } PoolStats;
-    
-    PoolStats stats[] = {
-        {"Int", 0, 0, 0, 0},
-        {"Array", 0, 0, 0, 0},
-        {"Function", 0, 0, 0, 0},
-        {"Code", 0, 0, 0, 0},
-        {"NativeFunc", 0, 0, 0, 0},
-        {"Float", 0, 0, 0, 0},
-        {"Bool", 0, 0, 0, 0},
-        {"None", 0, 0, 0, 0}
-    };
-    
-    ObjectPool* pools[] = {
-        &heap->int_pool,
-        &heap->array_pool,
-        &heap->function_pool,
-        &heap->code_pool,
-        &heap->native_func_pool,
-        &heap->float_pool,
-        &heap->bool_pool,
-        &heap->none_pool
-    };
-    
-    const char* pool_names[] = {
-        "Int", "Array", "Function", "Code", 
-        "NativeFunc", "Float", "Bool", "None"
-    };
-    
-    for (int pool_idx = 0; pool_idx < 8; pool_idx++) {
-        ObjectPool* pool = pools[pool_idx];
-        PoolStats* s = &stats[pool_idx];
-        
-        s->blocks = pool_block_count(pool);
-        
-        if (!pool || !pool->first) continue;
-        
-        MemoryBlock* block = pool->first;
-        while (block) {
+        for (MemoryBlock* block = heap_pool_at(heap, p)->first; block; block = block->next) {
+            s->blocks++;
+            if (block->released) {
+                s->released_blocks++;
+                continue;
+            }
+            s->slots += block->capacity;
+            s->used += block->used;
             for (size_t i = 0; i < block->used; i++) {
-                Object* obj = &block->memory[i];
-                if (obj) {
-                    if (obj->ref_count == 0) {
-                        s->free++;           
-                    } else if (obj->ref_count == 0x7FFFFFFF) {
-                        s->immortal++;       
-                    } else {
-                        s->live++;           
-                    }
+                Object* obj = heap_block_slot(block, i);
+                if (obj->ref_count == 0) {
+                    s->free++;
+                } else if (obj->ref_count == 0x7FFFFFFF) {
+                    s->immortal++;
+                } else {
+                    s->live++;
                 }
             }
-            block = block->next;
         }
     }
+}
+
+void heap_print_stats(Heap* heap) {
+    if (!heap || !debug_enabled) return;
+    
+    DPRINT("\n=== Heap Statistics ===\n");
+    DPRINT("Total allocations: %zu, %zu bytes\n", heap->total_allocations, heap->total_bytes);
+    DPRINT("Since last GC: %zu objects, %zu bytes\n",
+           heap->objects_since_gc, heap->bytes_since_gc);
+    DPRINT("Unswept blocks: %zu, released to the OS: %zu bytes\n",
+           heap->unswept_blocks, heap->released_bytes);
+
+    HeapPoolStats stats[HEAP_POOL_COUNT];
+    heap_get_pool_stats(heap, stats);
     
     size_t total_live = 0;
     size_t total_free = 0;
     size_t total_immortal = 0;
-    size_t total_objects = 0;
     size_t total_blocks = 0;
+    size_t resident_bytes = 0;
     
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i < HEAP_POOL_COUNT; i++) {
         total_live += stats[i].live;
         total_free += stats[i].free;
         total_immortal += stats[i].immortal;
-        total_objects += stats[i].live + stats[i].free + stats[i].immortal;
         total_blocks += stats[i].blocks;
+        resident_bytes += stats[i].slots * stats[i].slot_size;
     }
     
     DPRINT("Total live objects: %zu\n", total_live);
     DPRINT("Total free objects: %zu\n", total_free);
     DPRINT("Total immortal objects: %zu\n", total_immortal);
-    DPRINT("Total objects in pools: %zu\n", total_objects);
+    DPRINT("Total objects in pools: %zu\n", total_live + total_free + total_immortal);
     DPRINT("Total memory blocks: %zu\n", total_blocks);
     
-    DPRINT("%-12s | %6s | %6s | %6s | %6s | %7s\n", 
+    DPRINT("%-15s | %6s | %6s | %6s | %6s | %7s\n", 
             "Pool", "Live", "Free", "Immort", "Blocks", "Eff %");
-    DPRINT("------------|--------|--------|--------|--------|--------\n");
+    DPRINT("----------------|--------|--------|--------|--------|--------\n");
     
-    for (int i = 0; i < 8; i++) {
-        size_t total_in_pool = stats[i].live + stats[i].free + stats[i].immortal;
+    for (int i = 0; i < HEAP_POOL_COUNT; i++) {
+        size_t total_in_pool = stats[i].used;
         double efficiency = (total_in_pool > 0) ? 
             (double)stats[i].live * 100.0 / (total_in_pool) : 0.0;
         
-        DPRINT("%-12s | %6zu | %6zu | %6zu | %6zu | %6.1f%%\n",
-                pool_names[i],
+        DPRINT("%-15s | %6zu | %6zu | %6zu | %6zu | %6.1f%%\n",
+                stats[i].name,
                 stats[i].live,
                 stats[i].free,
                 stats[i].immortal,
@@ -628,14 +870,8 @@ void heap_print_stats(Heap* heap) {
                 efficiency);
     }
     
-    size_t estimated_memory = 0;
-    for (int i = 0; i < 8; i++) {
-        if (pools[i]->block_size > 0) {
-            estimated_memory += stats[i].blocks * pools[i]->block_size * sizeof(Object);
-        }
-    }
-    DPRINT("\nEstimated memory usage: ~%.2f MB\n",
-           estimated_memory / (1024.0 * 1024.0));
+    DPRINT("\nResident pool memory: ~%.2f MB\n",
+           resident_bytes / (1024.0 * 1024.0));
     DPRINT("=======================\n");
 }
 
@@ -645,7 +881,7 @@ static void pool_iterate_objects(ObjectPool* pool, HeapObjectCallback callback,
     MemoryBlock* block = pool->first;
     while (block) {
         for (size_t i = 0; i < block->used; i++) {
-            Object* obj = &block->memory[i];
+            Object* obj = heap_block_slot(block, i);
             if (obj) {
                 callback(user_data, obj);
             }
@@ -665,5 +901,156 @@ void heap_iterate_all_objects(Heap* heap, HeapObjectCallback callback, void* use
     pool_iterate_objects(&heap->float_pool, callback, user_data);
     pool_iterate_objects(&heap->bool_pool, callback, user_data);
     pool_iterate_objects(&heap->none_pool, callback, user_data);
+    pool_iterate_objects(&heap->record_pool, callback, user_data);
+
+}
+
+bool heap_iterate_step(Heap* heap, HeapCursor* cursor, size_t max_objects,
+                       HeapObjectCallback callback, void* user_data) {
+    if (!heap || !cursor || !callback) return true;
+
+    size_t visited = 0;
+    while (cursor->pool < HEAP_POOL_COUNT) {
+        if (!cursor->block) {
+            cursor->block = heap_pool_at(heap, cursor->pool)->first;
+            cursor->index = 0;
+            if (!cursor->block) {
+                cursor->pool++;
+                continue;
+            }
+        }
+
+        MemoryBlock* block = cursor->block;
+        while (cursor->index < block->used) {
+            if (visited == max_objects) return false;
+            callback(user_data, heap_block_slot(block, cursor->index++));
+            visited++;
+        }
+
+        cursor->block = block->next;
+        cursor->index = 0;
+        if (!cursor->block) {
+            cursor->pool++;
+        }
+    }
+    return true;
+}
+
+void heap_iterate_partition(Heap* heap, size_t part, size_t parts,
+                            HeapObjectCallback callback, void* user_data) {
+    if (!heap || !callback || parts == 0) return;
+
+    size_t chunk = 0;
+    for (int p = 0; p < HEAP_POOL_COUNT; p++) {
+        for (MemoryBlock* block = heap_pool_at(heap, p)->first; block; block = block->next) {
+            for (size_t start = 0; start < block->used; start += HEAP_PARTITION_CHUNK, chunk++) {
+                if (chunk % parts != part) continue;
+                size_t end = start + HEAP_PARTITION_CHUNK;
+                if (end > block->used) end = block->used;
+                for (size_t i = start; i < end; i++) {
+                    callback(user_data, heap_block_slot(block, i));
+                }
+            }
+        }
+    }
+}
+
+void heap_note_collection(Heap* heap) {
+    if (!heap) return;
+
+    heap->bytes_since_gc = 0;
+    heap->objects_since_gc = 0;
+    for (int p = 0; p < HEAP_POOL_COUNT; p++) {
+        pool_rewind_scan(heap_pool_at(heap, p));
+    }
+}
+
+void heap_begin_lazy_sweep(Heap* heap, HeapObjectCallback sweep, void* sweep_data) {
+    if (!heap || !sweep) return;
+
+    heap_finish_sweep(heap);
+    heap->sweep_callback = sweep;
+    heap->sweep_data = sweep_data;
 
+    size_t blocks = 0;
+    for (int p = 0; p < HEAP_POOL_COUNT; p++) {
+        for (MemoryBlock* block = heap_pool_at(heap, p)->first; block; block = block->next) {
+            if (block->used > 0) {
+                block->unswept = true;
+                blocks++;
+            }
+        }
+    }
+    heap->unswept_blocks = blocks;
+    heap->sweep_pool = 0;
+    heap->sweep_block = heap_pool_at(heap, 0)->first;
+
+    DPRINT("[HEAP] Lazy sweep of %zu blocks pending\n", blocks);
+}
+
+void heap_finish_sweep(Heap* heap) {
+    if (!heap) return;
+
+    while (heap->unswept_blocks > 0) {
+        heap_sweep_next_block(heap);
+    }
+}
+
+// Released blocks stay mapped and linked: the free-slot search and the
+// remembered set may still read them, and a zero page reads as a free
+// slot, so reusing one simply faults its pages back in.
+static size_t pool_release_empty_blocks(Heap* heap, ObjectPool* pool) {
+    size_t live = 0;
+    for (MemoryBlock* block = pool->first; block; block = block->next) {
+        block->live = 0;
+        for (size_t i = 0; i < block->used; i++) {
+            if (heap_block_slot(block, i)->ref_count != 0) {
+                block->live++;
+            }
+        }
+        live += block->live;
+    }
+
+    size_t allowance = live / HEAP_RETAIN_DIVISOR;
+    if (allowance < pool->block_size) {
+        allowance = pool->block_size;
+    }
+
+    size_t retained = 0;
+    size_t released = 0;
+    for (MemoryBlock* block = pool->first; block; block = block->next) {
+        if (block->live > 0 || block->used == 0) {
+            block->released = false;
+            continue;
+        }
+        if (block->released) continue;
+
+        if (retained + block->capacity <= allowance) {
+            retained += block->capacity;
+            continue;
+        }
+        size_t bytes = block->capacity * block->slot_size;
+        if (madvise(block->memory, bytes, MADV_DONTNEED) == 0) {
+            block->released = true;
+            heap->released_bytes += bytes;
+            released++;
+        }
+    }
+    return released;
+}
+
+size_t heap_release_empty_blocks(Heap* heap) {
+    if (!heap) return 0;
+
+    size_t released = 0;
+    for (int p = 0; p < HEAP_POOL_COUNT; p++) {
+        released += pool_release_empty_blocks(heap, heap_pool_at(heap, p));
+    }
+    heap->sweep_completed = false;
+
+    if (released > 0) {
+        DPRINT("[HEAP] Released %zu empty blocks, %zu bytes returned in total\n",
+               released, heap->released_bytes);
+    }
+    return released;
 }
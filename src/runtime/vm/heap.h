@@ -10,18 +10,46 @@
 #define INT_CACHE_MAX 1000000
 #define INT_CACHE_SIZE (INT_CACHE_MAX - INT_CACHE_MIN + 1)
 
+// Empty blocks beyond this fraction of a pool's live objects are given
+// back to the OS; one block per pool is always kept.
+#define HEAP_RETAIN_DIVISOR 4
+// Once a free-slot search finds nothing, it restarts after the pool has
+// grown by 1/HEAP_RESCAN_DIVISOR, or after the next collection.
+#define HEAP_RESCAN_DIVISOR 4
+
+#define HEAP_POOL_COUNT 9
+
+typedef void (*HeapObjectCallback)(void* user_data, Object* obj);
+
 typedef struct MemoryBlock {
-    Object* memory;
+    unsigned char* memory;  // page-aligned mapping, capacity slots
+    size_t slot_size;       // bytes per slot, set by the owning pool
     size_t capacity;
     size_t used;
+    bool unswept;       // marked by the last major, not yet swept
+    bool released;      // empty and handed back with MADV_DONTNEED
+    size_t live;        // live slots at the last release check
     struct MemoryBlock* next;
 } MemoryBlock;
 
+static inline Object* heap_block_slot(const MemoryBlock* block, size_t index) {
+    return (Object*)(block->memory + index * block->slot_size);
+}
+
+// One pool per object type, so every slot in a pool has the same size:
+// object_slot_size() of that type.
 typedef struct ObjectPool {
     MemoryBlock* first;
     MemoryBlock* current;
     size_t block_size;
+    size_t slot_size;
     size_t total_allocations;
+
+    // next-fit search for slots whose ref_count dropped to 0
+    MemoryBlock* scan_block;
+    size_t scan_index;
+    bool scan_exhausted;
+    size_t bumped_since_scan;
 } ObjectPool;
 
 typedef struct Heap {
@@ -38,9 +66,41 @@ typedef struct Heap {
     Object* true_singleton;
     Object* false_singleton;
 
+    // struct records: arrays of a layout's fields, kept apart from the
+    // arrays they are stored in so a struct array's records stay together
+    ObjectPool record_pool;
+
+    // small int objects, packed into one allocation
     Object* int_cache[INT_CACHE_SIZE];
+    unsigned char* int_cache_slab;
+
+    // Objects cannot move (raw Object* live in C frames), so the nursery is
+    // a bump-allocated log of young objects rather than a copying space.
+    bool track_young;
+    Object** nursery;
+    size_t nursery_count;
+    size_t nursery_capacity;
+
+    // Allocated since the last collection; the VM compares bytes_since_gc
+    // against the GC's young budget. Bytes include out-of-line array items
+    // and BigFloat digit buffers, not just object slots.
+    size_t bytes_since_gc;
+    size_t objects_since_gc;
+
+    // Lazy sweep left by a major collection: allocations sweep one block
+    // each through sweep_callback until unswept_blocks reaches zero.
+    HeapObjectCallback sweep_callback;
+    void* sweep_data;
+    size_t unswept_blocks;
+    int sweep_pool;
+    MemoryBlock* sweep_block;
+    // a sweep pass finished since empty blocks were last released
+    bool sweep_completed;
+    size_t released_bytes;
     
     size_t total_allocations;
+    // every byte counted into bytes_since_gc, never reset
+    size_t total_bytes;
 } Heap;
 
 Heap* heap_create(void);
@@ -57,11 +117,83 @@ Object* heap_alloc_array(Heap* heap);
 Object* heap_alloc_array_with_size(Heap* heap, size_t size);
 Object* heap_alloc_native_function(Heap* heap, NativeCFunc c_func, const char* name);
 
+// Array of size zero-initialised elements stored unboxed as kind.
+Object* heap_alloc_typed_array(Heap* heap, ArrayKind kind, size_t size);
+// Struct record of fields elements, from the record pool: typed storage
+// of kind when every field has that type, otherwise boxed.
+Object* heap_alloc_record(Heap* heap, ArrayKind kind, size_t fields);
+// rows x cols array in row-major order (T[n][m]); NULL if the element
+// count overflows.
+Object* heap_alloc_matrix(Heap* heap, ArrayKind kind, size_t rows, size_t cols);
+// Element index, boxed if the array is typed. No bounds check.
+Object* heap_array_load(Heap* heap, Object* array, size_t index);
+// Stores value unboxed if it matches a typed array's kind; false otherwise.
+bool heap_array_store_unboxed(Object* array, size_t index, Object* value);
+// Converts a typed array to boxed storage in place. The boxed items carry
+// only their own count: the caller owns counting them as array items.
+bool heap_array_box(Heap* heap, Object* array);
+// View of elements [lo, hi) of array (clamped to its size) sharing its
+// storage; a view of a view points at the underlying base. The caller owns
+// counting the view's reference to the base.
+Object* heap_alloc_array_view(Heap* heap, Object* array, size_t lo, size_t hi);
+// Resizes an array's storage to capacity elements (never below its size),
+// accounting the change. Growing past capacity through heap_array_grow
+// doubles it, so appends are amortized O(1); shrink with capacity = size.
+bool heap_array_reserve(Heap* heap, Object* array, size_t capacity);
+bool heap_array_grow(Heap* heap, Object* array, size_t needed);
+
 Object* heap_from_value(Heap* heap, Value val);
 size_t heap_live_objects(Heap* heap);
 void heap_print_stats(Heap* heap);
 
-typedef void (*HeapObjectCallback)(void* user_data, Object* obj);
+// Occupancy of one pool. Slots count resident blocks only; used slots are
+// those below the bump pointers, each live, immortal or free, so free/used
+// is how fragmented the pool is.
+typedef struct HeapPoolStats {
+    const char* name;
+    size_t slot_size;
+    size_t blocks;
+    size_t released_blocks;
+    size_t slots;
+    size_t used;
+    size_t live;
+    size_t immortal;
+    size_t free;
+} HeapPoolStats;
+
+void heap_get_pool_stats(Heap* heap, HeapPoolStats stats[HEAP_POOL_COUNT]);
+
 void heap_iterate_all_objects(Heap* heap, HeapObjectCallback callback, void* user_data);
 
+// Splits every pool into HEAP_PARTITION_CHUNK-object chunks and visits
+// those whose sequence number is part modulo parts.
+#define HEAP_PARTITION_CHUNK 4096
+void heap_iterate_partition(Heap* heap, size_t part, size_t parts,
+                            HeapObjectCallback callback, void* user_data);
+
+// Resumable walk over the same objects as heap_iterate_all_objects,
+// used by the incremental sweeper. Zero-initialise to start from the top.
+typedef struct HeapCursor {
+    int pool;
+    MemoryBlock* block;
+    size_t index;
+} HeapCursor;
+
+// Visits at most max_objects objects; returns true once the walk is complete.
+bool heap_iterate_step(Heap* heap, HeapCursor* cursor, size_t max_objects,
+                       HeapObjectCallback callback, void* user_data);
+
+// Restarts allocation accounting and the free-slot search after a collection.
+void heap_note_collection(Heap* heap);
+
+// Flags every block for sweeping by sweep(sweep_data, obj); each later
+// allocation sweeps one block, and a block is always swept before any of
+// its slots is handed out. Finish before the next collection marks.
+void heap_begin_lazy_sweep(Heap* heap, HeapObjectCallback sweep, void* sweep_data);
+void heap_finish_sweep(Heap* heap);
+
+// Releases empty blocks beyond the retention allowance. Only call right
+// after a collection, when the nursery log lists no dead objects.
+size_t heap_release_empty_blocks(Heap* heap);
+
 #endif
@@ -1,10 +1,11 @@
 #include "object.h"
+#include "../../system.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
 Object* object_new_int(int64_t v) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_INT;
     o->ref_count = 1;
     o->as.int_value = v;
@@ -12,7 +13,7 @@ Object* object_new_int(int64_t v) {
 }
 
 Object* object_new_bool(bool v) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_BOOL;
     o->ref_count = 1;
     o->as.bool_value = v;
@@ -20,7 +21,7 @@ Object* object_new_bool(bool v) {
 }
 
 Object* object_new_float(const char* v) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_FLOAT;
     o->ref_count = 1;
     o->as.float_value = bigfloat_create(v);
@@ -28,7 +29,7 @@ Object* object_new_float(const char* v) {
 }
 
 Object* object_new_float_from_bf(BigFloat* bf) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_FLOAT;
     o->ref_count = 1;
     o->as.float_value = bf;
@@ -36,14 +37,14 @@ Object* object_new_float_from_bf(BigFloat* bf) {
 }
 
 Object* object_new_none(void) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_NONE;
     o->ref_count = 1;
     return o;
 }
 
 Object* object_new_code(CodeObj* code) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_CODE;
     o->ref_count = 1;
     o->as.codeptr = code;
@@ -51,29 +52,29 @@ Object* object_new_code(CodeObj* code) {
 }
 
 Object* object_new_function(CodeObj* code) {
-    Object* o = malloc(sizeof(Object));
+    Object* o = calloc(1, sizeof(Object));
     o->type = OBJ_FUNCTION;
     o->ref_count = 1;
     o->as.function.codeptr = code;
-    o->as.function.call_count = 0;
-    o->as.function.jit_compiled = false;
     return o;
 }
 
 Object* object_new_array(void) {
-    Object* obj = malloc(sizeof(Object));
+    Object* obj = calloc(1, sizeof(Object));
     obj->type = OBJ_ARRAY;
     obj->ref_count = 1;
     obj->as.array.items = NULL;
     obj->as.array.size = 0;
+    obj->as.array.capacity = 0;
     return obj;
 }
 
 Object* object_new_array_with_size(size_t initial_size) {
-    Object* obj = malloc(sizeof(Object));
+    Object* obj = calloc(1, sizeof(Object));
     obj->type = OBJ_ARRAY;
     obj->ref_count = 1;
     obj->as.array.size = initial_size;
+    obj->as.array.capacity = initial_size;
     
     if (initial_size > 0) {
         obj->as.array.items = calloc(initial_size, sizeof(Object*));
@@ -87,24 +88,64 @@ Object* object_new_array_with_size(size_t initial_size) {
     return obj;
 }
 
+bool object_array_reserve(Object* array, size_t capacity) {
+    if (array->type != OBJ_ARRAY || array->as.array.base) return false;
+    if (capacity < array->as.array.size) capacity = array->as.array.size;
+    if (capacity == array->as.array.capacity) return true;
+
+    size_t elem_size = object_array_elem_size((ArrayKind)array->elem_kind);
+    void* storage = realloc(array->as.array.items, (capacity > 0 ? capacity : 1) * elem_size);
+    if (!storage) {
+        DPRINT("ERROR: Failed to resize array %p to %zu elements\n", (void*)array, capacity);
+        return false;
+    }
+    array->as.array.items = storage;
+    array->as.array.capacity = capacity;
+    return true;
+}
+
+bool object_array_grow(Object* array, size_t needed) {
+    size_t capacity = array->as.array.capacity;
+    if (needed <= capacity) return true;
+
+    capacity = capacity < OBJECT_ARRAY_MIN_CAPACITY ? OBJECT_ARRAY_MIN_CAPACITY : capacity;
+    while (capacity < needed) capacity *= 2;
+    return object_array_reserve(array, capacity);
+}
+
+void object_array_view_sync(Object* view) {
+    Object* base = view->as.array.base;
+    size_t offset = view->as.array.offset;
+    size_t available = base->as.array.size > offset ? base->as.array.size - offset : 0;
+    if (view->as.array.size > available) view->as.array.size = available;
+
+    view->elem_kind = base->elem_kind;
+    uint8_t* storage = (uint8_t*)base->as.array.items;
+    if (storage && available > 0) {
+        storage += offset * object_array_elem_size((ArrayKind)base->elem_kind);
+    }
+    view->as.array.items = (Object**)storage;
+}
+
 void object_array_append(Object* array, Object* element) {
-    if (array->type != OBJ_ARRAY) return;
-    
-    array->as.array.items = realloc(array->as.array.items, 
-                                   (array->as.array.size + 1) * sizeof(Object*));
+    if (array->type != OBJ_ARRAY || array->elem_kind != ARRAY_BOXED) return;
+    if (!object_array_grow(array, array->as.array.size + 1)) return;
+
     array->as.array.items[array->as.array.size] = element;
     array->as.array.size++;
 }
 
 Object* object_array_get(Object* array, size_t index) {
-    if (array->type != OBJ_ARRAY || index >= array->as.array.size) {
+    if (array->type != OBJ_ARRAY || array->elem_kind != ARRAY_BOXED ||
+        index >= array->as.array.size) {
         return NULL;
     }
     return array->as.array.items[index];
 }
 
 void object_array_set(Object* array, size_t index, Object* element) {
-    if (array->type != OBJ_ARRAY || index >= array->as.array.size) {
+    if (array->type != OBJ_ARRAY || array->elem_kind != ARRAY_BOXED ||
+        index >= array->as.array.size) {
         return;
     }
     
@@ -120,8 +161,17 @@ void object_array_set(Object* array, size_t index, Object* element) {
 
 void object_array_free(Object* array) {
     if (array->type != OBJ_ARRAY) return;
+
+    if (array->as.array.base) {
+        object_decref(array->as.array.base);
+        array->as.array.base = NULL;
+        array->as.array.items = NULL;
+        array->as.array.size = 0;
+        array->as.array.offset = 0;
+        return;
+    }
     
-    for (size_t i = 0; i < array->as.array.size; i++) {
+    for (size_t i = 0; object_array_has_refs(array) && i < array->as.array.size; i++) {
         if (array->as.array.items[i]) {
             object_decref(array->as.array.items[i]);
         }
@@ -129,6 +179,36 @@ void object_array_free(Object* array) {
     free(array->as.array.items);
     array->as.array.items = NULL;
     array->as.array.size = 0;
+    array->as.array.capacity = 0;
+}
+
+size_t object_array_elem_size(ArrayKind kind) {
+    switch (kind) {
+        case ARRAY_INT:  return sizeof(int64_t);
+        case ARRAY_BOOL: return sizeof(uint8_t);
+        default:         return sizeof(Object*);
+    }
+}
+
+size_t object_footprint(const Object* obj) {
+    if (!obj) return 0;
+
+    size_t bytes = object_slot_size((ObjectType)obj->type);
+    switch (obj->type) {
+        case OBJ_ARRAY:
+            if (!obj->as.array.base) {
+                bytes += obj->as.array.capacity * object_array_elem_size((ArrayKind)obj->elem_kind);
+            }
+            break;
+        case OBJ_FLOAT:
+            if (obj->as.float_value) {
+                bytes += sizeof(BigFloat) + (size_t)obj->as.float_value->len + 1;
+            }
+            break;
+        default:
+            break;
+    }
+    return bytes;
 }
 
 void object_incref(Object* obj) {
@@ -148,25 +228,33 @@ void object_decref(Object* obj) {
         if (obj->ref_count == 0) {
             switch (obj->type) {
                 case OBJ_ARRAY:
-                    if (obj->as.array.items) {
-                        for (size_t i = 0; i < obj->as.array.size; i++) {
+                    if (obj->as.array.base) {
+                        object_array_free(obj);
+                    } else if (obj->as.array.items) {
+                        for (size_t i = 0; object_array_has_refs(obj) && i < obj->as.array.size; i++) {
                             if (obj->as.array.items[i]) {
                                 object_decref(obj->as.array.items[i]);
                             }
                         }
                         free(obj->as.array.items);
+                        // the slot is reused in place; recycling must not see these again
+                        obj->as.array.items = NULL;
+                        obj->as.array.size = 0;
+                        obj->as.array.capacity = 0;
                     }
                     break;
                 
                 case OBJ_NATIVE_FUNCTION:
                     if (obj->as.native_function.name) {
                         free((void*)obj->as.native_function.name);
+                        obj->as.native_function.name = NULL;
                     }
                     break;
                 
                 case OBJ_FLOAT:
                     if (obj->as.float_value) {
                         bigfloat_destroy(obj->as.float_value);
+                        obj->as.float_value = NULL;
                     }
                     break;
                 
@@ -216,9 +304,18 @@ char* object_to_string(Object* o) {
         case OBJ_NONE:
             return strdup("None");
         case OBJ_ARRAY: {
+            object_array_sync(o);
             char* s = strdup("[");
             for (size_t i = 0; i < o->as.array.size; i++) {
-                char* item_s = object_to_string(o->as.array.items[i]);
+                char* item_s;
+                if (o->elem_kind == ARRAY_INT) {
+                    snprintf(buf, sizeof(buf), "%lld", (long long)o->as.array.ints[i]);
+                    item_s = strdup(buf);
+                } else if (o->elem_kind == ARRAY_BOOL) {
+                    item_s = strdup(o->as.array.bools[i] ? "true" : "false");
+                } else {
+                    item_s = object_to_string(o->as.array.items[i]);
+                }
                 size_t new_len = strlen(s) + strlen(item_s) + 3;
                 s = realloc(s, new_len);
                 strcat(s, item_s);
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include "../../compiler/value.h"
 #include "float_bigint.h"
 
@@ -23,8 +24,21 @@ typedef enum {
     OBJ_FLOAT,
 } ObjectType;
 
+// header bits owned by the collector
+#define OBJ_GC_MARKED     0x01
+#define OBJ_GC_YOUNG      0x02  // allocated since promotion, listed in the heap nursery
+#define OBJ_GC_REMEMBERED 0x04  // old object in the remembered set
+#define OBJ_GC_ZCT        0x08  // old object with no counted references, in the zero-count table
+
+// 8-byte header followed by one payload. Ints, bools, floats, code and
+// function objects need a single word and live in 16-byte slots; only
+// arrays and native functions use the full sizeof(Object). Never copy an
+// Object by value: a small slot is shorter than the struct.
 struct Object {
-    ObjectType type;
+    uint8_t type;       // ObjectType, narrowed so the header has room for gc_flags
+    uint8_t gc_flags;
+    uint8_t gc_age;     // minor collections survived while young
+    uint8_t elem_kind;  // ArrayKind of an array, ARRAY_BOXED for everything else
     uint32_t ref_count;
     union {
         int64_t int_value;
@@ -35,15 +49,31 @@ struct Object {
 
         CodeObj* codeptr;
         
+        // JIT hotness lives on the CodeObj, shared by every function made from it
         struct {
             CodeObj* codeptr;
-            size_t call_count;
-            bool jit_compiled;
         } function;
 
+        // Typed arrays (int[n], bool[n]) store raw values and hold no
+        // references; storing anything else turns them into boxed arrays.
+        // Storage holds capacity elements, of which the first size are live.
+        // A view (slice) owns no storage: it aliases size elements of its
+        // base starting at offset, and holds a counted reference to base.
+        // A 2-D array (T[n][m]) is the same flat storage in row-major order
+        // with cols set; its row count is size / cols.
         struct {
-            Object** items;
+            union {
+                Object** items;     // ARRAY_BOXED
+                int64_t* ints;      // ARRAY_INT
+                uint8_t* bools;     // ARRAY_BOOL
+            };
             size_t size;
+            union {
+                size_t capacity;    // arrays that own their storage
+                size_t offset;      // views
+            };
+            Object* base;           // viewed array, NULL unless this is a view
+            size_t cols;            // row length of a 2-D array, 0 otherwise
         } array;
 
         struct {
@@ -53,6 +83,60 @@ struct Object {
     } as;
 };
 
+#define OBJECT_HEADER_SIZE offsetof(Object, as)
+#define OBJECT_SMALL_SIZE (OBJECT_HEADER_SIZE + sizeof(void*))
+
+_Static_assert(OBJECT_HEADER_SIZE == 8, "object header must stay one word");
+_Static_assert(sizeof(Object) == OBJECT_HEADER_SIZE + 5 * sizeof(void*),
+               "widest payload is five words");
+
+// Arrays whose items are objects the collector and refcounting follow.
+// A view's items belong to its base, so only the base reference counts.
+static inline bool object_array_has_refs(const Object* o) {
+    return o->type == OBJ_ARRAY && o->elem_kind == ARRAY_BOXED && o->as.array.items &&
+           !o->as.array.base;
+}
+
+// The base of a view, NULL for any other object.
+static inline Object* object_array_base(const Object* o) {
+    return o->type == OBJ_ARRAY ? o->as.array.base : NULL;
+}
+
+// The array whose storage o uses: the base of a view, otherwise o itself.
+// Write barriers and boxing apply to the owner.
+static inline Object* object_array_owner(Object* o) {
+    Object* base = object_array_base(o);
+    return base ? base : o;
+}
+
+// A view caches a pointer into its base's storage, which moves when the
+// base grows or is boxed. Sync before touching a view's items: it repoints
+// them and clamps size to what the base still holds.
+void object_array_view_sync(Object* view);
+static inline void object_array_sync(Object* o) {
+    if (o && object_array_base(o)) object_array_view_sync(o);
+}
+
+// Rows of a 2-D array, 0 for anything else.
+static inline size_t object_array_rows(const Object* o) {
+    return o->type == OBJ_ARRAY && o->as.array.cols ? o->as.array.size / o->as.array.cols : 0;
+}
+
+size_t object_array_elem_size(ArrayKind kind);
+
+#define OBJECT_ARRAY_MIN_CAPACITY 4
+
+// Bytes a heap slot of this type occupies.
+static inline size_t object_slot_size(ObjectType type) {
+    switch (type) {
+        case OBJ_ARRAY:
+        case OBJ_NATIVE_FUNCTION:
+            return sizeof(Object);
+        default:
+            return OBJECT_SMALL_SIZE;
+    }
+}
+
 Object* object_new_int(int64_t v);
 Object* object_new_float(const char* v);
 Object* object_new_float_from_bf(BigFloat* bf);
@@ -63,11 +147,20 @@ Object* object_new_function(CodeObj* code);
 
 Object* object_new_array(void);
 Object* object_new_array_with_size(size_t initial_size);
+// Resizes storage to exactly capacity elements (never below size); false
+// if the allocation fails or the array is a view, leaving it unchanged.
+bool object_array_reserve(Object* array, size_t capacity);
+// Makes room for needed elements, doubling capacity from
+// OBJECT_ARRAY_MIN_CAPACITY so a run of appends is amortized O(1).
+bool object_array_grow(Object* array, size_t needed);
 void object_array_append(Object* array, Object* element);
 Object* object_array_get(Object* array, size_t index);
 void object_array_set(Object* array, size_t index, Object* element);
 void object_array_free(Object* array);
 
+// Bytes owned by o: its slot plus out-of-line array items and BigFloat digits.
+size_t object_footprint(const Object* o);
+
 void object_incref(Object* o);
 void object_decref(Object* o);
 
@@ -1,4 +1,6 @@
 #include "../../builtins/builtins.h"
+#include "../../builtins/array_kernels.h"
+#include "../../builtins/sort.h"
 #include "../../runtime/gc/gc.h"
 #include "../../runtime/jit/jit.h"
 #include "../../system.h"
@@ -7,21 +9,18 @@
 #include "heap.h"
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #define JIT_HOT_CALL_THRESHOLD 10
 
+// instructions between slices of an incremental major cycle
+#define GC_SLICE_INTERVAL 1000
 
-#define FAST_PUSH_GC(frame, obj) \
-    do { \
-        if ((frame)->stack_size >= (frame)->stack_capacity) { \
-            frame_stack_ensure_capacity_fast((frame), 1); \
-        } \
-        if ((obj)) { \
-            GC_INCREF_IF_ENABLED((frame), (obj)); \
-        } \
-        (frame)->stack[(frame)->stack_size++] = (obj); \
-    } while(0)
 
+// Stack and local slots hold uncounted references (see gc_decref_deferred):
+// the collector scans them as roots, so pushes, pops, LOAD_FAST/STORE_FAST
+// and call arguments never touch ref_count. Only stores into arrays and
+// globals count.
 #define FAST_PUSH_NO_GC(frame, obj) \
     do { \
         if ((frame)->stack_size >= (frame)->stack_capacity) { \
@@ -33,15 +32,6 @@
 #define FAST_POP_NO_GC(frame) \
     ((frame)->stack[--(frame)->stack_size])
 
-#define FAST_POP_GC(frame) \
-    ({ \
-        Object* _obj = (frame)->stack[--(frame)->stack_size]; \
-        if (_obj) { \
-            GC_DECREF_IF_ENABLED((frame), _obj); \
-        } \
-        _obj; \
-    })
-
 #define FAST_PEEK(frame, offset) \
     ((frame)->stack[(frame)->stack_size - 1 - (offset)])
 
@@ -55,14 +45,11 @@
 #define GC_DECREF_IF_ENABLED_VM(vm_ptr, obj_ptr) \
     do { \
         if (gc_enabled && (vm_ptr) && (vm_ptr)->gc && (obj_ptr)) { \
-            gc_decref((vm_ptr)->gc, (obj_ptr)); \
+            gc_decref_deferred((vm_ptr)->gc, (obj_ptr)); \
         } \
     } while (0)
 
 
-void gc_incref(GC* gc, Object* obj);
-void gc_decref(GC* gc, Object* obj);
-
 struct VM {
     Heap* heap;
     GC* gc;
@@ -78,6 +65,16 @@ struct VM {
     Frame** active_frames;
     size_t active_frames_count;
     size_t active_frames_capacity;
+
+    // bytes the heap may allocate before the next collection
+    size_t gc_trigger_bytes;
+
+    // 0 runs major collections stop-the-world; otherwise the slice budget
+    uint64_t gc_pause_ns;
+    HeapCursor sweep_cursor;
+
+    // start of the run, for the allocation rate in the telemetry dump
+    uint64_t created_ns;
 };
 
 struct Frame {
@@ -123,10 +120,24 @@ static void op_POP_JUMP_IF_NONE(Frame* frame, uint32_t arg);
 static void op_POP_JUMP_IF_NOT_NONE(Frame* frame, uint32_t arg);
 static void op_JUMP_BACKWARD_NO_INTERRUPT(Frame* frame, uint32_t arg);
 static void op_BUILD_ARRAY(Frame* frame, uint32_t arg);
+static void op_BUILD_TYPED_ARRAY(Frame* frame, uint32_t arg);
 static void op_STORE_SUBSCR(Frame* frame, uint32_t arg);
 static void op_DEL_SUBSCR(Frame* frame, uint32_t arg);
 static void op_LOAD_SUBSCR(Frame* frame, uint32_t arg);
+static void op_BUILD_ARRAY2(Frame* frame, uint32_t arg);
+static void op_STORE_SUBSCR2(Frame* frame, uint32_t arg);
+static void op_LOAD_SUBSCR2(Frame* frame, uint32_t arg);
+static void op_LOAD_SUBSCR_UNCHECKED(Frame* frame, uint32_t arg);
+static void op_STORE_SUBSCR_UNCHECKED(Frame* frame, uint32_t arg);
+static void op_GUARD_INDEX(Frame* frame, uint32_t arg);
+static void op_GUARD_LENGTH(Frame* frame, uint32_t arg);
+static void op_REUSE_TYPED_ARRAY(Frame* frame, uint32_t arg);
+static void op_BUILD_STRUCT(Frame* frame, uint32_t arg);
+static void op_BUILD_STRUCT_ARRAY(Frame* frame, uint32_t arg);
+static void op_LOAD_FIELD(Frame* frame, uint32_t arg);
+static void op_STORE_FIELD(Frame* frame, uint32_t arg);
 static void op_SWAP_ARRAY_ELEMENTS(Frame* frame, uint32_t arg);
+static void op_SORT_ARRAY(Frame* frame, uint32_t arg);
 
 static OpHandler op_table[256] = {NULL};
 
@@ -158,19 +169,30 @@ static void init_op_table(void) {
     op_table[POP_JUMP_IF_NOT_NONE] = op_POP_JUMP_IF_NOT_NONE;
     op_table[JUMP_BACKWARD_NO_INTERRUPT] = op_JUMP_BACKWARD_NO_INTERRUPT;
     op_table[BUILD_ARRAY] = op_BUILD_ARRAY;
+    op_table[BUILD_TYPED_ARRAY] = op_BUILD_TYPED_ARRAY;
     op_table[STORE_SUBSCR] = op_STORE_SUBSCR;
     op_table[DEL_SUBSCR] = op_DEL_SUBSCR;
     op_table[LOAD_SUBSCR] = op_LOAD_SUBSCR;
+    op_table[BUILD_ARRAY2] = op_BUILD_ARRAY2;
+    op_table[STORE_SUBSCR2] = op_STORE_SUBSCR2;
+    op_table[LOAD_SUBSCR2] = op_LOAD_SUBSCR2;
+    op_table[LOAD_SUBSCR_UNCHECKED] = op_LOAD_SUBSCR_UNCHECKED;
+    op_table[STORE_SUBSCR_UNCHECKED] = op_STORE_SUBSCR_UNCHECKED;
+    op_table[GUARD_INDEX] = op_GUARD_INDEX;
+    op_table[GUARD_LENGTH] = op_GUARD_LENGTH;
+    op_table[REUSE_TYPED_ARRAY] = op_REUSE_TYPED_ARRAY;
+    op_table[BUILD_STRUCT] = op_BUILD_STRUCT;
+    op_table[BUILD_STRUCT_ARRAY] = op_BUILD_STRUCT_ARRAY;
+    op_table[LOAD_FIELD] = op_LOAD_FIELD;
+    op_table[STORE_FIELD] = op_STORE_FIELD;
     op_table[COMPARE_AND_SWAP] = op_COMPARE_AND_SWAP;
     op_table[SWAP_ARRAY_ELEMENTS] = op_SWAP_ARRAY_ELEMENTS;
+    op_table[SORT_ARRAY] = op_SORT_ARRAY;
 }
 
 static inline void frame_stack_ensure_capacity_fast(Frame* frame, size_t additional);
 static void frame_stack_push(Frame* frame, Object* o) {
     frame_stack_ensure_capacity_fast(frame, 1);
-    if (o) {
-        GC_INCREF_IF_ENABLED(frame, o);
-    }
     frame->stack[frame->stack_size++] = o;
 }
 
@@ -186,34 +208,22 @@ static Object* _vm_execute_with_args(VM* vm, CodeObj* code, Object** args, size_
 void vm_register_builtins(VM* vm) {
     if (!vm || !vm->heap) return;
     
-    Object* print_func = heap_alloc_native_function(vm->heap, 
-        (NativeCFunc)builtin_print, "print");
-    Object* input_func = heap_alloc_native_function(vm->heap, 
-        (NativeCFunc)builtin_input, "input");
-    Object* randint_func = heap_alloc_native_function(vm->heap,
-        (NativeCFunc)builtin_randint, "randint");
-    Object* sqrt_func = heap_alloc_native_function(vm->heap,
-        (NativeCFunc)builtin_sqrt, "sqrt");
-    
-    print_func->ref_count = 0x7FFFFFFF;
-    input_func->ref_count = 0x7FFFFFFF;
-    randint_func->ref_count = 0x7FFFFFFF;
-    sqrt_func->ref_count = 0x7FFFFFFF;
-    
-    size_t print_idx = 0;
-    size_t input_idx = 1;
-    size_t randint_idx = 2;
-    size_t sqrt_idx = 3;
-    
-    vm_set_global(vm, print_idx, print_func);
-    vm_set_global(vm, input_idx, input_func);
-    vm_set_global(vm, randint_idx, randint_func);
-    vm_set_global(vm, sqrt_idx, sqrt_func);
-    
-    DPRINT("[VM] Builtins registered: print at %p, input at %p, randint at %p, sqrt at %p\n", 
-        (void*)print_func, (void*)input_func, (void*)randint_func, (void*)sqrt_func);
-    DPRINT("[VM] Builtins ref counts: print=%u, input=%u, randint=%u, sqrt=%u\n",
-        print_func->ref_count, input_func->ref_count, randint_func->ref_count, sqrt_func->ref_count);
+    static const struct {
+        const char* name;
+        NativeCFunc func;
+    } builtins[BUILTIN_COUNT] = {
+#define BUILTIN_ENTRY(name) { #name, (NativeCFunc)builtin_##name },
+        BUILTIN_LIST(BUILTIN_ENTRY)
+#undef BUILTIN_ENTRY
+    };
+
+    for (size_t i = 0; i < BUILTIN_COUNT; i++) {
+        Object* func = heap_alloc_native_function(vm->heap, builtins[i].func, builtins[i].name);
+        func->ref_count = 0x7FFFFFFF;
+        vm_set_global(vm, i, func);
+        DPRINT("[VM] Builtin %s registered at global %zu: %p\n",
+               builtins[i].name, i, (void*)func);
+    }
 }
 
 Heap* vm_get_heap(VM* vm) {
@@ -260,10 +270,10 @@ void vm_set_global(VM* vm, size_t idx, Object* value) {
         GC_INCREF_IF_ENABLED_VM(vm, value);
     }
     Object* old_value = vm->globals[idx];
+    vm->globals[idx] = value;
     if (old_value) {
-        GC_INCREF_IF_ENABLED_VM(vm, old_value);
+        GC_DECREF_IF_ENABLED_VM(vm, old_value);
     }
-    vm->globals[idx] = value;
 }
 
 Object* vm_get_global(VM* vm, size_t idx) {
@@ -272,8 +282,30 @@ Object* vm_get_global(VM* vm, size_t idx) {
 }
 
 GC* vm_get_gc(VM* vm) { return vm ? vm->gc : NULL; }
+
+void vm_set_gc_pause_us(VM* vm, uint64_t pause_us) {
+    if (vm) vm->gc_pause_ns = pause_us * 1000;
+}
+
+void vm_set_gc_threads(VM* vm, size_t threads) {
+    if (vm) gc_set_threads(vm->gc, threads);
+}
+
+void vm_set_gc_growth(VM* vm, double factor) {
+    if (vm) gc_set_growth_factor(vm->gc, factor);
+}
+
+void vm_set_gc_min_heap(VM* vm, size_t bytes) {
+    if (vm) gc_set_min_heap(vm->gc, bytes);
+}
 JIT* vm_get_jit(VM* vm) { return vm ? vm->jit : NULL; }
 
+static uint64_t vm_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
 VM* vm_create(Heap* heap, size_t global_count) {
     static bool table_inited = false;
     if (!table_inited) {
@@ -307,6 +339,12 @@ VM* vm_create(Heap* heap, size_t global_count) {
     vm->active_frames = NULL;
     vm->active_frames_count = 0;
     vm->active_frames_capacity = 0;
+
+    vm->gc_trigger_bytes = gc_get_young_budget(vm->gc);
+    vm->gc_pause_ns = 0;
+    memset(&vm->sweep_cursor, 0, sizeof(vm->sweep_cursor));
+    vm->created_ns = vm_now_ns();
+    heap->track_young = gc_enabled;
     
     vm_register_builtins(vm);
     return vm;
@@ -341,7 +379,6 @@ Frame* frame_create(VM* vm, CodeObj* code) {
     f->locals = calloc(f->local_count, sizeof(Object*));
     for (size_t i = 0; i < f->local_count; i++) {
         f->locals[i] = vm_get_none(vm);
-        if (f->locals[i]) GC_INCREF_IF_ENABLED(f, f->locals[i]);
     }
     f->stack = NULL;
     f->stack_capacity = 0;
@@ -360,18 +397,8 @@ void frame_destroy(Frame* frame) {
         vm_unregister_frame(frame->vm, frame);
     }
     
-    if (frame->stack) {
-        for (size_t i = 0; i < frame->stack_size; i++) {
-            if (frame->stack[i]) GC_DECREF_IF_ENABLED(frame, frame->stack[i]);
-        }
-        free(frame->stack);
-    }
-    if (frame->locals) {
-        for (size_t i = 0; i < frame->local_count; i++) {
-            if (frame->locals[i]) GC_DECREF_IF_ENABLED(frame, frame->locals[i]);
-        }
-        free(frame->locals);
-    }
+    free(frame->stack);
+    free(frame->locals);
     free(frame);
 }
 
@@ -391,7 +418,6 @@ Object* frame_execute(Frame* frame) {
     bytecode_array* code_arr = &code->code;
     
     size_t instruction_count = 0;
-    const size_t GC_INTERVAL = 100000;
 
     while (frame->ip < code_arr->count) {
         bytecode bc = code_arr->bytecodes[frame->ip++];
@@ -401,17 +427,20 @@ Object* frame_execute(Frame* frame) {
         if (handler) {
             handler(frame, arg);
 
-            instruction_count++;
-            if (instruction_count >= GC_INTERVAL && gc_enabled) {
-                vm_collect_garbage(frame->vm);
-                instruction_count = 0;
+            if (gc_enabled) {
+                VM* vm = frame->vm;
+                if (vm->heap->bytes_since_gc >= vm->gc_trigger_bytes) {
+                    vm_collect_young(vm);
+                } else if (++instruction_count >= GC_SLICE_INTERVAL) {
+                    instruction_count = 0;
+                    if (gc_incremental_active(vm->gc)) {
+                        vm_gc_step(vm);
+                    }
+                }
             }
             
             if (bc.op_code == RETURN_VALUE) {
                 Object* val = frame_stack_pop(frame);
-                if (val) {
-                    GC_INCREF_IF_ENABLED(frame, val);
-                }
                 return val ? val : vm_get_none(frame->vm);
             }
         } else {
@@ -419,9 +448,7 @@ Object* frame_execute(Frame* frame) {
         }
     }
     
-    Object* nonev = vm_get_none(frame->vm);
-    GC_INCREF_IF_ENABLED(frame, nonev);
-    return nonev;
+    return vm_get_none(frame->vm);
 }
 
 static inline void frame_stack_ensure_capacity_fast(Frame* frame, size_t additional) {
@@ -444,6 +471,136 @@ static inline void frame_stack_ensure_capacity_fast(Frame* frame, size_t additio
 
 
 
+// Elementwise BINARY_OP works through int operands this many elements at a time.
+#define ARRAY_OP_CHUNK 256
+
+// Arithmetic and comparison ops apply elementwise when one operand is an
+// array and the other is an array or a number; anything else (is, and/or,
+// an array against None) keeps its scalar meaning.
+static bool array_op_applies(uint8_t op, const Object* left, const Object* right) {
+    if (left->type != OBJ_ARRAY && right->type != OBJ_ARRAY) return false;
+    const Object* operands[2] = {left, right};
+    for (int k = 0; k < 2; k++) {
+        uint8_t type = operands[k]->type;
+        if (type != OBJ_ARRAY && type != OBJ_INT && type != OBJ_BOOL && type != OBJ_FLOAT) return false;
+    }
+    switch (op) {
+        case 0x00: case 0x0A: case 0x05: case 0x0B: case 0x06:
+        case 0x50: case 0x51: case 0x52: case 0x53: case 0x54: case 0x55:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// An int scalar, an int[n] array, or a boxed array holding only ints.
+static bool array_op_int_operand(const Object* o) {
+    if (o->type == OBJ_INT) return true;
+    if (o->type != OBJ_ARRAY) return false;
+    if (o->elem_kind == ARRAY_INT) return true;
+    if (o->elem_kind != ARRAY_BOXED) return false;
+    for (size_t i = 0; i < o->as.array.size; i++) {
+        Object* item = o->as.array.items[i];
+        if (!item || item->type != OBJ_INT) return false;
+    }
+    return true;
+}
+
+// One side of an int elementwise op, read a chunk at a time: an int[n]
+// array in place, a boxed array gathered into buf, or a scalar broadcast
+// through buf.
+typedef struct {
+    const Object* obj;
+    int64_t buf[ARRAY_OP_CHUNK];
+} IntOperand;
+
+static void int_operand_init(IntOperand* operand, const Object* o) {
+    operand->obj = o;
+    if (o->type == OBJ_INT) {
+        for (size_t k = 0; k < ARRAY_OP_CHUNK; k++) operand->buf[k] = o->as.int_value;
+    }
+}
+
+static const int64_t* int_operand_chunk(IntOperand* operand, size_t i, size_t n) {
+    const Object* o = operand->obj;
+    if (o->type == OBJ_INT) return operand->buf;
+    if (o->elem_kind == ARRAY_INT) return o->as.array.ints + i;
+    for (size_t k = 0; k < n; k++) operand->buf[k] = o->as.array.items[i + k]->as.int_value;
+    return operand->buf;
+}
+
+// Ints go through the array kernels into an int[n], or a bool[n] for the
+// comparisons; a <= b, a > b and a >= b are a < b with swapped or negated
+// lanes.
+static Object* array_binary_op_ints(Heap* heap, uint8_t op, const Object* left, const Object* right, size_t n) {
+    bool compare = op >= 0x50;
+    Object* result = heap_alloc_typed_array(heap, compare ? ARRAY_BOOL : ARRAY_INT, n);
+    if (!result || result->as.array.size != n) return NULL;
+
+    const ArrayKernels* kernels = array_kernels();
+    IntOperand a, b;
+    int_operand_init(&a, left);
+    int_operand_init(&b, right);
+    for (size_t i = 0; i < n; i += ARRAY_OP_CHUNK) {
+        size_t m = n - i < ARRAY_OP_CHUNK ? n - i : ARRAY_OP_CHUNK;
+        const int64_t* x = int_operand_chunk(&a, i, m);
+        const int64_t* y = int_operand_chunk(&b, i, m);
+        int64_t* dst = result->as.array.ints + i;
+        uint8_t* flags = result->as.array.bools + i;
+        switch (op) {
+            case 0x00: kernels->add(dst, x, y, m); break;
+            case 0x0A: kernels->sub(dst, x, y, m); break;
+            case 0x05: kernels->mul(dst, x, y, m); break;
+            case 0x0B: kernels->div(dst, x, y, m); break;
+            case 0x06: kernels->mod(dst, x, y, m); break;
+            case 0x50: kernels->eq(flags, x, y, m, 0); break;
+            case 0x51: kernels->eq(flags, x, y, m, 1); break;
+            case 0x52: kernels->lt(flags, x, y, m, 0); break;
+            case 0x53: kernels->lt(flags, y, x, m, 1); break;
+            case 0x54: kernels->lt(flags, y, x, m, 0); break;
+            case 0x55: kernels->lt(flags, x, y, m, 1); break;
+        }
+    }
+    return result;
+}
+
+// BINARY_OP with an array operand: the other side is an array of the same
+// shape or a number broadcast to every element, and the result is a new
+// array of that shape. Anything that is not all ints applies the scalar
+// op per element into a boxed array, so floats, bools and nested arrays
+// behave exactly as they would one at a time. NULL on a shape mismatch.
+static Object* vm_array_binary_op(Frame* frame, uint8_t op, Object* left, Object* right) {
+    VM* vm = frame->vm;
+    object_array_sync(left);
+    object_array_sync(right);
+
+    Object* shape = left->type == OBJ_ARRAY ? left : right;
+    size_t n = shape->as.array.size;
+    size_t cols = shape->as.array.cols;
+    if (left->type == OBJ_ARRAY && right->type == OBJ_ARRAY &&
+        (right->as.array.size != n || right->as.array.cols != cols)) {
+        DPRINT("[VM] ERROR: BINARY_OP on arrays of %zu and %zu elements\n", n, right->as.array.size);
+        return NULL;
+    }
+
+    Object* result = NULL;
+    if (array_op_int_operand(left) && array_op_int_operand(right)) {
+        result = array_binary_op_ints(vm->heap, op, left, right, n);
+    } else {
+        result = heap_alloc_array_with_size(vm->heap, n);
+        if (!result || result->as.array.size != n) return NULL;
+        for (size_t i = 0; i < n; i++) {
+            FAST_PUSH_NO_GC(frame, left->type == OBJ_ARRAY ? heap_array_load(vm->heap, left, i) : left);
+            FAST_PUSH_NO_GC(frame, right->type == OBJ_ARRAY ? heap_array_load(vm->heap, right, i) : right);
+            op_BINARY_OP(frame, op);
+            vm_array_store(vm, result, i, FAST_POP_NO_GC(frame));
+        }
+    }
+    if (result) result->as.array.cols = cols;
+    DPRINT("[VM] Elementwise BINARY_OP %u over %zu elements\n", op, n);
+    return result;
+}
+
 static void op_BINARY_OP(Frame* frame, uint32_t arg) {
     uint8_t op = arg & 0xFF;
     
@@ -584,6 +741,10 @@ static void op_BINARY_OP(Frame* frame, uint32_t arg) {
         }
     }
     
+    else if (array_op_applies(op, left, right)) {
+        ret = vm_array_binary_op(frame, op, left, right);
+    }
+    
     else if (left->type == OBJ_FLOAT || right->type == OBJ_FLOAT) {
         bool left_is_temp = false;
         bool right_is_temp = false;
@@ -734,22 +895,11 @@ static void op_BINARY_OP(Frame* frame, uint32_t arg) {
         ret = vm_get_none(frame->vm);
     }
     
-    if (left && left->ref_count != 0x7FFFFFFF) {
-        GC_DECREF_IF_ENABLED(frame, left);
-    }
-    if (right && right->ref_count != 0x7FFFFFFF) {
-        GC_DECREF_IF_ENABLED(frame, right);
-    }
-    
     if (!ret) {
         ret = vm_get_none(frame->vm);
     }
     
-    if (ret->ref_count == 0x7FFFFFFF) {
-        FAST_PUSH_NO_GC(frame, ret);
-    } else {
-        FAST_PUSH_GC(frame, ret);
-    }
+    FAST_PUSH_NO_GC(frame, ret);
 }
 
 static void op_SWAP_ARRAY_ELEMENTS(Frame* frame, uint32_t arg) {
@@ -779,6 +929,7 @@ static void op_SWAP_ARRAY_ELEMENTS(Frame* frame, uint32_t arg) {
         FAST_PUSH_NO_GC(frame, index2_obj);
         return;
     }
+    object_array_sync(array_obj);
     
     if (!index2_obj || index2_obj->type != OBJ_INT) {
         FAST_PUSH_NO_GC(frame, array_obj);
@@ -799,39 +950,29 @@ static void op_SWAP_ARRAY_ELEMENTS(Frame* frame, uint32_t arg) {
     }
 
     if (idx1 == idx2) {
-        GC_DECREF_IF_ENABLED(frame, index1_obj);
-        GC_DECREF_IF_ENABLED(frame, index2_obj);
         FAST_PUSH_NO_GC(frame, array_obj);
         return;
     }
 
-    Object* elem1 = array_obj->as.array.items[idx1];
-    Object* elem2 = array_obj->as.array.items[idx2];
-
-    Object* old_elem1 = array_obj->as.array.items[idx1];
-    Object* old_elem2 = array_obj->as.array.items[idx2];
-
-    array_obj->as.array.items[idx1] = old_elem2;
-    if (old_elem2) {
-        GC_INCREF_IF_ENABLED(frame, old_elem2);
-    }
-    if (old_elem1) {
-        GC_DECREF_IF_ENABLED(frame, old_elem1);
-    }
+    if (array_obj->elem_kind == ARRAY_INT) {
+        int64_t tmp = array_obj->as.array.ints[idx1];
+        array_obj->as.array.ints[idx1] = array_obj->as.array.ints[idx2];
+        array_obj->as.array.ints[idx2] = tmp;
+    } else if (array_obj->elem_kind == ARRAY_BOOL) {
+        uint8_t tmp = array_obj->as.array.bools[idx1];
+        array_obj->as.array.bools[idx1] = array_obj->as.array.bools[idx2];
+        array_obj->as.array.bools[idx2] = tmp;
+    } else {
+        Object* old_elem1 = array_obj->as.array.items[idx1];
+        Object* old_elem2 = array_obj->as.array.items[idx2];
 
-    array_obj->as.array.items[idx2] = old_elem1;
-    if (old_elem1) {
-        GC_INCREF_IF_ENABLED(frame, old_elem1);
-    }
-    if (old_elem2) {
-        GC_DECREF_IF_ENABLED(frame, old_elem2);
+        // both elements stay in the same array, so their counts are unchanged
+        array_obj->as.array.items[idx1] = old_elem2;
+        array_obj->as.array.items[idx2] = old_elem1;
     }
     
     DPRINT("[VM] SWAP_ARRAY_ELEMENTS: swap completed\n");
 
-    GC_DECREF_IF_ENABLED(frame, index1_obj);
-    GC_DECREF_IF_ENABLED(frame, index2_obj);
-
     FAST_PUSH_NO_GC(frame, array_obj);
 }
 
@@ -862,68 +1003,298 @@ static void op_LOAD_CONST(Frame* frame, uint32_t arg) {
         } else {
             DPRINT("[VM] LOAD_CONST %lld: CACHE MISS\n", (long long)val);            
             o = heap_alloc_int(frame->vm->heap, val);
-            FAST_PUSH_GC(frame, o);
+            FAST_PUSH_NO_GC(frame, o);
         }
     } else if (c.type == VAL_FLOAT) {
         o = heap_alloc_float(frame->vm->heap, strdup(c.float_val));
-        FAST_PUSH_GC(frame, o);
+        FAST_PUSH_NO_GC(frame, o);
     } else {
         o = heap_from_value(frame->vm->heap, c);
-        FAST_PUSH_GC(frame, o);
+        FAST_PUSH_NO_GC(frame, o);
+    }
+}
+
+// Index checks once the caller has checked and synced the array: an int
+// index with 0 <= index < limit, where limit is the size (or the row count
+// of a 2-D array). One unsigned compare covers both ends.
+static bool subscript_in_bounds(Object* index_obj, size_t limit, const char* op) {
+    if (index_obj->type != OBJ_INT) {
+        DPRINT("[VM] ERROR: %s index must be integer, got type=%d\n", op, index_obj->type);
+        return false;
+    }
+    if ((uint64_t)index_obj->as.int_value >= limit) {
+        DPRINT("[VM] ERROR: %s index %lld out of bounds (size=%zu)\n",
+               op, (long long)index_obj->as.int_value, limit);
+        return false;
     }
+    return true;
 }
 
+static inline void array_load(Frame* frame, Object* array_obj, size_t index) {
+    if (array_obj->as.array.cols) {
+        // a single index into a 2-D array gives a view of that row
+        size_t cols = array_obj->as.array.cols;
+        Object* row = vm_array_slice(frame->vm, array_obj, index * cols, (index + 1) * cols);
+        FAST_PUSH_NO_GC(frame, row ? row : vm_get_none(frame->vm));
+        return;
+    }
+    if (array_obj->elem_kind != ARRAY_BOXED) {
+        FAST_PUSH_NO_GC(frame, heap_array_load(frame->vm->heap, array_obj, index));
+        return;
+    }
+    Object* element = array_obj->as.array.items[index];
+    FAST_PUSH_NO_GC(frame, element ? element : vm_get_none(frame->vm));
+}
+
+// An out-of-range or non-integer index loads None.
 static void op_LOAD_SUBSCR(Frame* frame, uint32_t arg) {
     Object* index_obj = FAST_POP_NO_GC(frame);
     Object* array_obj = FAST_POP_NO_GC(frame);
     
-    if (!array_obj || !index_obj) {
-        GC_DECREF_IF_ENABLED(frame, index_obj);
-        GC_DECREF_IF_ENABLED(frame, array_obj);
+    if (!array_obj || !index_obj || array_obj->type != OBJ_ARRAY) {
         FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
         return;
     }
+    object_array_sync(array_obj);
     
-    int64_t index = index_obj->as.int_value;
-    Object* element = array_obj->as.array.items[index];
-    
-    if (element && element->ref_count == 0x7FFFFFFF) {
-        FAST_PUSH_NO_GC(frame, element);
-    } else {
-        FAST_PUSH_GC(frame, element ? element : vm_get_none(frame->vm));
+    size_t limit = array_obj->as.array.cols ? object_array_rows(array_obj) : array_obj->as.array.size;
+    if (!subscript_in_bounds(index_obj, limit, "LOAD_SUBSCR")) {
+        FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
+        return;
     }
-    
-    GC_DECREF_IF_ENABLED(frame, index_obj);
-    GC_DECREF_IF_ENABLED(frame, array_obj);
+    array_load(frame, array_obj, (size_t)index_obj->as.int_value);
 }
 
-static void op_STORE_SUBSCR(Frame* frame, uint32_t arg) {
+static void op_LOAD_SUBSCR_UNCHECKED(Frame* frame, uint32_t arg) {
     Object* index_obj = FAST_POP_NO_GC(frame);
     Object* array_obj = FAST_POP_NO_GC(frame);
-    Object* value_obj = FAST_POP_NO_GC(frame);
-    
-    if (!array_obj || !index_obj || !value_obj) {
-        GC_DECREF_IF_ENABLED(frame, value_obj);
-        GC_DECREF_IF_ENABLED(frame, array_obj);
-        GC_DECREF_IF_ENABLED(frame, index_obj);
+    object_array_sync(array_obj);
+    array_load(frame, array_obj, (size_t)index_obj->as.int_value);
+}
+
+// Flat index of a[row][col] in a 2-D array, or SIZE_MAX when either index
+// is outside its dimension.
+static size_t array2_index(Object* array_obj, Object* row_obj, Object* col_obj) {
+    if (row_obj->type != OBJ_INT || col_obj->type != OBJ_INT) return SIZE_MAX;
+    size_t cols = array_obj->as.array.cols;
+    size_t row = (size_t)row_obj->as.int_value;
+    size_t col = (size_t)col_obj->as.int_value;
+    if (row >= object_array_rows(array_obj) || col >= cols) return SIZE_MAX;
+    return row * cols + col;
+}
+
+// a[i][j] is one flat load on a 2-D array; on an array of arrays it
+// indexes twice, as two LOAD_SUBSCRs would.
+static void op_LOAD_SUBSCR2(Frame* frame, uint32_t arg) {
+    Object* col_obj = FAST_POP_NO_GC(frame);
+    Object* row_obj = FAST_POP_NO_GC(frame);
+    Object* array_obj = FAST_POP_NO_GC(frame);
+
+    if (!array_obj || !row_obj || !col_obj || array_obj->type != OBJ_ARRAY) {
+        FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
         return;
     }
-    
-    int64_t index = index_obj->as.int_value;
+    object_array_sync(array_obj);
+
+    if (!array_obj->as.array.cols) {
+        FAST_PUSH_NO_GC(frame, array_obj);
+        FAST_PUSH_NO_GC(frame, row_obj);
+        op_LOAD_SUBSCR(frame, 0);
+        FAST_PUSH_NO_GC(frame, col_obj);
+        op_LOAD_SUBSCR(frame, 0);
+        return;
+    }
+
+    size_t index = array2_index(array_obj, row_obj, col_obj);
+    if (index == SIZE_MAX) {
+        DPRINT("[VM] ERROR: LOAD_SUBSCR2 index out of bounds for %zu x %zu array\n",
+               object_array_rows(array_obj), array_obj->as.array.cols);
+        FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
+        return;
+    }
+    FAST_PUSH_NO_GC(frame, heap_array_load(frame->vm->heap, array_obj, index));
+}
+
+// Gives a typed array boxed storage before a store its kind cannot hold;
+// the boxed items become counted heap references like any stored value.
+// A view boxes its base and is then repointed at the new storage.
+static bool vm_array_box(VM* vm, Object* array_obj) {
+    Object* owner = object_array_owner(array_obj);
+    if (!heap_array_box(vm->heap, owner)) return false;
+    for (size_t i = 0; i < owner->as.array.size; i++) {
+        Object* item = owner->as.array.items[i];
+        gc_write_barrier(vm->gc, owner, item);
+        GC_INCREF_IF_ENABLED_VM(vm, item);
+    }
+    object_array_sync(array_obj);
+    return true;
+}
+
+void vm_array_store(VM* vm, Object* array_obj, size_t index, Object* value_obj) {
+    if (!vm || !array_obj || array_obj->type != OBJ_ARRAY || !value_obj) return;
+    object_array_sync(array_obj);
+    if (index >= array_obj->as.array.size) return;
+
+    if (array_obj->elem_kind != ARRAY_BOXED) {
+        if (heap_array_store_unboxed(array_obj, index, value_obj)) return;
+        if (!vm_array_box(vm, array_obj)) return;
+    }
+    Object* old_element = array_obj->as.array.items[index];
+    array_obj->as.array.items[index] = value_obj;
+    gc_write_barrier(vm->gc, object_array_owner(array_obj), value_obj);
+
+    GC_INCREF_IF_ENABLED_VM(vm, value_obj);
+    GC_DECREF_IF_ENABLED_VM(vm, old_element);
+}
+
+bool vm_array_append(VM* vm, Object* array_obj, Object* value_obj) {
+    if (!vm || !array_obj || array_obj->type != OBJ_ARRAY || !value_obj) return false;
+    if (object_array_base(array_obj)) return false;
+
+    size_t index = array_obj->as.array.size;
+    if (!heap_array_grow(vm->heap, array_obj, index + 1)) return false;
+
+    // the new slot must hold a valid element before the store reads it
+    switch (array_obj->elem_kind) {
+        case ARRAY_INT:  array_obj->as.array.ints[index] = 0; break;
+        case ARRAY_BOOL: array_obj->as.array.bools[index] = 0; break;
+        default:         array_obj->as.array.items[index] = NULL; break;
+    }
+    array_obj->as.array.size = index + 1;
+    vm_array_store(vm, array_obj, index, value_obj);
+    return true;
+}
+
+Object* vm_array_pop(VM* vm, Object* array_obj) {
+    if (!vm || !array_obj || array_obj->type != OBJ_ARRAY) return NULL;
+    object_array_sync(array_obj);
+    if (array_obj->as.array.size == 0) return NULL;
+
+    size_t index = array_obj->as.array.size - 1;
+    Object* element = heap_array_load(vm->heap, array_obj, index);
+    if (object_array_has_refs(array_obj)) {
+        array_obj->as.array.items[index] = NULL;
+        GC_DECREF_IF_ENABLED_VM(vm, element);
+    }
+    array_obj->as.array.size = index;
+    return element;
+}
+
+void vm_array_truncate(VM* vm, Object* array_obj, size_t size) {
+    if (!vm || !array_obj || array_obj->type != OBJ_ARRAY) return;
+    object_array_sync(array_obj);
+    if (size >= array_obj->as.array.size) return;
+
+    for (size_t i = size; object_array_has_refs(array_obj) && i < array_obj->as.array.size; i++) {
+        Object* item = array_obj->as.array.items[i];
+        array_obj->as.array.items[i] = NULL;
+        GC_DECREF_IF_ENABLED_VM(vm, item);
+    }
+    array_obj->as.array.size = size;
+}
+
+Object* vm_array_slice(VM* vm, Object* array_obj, size_t lo, size_t hi) {
+    if (!vm || !array_obj || array_obj->type != OBJ_ARRAY) return NULL;
+
+    Object* view = heap_alloc_array_view(vm->heap, array_obj, lo, hi);
+    if (!view) return NULL;
+    gc_write_barrier(vm->gc, view, view->as.array.base);
+    GC_INCREF_IF_ENABLED_VM(vm, view->as.array.base);
+    return view;
+}
+
+static inline void array_store(Frame* frame, Object* array_obj, size_t index, Object* value_obj) {
+    if (array_obj->elem_kind != ARRAY_BOXED) {
+        if (heap_array_store_unboxed(array_obj, index, value_obj)) return;
+        if (!vm_array_box(frame->vm, array_obj)) return;
+    }
     Object* old_element = array_obj->as.array.items[index];
     array_obj->as.array.items[index] = value_obj;
+    gc_write_barrier(frame->vm->gc, object_array_owner(array_obj), value_obj);
     
     GC_INCREF_IF_ENABLED(frame, value_obj);
     GC_DECREF_IF_ENABLED(frame, old_element);
+}
+
+// A store to an out-of-range or non-integer index does nothing.
+static void op_STORE_SUBSCR(Frame* frame, uint32_t arg) {
+    Object* index_obj = FAST_POP_NO_GC(frame);
+    Object* array_obj = FAST_POP_NO_GC(frame);
+    Object* value_obj = FAST_POP_NO_GC(frame);
+    
+    if (!array_obj || !index_obj || !value_obj || array_obj->type != OBJ_ARRAY) {
+        return;
+    }
+    object_array_sync(array_obj);
     
-    GC_DECREF_IF_ENABLED(frame, index_obj);
-    GC_DECREF_IF_ENABLED(frame, array_obj);
+    if (!subscript_in_bounds(index_obj, array_obj->as.array.size, "STORE_SUBSCR")) {
+        return;
+    }
+    array_store(frame, array_obj, (size_t)index_obj->as.int_value, value_obj);
+}
+
+static void op_STORE_SUBSCR_UNCHECKED(Frame* frame, uint32_t arg) {
+    Object* index_obj = FAST_POP_NO_GC(frame);
+    Object* array_obj = FAST_POP_NO_GC(frame);
+    Object* value_obj = FAST_POP_NO_GC(frame);
+    object_array_sync(array_obj);
+    array_store(frame, array_obj, (size_t)index_obj->as.int_value, value_obj);
+}
+
+// Loop guards from the bounds pass; each pushes whether the loop may run
+// its unchecked copy. GUARD_INDEX: the value is an int in [0, 2^62), so a
+// start or step can be added to an in-range index without overflowing.
+static void op_GUARD_INDEX(Frame* frame, uint32_t arg) {
+    Object* value = FAST_POP_NO_GC(frame);
+    bool ok = value && value->type == OBJ_INT && (uint64_t)value->as.int_value < (UINT64_C(1) << 62);
+    FAST_PUSH_NO_GC(frame, ok ? vm_get_true(frame->vm) : vm_get_false(frame->vm));
+}
+
+// GUARD_LENGTH: array holds at least bound elements, bound being an int.
+static void op_GUARD_LENGTH(Frame* frame, uint32_t arg) {
+    Object* bound = FAST_POP_NO_GC(frame);
+    Object* array_obj = FAST_POP_NO_GC(frame);
+    bool ok = false;
+    if (array_obj && bound && array_obj->type == OBJ_ARRAY && bound->type == OBJ_INT &&
+        !array_obj->as.array.cols) {
+        object_array_sync(array_obj);
+        ok = bound->as.int_value <= (int64_t)array_obj->as.array.size;
+    }
+    DPRINT("[VM] GUARD_LENGTH: %s\n", ok ? "unchecked loop" : "checked loop");
+    FAST_PUSH_NO_GC(frame, ok ? vm_get_true(frame->vm) : vm_get_false(frame->vm));
+}
+
+static void op_STORE_SUBSCR2(Frame* frame, uint32_t arg) {
+    Object* col_obj = FAST_POP_NO_GC(frame);
+    Object* row_obj = FAST_POP_NO_GC(frame);
+    Object* array_obj = FAST_POP_NO_GC(frame);
+    Object* value_obj = FAST_POP_NO_GC(frame);
 
-    if (debug_enabled && array_obj && array_obj->type == OBJ_ARRAY && array_obj->as.array.size == 1000 && index >= 0 && index < 30) {
-        int64_t val = 0;
-        if (value_obj && value_obj->type == OBJ_INT) val = value_obj->as.int_value;
-        DPRINT("[VM] STORE_SUBSCR: array=%p idx=%lld <- %lld (old=%lld)\n", (void*)array_obj, (long long)index, (long long)val, (long long)(old_element ? old_element->as.int_value : 0));
+    if (!array_obj || !row_obj || !col_obj || !value_obj || array_obj->type != OBJ_ARRAY) {
+        return;
+    }
+    object_array_sync(array_obj);
+
+    if (!array_obj->as.array.cols) {
+        // array of arrays: store into the row a[i]
+        FAST_PUSH_NO_GC(frame, array_obj);
+        FAST_PUSH_NO_GC(frame, row_obj);
+        op_LOAD_SUBSCR(frame, 0);
+        Object* row = FAST_POP_NO_GC(frame);
+        FAST_PUSH_NO_GC(frame, value_obj);
+        FAST_PUSH_NO_GC(frame, row);
+        FAST_PUSH_NO_GC(frame, col_obj);
+        op_STORE_SUBSCR(frame, 0);
+        return;
     }
+
+    size_t index = array2_index(array_obj, row_obj, col_obj);
+    if (index == SIZE_MAX) {
+        DPRINT("[VM] ERROR: STORE_SUBSCR2 index out of bounds for %zu x %zu array\n",
+               object_array_rows(array_obj), array_obj->as.array.cols);
+        return;
+    }
+    vm_array_store(frame->vm, array_obj, index, value_obj);
 }
 
 static void op_LOAD_FAST(Frame* frame, uint32_t arg) {
@@ -939,15 +1310,10 @@ static void op_LOAD_FAST(Frame* frame, uint32_t arg) {
 static void op_STORE_FAST(Frame* frame, uint32_t arg) {
     if (arg >= frame->code->local_count) {
         DPRINT("VM: STORE_FAST index out of range %u\n", arg);
-        Object* v = frame_stack_pop(frame);
-        GC_DECREF_IF_ENABLED(frame, v);
+        frame_stack_pop(frame);
         return;
     }
-    Object* v = frame_stack_pop(frame);
-    
-    GC_INCREF_IF_ENABLED(frame, v);
-    if (frame->locals[arg]) GC_DECREF_IF_ENABLED(frame, frame->locals[arg]);
-    frame->locals[arg] = v;
+    frame->locals[arg] = frame_stack_pop(frame);
 }
 
 static void op_LOAD_GLOBAL(Frame* frame, uint32_t arg) {
@@ -961,7 +1327,6 @@ static void op_STORE_GLOBAL(Frame* frame, uint32_t arg) {
     size_t gidx = arg;
     Object* v = frame_stack_pop(frame);
     vm_set_global(frame->vm, gidx, v);
-    GC_DECREF_IF_ENABLED(frame, v);
 }
 
 
@@ -1031,13 +1396,7 @@ static void op_UNARY_OP(Frame* frame, uint32_t arg) {
         ret = vm_get_none(frame->vm);
     }
 
-    GC_DECREF_IF_ENABLED(frame, obj);
-    
-    if (ret->ref_count == 0x7FFFFFFF) {
-        FAST_PUSH_NO_GC(frame, ret);
-    } else {
-        FAST_PUSH_GC(frame, ret);
-    }
+    FAST_PUSH_NO_GC(frame, ret);
 }
 
 static void op_PUSH_NULL(Frame* frame, uint32_t arg) {
@@ -1045,8 +1404,7 @@ static void op_PUSH_NULL(Frame* frame, uint32_t arg) {
 }
 
 static void op_POP_TOP(Frame* frame, uint32_t arg) {
-    Object* o = frame_stack_pop(frame);
-    GC_DECREF_IF_ENABLED(frame, o);
+    frame_stack_pop(frame);
 }
 
 static void op_MAKE_FUNCTION(Frame* frame, uint32_t arg) {
@@ -1054,17 +1412,11 @@ static void op_MAKE_FUNCTION(Frame* frame, uint32_t arg) {
     
     if (maybe && maybe->type == OBJ_CODE) {
         CodeObj* codeptr = maybe->as.codeptr;
-
-        GC_DECREF_IF_ENABLED(frame, maybe);
         
+        /* Hotness-based JIT: counted on the CodeObj at call time */
         Object* func_obj = heap_alloc_function(frame->vm->heap, codeptr);
-        /* Hotness-based JIT: do not pre-JIT at creation time */
-        func_obj->as.function.jit_compiled = false;
         frame_stack_push(frame, func_obj);
-        
-        GC_DECREF_IF_ENABLED(frame, func_obj);
     } else {
-        GC_DECREF_IF_ENABLED(frame, maybe);
         frame_stack_push(frame, vm_get_none(frame->vm));
     }
 }
@@ -1085,63 +1437,49 @@ static void op_CALL_FUNCTION(Frame* frame, uint32_t arg) {
         }
     }
     
-    Object* maybe_null = frame_stack_pop(frame);
-    GC_DECREF_IF_ENABLED(frame, maybe_null);
+    frame_stack_pop(frame);
     
     Object* callee_obj = frame_stack_pop(frame);
     if (!callee_obj) {
         DPRINT("[VM] ERROR: Callee is NULL\n");
-        if (args) {
-            for (uint32_t i = 0; i < argc; i++) {
-                if (args[i]) GC_DECREF_IF_ENABLED(frame, args[i]);
-            }
-            free(args);
-        }
+        free(args);
         frame_stack_push(frame, vm_get_none(frame->vm));
         return;
     }
     
     Object* ret = NULL;
     if (callee_obj->type == OBJ_FUNCTION) {
-        if (jit_enabled && frame->vm && frame->vm->jit && 
-            !callee_obj->as.function.jit_compiled) {
-            size_t calls = ++callee_obj->as.function.call_count;
-            DPRINT("[VM] JIT hot counter for %s: %zu/%d\n",
-                   callee_obj->as.function.codeptr && callee_obj->as.function.codeptr->name ?
-                       callee_obj->as.function.codeptr->name : "<anonymous>",
-                   calls, JIT_HOT_CALL_THRESHOLD);
-            if (calls >= JIT_HOT_CALL_THRESHOLD) {
-                CodeObj* hot_code = callee_obj->as.function.codeptr;
-                JIT_COMPILE_IF_ENABLED(frame->vm, hot_code);
-                if (hot_code) {
-                    callee_obj->as.function.codeptr = hot_code;
+        CodeObj* callee_code = callee_obj->as.function.codeptr;
+        if (jit_enabled && frame->vm && frame->vm->jit && callee_code) {
+            if (!callee_code->jit_code) {
+                size_t calls = ++callee_code->call_count;
+                DPRINT("[VM] JIT hot counter for %s: %zu/%d\n",
+                       callee_code->name ? callee_code->name : "<anonymous>",
+                       calls, JIT_HOT_CALL_THRESHOLD);
+                if (calls >= JIT_HOT_CALL_THRESHOLD ||
+                    (calls == 1 && jit_wants_eager_compile(callee_code))) {
+                    CodeObj* hot_code = callee_code;
+                    JIT_COMPILE_IF_ENABLED(frame->vm, hot_code);
+                    callee_code->jit_code = hot_code ? hot_code : callee_code;
                 }
-                callee_obj->as.function.jit_compiled = true;
+            }
+            if (callee_code->jit_code) {
+                callee_code = callee_code->jit_code;
             }
         }
 
-        CodeObj* callee_code = callee_obj->as.function.codeptr;
-        GC_DECREF_IF_ENABLED(frame, callee_obj);
         ret = _vm_execute_with_args(frame->vm, callee_code, args, argc);
     } 
     else if (callee_obj->type == OBJ_NATIVE_FUNCTION) {
         NativeCFunc native_func = callee_obj->as.native_function.c_func;
         ret = native_func(frame->vm, argc, args);
-        if (ret) GC_INCREF_IF_ENABLED(frame, ret);
-        GC_DECREF_IF_ENABLED(frame, callee_obj);
     } 
     else {
         DPRINT("[VM] ERROR: Callee is not a function (type=%d)\n", callee_obj->type);
-        GC_DECREF_IF_ENABLED(frame, callee_obj);
         ret = vm_get_none(frame->vm);
     }
     
-    if (args) {
-        for (uint32_t i = 0; i < argc; i++) {
-            if (args[i]) GC_DECREF_IF_ENABLED(frame, args[i]);
-        }
-        free(args);
-    }
+    free(args);
     
     if (!ret) {
         DPRINT("[VM] WARNING: Function returned NULL, using None\n");
@@ -1154,9 +1492,6 @@ static void op_CALL_FUNCTION(Frame* frame, uint32_t arg) {
 
 static void op_RETURN_VALUE(Frame* frame, uint32_t arg) {
     Object* val = frame_stack_pop(frame);
-    if (val) {
-        GC_INCREF_IF_ENABLED(frame, val);
-    }
     frame_stack_push(frame, val);
 }
 
@@ -1243,7 +1578,6 @@ static void op_POP_JUMP_IF_FALSE(Frame* frame, uint32_t arg) {
         }
     }
     
-    GC_DECREF_IF_ENABLED(frame, condition);
     
     if (should_jump) {
         frame->ip += (int32_t)arg;
@@ -1274,7 +1608,6 @@ static void op_POP_JUMP_IF_TRUE(Frame* frame, uint32_t arg) {
         }
     }
     
-    GC_DECREF_IF_ENABLED(frame, condition);
     if (should_jump) {
         frame->ip += (int32_t)arg;
     }
@@ -1286,7 +1619,6 @@ static void op_POP_JUMP_IF_NONE(Frame* frame, uint32_t arg) {
     if (condition && condition->type == OBJ_NONE) {
         should_jump = true;
     }
-    GC_DECREF_IF_ENABLED(frame, condition);
     if (should_jump) {
         frame->ip += (int32_t)arg;
     }
@@ -1298,7 +1630,6 @@ static void op_POP_JUMP_IF_NOT_NONE(Frame* frame, uint32_t arg) {
     if (condition && condition->type != OBJ_NONE) {
         should_jump = true;
     }
-    GC_DECREF_IF_ENABLED(frame, condition);
     
     if (should_jump) {
         frame->ip += (int32_t)arg;
@@ -1318,7 +1649,6 @@ static void op_BUILD_ARRAY(Frame* frame, uint32_t arg) {
         Object* size_obj = frame_stack_pop(frame);
         if (!size_obj || size_obj->type != OBJ_INT) {
             DPRINT("[VM] ERROR: BUILD_ARRAY(0) expected integer size on stack\n");
-            GC_DECREF_IF_ENABLED(frame, size_obj);
             frame_stack_push(frame, vm_get_none(frame->vm));
             return;
         }
@@ -1328,8 +1658,6 @@ static void op_BUILD_ARRAY(Frame* frame, uint32_t arg) {
         
         Object* array = heap_alloc_array_with_size(frame->vm->heap, size);
         
-        GC_DECREF_IF_ENABLED(frame, size_obj);
-        
         if (!array) {
             DPRINT("[VM] ERROR: Failed to allocate array\n");
             frame_stack_push(frame, vm_get_none(frame->vm));
@@ -1368,8 +1696,6 @@ static void op_BUILD_ARRAY(Frame* frame, uint32_t arg) {
                     
                     array->as.array.items[i] = element;
                 }
-                
-                GC_DECREF_IF_ENABLED(frame, element);
             }
         }
         
@@ -1377,21 +1703,177 @@ static void op_BUILD_ARRAY(Frame* frame, uint32_t arg) {
     }
 }
 
+// int[n] and bool[n] declarations: the size is on the stack, arg is the ArrayKind.
+static void op_BUILD_TYPED_ARRAY(Frame* frame, uint32_t arg) {
+    Object* size_obj = frame_stack_pop(frame);
+    if (!size_obj || size_obj->type != OBJ_INT || arg > ARRAY_BOOL) {
+        DPRINT("[VM] ERROR: BUILD_TYPED_ARRAY expected integer size on stack\n");
+        frame_stack_push(frame, vm_get_none(frame->vm));
+        return;
+    }
+
+    int64_t size = size_obj->as.int_value;
+    DPRINT("[VM] Creating typed array kind=%u size=%lld\n", arg, (long long)size);
+
+    Object* array = heap_alloc_typed_array(frame->vm->heap, (ArrayKind)arg, size);
+    if (!array) {
+        DPRINT("[VM] ERROR: Failed to allocate array\n");
+        frame_stack_push(frame, vm_get_none(frame->vm));
+        return;
+    }
+
+    frame_stack_push(frame, array);
+}
+
+// BUILD_TYPED_ARRAY for a scratch array the JIT's escape pass proved never
+// leaves its local. When the local still holds the previous iteration's
+// array, of the same kind and with room for size elements, that array is
+// cleared and pushed again instead of allocating a new one.
+static void op_REUSE_TYPED_ARRAY(Frame* frame, uint32_t arg) {
+    uint32_t local = arg >> 8;
+    uint32_t kind = arg & 0xFF;
+    Object* size_obj = frame->stack_size ? FAST_PEEK(frame, 0) : NULL;
+    Object* old = local < frame->code->local_count ? frame->locals[local] : NULL;
+
+    if (!old || !size_obj || old->type != OBJ_ARRAY || old->elem_kind != kind ||
+        object_array_base(old) || old->as.array.cols || size_obj->type != OBJ_INT ||
+        size_obj->as.int_value < 0 || (uint64_t)size_obj->as.int_value > old->as.array.capacity) {
+        op_BUILD_TYPED_ARRAY(frame, kind);
+        return;
+    }
+
+    size_t size = (size_t)size_obj->as.int_value;
+    (void)FAST_POP_NO_GC(frame);
+    if (size > 0) {
+        memset(kind == ARRAY_INT ? (void*)old->as.array.ints : (void*)old->as.array.bools, 0,
+               size * object_array_elem_size((ArrayKind)kind));
+    }
+    old->as.array.size = size;
+    DPRINT("[VM] Reusing typed array %p kind=%u size=%zu\n", (void*)old, kind, size);
+    FAST_PUSH_NO_GC(frame, old);
+}
+
+static void op_BUILD_ARRAY2(Frame* frame, uint32_t arg) {
+    Object* cols_obj = frame_stack_pop(frame);
+    Object* rows_obj = frame_stack_pop(frame);
+    if (!rows_obj || !cols_obj || rows_obj->type != OBJ_INT || cols_obj->type != OBJ_INT ||
+        rows_obj->as.int_value < 0 || cols_obj->as.int_value < 0 || arg > ARRAY_BOOL) {
+        DPRINT("[VM] ERROR: BUILD_ARRAY2 expected non-negative integer dimensions on stack\n");
+        frame_stack_push(frame, vm_get_none(frame->vm));
+        return;
+    }
+
+    size_t rows = (size_t)rows_obj->as.int_value;
+    size_t cols = (size_t)cols_obj->as.int_value;
+    DPRINT("[VM] Creating 2-D array kind=%u %zu x %zu\n", arg, rows, cols);
+
+    Object* array = heap_alloc_matrix(frame->vm->heap, (ArrayKind)arg, rows, cols);
+    if (!array) {
+        DPRINT("[VM] ERROR: Failed to allocate array\n");
+        frame_stack_push(frame, vm_get_none(frame->vm));
+        return;
+    }
+
+    frame_stack_push(frame, array);
+}
+
+// A struct record is an array of its fields in declaration order, built
+// from the field defaults the compiler pushes: stored as ints (or bools)
+// when every field is one, boxed otherwise.
+static ArrayKind record_kind(Object** fields, size_t count) {
+    if (count == 0) return ARRAY_BOXED;
+    uint8_t type = fields[0]->type;
+    if (type != OBJ_INT && type != OBJ_BOOL) return ARRAY_BOXED;
+    for (size_t i = 1; i < count; i++) {
+        if (fields[i]->type != type) return ARRAY_BOXED;
+    }
+    return type == OBJ_INT ? ARRAY_INT : ARRAY_BOOL;
+}
+
+static Object* vm_build_record(VM* vm, Object** fields, size_t count) {
+    Object* record = heap_alloc_record(vm->heap, record_kind(fields, count), count);
+    if (!record) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        vm_array_store(vm, record, i, fields[i]);
+    }
+    return record;
+}
+
+// struct S s; the arg field defaults are on the stack.
+static void op_BUILD_STRUCT(Frame* frame, uint32_t arg) {
+    if (frame->stack_size < arg) {
+        DPRINT("[VM] ERROR: BUILD_STRUCT needs %u fields on the stack\n", arg);
+        FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
+        return;
+    }
+
+    Object* record = vm_build_record(frame->vm, &frame->stack[frame->stack_size - arg], arg);
+    frame->stack_size -= arg;
+    FAST_PUSH_NO_GC(frame, record ? record : vm_get_none(frame->vm));
+}
+
+// struct S[n] a; the arg field defaults, then n, are on the stack. The
+// array holds one record per element (array of structs).
+static void op_BUILD_STRUCT_ARRAY(Frame* frame, uint32_t arg) {
+    Object* size_obj = frame_stack_pop(frame);
+    if (!size_obj || size_obj->type != OBJ_INT || size_obj->as.int_value < 0 ||
+        frame->stack_size < arg) {
+        DPRINT("[VM] ERROR: BUILD_STRUCT_ARRAY expected %u fields and a size on the stack\n", arg);
+        frame->stack_size -= frame->stack_size < arg ? frame->stack_size : arg;
+        FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
+        return;
+    }
+
+    size_t size = (size_t)size_obj->as.int_value;
+    Object** fields = &frame->stack[frame->stack_size - arg];
+    DPRINT("[VM] Creating struct array of %zu records with %u fields\n", size, arg);
+
+    Object* array = heap_alloc_array_with_size(frame->vm->heap, size);
+    for (size_t i = 0; array && i < array->as.array.size; i++) {
+        Object* record = vm_build_record(frame->vm, fields, arg);
+        if (!record) break;
+        vm_array_store(frame->vm, array, i, record);
+    }
+    frame->stack_size -= arg;
+    FAST_PUSH_NO_GC(frame, array ? array : vm_get_none(frame->vm));
+}
+
+// s.f is one load at the field's offset. Anything but a record with that
+// many fields (the variable was rebound) loads None.
+static void op_LOAD_FIELD(Frame* frame, uint32_t arg) {
+    Object* record = FAST_POP_NO_GC(frame);
+    if (!record || record->type != OBJ_ARRAY || object_array_base(record) ||
+        arg >= record->as.array.size) {
+        DPRINT("[VM] ERROR: LOAD_FIELD %u on a value that is not a record\n", arg);
+        FAST_PUSH_NO_GC(frame, vm_get_none(frame->vm));
+        return;
+    }
+    FAST_PUSH_NO_GC(frame, heap_array_load(frame->vm->heap, record, arg));
+}
+
+// s.f = value; like LOAD_FIELD, a value that is not a record is left alone.
+static void op_STORE_FIELD(Frame* frame, uint32_t arg) {
+    Object* record = FAST_POP_NO_GC(frame);
+    Object* value = FAST_POP_NO_GC(frame);
+    if (!record || !value || record->type != OBJ_ARRAY || object_array_base(record) ||
+        arg >= record->as.array.size) {
+        DPRINT("[VM] ERROR: STORE_FIELD %u on a value that is not a record\n", arg);
+        return;
+    }
+    array_store(frame, record, arg, value);
+}
+
 static void op_DEL_SUBSCR(Frame* frame, uint32_t arg) {
     Object* index_obj = frame_stack_pop(frame);
     Object* array_obj = frame_stack_pop(frame);
     
     if (!array_obj || !index_obj) {
         DPRINT("[VM] ERROR: DEL_SUBSCR missing array or index\n");
-        GC_DECREF_IF_ENABLED(frame, index_obj);
-        GC_DECREF_IF_ENABLED(frame, array_obj);
         return;
     }
     
     if (array_obj->type != OBJ_ARRAY) {
         DPRINT("[VM] ERROR: DEL_SUBSCR expected array, got type=%d\n", array_obj->type);
-        GC_DECREF_IF_ENABLED(frame, index_obj);
-        GC_DECREF_IF_ENABLED(frame, array_obj);
         return;
     }
     
@@ -1400,26 +1882,21 @@ static void op_DEL_SUBSCR(Frame* frame, uint32_t arg) {
         index = index_obj->as.int_value;
     } else {
         DPRINT("[VM] ERROR: DEL_SUBSCR index must be integer, got type=%d\n", index_obj->type);
-        GC_DECREF_IF_ENABLED(frame, index_obj);
-        GC_DECREF_IF_ENABLED(frame, array_obj);
         return;
     }
+    object_array_sync(array_obj);
     
     if (index < 0 || index >= (int64_t)array_obj->as.array.size) {
         DPRINT("[VM] ERROR: DEL_SUBSCR index %lld out of bounds (size=%zu)\n", 
                (long long)index, array_obj->as.array.size);
-        GC_DECREF_IF_ENABLED(frame, index_obj);
-        GC_DECREF_IF_ENABLED(frame, array_obj);
         return;
     }
     
+    if (array_obj->elem_kind != ARRAY_BOXED && !vm_array_box(frame->vm, array_obj)) return;
     Object* old_element = array_obj->as.array.items[index];
     array_obj->as.array.items[index] = vm_get_none(frame->vm);
     
     if (old_element) GC_DECREF_IF_ENABLED(frame, old_element);
-    
-    GC_DECREF_IF_ENABLED(frame, index_obj);
-    GC_DECREF_IF_ENABLED(frame, array_obj);
 }
 
 static void op_COMPARE_AND_SWAP(Frame* frame, uint32_t arg) {
@@ -1451,23 +1928,36 @@ static void op_COMPARE_AND_SWAP(Frame* frame, uint32_t arg) {
     
     int64_t j = j_obj->as.int_value;
     int64_t j_plus_1 = j_plus_1_obj->as.int_value;
+    object_array_sync(array_obj);
     
-    #ifdef DEBUG
-    if (j < 0 || j >= array_obj->as.array.size || 
-        j_plus_1 < 0 || j_plus_1 >= array_obj->as.array.size) {
+    if ((uint64_t)j >= array_obj->as.array.size || (uint64_t)j_plus_1 >= array_obj->as.array.size) {
         DPRINT("[VM] COMPARE_AND_SWAP: indices out of bounds: %lld, %lld (size=%zu)\n",
                (long long)j, (long long)j_plus_1, array_obj->as.array.size);
-        FAST_PUSH_NO_GC(frame, array_obj);
-        FAST_PUSH_NO_GC(frame, j_obj);
-        FAST_PUSH_NO_GC(frame, j_plus_1_obj);
         return;
     }
-    #endif
     
+    if (array_obj->elem_kind == ARRAY_INT) {
+        int64_t* ints = array_obj->as.array.ints;
+        if (ints[j] > ints[j_plus_1]) {
+            int64_t tmp = ints[j];
+            ints[j] = ints[j_plus_1];
+            ints[j_plus_1] = tmp;
+        }
+        return;
+    }
+    if (array_obj->elem_kind == ARRAY_BOOL) {
+        uint8_t* bools = array_obj->as.array.bools;
+        if (bools[j] > bools[j_plus_1]) {
+            bools[j] = 0;
+            bools[j_plus_1] = 1;
+        }
+        return;
+    }
+
     Object* a = array_obj->as.array.items[j];
     Object* b = array_obj->as.array.items[j_plus_1];
     
-    if (a->as.int_value > b->as.int_value) {
+    if (a && b && a->as.int_value > b->as.int_value) {
         DPRINT("[VM] COMPARE_AND_SWAP: swapping indices %lld and %lld (vals %lld > %lld) frame=%p\n",
             (long long)j, (long long)j_plus_1,
             (long long)(a ? a->as.int_value : 0), (long long)(b ? b->as.int_value : 0), (void*)frame);
@@ -1475,12 +1965,7 @@ static void op_COMPARE_AND_SWAP(Frame* frame, uint32_t arg) {
         Object* old_b = array_obj->as.array.items[j_plus_1];
 
         array_obj->as.array.items[j] = old_b;
-        GC_INCREF_IF_ENABLED(frame, old_b);
-        GC_DECREF_IF_ENABLED(frame, old_a);
-
         array_obj->as.array.items[j_plus_1] = old_a;
-        GC_INCREF_IF_ENABLED(frame, old_a);
-        GC_DECREF_IF_ENABLED(frame, old_b);
 
         Object* new_a = array_obj->as.array.items[j];
         Object* new_b = array_obj->as.array.items[j_plus_1];
@@ -1494,9 +1979,43 @@ static void op_COMPARE_AND_SWAP(Frame* frame, uint32_t arg) {
         }
     #endif
     }
-    
-    GC_DECREF_IF_ENABLED(frame, j_obj);
-    GC_DECREF_IF_ENABLED(frame, j_plus_1_obj);
+}
+
+// SORT_ARRAY only stands in for the bubble-sort nest when the nest could
+// not tell the difference: [lo, hi) lies inside a 1-D array and holds only
+// numbers, which compare the same way in both.
+static bool sortable_range(Object* array, int64_t lo, int64_t hi) {
+    object_array_sync(array);
+    if (array->as.array.cols || lo < 0 || lo > hi || (uint64_t)hi > array->as.array.size) return false;
+    if (array->elem_kind != ARRAY_BOXED) return true;
+    for (int64_t i = lo; i < hi; i++) {
+        Object* item = array->as.array.items[i];
+        if (!item || (item->type != OBJ_INT && item->type != OBJ_BOOL && item->type != OBJ_FLOAT)) return false;
+    }
+    return true;
+}
+
+// Emitted by the JIT ahead of a whole bubble-sort loop nest. Pushes true once
+// the range is sorted, false to have the original nest run instead.
+static void op_SORT_ARRAY(Frame* frame, uint32_t arg) {
+    if (frame->stack_size < 3) {
+        DPRINT("[VM] SORT_ARRAY: stack underflow\n");
+        return;
+    }
+
+    Object* hi_obj = FAST_POP_NO_GC(frame);
+    Object* lo_obj = FAST_POP_NO_GC(frame);
+    Object* array_obj = FAST_POP_NO_GC(frame);
+    if (!array_obj || array_obj->type != OBJ_ARRAY ||
+        !lo_obj || lo_obj->type != OBJ_INT || !hi_obj || hi_obj->type != OBJ_INT ||
+        !sortable_range(array_obj, lo_obj->as.int_value, hi_obj->as.int_value)) {
+        DPRINT("[VM] SORT_ARRAY: not a numeric range of a 1-D array, running the loop\n");
+        FAST_PUSH_NO_GC(frame, vm_get_false(frame->vm));
+        return;
+    }
+
+    sort_array(array_obj, (size_t)lo_obj->as.int_value, (size_t)hi_obj->as.int_value);
+    FAST_PUSH_NO_GC(frame, vm_get_true(frame->vm));
 }
 
 static Object* _vm_execute_with_args(VM* vm, CodeObj* code, Object** args, size_t argc) {
@@ -1506,9 +2025,7 @@ static Object* _vm_execute_with_args(VM* vm, CodeObj* code, Object** args, size_
     
     for (size_t i = 0; i < frame->local_count && i < argc; i++) {
         if (args && args[i]) {
-            if (frame->locals[i]) GC_DECREF_IF_ENABLED(frame, frame->locals[i]);
             frame->locals[i] = args[i];
-            GC_INCREF_IF_ENABLED(frame, frame->locals[i]);
         }
     }
     
@@ -1545,83 +2062,221 @@ void vm_unregister_frame(VM* vm, Frame* frame) {
     }
 }
 
-static void heap_iterate_wrapper(void* iterator_data, GC_ObjectCallback callback, void* callback_data) {
-    Heap* heap = (Heap*)iterator_data;
-    if (!heap || !callback) return;
+// Reports every root slot in place: globals, the interned singletons and
+// each active frame's locals and live operand stack. Nothing is copied and
+// there is no cap, so deep recursion stays precise.
+static void vm_enumerate_roots(GC* gc, void* roots_data) {
+    VM* vm = (VM*)roots_data;
+    if (!vm) return;
 
-    heap_iterate_all_objects(heap, (HeapObjectCallback)callback, callback_data);
-}
+    if (vm->globals) {
+        gc_visit_roots(gc, vm->globals, vm->globals_count);
+    }
 
-static size_t vm_collect_roots(VM* vm, Object** roots_buffer, size_t buffer_capacity) {
-    if (!vm || !roots_buffer) return 0;
-    
-    size_t count = 0;
+    gc_visit_root(gc, vm->none_object);
+    gc_visit_root(gc, vm->true_object);
+    gc_visit_root(gc, vm->false_object);
 
-    if (vm->globals) {
-        for (size_t i = 0; i < vm->globals_count && count < buffer_capacity; i++) {
-            if (vm->globals[i]) {
-                roots_buffer[count++] = vm->globals[i];
-            }
+    for (size_t i = 0; i < vm->active_frames_count; i++) {
+        Frame* frame = vm->active_frames[i];
+        if (!frame) continue;
+
+        if (frame->locals) {
+            gc_visit_roots(gc, frame->locals, frame->local_count);
+        }
+        if (frame->stack) {
+            gc_visit_roots(gc, frame->stack, frame->stack_size);
         }
     }
+}
 
-    if (count < buffer_capacity && vm->none_object) {
-        roots_buffer[count++] = vm->none_object;
-    }
-    if (count < buffer_capacity && vm->true_object) {
-        roots_buffer[count++] = vm->true_object;
+static void heap_partition_wrapper(void* iterator_data, size_t part, size_t parts,
+                                   GC_ObjectCallback callback, void* callback_data) {
+    heap_iterate_partition((Heap*)iterator_data, part, parts,
+                           (HeapObjectCallback)callback, callback_data);
+}
+
+static bool heap_step_wrapper(void* iterator_data, bool restart, size_t max_objects,
+                              GC_ObjectCallback callback, void* callback_data) {
+    VM* vm = (VM*)iterator_data;
+    if (restart) {
+        memset(&vm->sweep_cursor, 0, sizeof(vm->sweep_cursor));
     }
-    if (count < buffer_capacity && vm->false_object) {
-        roots_buffer[count++] = vm->false_object;
+    return heap_iterate_step(vm->heap, &vm->sweep_cursor, max_objects,
+                             (HeapObjectCallback)callback, callback_data);
+}
+
+// Runs one budgeted slice of the incremental major cycle in progress.
+void vm_gc_step(VM* vm) {
+    if (!vm || !vm->gc || !vm->heap) return;
+
+    bool done = gc_incremental_step(vm->gc, vm->gc_pause_ns, vm_enumerate_roots, vm,
+                                    heap_step_wrapper, vm, vm->heap->nursery,
+                                    vm->heap->nursery_count);
+    if (done) {
+        DPRINT("[VM] Incremental collection finished\n");
+        vm->heap->sweep_completed = true;
+        heap_print_stats(vm->heap);
     }
+}
 
-    if (vm->active_frames) {
-        for (size_t i = 0; i < vm->active_frames_count && count < buffer_capacity; i++) {
-            Frame* frame = vm->active_frames[i];
-            if (!frame) continue;
-
-            if (frame->locals) {
-                for (size_t j = 0; j < frame->local_count && count < buffer_capacity; j++) {
-                    if (frame->locals[j]) {
-                        roots_buffer[count++] = frame->locals[j];
-                    }
-                }
-            }
+// Restarts allocation accounting after any collection work.
+static void vm_reset_gc_trigger(VM* vm) {
+    heap_note_collection(vm->heap);
+    vm->gc_trigger_bytes = gc_get_young_budget(vm->gc);
+}
 
-            if (frame->stack) {
-                for (size_t j = 0; j < frame->stack_size && count < buffer_capacity; j++) {
-                    if (frame->stack[j]) {
-                        roots_buffer[count++] = frame->stack[j];
-                    }
-                }
-            }
-        }
+// The lazy sweep left by the last major must end before marking again.
+static void vm_finish_sweep(VM* vm) {
+    if (!gc_lazy_sweep_pending(vm->gc)) return;
+    heap_finish_sweep(vm->heap);
+    gc_finish_lazy_sweep(vm->gc);
+}
+
+// Empty blocks are released only right after a minor or atomic major
+// collection, when the nursery log no longer lists dead objects.
+static void vm_release_memory(VM* vm) {
+    if (vm->heap->sweep_completed) {
+        heap_release_empty_blocks(vm->heap);
     }
-    
-    return count;
 }
 
+// Collects the whole heap at once, sweeping eagerly.
 void vm_collect_garbage(VM* vm) {
     if (!vm || !vm->gc || !vm->heap) return;
-    
-    DPRINT("[VM] Starting garbage collection...\n");
-    heap_print_stats(vm->heap);
 
-    size_t roots_capacity = 1024;
-    Object** roots = malloc(roots_capacity * sizeof(Object*));
-    if (!roots) {
-        DPRINT("[VM] Failed to allocate roots buffer for GC\n");
+    vm_finish_sweep(vm);
+    vm_reset_gc_trigger(vm);
+
+    // an explicit collection finishes any incremental cycle without a budget
+    if (gc_incremental_active(vm->gc)) {
+        gc_incremental_step(vm->gc, UINT64_MAX, vm_enumerate_roots, vm,
+                            heap_step_wrapper, vm, vm->heap->nursery,
+                            vm->heap->nursery_count);
         return;
     }
     
-    size_t roots_count = vm_collect_roots(vm, roots, roots_capacity);
-    
-    DPRINT("[VM] Collected %zu roots for GC\n", roots_count);
+    DPRINT("[VM] Starting garbage collection...\n");
+    heap_print_stats(vm->heap);
 
-    gc_collect(vm->gc, roots, roots_count, heap_iterate_wrapper, vm->heap);
-    
-    free(roots);
+    gc_collect_major(vm->gc, vm_enumerate_roots, vm, heap_partition_wrapper, vm->heap,
+                     vm->heap->nursery, &vm->heap->nursery_count);
+    vm->heap->sweep_completed = true;
+    vm_release_memory(vm);
+
+    DPRINT("[VM] Scanned %zu roots in %llu ns\n", gc_get_root_count(vm->gc),
+           (unsigned long long)gc_get_root_scan_ns(vm->gc));
     
     DPRINT("[VM] Garbage collection completed: \n");
     heap_print_stats(vm->heap);
 }
+
+// Runs once the heap has allocated the GC's young budget. Globals are
+// visited as roots on every minor collection (a flag test per old slot),
+// so vm_set_global needs no write barrier.
+void vm_collect_young(VM* vm) {
+    if (!vm || !vm->gc || !vm->heap) return;
+
+    DPRINT("[VM] Allocated %zu objects, %zu bytes since the last collection\n",
+           vm->heap->objects_since_gc, vm->heap->bytes_since_gc);
+
+    vm_finish_sweep(vm);
+
+    if (gc_incremental_active(vm->gc)) {
+        vm_reset_gc_trigger(vm);
+        vm_gc_step(vm);
+        return;
+    }
+
+    if (gc_major_due(vm->gc)) {
+        if (vm->gc_pause_ns > 0) {
+            vm_reset_gc_trigger(vm);
+            gc_incremental_start(vm->gc, vm_enumerate_roots, vm);
+        } else if (gc_get_threads(vm->gc) > 1) {
+            vm_collect_garbage(vm);
+        } else {
+            // pays for the sweep a block per allocation instead of in this pause
+            vm_reset_gc_trigger(vm);
+            gc_collect_major_lazy(vm->gc, vm_enumerate_roots, vm,
+                                  vm->heap->nursery, &vm->heap->nursery_count);
+            heap_begin_lazy_sweep(vm->heap, gc_sweep_object, vm->gc);
+        }
+        return;
+    }
+
+    vm_reset_gc_trigger(vm);
+    gc_collect_minor(vm->gc, vm_enumerate_roots, vm,
+                     vm->heap->nursery, &vm->heap->nursery_count);
+    vm->gc_trigger_bytes = gc_get_young_budget(vm->gc);
+    vm_release_memory(vm);
+
+    DPRINT("[VM] Minor collection: %zu young survivors, %zu remembered, %zu promoted total\n",
+           vm->heap->nursery_count, gc_get_remembered_count(vm->gc),
+           gc_get_promoted_count(vm->gc));
+    DPRINT("[VM] Survival rate %.2f, next collection after %zu bytes\n",
+           gc_get_survival_rate(vm->gc), vm->gc_trigger_bytes);
+}
+
+static void write_gc_work(FILE* out, const GCWork* work) {
+    fprintf(out, "\"marked_objects\": %zu, \"marked_bytes\": %zu, "
+                 "\"swept_objects\": %zu, \"swept_bytes\": %zu, "
+                 "\"promoted_objects\": %zu, \"promoted_bytes\": %zu",
+            work->marked_objects, work->marked_bytes, work->swept_objects,
+            work->swept_bytes, work->promoted_objects, work->promoted_bytes);
+}
+
+// One JSON object with the collector's totals and recent pauses, heap
+// occupancy per pool and the allocation rate since the VM was created.
+void vm_write_gc_stats(VM* vm, FILE* out) {
+    if (!vm || !out) return;
+
+    double elapsed = (double)(vm_now_ns() - vm->created_ns) / 1e9;
+    Heap* heap = vm->heap;
+
+    GCStats gc;
+    gc_get_stats(vm->gc, &gc);
+    HeapPoolStats pools[HEAP_POOL_COUNT];
+    heap_get_pool_stats(heap, pools);
+
+    fprintf(out, "{\n  \"elapsed_s\": %.6f,\n", elapsed);
+    fprintf(out, "  \"allocation\": {\"objects\": %zu, \"bytes\": %zu, \"bytes_per_s\": %.0f},\n",
+            heap->total_allocations, heap->total_bytes,
+            elapsed > 0 ? (double)heap->total_bytes / elapsed : 0.0);
+
+    fprintf(out, "  \"gc\": {\n    \"enabled\": %s, \"minor_collections\": %zu, \"major_collections\": %zu,\n",
+            gc_enabled ? "true" : "false", gc.minor_collections, gc.major_collections);
+    fprintf(out, "    \"pauses\": {\"count\": %zu, \"total_ns\": %llu, \"max_ns\": %llu},\n",
+            gc.pause_count, (unsigned long long)gc.total_pause_ns,
+            (unsigned long long)gc.max_pause_ns);
+    fprintf(out, "    \"work\": {");
+    write_gc_work(out, &gc.total);
+    fprintf(out, "},\n");
+    fprintf(out, "    \"young_budget\": %zu, \"heap_target\": %zu, \"old_bytes\": %zu, "
+                 "\"survival_rate\": %.4f, \"remembered\": %zu, \"zero_count\": %zu,\n",
+            gc.young_budget, gc.heap_target, gc.old_bytes, gc.survival_rate,
+            gc.remembered_count, gc.zct_count);
+    fprintf(out, "    \"recent\": [");
+    for (size_t i = 0; i < gc.history_count; i++) {
+        const GCPauseRecord* record = &gc.history[i];
+        fprintf(out, "%s\n      {\"kind\": \"%s\", \"pause_ns\": %llu, ", i > 0 ? "," : "",
+                gc_kind_name(record->kind), (unsigned long long)record->pause_ns);
+        write_gc_work(out, &record->work);
+        fprintf(out, "}");
+    }
+    fprintf(out, "%s]\n  },\n", gc.history_count > 0 ? "\n    " : "");
+
+    fprintf(out, "  \"heap\": {\n    \"released_bytes\": %zu,\n    \"pools\": [",
+            heap->released_bytes);
+    for (int i = 0; i < HEAP_POOL_COUNT; i++) {
+        const HeapPoolStats* pool = &pools[i];
+        double occupancy = pool->slots > 0 ? (double)(pool->live + pool->immortal) / pool->slots : 0.0;
+        double fragmentation = pool->used > 0 ? (double)pool->free / pool->used : 0.0;
+        fprintf(out, "%s\n      {\"name\": \"%s\", \"slot_size\": %zu, \"blocks\": %zu, \"released_blocks\": %zu, "
+                     "\"slots\": %zu, \"used\": %zu, \"live\": %zu, \"immortal\": %zu, \"free\": %zu, "
+                     "\"occupancy\": %.4f, \"fragmentation\": %.4f}",
+                i > 0 ? "," : "", pool->name, pool->slot_size, pool->blocks, pool->released_blocks, pool->slots,
+                pool->used, pool->live, pool->immortal, pool->free, occupancy, fragmentation);
+    }
+    fprintf(out, "\n    ]\n  }\n}\n");
+    fflush(out);
+}
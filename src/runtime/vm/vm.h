@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include "heap.h"
 #include "../../runtime/gc/gc.h"
@@ -33,5 +34,27 @@ Object* vm_get_true(VM* vm);
 Object* vm_get_false(VM* vm);
 
 void vm_collect_garbage(VM* vm);
+void vm_collect_young(VM* vm);
+void vm_gc_step(VM* vm);
+void vm_set_gc_pause_us(VM* vm, uint64_t pause_us);
+void vm_set_gc_threads(VM* vm, size_t threads);
+void vm_set_gc_growth(VM* vm, double factor);
+void vm_set_gc_min_heap(VM* vm, size_t bytes);
+// Dumps GC and heap telemetry as JSON (--gc-stats=json, gc_stats()).
+void vm_write_gc_stats(VM* vm, FILE* out);
+// STORE_SUBSCR for native code: stores unboxed into a typed array when the
+// kind matches, boxes it otherwise, and keeps barriers and counts right.
+// Out-of-range indices are ignored.
+void vm_array_store(VM* vm, Object* array, size_t index, Object* value);
+// Growable-array operations behind append/pop/truncate. Storage grows
+// geometrically, and dropped boxed items lose their array reference.
+// pop returns NULL for an empty array; truncate never grows or frees storage.
+bool vm_array_append(VM* vm, Object* array, Object* value);
+Object* vm_array_pop(VM* vm, Object* array);
+void vm_array_truncate(VM* vm, Object* array, size_t size);
+// View of elements [lo, hi) of array, sharing its storage; NULL if array
+// is not one. Views have a fixed length: append does not grow them, and pop
+// and truncate only shorten the view.
+Object* vm_array_slice(VM* vm, Object* array, size_t lo, size_t hi);
 void vm_register_frame(VM* vm, Frame* frame);
 void vm_unregister_frame(VM* vm, Frame* frame);
\ No newline at end of file
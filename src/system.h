@@ -35,9 +35,10 @@ extern int gc_enabled;
         } \
     } while (0)
 
+// heap-to-heap references only; a drop never frees, see gc_decref_deferred
 #define GC_DECREF_IF_ENABLED(frame_ptr, obj_ptr) \
     do { \
         if (gc_enabled && (frame_ptr) && (frame_ptr)->vm && (obj_ptr)) { \
-            gc_decref((frame_ptr)->vm->gc, (obj_ptr)); \
+            gc_decref_deferred((frame_ptr)->vm->gc, (obj_ptr)); \
         } \
     } while (0)
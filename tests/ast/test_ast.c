@@ -466,6 +466,38 @@ bool test_add_statement_to_block() {
     return result;
 }
 
+bool test_arena_owned_tree() {
+    SourceLocation loc = {1, 1};
+    Arena* arena = arena_create(256);
+    ast_set_arena(arena);
+    
+    ASTNode* block = ast_new_block_statement(loc, NULL, 0);
+    ASTNode* last_stmt = NULL;
+    for (int i = 0; i < 100; i++) {
+        ASTNode* literal = ast_new_literal_expression(loc, TYPE_INT, i);
+        ASTNode* var = ast_new_variable_expression(loc, "x");
+        ASTNode* sum = ast_new_binary_expression(loc, var, (Token){.type=OP_PLUS, .value="+"}, literal);
+        last_stmt = ast_new_expression_statement(loc, sum);
+        assert(add_statement_to_block(block, last_stmt));
+        
+        // constructors adopt children instead of copying them
+        assert(((BinaryExpression*)sum)->left == var);
+        ast_free(literal);
+    }
+    ast_set_arena(NULL);
+    
+    BlockStatement* block_stmt = (BlockStatement*)block;
+    assert(block->arena_owned);
+    assert(block_stmt->statement_count == 100);
+    assert(block_stmt->statements[99] == last_stmt);
+    
+    // ast_free leaves arena nodes alone; the arena releases them in one step
+    ast_free(block);
+    assert(arena->bytes_used > 0);
+    arena_destroy(arena);
+    return true;
+}
+
 // gcc tests/ast/test_ast.c src/lexer/token.h src/AST/ast.c src/parser/parser.c
 int main() {
     debug_enabled = 1;
@@ -486,6 +518,7 @@ int main() {
     ASTNode* test13 = test_ast_new_expression_statement();
     ASTNode* test14 = test_ast_new_block_statement();
     bool test15 = test_add_statement_to_block();
+    test_arena_owned_tree();
 
     ast_free(test1);
     ast_free(test2);
@@ -1836,6 +1836,147 @@ void test_compile_float_function_parameter() {
     printf("✓ Test completed successfully\n\n");
 }
 
+void test_compile_constant_pool_dedup() {
+    printf("=== Test: Constant Pool Deduplication ===\n");
+    
+    // Arrange: 7; 7; ...; 1.50; 1.5; (repeated literals)
+    SourceLocation loc = {0, 0};
+    const size_t repeats = 500;
+    ASTNode** statements = malloc((repeats + 2) * sizeof(ASTNode*));
+    for (size_t i = 0; i < repeats; i++) {
+        ASTNode* literal = ast_new_literal_expression(loc, TYPE_INT, 7);
+        statements[i] = ast_new_expression_statement(loc, literal);
+        ast_free(literal);
+    }
+    ASTNode* float_a = ast_new_literal_expression_long_arithmetics(loc, TYPE_FLOAT, "1.50");
+    ASTNode* float_b = ast_new_literal_expression_long_arithmetics(loc, TYPE_FLOAT, "1.5");
+    statements[repeats] = ast_new_expression_statement(loc, float_a);
+    statements[repeats + 1] = ast_new_expression_statement(loc, float_b);
+    ast_free(float_a);
+    ast_free(float_b);
+    
+    ASTNode* block_stmt = ast_new_block_statement(loc, statements, repeats + 2);
+    compiler* comp = compiler_create(block_stmt);
+    
+    // Act
+    compilation_result* result = compiler_compile(comp);
+    
+    // Assert
+    assert(result != NULL);
+    printf("Constants pool size: %zu\n", result->constants_count);
+    assert(result->constants_count == 2);
+    assert(result->constants[0].type == VAL_INT);
+    assert(result->constants[0].int_val == 7);
+    assert(result->constants[1].type == VAL_FLOAT);
+    
+    for (uint32_t i = 0; i < result->code_array.count; i++) {
+        bytecode bc = result->code_array.bytecodes[i];
+        if (bc.op_code == LOAD_CONST) {
+            assert(bytecode_get_arg(bc) < result->constants_count);
+        }
+    }
+    printf("✓ Repeated literals share one pool entry\n");
+    
+    // Cleanup
+    for (size_t i = 0; i < repeats + 2; i++) {
+        ast_free(statements[i]);
+    }
+    free(statements);
+    compiler_destroy(comp);
+    printf("✓ Test completed successfully\n\n");
+}
+
+static ASTNode* build_parallel_module(size_t function_count) {
+    // int fi() { xi = i; shared = shared + xi; return f(i-1)() + missing; }
+    // with "int shared = 0;" declared after the first few functions
+    SourceLocation loc = {0, 0};
+    ASTNode** statements = malloc((function_count + 1) * sizeof(ASTNode*));
+    size_t count = 0;
+    for (size_t i = 0; i < function_count; i++) {
+        if (i == 3) {
+            ASTNode* zero = ast_new_literal_expression(loc, TYPE_INT, 0);
+            statements[count++] = ast_new_variable_declaration_statement(loc, TYPE_INT, "shared", zero);
+            ast_free(zero);
+        }
+
+        char local_name[32], callee_name[32], function_name[32];
+        snprintf(local_name, sizeof(local_name), "x%zu", i);
+        snprintf(callee_name, sizeof(callee_name), "f%zu", i > 0 ? i - 1 : 0);
+        snprintf(function_name, sizeof(function_name), "f%zu", i);
+
+        ASTNode* x = ast_new_variable_expression(loc, local_name);
+        ASTNode* shared = ast_new_variable_expression(loc, "shared");
+        ASTNode* value = ast_new_literal_expression(loc, TYPE_INT, (int)i);
+        ASTNode* store_x = ast_new_assignment_statement(loc, x, value);
+        ASTNode* sum = ast_new_binary_expression(loc, shared, (Token){.type = OP_PLUS, .value = "+"}, x);
+        ASTNode* store_shared = ast_new_assignment_statement(loc, shared, sum);
+
+        ASTNode* callee = ast_new_variable_expression(loc, callee_name);
+        ASTNode* call = ast_new_call_expression(loc, callee, NULL, 0);
+        ASTNode* missing = ast_new_variable_expression(loc, "missing");
+        ASTNode* ret_sum = ast_new_binary_expression(loc, call, (Token){.type = OP_PLUS, .value = "+"}, missing);
+        ASTNode* ret = ast_new_return_statement(loc, ret_sum);
+
+        ASTNode* body_stmts[] = {store_x, store_shared, ret};
+        ASTNode* body = ast_new_block_statement(loc, body_stmts, 3);
+        statements[count++] = ast_new_function_declaration_statement(loc, function_name, TYPE_INT, NULL, 0, body);
+    }
+    return ast_new_block_statement(loc, statements, count);
+}
+
+static void assert_same_code(const CodeObj* a, const CodeObj* b) {
+    assert(a->code.count == b->code.count);
+    assert(memcmp(a->code.bytecodes, b->code.bytecodes, a->code.count * sizeof(bytecode)) == 0);
+    assert(a->constants_count == b->constants_count);
+    for (size_t i = 0; i < a->constants_count; i++) {
+        assert(a->constants[i].type == b->constants[i].type);
+        if (a->constants[i].type == VAL_CODE) {
+            assert_same_code(a->constants[i].code_val, b->constants[i].code_val);
+        } else {
+            assert(values_equal(a->constants[i], b->constants[i]));
+        }
+    }
+}
+
+void test_compile_parallel_functions_deterministic() {
+    printf("=== Test: Parallel Function Compilation ===\n");
+
+    // Arrange
+    const size_t function_count = 40;
+    compiler* serial = compiler_create(build_parallel_module(function_count));
+    compiler* parallel = compiler_create(build_parallel_module(function_count));
+    compiler_set_threads(parallel, 4);
+
+    // Act: debug output forces the serial path, so switch it off here
+    int saved_debug = debug_enabled;
+    debug_enabled = 0;
+    compilation_result* serial_result = compiler_compile(serial);
+    compilation_result* parallel_result = compiler_compile(parallel);
+    debug_enabled = saved_debug;
+
+    // Assert: byte-for-byte the same module
+    assert(serial_result != NULL && parallel_result != NULL);
+    CodeObj serial_module = {.code = serial_result->code_array,
+                             .constants = serial_result->constants,
+                             .constants_count = serial_result->constants_count};
+    CodeObj parallel_module = {.code = parallel_result->code_array,
+                               .constants = parallel_result->constants,
+                               .constants_count = parallel_result->constants_count};
+    assert_same_code(&serial_module, &parallel_module);
+
+    assert(serial->global_names->count == parallel->global_names->count);
+    for (size_t i = 0; i < serial->global_names->count; i++) {
+        assert(strcmp(string_table_get(serial->global_names, i),
+                      string_table_get(parallel->global_names, i)) == 0);
+    }
+    printf("✓ %zu functions compiled on 4 threads match the serial build\n", function_count);
+
+    // Cleanup
+    compiler_destroy(serial);
+    compiler_destroy(parallel);
+    printf("✓ Test completed successfully\n\n");
+}
+
 // gcc tests/compiler/test_compiler.c src/compiler/compiler.c src/compiler/value.c src/compiler/scope.c src/compiler/string_table.c src/compiler/bytecode.c src/AST/ast.c src/lexer/token.c
 int main() {
     debug_enabled = 1;
@@ -1879,6 +2020,8 @@ int main() {
     test_compile_float_scientific_notation();
     test_compile_float_assignment();
     test_compile_float_function_parameter();
+    test_compile_constant_pool_dedup();
+    test_compile_parallel_functions_deterministic();
 
     printf("All tests passed! ✅\n");
     return 0;
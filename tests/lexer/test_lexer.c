@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <unistd.h>
 #include "../../src/system.h"
 
 
@@ -369,6 +370,58 @@ void test_float_in_expression() {
     printf("Float in expression test passed!\n\n");
 }
 
+void test_mapped_matches_stream() {
+    printf("Testing mapped lexer against stream lexer...\n");
+    
+    const char* code =
+        "int count = 10; // comment\n"
+        "        float x = 1.5e-3;\n"
+        "if (count==10 and x<=2.0) { print(count!=3); }\n"
+        "arr[0] = not true or false;\n"
+        "bad ! 1e+";
+    
+    char path[] = "/tmp/test_lexer_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    FILE* out = fdopen(fd, "w");
+    assert(out != NULL);
+    fputs(code, out);
+    fclose(out);
+    
+    lexer* mapped = lexer_create(path);
+    assert(mapped != NULL);
+    assert(lexer_source(mapped) != NULL);
+    lexer* stream = lexer_create_from_stream(create_temp_file(code), "test_stream");
+    assert(stream != NULL);
+    
+    Token* a = lexer_parse_file(mapped, path);
+    Token* b = lexer_parse_file(stream, "test_stream");
+    assert(a != NULL && b != NULL);
+    
+    int i = 0;
+    for (; a[i].type != END_OF_FILE; i++) {
+        assert(a[i].type == b[i].type);
+        assert(strcmp(a[i].value, b[i].value) == 0);
+        assert(a[i].line == b[i].line);
+        assert(a[i].column == b[i].column);
+        assert(a[i].offset == b[i].offset);
+        assert(a[i].length == b[i].length);
+        assert(strncmp(lexer_source(mapped) + a[i].offset, a[i].value, a[i].length) == 0);
+    }
+    assert(b[i].type == END_OF_FILE);
+    assert(a[4].type == SEMICOLON && a[4].line == 1);
+    assert(a[5].type == KW_FLOAT && a[5].line == 2 && a[5].column == 9);
+    
+    for (int j = 0; a[j].type != END_OF_FILE || a[j].value != NULL; j++) free(a[j].value);
+    for (int j = 0; b[j].type != END_OF_FILE || b[j].value != NULL; j++) free(b[j].value);
+    free(a);
+    free(b);
+    lexer_destroy(mapped);
+    lexer_destroy(stream);
+    unlink(path);
+    printf("Mapped lexer test passed!\n\n");
+}
+
 // gcc tests/lexer/test_lexer.c src/lexer/lexer.c src/lexer/token.c
 int main() {
     debug_enabled = 1;
@@ -383,6 +436,7 @@ int main() {
     test_float_numbers();
     test_mixed_numbers();
     test_float_in_expression();
+    test_mapped_matches_stream();
 
     printf("All tests passed! ✅\n");
     return 0;
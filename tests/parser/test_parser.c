@@ -761,6 +761,107 @@ void test_scientific_notation_in_code() {
     printf("\n\n");
 }
 
+void test_streaming_parser() {
+    printf("=== TEST: streaming token window ===\n");
+
+    // function body is far longer than PARSER_TOKEN_WINDOW
+    const char* code =
+        "int sum(int n) {\n"
+        "    int total = 0;\n"
+        "    for (int i = 0; i < n; i = i + 1) { total = total + i * 2 - 1; }\n"
+        "    while (total > 100) { total = total - 100; }\n"
+        "    if (total == 3) { total = 4; } elif (total != 5) { total = 6; } else { total = 7; }\n"
+        "    int[4] arr = [1, 2, 3, 4];\n"
+        "    arr[0] = arr[1] + arr[2] + arr[3];\n"
+        "    return total + arr[0];\n"
+        "}\n"
+        "int main() { print(sum(10)); return 0; }\n";
+
+    FILE* temp = tmpfile();
+    assert(temp != NULL);
+    fputs(code, temp);
+    rewind(temp);
+
+    lexer* l = lexer_create_from_stream(temp, "test_streaming");
+    assert(l != NULL);
+    Parser* parser = parser_create_from_lexer(l);
+    assert(parser != NULL);
+
+    ASTNode* root = parser_parse(parser);
+    assert(root != NULL);
+    BlockStatement* block = (BlockStatement*)root;
+    assert(block->statement_count == 2);
+    assert(block->statements[0]->node_type == NODE_FUNCTION_DECLARATION_STATEMENT);
+    FunctionDeclarationStatement* sum = (FunctionDeclarationStatement*)block->statements[0];
+    assert(strcmp(sum->name, "sum") == 0);
+    assert(parser->window_end - parser->window_start <= PARSER_TOKEN_WINDOW);
+    assert(parser->window_start > 0);
+    // retired spellings are released between statements, not kept until destroy
+    assert(parser->retired_count < PARSER_TOKEN_WINDOW);
+
+    ast_free(root);
+    parser_destroy(parser);
+    lexer_destroy(l);
+    printf("\n\n");
+}
+
+void test_struct_declaration() {
+    printf("=== TEST: struct declaration and field access ===\n");
+
+    const char* code =
+        "struct Body { float m; int id; };\n"
+        "int weigh(struct Body[] bs, struct Body b) { return bs[b.id].id; }\n"
+        "struct Body[4] bs;\n"
+        "bs[1].id = bs[0].id + 2;\n"
+        "struct Body c = bs[1];\n";
+
+    FILE* temp = tmpfile();
+    assert(temp != NULL);
+    fputs(code, temp);
+    rewind(temp);
+
+    lexer* l = lexer_create_from_stream(temp, "test_struct");
+    Parser* parser = parser_create_from_lexer(l);
+    ASTNode* root = parser_parse(parser);
+    assert(root != NULL);
+    ast_print_tree(root, 0);
+
+    BlockStatement* block = (BlockStatement*)root;
+    assert(block->statement_count == 5);
+
+    assert(block->statements[0]->node_type == NODE_STRUCT_DECLARATION_STATEMENT);
+    StructDeclarationStatement* body = (StructDeclarationStatement*)block->statements[0];
+    assert(strcmp(body->name, "Body") == 0 && body->field_count == 2);
+    assert(strcmp(body->fields[0].name, "m") == 0 && body->fields[0].type == TYPE_FLOAT);
+    assert(strcmp(body->fields[1].name, "id") == 0 && body->fields[1].type == TYPE_INT);
+
+    FunctionDeclarationStatement* weigh = (FunctionDeclarationStatement*)block->statements[1];
+    assert(weigh->parameter_count == 2);
+    assert(strcmp(weigh->parameters[0].struct_name, "Body") == 0 && weigh->parameters[0].is_array);
+    assert(strcmp(weigh->parameters[1].struct_name, "Body") == 0 && !weigh->parameters[1].is_array);
+
+    assert(block->statements[2]->node_type == NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT);
+    StructVariableDeclarationStatement* bs = (StructVariableDeclarationStatement*)block->statements[2];
+    assert(strcmp(bs->struct_name, "Body") == 0 && strcmp(bs->name, "bs") == 0);
+    assert(bs->is_array && bs->size != NULL && bs->initializer == NULL);
+
+    assert(block->statements[3]->node_type == NODE_ASSIGNMENT_STATEMENT);
+    AssignmentStatement* assign = (AssignmentStatement*)block->statements[3];
+    assert(assign->left->node_type == NODE_FIELD_EXPRESSION);
+    FieldExpression* field = (FieldExpression*)assign->left;
+    assert(strcmp(field->field, "id") == 0 && field->object->node_type == NODE_SUBSCRIPT_EXPRESSION);
+
+    assert(block->statements[4]->node_type == NODE_STRUCT_VARIABLE_DECLARATION_STATEMENT);
+    StructVariableDeclarationStatement* c = (StructVariableDeclarationStatement*)block->statements[4];
+    assert(!c->is_array && c->size == NULL);
+    assert(c->initializer && c->initializer->node_type == NODE_SUBSCRIPT_EXPRESSION);
+
+    ast_free(root);
+    parser_destroy(parser);
+    lexer_destroy(l);
+    printf("\n\n");
+}
+
 int main() {
     debug_enabled = 1;
     test_simple_expressions();
@@ -781,6 +882,8 @@ int main() {
     test_mixed_type_expressions();          // Смешанные выражения
     test_float_function_parameters();       // Функции с float параметрами
     test_scientific_notation_in_code();     // Научная нотация
+    test_streaming_parser();
+    test_struct_declaration();
     
     printf("All tests passed!\n");
     return 0;
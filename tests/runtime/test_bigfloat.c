@@ -352,6 +352,12 @@ static void test_comparisons() {
     assert(bigfloat_lt(a6, b6) == true);
     printf("-1.0 < 1.0 ✓\n");
     
+    BigFloat* a7 = bigfloat_create("-100");
+    BigFloat* b7 = bigfloat_create("-0.5");
+    assert(bigfloat_lt(a7, b7) == true);
+    assert(bigfloat_gt(b7, a7) == true);
+    printf("-100 < -0.5 ✓\n");
+    
     // Test with decimals
     BigFloat* a8 = bigfloat_create("1.23");
     BigFloat* b8 = bigfloat_create("1.24");
@@ -371,6 +377,8 @@ static void test_comparisons() {
     bigfloat_destroy(b5);
     bigfloat_destroy(a6);
     bigfloat_destroy(b6);
+    bigfloat_destroy(a7);
+    bigfloat_destroy(b7);
     bigfloat_destroy(a8);
     bigfloat_destroy(b8);
     
@@ -4,7 +4,9 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <string.h>
 #include "../../src/runtime/gc/gc.h"
+#include "../../src/runtime/vm/heap.h"
 
 static void assert_ref_count(Object* obj, uint32_t expected, const char* test_name) {
     if (obj) {
@@ -191,29 +193,522 @@ static void test_nested_arrays() {
     printf("PASSED\n\n");
 }
 
+static void heap_iterator(void* iterator_data, GC_ObjectCallback callback, void* callback_data) {
+    heap_iterate_all_objects((Heap*)iterator_data, (HeapObjectCallback)callback, callback_data);
+}
+
 static void test_gc_collect() {
     printf("=== Test 8: GC Collect ===\n");
     GC* gc = gc_create();
-    
-    Object* obj1 = object_new_int(1);
-    Object* obj2 = object_new_int(2);
-    Object* obj3 = object_new_int(3);
-    
-    gc_incref(gc, obj1);
-    gc_incref(gc, obj2);
-    gc_incref(gc, obj3);
+    Heap* heap = heap_create();
+
+    // outside the small int cache so they live in the int pool
+    Object* obj1 = heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    Object* obj2 = heap_alloc_int(heap, INT_CACHE_MAX + 2);
+    Object* obj3 = heap_alloc_int(heap, INT_CACHE_MAX + 3);
+
+    Object* roots[] = { obj1, obj2 };
+    gc_collect(gc, roots, 2, heap_iterator, heap);
+
+    assert(gc_get_marked_count(gc) == 2);
+    assert(gc_get_collected_count(gc) == 1);
+    assert_ref_count(obj1, 1, "Rooted object survives");
+    assert_ref_count(obj2, 1, "Rooted object survives");
+    assert_ref_count(obj3, 0, "Unrooted object collected");
+    assert((obj1->gc_flags & OBJ_GC_MARKED) == 0);
+    assert((obj2->gc_flags & OBJ_GC_MARKED) == 0);
+    printf("  ✓ Unreachable object swept, mark bits reset\n");
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
 
-    gc_collect(gc);
-    printf("  ✓ gc_collect called without errors\n");
+static void test_gc_deep_nesting() {
+    printf("=== Test 9: Deeply Nested Arrays ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
 
-    gc_decref(gc, obj1);
-    gc_decref(gc, obj2);
-    gc_decref(gc, obj3);
-    
+    // deep enough to overflow the C stack if marking recursed
+    const size_t depth = 500000;
+    Object* outer = object_new_array();
+    Object* current = outer;
+    for (size_t i = 0; i < depth; i++) {
+        Object* inner = object_new_array();
+        object_array_append(current, inner);
+        current = inner;
+    }
+    heap_alloc_array(heap);
+
+    Object* roots[] = { outer };
+    gc_collect(gc, roots, 1, heap_iterator, heap);
+
+    assert(gc_get_marked_count(gc) == depth + 1);
+    assert(gc_get_collected_count(gc) == 1);
+    printf("  ✓ %zu nested arrays marked without recursion\n", depth + 1);
+
+    while (outer) {
+        Object* next = outer->as.array.size > 0 ? outer->as.array.items[0] : NULL;
+        free(outer->as.array.items);
+        free(outer);
+        outer = next;
+    }
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+typedef struct {
+    Object** slots;
+    size_t count;
+} RootSlots;
+
+static void enumerate_test_roots(GC* gc, void* roots_data) {
+    RootSlots* roots = (RootSlots*)roots_data;
+    gc_visit_roots(gc, roots->slots, roots->count);
+}
+
+static void test_gc_root_enumeration() {
+    printf("=== Test 10: Unbounded Root Enumeration ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    // well past the old fixed 1024-entry roots buffer
+    const size_t count = 5000;
+    Object** slots = calloc(count, sizeof(Object*));
+    for (size_t i = 0; i < count; i++) {
+        slots[i] = heap_alloc_int(heap, INT_CACHE_MAX + 1 + (int64_t)i);
+    }
+    Object* garbage = heap_alloc_int(heap, INT_CACHE_MIN - 1);
+
+    RootSlots roots = { slots, count };
+    gc_collect_with_roots(gc, enumerate_test_roots, &roots, heap_iterator, heap);
+
+    assert(gc_get_root_count(gc) == count);
+    assert(gc_get_collected_count(gc) == 1);
+    assert_ref_count(garbage, 0, "Unrooted object collected");
+    for (size_t i = 0; i < count; i++) {
+        assert(slots[i]->ref_count == 1);
+    }
+    assert(gc_get_total_root_scan_ns(gc) >= gc_get_root_scan_ns(gc));
+    printf("  ✓ %zu roots visited in place\n", count);
+
+    free(slots);
+    heap_destroy(heap);
     gc_destroy(gc);
     printf("PASSED\n\n");
 }
 
+static void test_gc_minor_collection() {
+    printf("=== Test 11: Minor Collection ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    // allocated before tracking starts, so it is already old
+    Object* holder = heap_alloc_array_with_size(heap, 1);
+    heap->track_young = true;
+
+    Object* stored = heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    Object* rooted = heap_alloc_int(heap, INT_CACHE_MAX + 2);
+    Object* garbage = heap_alloc_int(heap, INT_CACHE_MAX + 3);
+    assert(heap->nursery_count == 3);
+    assert(stored->gc_flags & OBJ_GC_YOUNG);
+
+    holder->as.array.items[0] = stored;
+    gc_write_barrier(gc, holder, stored);
+    assert(gc_get_remembered_count(gc) == 1);
+
+    // only the young root is reported; holder reaches stored through the remembered set
+    RootSlots roots = { &rooted, 1 };
+    gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+
+    assert_ref_count(stored, 1, "Remembered young object survives");
+    assert_ref_count(rooted, 1, "Rooted young object survives");
+    assert_ref_count(garbage, 0, "Unreachable young object collected");
+    assert(heap->nursery_count == 2);
+    assert(holder->ref_count == 1);
+
+    for (int i = 1; i < GC_PROMOTION_AGE; i++) {
+        gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+    }
+    assert(heap->nursery_count == 0);
+    assert(!(stored->gc_flags & OBJ_GC_YOUNG));
+    assert(gc_get_promoted_count(gc) == 2);
+    assert(gc_get_remembered_count(gc) == 0);
+    assert(gc_get_minor_count(gc) == GC_PROMOTION_AGE);
+    printf("  ✓ Survivors promoted after %d minor collections\n", GC_PROMOTION_AGE);
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static bool heap_step_iterator(void* iterator_data, bool restart, size_t max_objects,
+                               GC_ObjectCallback callback, void* callback_data) {
+    static HeapCursor cursor;
+    if (restart) {
+        cursor = (HeapCursor){0};
+    }
+    return heap_iterate_step((Heap*)iterator_data, &cursor, max_objects,
+                             (HeapObjectCallback)callback, callback_data);
+}
+
+static void test_gc_incremental_cycle() {
+    printf("=== Test 12: Incremental Cycle ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    // an empty array is blackened as soon as it is shaded
+    Object* black = heap_alloc_array(heap);
+    Object* other = heap_alloc_array_with_size(heap, 1);
+    Object* moved = heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    other->as.array.items[0] = moved;
+
+    const size_t live = 20000;
+    Object* big = heap_alloc_array_with_size(heap, live);
+    for (size_t i = 0; i < live; i++) {
+        big->as.array.items[i] = heap_alloc_int(heap, INT_CACHE_MAX + 2 + (int64_t)i);
+    }
+
+    Object* root_slots[] = { black, big };
+    RootSlots roots = { root_slots, 2 };
+    gc_incremental_start(gc, enumerate_test_roots, &roots);
+    assert(gc_incremental_active(gc));
+    assert(black->gc_flags & OBJ_GC_MARKED);
+
+    // the mutator moves the only reference to `moved` into the black array
+    black->as.array.items = malloc(sizeof(Object*));
+    black->as.array.items[0] = moved;
+    black->as.array.size = 1;
+    gc_write_barrier(gc, black, moved);
+    other->as.array.items[0] = NULL;
+    assert(moved->gc_flags & OBJ_GC_MARKED);
+
+    size_t steps = 0;
+    while (!gc_incremental_step(gc, 0, enumerate_test_roots, &roots,
+                                heap_step_iterator, heap, NULL, 0)) {
+        steps++;
+    }
+    assert(steps > 1);
+    assert(!gc_incremental_active(gc));
+
+    assert_ref_count(moved, 1, "Object stored behind the barrier survives");
+    assert_ref_count(other, 0, "Unreachable array collected");
+    assert(big->as.array.items[live - 1]->ref_count == 1);
+    assert(gc_get_pause_count(gc) == steps + 2);
+    printf("  ✓ Cycle finished in %zu budgeted slices\n", steps + 1);
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static void heap_partition_iterator(void* iterator_data, size_t part, size_t parts,
+                                    GC_ObjectCallback callback, void* callback_data) {
+    heap_iterate_partition((Heap*)iterator_data, part, parts,
+                           (HeapObjectCallback)callback, callback_data);
+}
+
+static void test_gc_parallel_major() {
+    printf("=== Test 13: Parallel Major Collection ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+    gc_set_threads(gc, 4);
+
+    const size_t rows = 16, cols = 500;
+    Object* table = heap_alloc_array_with_size(heap, rows);
+    int64_t next = INT_CACHE_MAX + 1;
+    for (size_t r = 0; r < rows; r++) {
+        Object* row = heap_alloc_array_with_size(heap, cols);
+        for (size_t c = 0; c < cols; c++) {
+            row->as.array.items[c] = heap_alloc_int(heap, next++);
+        }
+        table->as.array.items[r] = row;
+    }
+    Object* garbage = heap_alloc_array_with_size(heap, 1000);
+    for (size_t i = 0; i < 1000; i++) {
+        garbage->as.array.items[i] = heap_alloc_int(heap, next++);
+    }
+
+    RootSlots roots = { &table, 1 };
+    gc_collect_major(gc, enumerate_test_roots, &roots, heap_partition_iterator, heap, NULL, NULL);
+
+    assert(gc_get_marked_count(gc) == 1 + rows + rows * cols);
+    assert(gc_get_collected_count(gc) == 1001);
+    for (size_t r = 0; r < rows; r++) {
+        Object* row = table->as.array.items[r];
+        assert(row->ref_count == 1 && !(row->gc_flags & OBJ_GC_MARKED));
+        for (size_t c = 0; c < cols; c++) {
+            assert(row->as.array.items[c]->ref_count == 1);
+            assert(!(row->as.array.items[c]->gc_flags & OBJ_GC_MARKED));
+        }
+    }
+    assert_ref_count(garbage, 0, "Unreachable array collected");
+    printf("  ✓ 4 threads marked %zu and swept %zu objects\n",
+           gc_get_marked_count(gc), gc_get_collected_count(gc));
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static void test_gc_allocation_policy() {
+    printf("=== Test 14: Allocation-Driven Policy ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    // old structure: allocated before tracking starts
+    Object* table = heap_alloc_array_with_size(heap, 4);
+    for (size_t i = 0; i < 4; i++) {
+        table->as.array.items[i] = heap_alloc_int(heap, INT_CACHE_MAX + 1 + (int64_t)i);
+    }
+    assert(heap->objects_since_gc == 5);
+    assert(heap->bytes_since_gc == sizeof(Object) + 4 * OBJECT_SMALL_SIZE + 4 * sizeof(Object*));
+    heap->track_young = true;
+
+    Object* pi = heap_alloc_float(heap, "3.14159");
+    assert(object_footprint(pi) > OBJECT_SMALL_SIZE);
+    printf("  ✓ Out-of-line array items and BigFloat digits are counted\n");
+
+    // nothing young is rooted, so the budget shrinks
+    RootSlots roots = { &table, 1 };
+    size_t budget = gc_get_young_budget(gc);
+    gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+    assert(gc_get_survival_rate(gc) == 0.0);
+    assert(gc_get_young_budget(gc) == budget / 2);
+
+    // everything young survives, so it grows back
+    Object* kept = heap_alloc_int(heap, INT_CACHE_MAX + 10);
+    RootSlots both = { (Object*[]){ table, kept }, 2 };
+    gc_collect_minor(gc, enumerate_test_roots, &both, heap->nursery, &heap->nursery_count);
+    assert(gc_get_survival_rate(gc) == 1.0);
+    assert(gc_get_young_budget(gc) == budget);
+    printf("  ✓ Young budget follows the survival rate\n");
+
+    gc_set_min_heap(gc, 0);
+    gc_set_growth_factor(gc, 3.0);
+    gc_collect_major(gc, enumerate_test_roots, &roots, heap_partition_iterator, heap,
+                     heap->nursery, &heap->nursery_count);
+    size_t live = object_footprint(table) + 4 * OBJECT_SMALL_SIZE;
+    assert(gc_get_old_bytes(gc) == live);
+    assert(gc_get_heap_target(gc) == 3 * live);
+    assert(!gc_major_due(gc));
+    printf("  ✓ Next major at %zu bytes for %zu live\n", gc_get_heap_target(gc), live);
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static void test_gc_lazy_sweep() {
+    printf("=== Test 15: Lazy Sweep and Block Release ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    const size_t kept = 10;
+    const size_t garbage = 3 * 65536;
+    Object* table = heap_alloc_array_with_size(heap, kept);
+    for (size_t i = 0; i < kept; i++) {
+        table->as.array.items[i] = heap_alloc_int(heap, INT_CACHE_MAX + 1 + (int64_t)i);
+    }
+    for (size_t i = 0; i < garbage; i++) {
+        heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    }
+    MemoryBlock* first = heap->int_pool.first;
+
+    RootSlots roots = { &table, 1 };
+    gc_collect_major_lazy(gc, enumerate_test_roots, &roots, NULL, NULL);
+    assert(gc_lazy_sweep_pending(gc));
+    assert(gc_get_marked_count(gc) == 1 + kept);
+    assert(gc_get_collected_count(gc) == 0);
+
+    heap_begin_lazy_sweep(heap, gc_sweep_object, gc);
+    heap_note_collection(heap);
+    size_t pending = heap->unswept_blocks;
+    assert(pending > 1);
+
+    // the allocation sweeps a block first and reuses a slot from it
+    Object* fresh = heap_alloc_int(heap, INT_CACHE_MAX + 100);
+    assert(heap->unswept_blocks < pending);
+    assert(fresh >= heap_block_slot(first, 0) && fresh < heap_block_slot(first, first->capacity));
+    printf("  ✓ Allocation swept a block and reused slot %zu\n",
+           (size_t)((unsigned char*)fresh - first->memory) / first->slot_size);
+
+    heap_finish_sweep(heap);
+    gc_finish_lazy_sweep(gc);
+    assert(!gc_lazy_sweep_pending(gc));
+    assert(gc_get_collected_count(gc) == garbage);
+    for (size_t i = 0; i < kept; i++) {
+        Object* item = table->as.array.items[i];
+        assert(item->ref_count == 1 && !(item->gc_flags & OBJ_GC_MARKED));
+    }
+    assert(!(table->gc_flags & OBJ_GC_MARKED));
+    printf("  ✓ Lazy sweep collected %zu objects\n", gc_get_collected_count(gc));
+
+    // one empty block is retained for reuse, the other two go back to the OS
+    assert(heap->sweep_completed);
+    assert(heap_release_empty_blocks(heap) == 2);
+    assert(heap->released_bytes == 2 * first->capacity * first->slot_size);
+    assert(heap_block_slot(first->next->next, 0)->ref_count == 0);
+    assert(heap_release_empty_blocks(heap) == 0);
+    printf("  ✓ Released %zu bytes\n", heap->released_bytes);
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static void test_gc_deferred_refcount() {
+    printf("=== Test 16: Deferred Reference Counting ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    // old objects: allocated before tracking starts
+    Object* holder = heap_alloc_array_with_size(heap, 2);
+    Object* row = heap_alloc_array_with_size(heap, 1);
+    Object* item = heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    Object* local = heap_alloc_int(heap, INT_CACHE_MAX + 2);
+    row->as.array.items[0] = item;
+    gc_incref(gc, item);
+    holder->as.array.items[0] = row;
+    gc_incref(gc, row);
+    holder->as.array.items[1] = local;
+    gc_incref(gc, local);
+    heap->track_young = true;
+
+    Object* young = heap_alloc_int(heap, INT_CACHE_MAX + 3);
+    gc_incref(gc, young);
+    gc_decref_deferred(gc, young);
+    assert(gc_get_zct_count(gc) == 0);
+
+    // dropping the last heap reference only logs the object
+    holder->as.array.items[0] = NULL;
+    gc_decref_deferred(gc, row);
+    holder->as.array.items[1] = NULL;
+    gc_decref_deferred(gc, local);
+    assert_ref_count(row, GC_RC_BIAS, "Unreferenced row is not freed at once");
+    assert(row->gc_flags & OBJ_GC_ZCT);
+    assert(gc_get_zct_count(gc) == 2);
+    gc_decref_deferred(gc, row);
+    assert_ref_count(row, GC_RC_BIAS, "The bias is never dropped");
+    printf("  ✓ Old objects at the bias are logged, young ones are not\n");
+
+    // `local` is still in a stack slot
+    RootSlots roots = { (Object*[]){ holder, local, young }, 3 };
+    gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+    assert_ref_count(row, 0, "Unrooted zero-count row freed");
+    assert_ref_count(local, GC_RC_BIAS, "Rooted zero-count object kept");
+    assert(!(local->gc_flags & OBJ_GC_MARKED));
+    assert_ref_count(item, GC_RC_BIAS, "Item of the freed row loses its count");
+    assert(gc_get_zct_count(gc) == 2);
+
+    // the item was logged during reconciliation and is freed by the next one
+    gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+    assert_ref_count(item, 0, "Cascaded item freed");
+    assert_ref_count(local, GC_RC_BIAS, "Rooted zero-count object still kept");
+    printf("  ✓ Minor collections reconcile the zero-count table\n");
+
+    // promoted with no heap references, so only its root keeps it
+    assert(!(young->gc_flags & OBJ_GC_YOUNG));
+    assert(young->gc_flags & OBJ_GC_ZCT);
+    assert(gc_get_zct_count(gc) == 2);
+    printf("  ✓ Promotion logs objects held only by roots\n");
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static void test_gc_telemetry() {
+    printf("=== Test 17: Collection Telemetry ===\n");
+    GC* gc = gc_create();
+    Heap* heap = heap_create();
+
+    Object* holder = heap_alloc_array_with_size(heap, 1);
+    heap->track_young = true;
+    Object* rooted = heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    heap_alloc_int(heap, INT_CACHE_MAX + 2);
+    heap_alloc_int(heap, INT_CACHE_MAX + 3);
+
+    RootSlots roots = { &rooted, 1 };
+    gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+
+    GCStats stats;
+    gc_get_stats(gc, &stats);
+    assert(stats.minor_collections == 1 && stats.major_collections == 0);
+    assert(stats.history_count == 1);
+    assert(stats.history[0].kind == GC_KIND_MINOR);
+    assert(stats.history[0].work.marked_objects == 1);
+    assert(stats.history[0].work.swept_objects == 2);
+    assert(stats.history[0].work.swept_bytes == 2 * object_footprint(rooted));
+    printf("  ✓ Minor pause recorded: marked %zu, swept %zu\n",
+           stats.history[0].work.marked_objects, stats.history[0].work.swept_objects);
+
+    RootSlots all = { (Object*[]){ holder, rooted }, 2 };
+    gc_collect_major(gc, enumerate_test_roots, &all, heap_partition_iterator, heap,
+                     heap->nursery, &heap->nursery_count);
+    gc_get_stats(gc, &stats);
+    assert(stats.history_count == 2);
+    assert(stats.history[1].kind == GC_KIND_MAJOR);
+    assert(stats.history[1].work.marked_objects >= 2);
+    assert(stats.total.marked_objects ==
+           stats.history[0].work.marked_objects + stats.history[1].work.marked_objects);
+    assert(stats.pause_count == 2);
+    printf("  ✓ Major pause recorded and totals add up\n");
+
+    // the ring keeps the most recent pauses, oldest first
+    for (int i = 0; i < GC_STATS_HISTORY; i++) {
+        gc_collect_minor(gc, enumerate_test_roots, &roots, heap->nursery, &heap->nursery_count);
+    }
+    gc_get_stats(gc, &stats);
+    assert(stats.history_count == GC_STATS_HISTORY);
+    assert(stats.history[0].kind == GC_KIND_MINOR);
+    assert(stats.minor_collections == 1 + GC_STATS_HISTORY);
+    printf("  ✓ History keeps the last %d pauses\n", GC_STATS_HISTORY);
+
+    HeapPoolStats pools[HEAP_POOL_COUNT];
+    heap_get_pool_stats(heap, pools);
+    assert(strcmp(pools[0].name, "int") == 0);
+    assert(pools[0].used == 3 && pools[0].live == 1 && pools[0].free == 2);
+    assert(strcmp(pools[1].name, "array") == 0 && pools[1].live == 1);
+    assert(heap->total_bytes >= 3 * object_footprint(rooted) + object_footprint(holder));
+    printf("  ✓ Pool occupancy: %zu of %zu int slots live\n", pools[0].live, pools[0].used);
+
+    heap_destroy(heap);
+    gc_destroy(gc);
+    printf("PASSED\n\n");
+}
+
+static void test_size_class_slots() {
+    printf("=== Test 18: Size-Class Slots ===\n");
+    Heap* heap = heap_create();
+
+    assert(OBJECT_SMALL_SIZE == 16);
+    Object* a = heap_alloc_int(heap, INT_CACHE_MAX + 1);
+    Object* b = heap_alloc_int(heap, INT_CACHE_MAX + 2);
+    assert((unsigned char*)b - (unsigned char*)a == OBJECT_SMALL_SIZE);
+    assert(object_footprint(a) == OBJECT_SMALL_SIZE);
+    assert(heap_alloc_int(heap, 7) == heap->int_cache[7 - INT_CACHE_MIN]);
+    printf("  ✓ Ints take %zu-byte slots\n", (size_t)OBJECT_SMALL_SIZE);
+
+    Object* x = heap_alloc_array(heap);
+    Object* y = heap_alloc_array(heap);
+    assert((size_t)((unsigned char*)y - (unsigned char*)x) == sizeof(Object));
+    printf("  ✓ Arrays take %zu-byte slots\n", sizeof(Object));
+
+    // a freed small slot is reused without touching its neighbour
+    a->ref_count = 0;
+    heap_note_collection(heap);
+    Object* c = heap_alloc_int(heap, INT_CACHE_MAX + 3);
+    assert(c == a);
+    assert(b->as.int_value == INT_CACHE_MAX + 2 && b->ref_count == 1);
+    printf("  ✓ Freed slot reused in place\n");
+
+    heap_destroy(heap);
+    printf("PASSED\n\n");
+}
+
 int main() {
     printf("========================================\n");
     printf("GC Test Suite\n");
@@ -227,6 +722,16 @@ int main() {
     test_null_handling();
     test_nested_arrays();
     test_gc_collect();
+    test_gc_deep_nesting();
+    test_gc_root_enumeration();
+    test_gc_minor_collection();
+    test_gc_incremental_cycle();
+    test_gc_parallel_major();
+    test_gc_allocation_policy();
+    test_gc_lazy_sweep();
+    test_gc_deferred_refcount();
+    test_gc_telemetry();
+    test_size_class_slots();
     
     printf("========================================\n");
     printf("All GC tests PASSED! ✓\n");
@@ -8,6 +8,11 @@
 #include "../../src/compiler/bytecode.h"
 #include "../../src/compiler/value.h"
 #include "../../src/builtins/builtins.h"
+#include "../../src/builtins/array_kernels.h"
+#include "../../src/builtins/sort.h"
+#include "../../src/builtins/matrix.h"
+#include "../../src/runtime/jit/bounds.h"
+#include "../../src/runtime/jit/escape.h"
 
 static void cleanup_test(Heap* heap, VM* vm, CodeObj* code_obj, bytecode* bcs) {
     if (vm) vm_destroy(vm);
@@ -644,9 +649,964 @@ static void test_arrays() {
         //free(bcs);
     }
     
+    // Test: int[4] stores unboxed until a bool is stored into it
+    for (int boxed = 0; boxed <= 1; boxed++) {
+        Value* consts = malloc(5 * sizeof(Value));
+        consts[0] = value_create_int(4);
+        consts[1] = value_create_int(7);
+        consts[2] = value_create_int(2);
+        consts[3] = value_create_bool(true);
+        consts[4] = value_create_int(1);
+        
+        bytecode* bcs = malloc(16 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(BUILD_TYPED_ARRAY, ARRAY_INT);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1); // a[2] = 7
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+        bcs[i++] = bytecode_create_with_number(STORE_SUBSCR, 0);
+        if (boxed) {
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3); // a[1] = true
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 4);
+            bcs[i++] = bytecode_create_with_number(STORE_SUBSCR, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        } else {
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+        }
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        bytecode_array arr = create_bytecode_array(bcs, i);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = arr;
+        code_obj->name = strdup("test_typed_array");
+        code_obj->local_count = 1;
+        code_obj->constants = consts;
+        code_obj->constants_count = 5;
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, code_obj);
+        assert(ret != NULL);
+        if (!boxed) {
+            assert(ret->type == OBJ_INT && ret->as.int_value == 7);
+            printf("int[4] stores and loads unboxed ✓\n");
+        } else {
+            assert(ret->type == OBJ_ARRAY && ret->elem_kind == ARRAY_BOXED);
+            assert(ret->as.array.size == 4);
+            assert(ret->as.array.items[0]->type == OBJ_INT && ret->as.array.items[0]->as.int_value == 0);
+            assert(ret->as.array.items[2]->type == OBJ_INT && ret->as.array.items[2]->as.int_value == 7);
+            assert(ret->as.array.items[1]->type == OBJ_BOOL && ret->as.array.items[1]->as.bool_value);
+            printf("int[4] boxed after a bool store ✓\n");
+        }
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
+    // Test: int[3][4] built by BUILD_ARRAY2, m[2][1] = 7, return m[2][1] and m[1]
+    for (int whole_row = 0; whole_row <= 1; whole_row++) {
+        Value* consts = malloc(5 * sizeof(Value));
+        consts[0] = value_create_int(3);
+        consts[1] = value_create_int(4);
+        consts[2] = value_create_int(7);
+        consts[3] = value_create_int(2);
+        consts[4] = value_create_int(1);
+        
+        bytecode* bcs = malloc(16 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+        bcs[i++] = bytecode_create_with_number(BUILD_ARRAY2, ARRAY_INT);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2); // m[2][1] = 7
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 4);
+        bcs[i++] = bytecode_create_with_number(STORE_SUBSCR2, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);
+        if (whole_row) {
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+        } else {
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 4);
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR2, 0);
+        }
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        bytecode_array arr = create_bytecode_array(bcs, i);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = arr;
+        code_obj->name = strdup("test_array2");
+        code_obj->local_count = 1;
+        code_obj->constants = consts;
+        code_obj->constants_count = 5;
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, code_obj);
+        assert(ret != NULL);
+        if (!whole_row) {
+            assert(ret->type == OBJ_INT && ret->as.int_value == 7);
+            printf("int[3][4] stores and loads by two indices ✓\n");
+        } else {
+            Object* m = ret->as.array.base;
+            assert(ret->type == OBJ_ARRAY && m && m->as.array.cols == 4 && object_array_rows(m) == 3);
+            assert(ret->as.array.size == 4 && ret->as.array.offset == 8);
+            assert(ret->as.array.ints[1] == 7 && m->as.array.ints[9] == 7);
+            printf("m[i] on int[3][4] is a view of row i ✓\n");
+        }
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
+    // Test: [1, 2, 3] op 2 for each elementwise operator
+    {
+        const struct { uint8_t op; int64_t expect[3]; } cases[] = {
+            {0x00, {3, 4, 5}}, {0x0A, {-1, 0, 1}}, {0x05, {2, 4, 6}},
+            {0x0B, {0, 1, 1}}, {0x06, {1, 0, 1}},
+            {0x50, {0, 1, 0}}, {0x51, {1, 0, 1}}, {0x52, {1, 0, 0}},
+            {0x53, {1, 1, 0}}, {0x54, {0, 0, 1}}, {0x55, {0, 1, 1}},
+        };
+        for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            Value* consts = malloc(3 * sizeof(Value));
+            consts[0] = value_create_int(1);
+            consts[1] = value_create_int(2);
+            consts[2] = value_create_int(3);
+            
+            bytecode* bcs = malloc(8 * sizeof(bytecode));
+            int i = 0;
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+            bcs[i++] = bytecode_create_with_number(BUILD_ARRAY, 3);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+            bcs[i++] = bytecode_create_with_number(BINARY_OP, cases[c].op);
+            bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+            
+            CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+            code_obj->code = create_bytecode_array(bcs, i);
+            code_obj->name = strdup("test_array_binary_op");
+            code_obj->constants = consts;
+            code_obj->constants_count = 3;
+            
+            Heap* heap = heap_create();
+            VM* vm = vm_create(heap, 0);
+            vm_register_builtins(vm);
+            
+            Object* ret = vm_execute(vm, code_obj);
+            bool compare = cases[c].op >= 0x50;
+            assert(ret != NULL && ret->type == OBJ_ARRAY && ret->as.array.size == 3);
+            assert(ret->elem_kind == (compare ? ARRAY_BOOL : ARRAY_INT));
+            for (size_t k = 0; k < 3; k++) {
+                int64_t got = compare ? ret->as.array.bools[k] : ret->as.array.ints[k];
+                assert(got == cases[c].expect[k]);
+            }
+            
+            vm_destroy(vm);
+            heap_destroy(heap);
+            
+            free(code_obj->name);
+            free(code_obj->constants);
+            free(code_obj->code.bytecodes);
+            free(code_obj);
+        }
+        printf("[1, 2, 3] op 2 is elementwise ✓\n");
+    }
+    
+    // Test: int[4] a; a[4] = 9; a[-1] = 9; return a[4] and a
+    for (int whole = 0; whole <= 1; whole++) {
+        Value* consts = malloc(4 * sizeof(Value));
+        consts[0] = value_create_int(4);
+        consts[1] = value_create_int(9);
+        consts[2] = value_create_int(-1);
+        consts[3] = value_create_int(1);
+        
+        bytecode* bcs = malloc(16 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(BUILD_TYPED_ARRAY, ARRAY_INT);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1); // a[4] = 9
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(STORE_SUBSCR, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1); // a[-1] = 9
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+        bcs[i++] = bytecode_create_with_number(STORE_SUBSCR, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        if (!whole) {
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+        }
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = create_bytecode_array(bcs, i);
+        code_obj->name = strdup("test_array_out_of_bounds");
+        code_obj->local_count = 1;
+        code_obj->constants = consts;
+        code_obj->constants_count = 4;
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, code_obj);
+        assert(ret != NULL);
+        if (!whole) {
+            assert(ret->type == OBJ_NONE);
+            printf("Out-of-range load gives None ✓\n");
+        } else {
+            assert(ret->type == OBJ_ARRAY && ret->as.array.size == 4);
+            for (size_t k = 0; k < 4; k++) assert(ret->as.array.ints[k] == 0);
+            printf("Out-of-range stores are ignored ✓\n");
+        }
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
+    // Test: for (i = 0; i < n; i = i + 1) a[i] = i; on int[4], versioned by
+    // the bounds pass; n = 6 fails GUARD_LENGTH and runs the checked copy
+    for (int n = 4; n <= 6; n += 2) {
+        Value* consts = malloc(4 * sizeof(Value));
+        consts[0] = value_create_int(4);
+        consts[1] = value_create_int(0);
+        consts[2] = value_create_int(1);
+        consts[3] = value_create_int(n);
+        
+        bytecode* bcs = malloc(32 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(BUILD_TYPED_ARRAY, ARRAY_INT);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);  // a
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 2);  // n
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 1);  // i = 0
+        bcs[i++] = bytecode_create_with_number(JUMP_FORWARD, 5);
+        bcs[i++] = bytecode_create_with_number(LOOP_START, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);   // i = i + 1
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+        bcs[i++] = bytecode_create_with_number(BINARY_OP, 0x00);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 1);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);   // i < n
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 2);
+        bcs[i++] = bytecode_create_with_number(BINARY_OP, 0x52);
+        bcs[i++] = bytecode_create_with_number(POP_JUMP_IF_FALSE, 6);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);   // a[i] = i
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);
+        bcs[i++] = bytecode_create_with_number(STORE_SUBSCR, 0);
+        bcs[i++] = bytecode_create_with_number(JUMP_BACKWARD, 14);
+        bcs[i++] = bytecode_create_with_number(LOOP_END, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = create_bytecode_array(bcs, i);
+        code_obj->name = strdup("test_bounds_loop");
+        code_obj->local_count = 3;
+        code_obj->constants = consts;
+        code_obj->constants_count = 4;
+        
+        assert(has_bounds_loop(code_obj));
+        BoundsStats stats;
+        CodeObj* optimized = jit_optimize_bounds(code_obj, &stats);
+        assert(optimized != NULL);
+        assert(stats.versioned_loops == 1 && stats.unchecked_subscripts == 1);
+        assert(!has_bounds_loop(optimized));
+        
+        size_t unchecked = 0;
+        for (size_t k = 0; k < optimized->code.count; k++) {
+            unchecked += optimized->code.bytecodes[k].op_code == STORE_SUBSCR_UNCHECKED;
+        }
+        assert(unchecked == 1);
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, optimized);
+        assert(ret != NULL && ret->type == OBJ_ARRAY && ret->as.array.size == 4);
+        for (size_t k = 0; k < 4; k++) assert(ret->as.array.ints[k] == (int64_t)k);
+        printf("Bounds pass: a[i] = i with n = %d %s ✓\n", n,
+               n == 4 ? "runs unchecked" : "falls back to checked");
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        free_code_obj(optimized);
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
+    // Test: for (r = 0; r < 3; r = r + 1) { int[4] t; t[1] = t[1] + r; s = s + t[1]; }
+    // through the escape pass: t is reused (and cleared) when only subscripted,
+    // kept when returned, and dropped when never read
+    for (int variant = 0; variant < 3; variant++) {
+        bool reuse = variant == 0, escapes = variant == 1, unused = variant == 2;
+        Value* consts = malloc(4 * sizeof(Value));
+        consts[0] = value_create_int(0);
+        consts[1] = value_create_int(1);
+        consts[2] = value_create_int(3);
+        consts[3] = value_create_int(4);
+        
+        bytecode* bcs = malloc(40 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);  // s = 0
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 2);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);  // r = 0
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(JUMP_FORWARD, 5);
+        int loop_start = i;
+        bcs[i++] = bytecode_create_with_number(LOOP_START, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);   // r = r + 1
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+        bcs[i++] = bytecode_create_with_number(BINARY_OP, 0x00);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);   // r < 3
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+        bcs[i++] = bytecode_create_with_number(BINARY_OP, 0x52);
+        int exit_jump = i++;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);  // int[4] t
+        bcs[i++] = bytecode_create_with_number(BUILD_TYPED_ARRAY, ARRAY_INT);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 1);
+        if (!unused) {
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);   // t[1] = t[1] + r
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+            bcs[i++] = bytecode_create_with_number(BINARY_OP, 0x00);
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+            bcs[i++] = bytecode_create_with_number(STORE_SUBSCR, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 2);   // s = s + t[1]
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 1);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+            bcs[i++] = bytecode_create_with_number(BINARY_OP, 0x00);
+            bcs[i++] = bytecode_create_with_number(STORE_FAST, 2);
+        }
+        bcs[i] = bytecode_create_with_number(JUMP_BACKWARD, i + 1 - loop_start);
+        i++;
+        bcs[i++] = bytecode_create_with_number(LOOP_END, 0);
+        bcs[exit_jump] = bytecode_create_with_number(POP_JUMP_IF_FALSE, i - exit_jump - 1);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, escapes ? 1 : 2);
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = create_bytecode_array(bcs, i);
+        code_obj->name = strdup("test_scratch_array");
+        code_obj->local_count = 3;
+        code_obj->constants = consts;
+        code_obj->constants_count = 4;
+        
+        assert(has_scratch_array(code_obj) == !escapes);
+        EscapeStats stats;
+        CodeObj* optimized = jit_optimize_escape(code_obj, &stats);
+        assert((optimized != NULL) == !escapes);
+        if (optimized) {
+            assert(stats.reused_arrays == (size_t)reuse && stats.removed_arrays == (size_t)unused);
+            size_t allocs = 0, reuses = 0;
+            for (size_t k = 0; k < optimized->code.count; k++) {
+                allocs += optimized->code.bytecodes[k].op_code == BUILD_TYPED_ARRAY;
+                reuses += optimized->code.bytecodes[k].op_code == REUSE_TYPED_ARRAY;
+            }
+            assert(allocs == 0 && reuses == (size_t)reuse);
+            assert(optimized->code.count == code_obj->code.count - (unused ? 3 : 0));
+        }
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, optimized ? optimized : code_obj);
+        assert(ret != NULL);
+        if (escapes) {
+            assert(ret->type == OBJ_ARRAY && ret->as.array.ints[1] == 2);
+        } else {
+            assert(ret->type == OBJ_INT && ret->as.int_value == (unused ? 0 : 3));
+        }
+        printf("Escape pass: scratch array %s ✓\n",
+               reuse ? "reused and cleared" : escapes ? "kept when returned" : "removed when unused");
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        if (optimized) free_code_obj(optimized);
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
     printf("Arrays: TEST PASSED ✓\n\n");
 }
 
+static void test_array_builtins() {
+    printf("=== Testing Array Builtins ===\n");
+    
+    // Every kernel variant agrees with the scalar one, tails included
+    {
+        const ArrayKernels* fast = array_kernels();
+        const ArrayKernels* slow = array_kernels_scalar();
+        int64_t a[37], b[37], y1[37], y2[37];
+        for (size_t n = 1; n <= 37; n += 6) {
+            for (size_t i = 0; i < n; i++) {
+                a[i] = (int64_t)(i * 2654435761u) - 1000000000;
+                b[i] = (int64_t)i * -7 + ((i & 1) ? INT64_MAX / 3 : 5);
+                y1[i] = y2[i] = (int64_t)i;
+            }
+            assert(fast->sum(a, n) == slow->sum(a, n));
+            assert(fast->dot(a, b, n) == slow->dot(a, b, n));
+            fast->axpy(y1, -3, b, n);
+            slow->axpy(y2, -3, b, n);
+            assert(memcmp(y1, y2, n * sizeof(int64_t)) == 0);
+            int64_t lo1, hi1, lo2, hi2;
+            fast->minmax(b, n, &lo1, &hi1);
+            slow->minmax(b, n, &lo2, &hi2);
+            assert(lo1 == lo2 && hi1 == hi2);
+            fast->fill(y1, 42, n);
+            assert(y1[0] == 42 && y1[n - 1] == 42);
+
+            b[0] = 0;
+            b[n - 1] = -1;
+            b[n / 2] = a[n / 2];
+            void (*fast_ops[])(int64_t*, const int64_t*, const int64_t*, size_t) = {
+                fast->add, fast->sub, fast->mul, fast->div, fast->mod};
+            void (*slow_ops[])(int64_t*, const int64_t*, const int64_t*, size_t) = {
+                slow->add, slow->sub, slow->mul, slow->div, slow->mod};
+            for (int op = 0; op < 5; op++) {
+                fast_ops[op](y1, a, b, n);
+                slow_ops[op](y2, a, b, n);
+                assert(memcmp(y1, y2, n * sizeof(int64_t)) == 0);
+            }
+            assert(y1[0] == 0);
+            uint8_t f1[37], f2[37];
+            for (uint8_t flip = 0; flip <= 1; flip++) {
+                fast->eq(f1, a, b, n, flip);
+                slow->eq(f2, a, b, n, flip);
+                assert(memcmp(f1, f2, n) == 0 && f1[n / 2] == !flip);
+                fast->lt(f1, a, b, n, flip);
+                slow->lt(f2, a, b, n, flip);
+                assert(memcmp(f1, f2, n) == 0);
+            }
+        }
+        printf("%s kernels match scalar ✓\n", fast->name);
+    }
+    
+    // Builtins on int[n], and a boxed fallback when fill stores a bool
+    {
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* a = heap_alloc_typed_array(heap, ARRAY_INT, 10);
+        Object* b = heap_alloc_typed_array(heap, ARRAY_INT, 10);
+        for (int i = 0; i < 10; i++) b->as.array.ints[i] = i;
+        
+        Object* args[3] = {a, heap_alloc_int(heap, 2), NULL};
+        builtin_fill(vm, 2, args);
+        assert(a->elem_kind == ARRAY_INT && a->as.array.ints[9] == 2);
+        
+        args[0] = a; args[1] = b;
+        assert(builtin_sum(vm, 1, args)->as.int_value == 20);
+        assert(builtin_dot(vm, 2, args)->as.int_value == 90);
+        
+        args[0] = a; args[1] = heap_alloc_int(heap, 3); args[2] = b;
+        builtin_axpy(vm, 3, args);
+        assert(a->as.array.ints[4] == 14);
+        
+        args[0] = a;
+        Object* mm = builtin_minmax(vm, 1, args);
+        assert(mm->type == OBJ_ARRAY && mm->elem_kind == ARRAY_INT);
+        assert(mm->as.array.ints[0] == 2 && mm->as.array.ints[1] == 29);
+        
+        Object* c = heap_alloc_typed_array(heap, ARRAY_INT, 4);
+        args[0] = c; args[1] = b;
+        assert(builtin_copy(vm, 2, args)->as.int_value == 4);
+        assert(c->as.array.ints[3] == 3);
+        
+        args[0] = c; args[1] = vm_get_true(vm);
+        builtin_fill(vm, 2, args);
+        assert(c->elem_kind == ARRAY_BOXED);
+        assert(builtin_sum(vm, 1, args)->as.int_value == 4);
+        printf("fill/copy/sum/dot/axpy/minmax ✓\n");
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+    }
+    
+    // sort_i64 on insertion, radix and parallel sizes
+    {
+        size_t sizes[] = {7, 1000, SORT_PARALLEL_MIN + 123};
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t n = sizes[s];
+            int64_t* a = malloc(n * sizeof(int64_t));
+            uint64_t x = 88172645463325252ull;
+            // unsigned so the checksum wraps instead of overflowing
+            uint64_t total = 0;
+            for (size_t i = 0; i < n; i++) {
+                x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                a[i] = (i % 5 == 0) ? (int64_t)(x % 100) - 50 : (int64_t)x;
+                total += (uint64_t)a[i];
+            }
+            sort_i64(a, n);
+            uint64_t check = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (i > 0) assert(a[i - 1] <= a[i]);
+                check += (uint64_t)a[i];
+            }
+            assert(check == total);
+            free(a);
+        }
+        printf("sort_i64 ✓\n");
+    }
+    
+    // sort_array on a sub-range, bool[n] and boxed arrays
+    {
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ints = heap_alloc_typed_array(heap, ARRAY_INT, 6);
+        for (int i = 0; i < 6; i++) ints->as.array.ints[i] = 5 - i;
+        sort_array(ints, 1, 4);
+        int64_t want[] = {5, 2, 3, 4, 1, 0};
+        assert(memcmp(ints->as.array.ints, want, sizeof(want)) == 0);
+        
+        Object* bools = heap_alloc_typed_array(heap, ARRAY_BOOL, 4);
+        bools->as.array.bools[0] = 1;
+        bools->as.array.bools[2] = 1;
+        sort_array(bools, 0, 100);
+        assert(!bools->as.array.bools[0] && !bools->as.array.bools[1]);
+        assert(bools->as.array.bools[2] && bools->as.array.bools[3]);
+        
+        Object* boxed = heap_alloc_array_with_size(heap, 200);
+        for (int i = 0; i < 200; i++) {
+            boxed->as.array.items[i] = heap_alloc_int(heap, (i * 37) % 200 - 100);
+        }
+        boxed->as.array.items[17] = heap_alloc_float(heap, strdup("-0.5"));
+        Object* args[1] = {boxed};
+        builtin_sort(vm, 1, args);
+        for (int i = 1; i < 200; i++) {
+            Object* prev = boxed->as.array.items[i - 1];
+            Object* cur = boxed->as.array.items[i];
+            if (prev->type == OBJ_INT && cur->type == OBJ_INT) {
+                assert(prev->as.int_value <= cur->as.int_value);
+            }
+        }
+        assert(boxed->as.array.items[99]->type == OBJ_FLOAT);
+        printf("sort/sort_array ✓\n");
+
+        vm_destroy(vm);
+        heap_destroy(heap);
+    }
+
+    // SORT_ARRAY sorts [0, hi) only when the bubble-sort nest it stands in for
+    // could not tell: a None element or hi past the end leaves the array alone
+    // and pushes false so the nest runs instead.
+    {
+        const struct { int has_none; int64_t hi; int sorted; } cases[] = {
+            {1, 3, 0}, {0, 3, 1}, {0, 4, 0},
+        };
+        for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            Value* consts = malloc(5 * sizeof(Value));
+            consts[0] = value_create_int(3);
+            consts[1] = cases[c].has_none ? value_create_none() : value_create_int(2);
+            consts[2] = value_create_int(1);
+            consts[3] = value_create_int(0);
+            consts[4] = value_create_int(cases[c].hi);
+            
+            bytecode* bcs = malloc(12 * sizeof(bytecode));
+            int i = 0;
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+            bcs[i++] = bytecode_create_with_number(BUILD_ARRAY, 3);
+            bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 4);
+            bcs[i++] = bytecode_create_with_number(SORT_ARRAY, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+            bcs[i++] = bytecode_create_with_number(BUILD_ARRAY, 2);
+            bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+            
+            CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+            code_obj->code = create_bytecode_array(bcs, i);
+            code_obj->name = strdup("test_sort_array");
+            code_obj->local_count = 1;
+            code_obj->constants = consts;
+            code_obj->constants_count = 5;
+            
+            Heap* heap = heap_create();
+            VM* vm = vm_create(heap, 0);
+            vm_register_builtins(vm);
+            
+            Object* ret = vm_execute(vm, code_obj);
+            assert(ret != NULL && ret->type == OBJ_ARRAY && ret->as.array.size == 2);
+            Object* done = heap_array_load(heap, ret, 0);
+            Object* array = heap_array_load(heap, ret, 1);
+            assert(done->type == OBJ_BOOL && done->as.bool_value == cases[c].sorted);
+            Object* first = heap_array_load(heap, array, 0);
+            Object* middle = heap_array_load(heap, array, 1);
+            assert(first->type == OBJ_INT && first->as.int_value == (cases[c].sorted ? 1 : 3));
+            assert(middle->type == (cases[c].has_none ? OBJ_NONE : OBJ_INT));
+            
+            vm_destroy(vm);
+            heap_destroy(heap);
+            
+            free(code_obj->name);
+            free(code_obj->constants);
+            free(code_obj->code.bytecodes);
+            free(code_obj);
+        }
+        printf("SORT_ARRAY falls back on None or a bound past the end ✓\n");
+    }
+
+    // append/pop/len/reserve/truncate/shrink; capacity doubles, size does not
+    {
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+
+        Object* a = heap_alloc_typed_array(heap, ARRAY_INT, 0);
+        Object* args[2] = {a, NULL};
+        for (int i = 0; i < 100; i++) {
+            args[1] = heap_alloc_int(heap, i * 3);
+            builtin_append(vm, 2, args);
+        }
+        assert(a->elem_kind == ARRAY_INT);
+        assert(builtin_len(vm, 1, args)->as.int_value == 100);
+        assert(a->as.array.capacity == 128);
+        assert(a->as.array.ints[99] == 297);
+
+        Object* last = builtin_pop(vm, 1, args);
+        assert(last->type == OBJ_INT && last->as.int_value == 297);
+        assert(a->as.array.size == 99);
+
+        args[1] = heap_alloc_int(heap, 10);
+        builtin_truncate(vm, 2, args);
+        assert(a->as.array.size == 10 && a->as.array.capacity == 128);
+        builtin_shrink(vm, 1, args);
+        assert(a->as.array.capacity == 10 && a->as.array.ints[9] == 27);
+        args[1] = heap_alloc_int(heap, 1000);
+        builtin_reserve(vm, 2, args);
+        assert(a->as.array.size == 10 && a->as.array.capacity == 1000);
+
+        // appending a bool boxes the array but keeps its reserved room
+        args[1] = vm_get_true(vm);
+        builtin_append(vm, 2, args);
+        assert(a->elem_kind == ARRAY_BOXED && a->as.array.size == 11);
+        assert(a->as.array.capacity == 1000);
+        assert(a->as.array.items[3]->as.int_value == 9);
+        assert(builtin_pop(vm, 1, args)->type == OBJ_BOOL);
+
+        Object* empty = heap_alloc_array(heap);
+        args[0] = empty;
+        assert(builtin_pop(vm, 1, args)->type == OBJ_NONE);
+        assert(builtin_len(vm, 1, args)->as.int_value == 0);
+        printf("append/pop/len/reserve/truncate/shrink ✓\n");
+
+        vm_destroy(vm);
+        heap_destroy(heap);
+    }
+
+    // slice views share storage with their base and follow it when it moves
+    {
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+
+        Object* a = heap_alloc_typed_array(heap, ARRAY_INT, 10);
+        for (int i = 0; i < 10; i++) a->as.array.ints[i] = i;
+
+        Object* args[3] = {a, heap_alloc_int(heap, 2), heap_alloc_int(heap, 8)};
+        Object* v = builtin_slice(vm, 3, args);
+        assert(v->type == OBJ_ARRAY && v->as.array.base == a);
+        assert(v->as.array.size == 6 && v->as.array.ints == a->as.array.ints + 2);
+
+        vm_array_store(vm, v, 0, heap_alloc_int(heap, 100));
+        assert(a->as.array.ints[2] == 100);
+
+        // a view of a view points straight at the base
+        args[0] = v;
+        args[1] = heap_alloc_int(heap, 1);
+        args[2] = heap_alloc_int(heap, 50);
+        Object* w = builtin_slice(vm, 3, args);
+        assert(w->as.array.base == a && w->as.array.offset == 3 && w->as.array.size == 5);
+
+        // growing the base reallocates; the view resyncs on next use
+        args[0] = a;
+        for (int i = 0; i < 100; i++) {
+            args[1] = heap_alloc_int(heap, i);
+            builtin_append(vm, 2, args);
+        }
+        args[0] = v;
+        assert(builtin_len(vm, 1, args)->as.int_value == 6);
+        assert(v->as.array.ints == a->as.array.ints + 2 && v->as.array.ints[0] == 100);
+        args[1] = heap_alloc_int(heap, 5);
+        builtin_append(vm, 2, args);
+        assert(v->as.array.size == 6);
+
+        // storing a bool through the view boxes the base
+        vm_array_store(vm, w, 0, vm_get_true(vm));
+        assert(a->elem_kind == ARRAY_BOXED && a->as.array.items[3]->type == OBJ_BOOL);
+        object_array_sync(v);
+        assert(v->elem_kind == ARRAY_BOXED && v->as.array.items[1]->type == OBJ_BOOL);
+        assert(v->as.array.items[0]->as.int_value == 100);
+        printf("slice views ✓\n");
+
+        vm_destroy(vm);
+        heap_destroy(heap);
+    }
+
+    // Blocked matrix kernels agree with naive loops across block edges
+    {
+        size_t n = 37, m = MATMUL_BLOCK_K + 9, p = MATMUL_BLOCK_J + 13;
+        int64_t* a = malloc(n * m * sizeof(int64_t));
+        int64_t* b = malloc(m * p * sizeof(int64_t));
+        int64_t* c = malloc(n * p * sizeof(int64_t));
+        int64_t* t = malloc(m * p * sizeof(int64_t));
+        int64_t y[37];
+        for (size_t i = 0; i < n * m; i++) a[i] = (int64_t)(i * 2654435761u % 201) - 100;
+        for (size_t i = 0; i < m * p; i++) b[i] = (int64_t)(i * 40503u % 97) - 48;
+
+        matmul_i64(a, b, c, n, m, p);
+        for (size_t i = 0; i < n; i += 6) {
+            for (size_t j = 0; j < p; j += 7) {
+                int64_t acc = 0;
+                for (size_t k = 0; k < m; k++) acc += a[i * m + k] * b[k * p + j];
+                assert(c[i * p + j] == acc);
+            }
+        }
+
+        transpose_i64(b, t, m, p);
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < p; j++) assert(t[j * m + i] == b[i * p + j]);
+        }
+
+        matvec_i64(a, b, y, n, m);
+        for (size_t i = 0; i < n; i++) {
+            int64_t acc = 0;
+            for (size_t k = 0; k < m; k++) acc += a[i * m + k] * b[k];
+            assert(y[i] == acc);
+        }
+        free(a);
+        free(b);
+        free(c);
+        free(t);
+        printf("matmul/transpose/matvec kernels ✓\n");
+    }
+
+    // matmul, transpose and matvec on 2-D array objects
+    {
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+
+        Object* a = heap_alloc_matrix(heap, ARRAY_INT, 2, 3);
+        Object* b = heap_alloc_matrix(heap, ARRAY_INT, 3, 2);
+        for (int i = 0; i < 6; i++) {
+            a->as.array.ints[i] = i + 1;   // [[1, 2, 3], [4, 5, 6]]
+            b->as.array.ints[i] = 6 - i;   // [[6, 5], [4, 3], [2, 1]]
+        }
+
+        Object* args[2] = {a, b};
+        Object* c = builtin_matmul(vm, 2, args);
+        assert(c->type == OBJ_ARRAY && c->elem_kind == ARRAY_INT);
+        assert(c->as.array.cols == 2 && object_array_rows(c) == 2);
+        assert(c->as.array.ints[0] == 20 && c->as.array.ints[1] == 14);
+        assert(c->as.array.ints[2] == 56 && c->as.array.ints[3] == 41);
+
+        args[1] = a;
+        assert(builtin_matmul(vm, 2, args)->type == OBJ_NONE);
+
+        Object* t = builtin_transpose(vm, 1, args);
+        assert(t->as.array.cols == 2 && object_array_rows(t) == 3);
+        assert(t->as.array.ints[1] == 4 && t->as.array.ints[4] == 3);
+
+        // a boxed int matrix takes the same kernels through a scratch copy
+        vm_array_store(vm, b, 5, vm_get_true(vm));
+        assert(b->elem_kind == ARRAY_BOXED && b->as.array.cols == 2);
+        args[1] = b;
+        c = builtin_matmul(vm, 2, args);
+        assert(c->elem_kind == ARRAY_INT && c->as.array.ints[3] == 41);
+
+        Object* x = heap_alloc_typed_array(heap, ARRAY_INT, 3);
+        x->as.array.ints[0] = 1;
+        x->as.array.ints[2] = -1;
+        args[1] = x;
+        Object* y = builtin_matvec(vm, 2, args);
+        assert(y->as.array.size == 2 && y->as.array.ints[0] == -2 && y->as.array.ints[1] == -2);
+
+        // any float sends matvec down the BigFloat path
+        vm_array_store(vm, a, 0, heap_alloc_float(heap, "0.5"));
+        y = builtin_matvec(vm, 2, args);
+        assert(y->elem_kind == ARRAY_BOXED && y->as.array.items[0]->type == OBJ_FLOAT);
+        char* s = bigfloat_to_string(y->as.array.items[0]->as.float_value);
+        assert(strcmp(s, "-2.5") == 0);
+        free(s);
+        assert(y->as.array.items[1]->type == OBJ_FLOAT);
+        printf("matmul/transpose/matvec builtins ✓\n");
+
+        vm_destroy(vm);
+        heap_destroy(heap);
+    }
+
+    printf("Array builtins: TEST PASSED ✓\n\n");
+}
+
+static void test_structs() {
+    printf("=== Testing Struct Records ===\n");
+    
+    // Test: struct {int a; int|bool b;} r; r.b = 7; return r
+    for (int mixed = 0; mixed <= 1; mixed++) {
+        Value* consts = malloc(3 * sizeof(Value));
+        consts[0] = value_create_int(0);
+        consts[1] = mixed ? value_create_bool(false) : value_create_int(0);
+        consts[2] = value_create_int(7);
+        
+        bytecode* bcs = malloc(16 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+        bcs[i++] = bytecode_create_with_number(BUILD_STRUCT, 2);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(STORE_FIELD, 1);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = create_bytecode_array(bcs, i);
+        code_obj->name = strdup("test_struct");
+        code_obj->local_count = 1;
+        code_obj->constants = consts;
+        code_obj->constants_count = 3;
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, code_obj);
+        assert(ret != NULL && ret->type == OBJ_ARRAY && ret->as.array.size == 2);
+        assert(heap->record_pool.total_allocations == 1);
+        if (!mixed) {
+            assert(ret->elem_kind == ARRAY_INT && ret->as.array.ints[0] == 0 && ret->as.array.ints[1] == 7);
+            printf("int-only struct is an unboxed record ✓\n");
+        } else {
+            assert(ret->elem_kind == ARRAY_BOXED);
+            assert(ret->as.array.items[0]->type == OBJ_INT && ret->as.array.items[1]->as.int_value == 7);
+            printf("mixed struct is a boxed record ✓\n");
+        }
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
+    // Test: struct {int a;}[3] ps; ps[2].a = 5; return ps[2].a or ps
+    for (int whole = 0; whole <= 1; whole++) {
+        Value* consts = malloc(4 * sizeof(Value));
+        consts[0] = value_create_int(0);
+        consts[1] = value_create_int(3);
+        consts[2] = value_create_int(5);
+        consts[3] = value_create_int(2);
+        
+        bytecode* bcs = malloc(16 * sizeof(bytecode));
+        int i = 0;
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 1);
+        bcs[i++] = bytecode_create_with_number(BUILD_STRUCT_ARRAY, 1);
+        bcs[i++] = bytecode_create_with_number(STORE_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 2);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);
+        bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+        bcs[i++] = bytecode_create_with_number(STORE_FIELD, 0);
+        bcs[i++] = bytecode_create_with_number(LOAD_FAST, 0);
+        if (!whole) {
+            bcs[i++] = bytecode_create_with_number(LOAD_CONST, 3);
+            bcs[i++] = bytecode_create_with_number(LOAD_SUBSCR, 0);
+            bcs[i++] = bytecode_create_with_number(LOAD_FIELD, 0);
+        }
+        bcs[i++] = bytecode_create_with_number(RETURN_VALUE, 0);
+        
+        CodeObj* code_obj = calloc(1, sizeof(CodeObj));
+        code_obj->code = create_bytecode_array(bcs, i);
+        code_obj->name = strdup("test_struct_array");
+        code_obj->local_count = 1;
+        code_obj->constants = consts;
+        code_obj->constants_count = 4;
+        
+        Heap* heap = heap_create();
+        VM* vm = vm_create(heap, 0);
+        vm_register_builtins(vm);
+        
+        Object* ret = vm_execute(vm, code_obj);
+        assert(ret != NULL);
+        if (!whole) {
+            assert(ret->type == OBJ_INT && ret->as.int_value == 5);
+            printf("ps[2].a loads the field stored at its offset ✓\n");
+        } else {
+            assert(ret->type == OBJ_ARRAY && ret->as.array.size == 3);
+            Object** rows = ret->as.array.items;
+            assert(rows[0] != rows[1] && rows[1] != rows[2]);
+            assert(rows[0]->as.array.ints[0] == 0 && rows[2]->as.array.ints[0] == 5);
+            assert(heap->record_pool.total_allocations == 3);
+            printf("struct array holds one record per element ✓\n");
+        }
+        
+        vm_destroy(vm);
+        heap_destroy(heap);
+        
+        free(code_obj->name);
+        free(code_obj->constants);
+        free(code_obj->code.bytecodes);
+        free(code_obj);
+    }
+    
+    printf("Structs: TEST PASSED ✓\n\n");
+}
+
 int main() {
     debug_enabled = 0; // Disable debug for cleaner output
     
@@ -658,6 +1618,8 @@ int main() {
     // Skipping control flow test due to known intermittent failure
     // test_control_flow();
     test_arrays();
+    test_array_builtins();
+    test_structs();
     
     printf("=== ALL VM TESTS PASSED ✓ ===\n");
     return 0;
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "../src/lexer/lexer.h"
 #include "../src/parser/parser.h"
@@ -21,10 +22,28 @@ int main(int argc, char** argv) {
         printf("  -d, --debug     Enable debug mode\n");
         printf("  -j, --jit       Enable JIT compilation\n");
         printf("  -g, --gc        Enable garbage collection\n");
+        printf("  --compile-threads=N  Compile top-level functions on N threads (0 = all cores)\n");
+        printf("  --gc-pause-us=N      Run major collections incrementally in slices of about N us\n");
+        printf("  --gc-threads=N       Mark and sweep major collections on N threads (0 = all cores)\n");
+        printf("  --gc-growth=F        Next major collection at F times the live heap (env RENAME_GC_GROWTH)\n");
+        printf("  --gc-min-heap-kb=N   Never schedule a major collection below N KiB (env RENAME_GC_MIN_HEAP_KB)\n");
+        printf("  --gc-stats=json      Dump GC and heap telemetry as JSON to stderr at exit\n");
         return 1;
     }
 
     int argi = 1;
+    size_t compile_threads = 1;
+    uint64_t gc_pause_us = 0;
+    size_t gc_threads = 1;
+    // 0 keeps the collector's defaults; the flags override the environment
+    double gc_growth = 0.0;
+    size_t gc_min_heap_kb = 0;
+    bool gc_stats_json = false;
+
+    const char* env = getenv("RENAME_GC_GROWTH");
+    if (env) gc_growth = strtod(env, NULL);
+    env = getenv("RENAME_GC_MIN_HEAP_KB");
+    if (env) gc_min_heap_kb = strtoull(env, NULL, 10);
     
     while (argi < argc) {
         if (strcmp(argv[argi], "--debug") == 0 || strcmp(argv[argi], "-d") == 0) {
@@ -42,6 +61,40 @@ int main(int argc, char** argv) {
             DPRINT("[RUNNER] Garbage collection enabled\n");
             argi++;
         }
+        else if (strncmp(argv[argi], "--compile-threads=", 18) == 0) {
+            long threads = strtol(argv[argi] + 18, NULL, 10);
+            if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+            compile_threads = threads > 0 ? (size_t)threads : 1;
+            DPRINT("[RUNNER] Compiling on %zu threads\n", compile_threads);
+            argi++;
+        }
+        else if (strncmp(argv[argi], "--gc-pause-us=", 14) == 0) {
+            long long pause = strtoll(argv[argi] + 14, NULL, 10);
+            gc_pause_us = pause > 0 ? (uint64_t)pause : 0;
+            DPRINT("[RUNNER] GC pause budget %llu us\n", (unsigned long long)gc_pause_us);
+            argi++;
+        }
+        else if (strncmp(argv[argi], "--gc-threads=", 13) == 0) {
+            long threads = strtol(argv[argi] + 13, NULL, 10);
+            if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+            gc_threads = threads > 0 ? (size_t)threads : 1;
+            DPRINT("[RUNNER] Collecting on %zu threads\n", gc_threads);
+            argi++;
+        }
+        else if (strncmp(argv[argi], "--gc-growth=", 12) == 0) {
+            gc_growth = strtod(argv[argi] + 12, NULL);
+            DPRINT("[RUNNER] GC growth factor %.2f\n", gc_growth);
+            argi++;
+        }
+        else if (strcmp(argv[argi], "--gc-stats=json") == 0) {
+            gc_stats_json = true;
+            argi++;
+        }
+        else if (strncmp(argv[argi], "--gc-min-heap-kb=", 17) == 0) {
+            gc_min_heap_kb = strtoull(argv[argi] + 17, NULL, 10);
+            DPRINT("[RUNNER] GC minimum heap %zu KiB\n", gc_min_heap_kb);
+            argi++;
+        }
         else {
             break;
         }
@@ -53,6 +106,12 @@ int main(int argc, char** argv) {
         printf("  -d, --debug     Enable debug mode\n");
         printf("  -j, --jit       Enable JIT compilation\n");
         printf("  -g, --gc        Enable garbage collection\n");
+        printf("  --compile-threads=N  Compile top-level functions on N threads (0 = all cores)\n");
+        printf("  --gc-pause-us=N      Run major collections incrementally in slices of about N us\n");
+        printf("  --gc-threads=N       Mark and sweep major collections on N threads (0 = all cores)\n");
+        printf("  --gc-growth=F        Next major collection at F times the live heap (env RENAME_GC_GROWTH)\n");
+        printf("  --gc-min-heap-kb=N   Never schedule a major collection below N KiB (env RENAME_GC_MIN_HEAP_KB)\n");
+        printf("  --gc-stats=json      Dump GC and heap telemetry as JSON to stderr at exit\n");
         return 1;
     }
 
@@ -64,42 +123,39 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    Token* tokens = lexer_parse_file(l, filename);
-    if (!tokens) {
-        fprintf(stderr, "Failed to parse file: %s\n", filename);
-        lexer_destroy(l);
-        return 1;
-    }
-
-    size_t token_count = 0;
-    while (tokens[token_count].type != END_OF_FILE) token_count++;
-    token_count++;
+    // tokens, AST and compiler scratch of this compilation unit; dropped right after codegen
+    Arena* arena = arena_create(ARENA_DEFAULT_CHUNK_SIZE);
+    lexer_set_arena(l, arena);
+    ast_set_arena(arena);
 
-    DPRINT("[RUNNER] token_count=%zu\n", token_count);
-    for (size_t ti = 0; ti < token_count; ti++) {
-        DPRINT("[RUNNER] token[%zu] type=%s value='%s'\n", ti, token_type_to_string(tokens[ti].type), tokens[ti].value ? tokens[ti].value : "NULL");
-    }
-    Parser* parser = parser_create(tokens, token_count);
+    // the parser pulls tokens from the lexer through a bounded window
+    Parser* parser = parser_create_from_lexer(l);
     if (!parser) {
         fprintf(stderr, "Failed to create parser\n");
         lexer_destroy(l);
+        arena_destroy(arena);
         return 1;
     }
 
     ASTNode* ast = parser_parse(parser);
     parser_destroy(parser);
     lexer_destroy(l);
+    ast_set_arena(NULL);
 
     if (!ast) {
         fprintf(stderr, "Parsing failed\n");
+        arena_destroy(arena);
         return 1;
     }
 
     compiler* comp = compiler_create(ast);
     if (!comp) {
         fprintf(stderr, "Failed to create compiler\n");
+        arena_destroy(arena);
         return 1;
     }
+    compiler_set_arena(comp, arena);
+    compiler_set_threads(comp, compile_threads);
 
     compilation_result* result = compiler_compile(comp);
     if (!result) {
@@ -115,16 +171,17 @@ int main(int argc, char** argv) {
     }
     DPRINT("[RUNNER] Global names count: %zu\n", comp->global_names ? comp->global_names->count : 0);
 
-    for (size_t i = 0; i < token_count; i++) {
-        if (tokens[i].value) free((void*)tokens[i].value);
-    }
-    free(tokens);
+    compiler_release_arena(comp);
 
     size_t global_count = comp->global_names ? comp->global_names->count : 0;
     Heap* heap = heap_create();
     VM* vm = vm_create(heap, global_count);
+    vm_set_gc_pause_us(vm, gc_pause_us);
+    vm_set_gc_threads(vm, gc_threads);
+    if (gc_growth > 0.0) vm_set_gc_growth(vm, gc_growth);
+    if (gc_min_heap_kb > 0) vm_set_gc_min_heap(vm, gc_min_heap_kb * 1024);
 
-    CodeObj module_code;
+    CodeObj module_code = {0};
     module_code.code = result->code_array;
     module_code.name = strdup("<module>");
     module_code.arg_count = 0;
@@ -181,7 +238,7 @@ int main(int argc, char** argv) {
     codes[2] = bytecode_create_with_number(CALL_FUNCTION, 0);
     codes[3] = bytecode_create(RETURN_VALUE, 0, 0, 0);
 
-    CodeObj call_main;
+    CodeObj call_main = {0};
     call_main.code = create_bytecode_array(codes, 4);
     call_main.name = strdup("<call_main>");
     call_main.arg_count = 0;
@@ -201,6 +258,10 @@ int main(int argc, char** argv) {
     if (gc_enabled && vm) {
         DPRINT("[RUNNER] Running final garbage collection...\n");
         vm_collect_garbage(vm);
+        gc_print_pause_histogram(vm_get_gc(vm));
+    }
+    if (gc_stats_json && vm) {
+        vm_write_gc_stats(vm, stderr);
     }
 
     if (ret) object_decref(ret);